@@ -2068,7 +2068,7 @@ void CFileItemList::Assign(const CFileItemList& itemlist, bool append)
   m_sortDescription = itemlist.m_sortDescription;
   m_replaceListing = itemlist.m_replaceListing;
   m_content = itemlist.m_content;
-  m_mapProperties = itemlist.m_mapProperties;
+  m_properties = itemlist.m_properties;
   m_cacheToDisc = itemlist.m_cacheToDisc;
 }
 
@@ -2080,7 +2080,7 @@ bool CFileItemList::Copy(const CFileItemList& items, bool copyItems /* = true */
   // assign the rest of the CFileItemList properties
   m_replaceListing  = items.m_replaceListing;
   m_content         = items.m_content;
-  m_mapProperties   = items.m_mapProperties;
+  m_properties      = items.m_properties;
   m_cacheToDisc     = items.m_cacheToDisc;
   m_sortDetails     = items.m_sortDetails;
   m_sortDescription = items.m_sortDescription;
@@ -3254,13 +3254,12 @@ std::string CFileItem::GetLocalFanart() const
   if (strDir.empty())
     return "";
 
-  CFileItemList items;
-  CDirectory::GetDirectory(strDir, items, CServiceBroker::GetFileExtensionProvider().GetPictureExtensions(), DIR_FLAG_NO_FILE_DIRS | DIR_FLAG_READ_CACHE | DIR_FLAG_NO_FILE_INFO);
+  // only read, so share the cached listings
+  std::vector<std::shared_ptr<const CFileItemList>> listings;
+  listings.push_back(CDirectory::GetSharedDirectory(strDir, CServiceBroker::GetFileExtensionProvider().GetPictureExtensions(), DIR_FLAG_NO_FILE_DIRS | DIR_FLAG_READ_CACHE | DIR_FLAG_NO_FILE_INFO));
   if (IsOpticalMediaFile())
   { // grab from the optical media parent folder as well
-    CFileItemList moreItems;
-    CDirectory::GetDirectory(GetLocalMetadataPath(), moreItems, CServiceBroker::GetFileExtensionProvider().GetPictureExtensions(), DIR_FLAG_NO_FILE_DIRS | DIR_FLAG_READ_CACHE | DIR_FLAG_NO_FILE_INFO);
-    items.Append(moreItems);
+    listings.push_back(CDirectory::GetSharedDirectory(GetLocalMetadataPath(), CServiceBroker::GetFileExtensionProvider().GetPictureExtensions(), DIR_FLAG_NO_FILE_DIRS | DIR_FLAG_READ_CACHE | DIR_FLAG_NO_FILE_INFO));
   }
 
   std::vector<std::string> fanarts = StringUtils::Split(CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_fanartImages, "|");
@@ -3273,14 +3272,20 @@ std::string CFileItem::GetLocalFanart() const
 
   for (std::vector<std::string>::const_iterator i = fanarts.begin(); i != fanarts.end(); ++i)
   {
-    for (int j = 0; j < items.Size(); j++)
+    for (const auto& items : listings)
     {
-      std::string strCandidate = URIUtils::GetFileName(items[j]->m_strPath);
-      URIUtils::RemoveExtension(strCandidate);
-      std::string strFanart = *i;
-      URIUtils::RemoveExtension(strFanart);
-      if (StringUtils::EqualsNoCase(strCandidate, strFanart))
-        return items[j]->m_strPath;
+      if (!items)
+        continue;
+
+      for (int j = 0; j < items->Size(); j++)
+      {
+        std::string strCandidate = URIUtils::GetFileName(items->Get(j)->m_strPath);
+        URIUtils::RemoveExtension(strCandidate);
+        std::string strFanart = *i;
+        URIUtils::RemoveExtension(strFanart);
+        if (StringUtils::EqualsNoCase(strCandidate, strFanart))
+          return items->Get(j)->m_strPath;
+      }
     }
   }
 
@@ -3520,8 +3525,11 @@ std::string CFileItem::FindTrailer() const
     return "";
 
   std::string strDir = URIUtils::GetDirectory(strFile);
-  CFileItemList items;
-  CDirectory::GetDirectory(strDir, items, CServiceBroker::GetFileExtensionProvider().GetVideoExtensions(), DIR_FLAG_READ_CACHE | DIR_FLAG_NO_FILE_INFO | DIR_FLAG_NO_FILE_DIRS);
+  // only read, so share the cached listing
+  std::shared_ptr<const CFileItemList> listing = CDirectory::GetSharedDirectory(strDir, CServiceBroker::GetFileExtensionProvider().GetVideoExtensions(), DIR_FLAG_READ_CACHE | DIR_FLAG_NO_FILE_INFO | DIR_FLAG_NO_FILE_DIRS);
+  if (!listing)
+    return "";
+  const CFileItemList& items = *listing;
   URIUtils::RemoveExtension(strFile);
   strFile += "-trailer";
   std::string strFile3 = URIUtils::AddFileToFolder(strDir, "movie-trailer");
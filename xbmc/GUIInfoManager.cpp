@@ -9211,9 +9211,9 @@ INFO::InfoPtr CGUIInfoManager::Register(const std::string &expression, int conte
   std::pair<INFOBOOLTYPE::iterator, bool> res;
 
   if (condition.find_first_of("|+[]!") != condition.npos)
-    res = m_bools.insert(std::make_shared<InfoExpression>(condition, context, m_refreshCounter));
+    res = m_bools.insert(std::make_shared<InfoExpression>(condition, context, m_changeTracker));
   else
-    res = m_bools.insert(std::make_shared<InfoSingle>(condition, context, m_refreshCounter));
+    res = m_bools.insert(std::make_shared<InfoSingle>(condition, context, m_changeTracker));
 
   if (res.second)
     res.first->get()->Initialize();
@@ -9491,11 +9491,13 @@ void CGUIInfoManager::ResetCurrentItem()
 {
   m_currentFile->Reset();
   m_infoProviders.InitCurrentItem(nullptr);
+  ResetCache(INFO::DEPENDS_PLAYER);
 }
 
 void CGUIInfoManager::UpdateCurrentItem(const CFileItem &item)
 {
   m_currentFile->UpdateInfo(item);
+  ResetCache(INFO::DEPENDS_PLAYER);
 }
 
 void CGUIInfoManager::SetCurrentItem(const CFileItem &item)
@@ -9504,6 +9506,7 @@ void CGUIInfoManager::SetCurrentItem(const CFileItem &item)
   m_currentFile->FillInDefaultIcon();
 
   m_infoProviders.InitCurrentItem(m_currentFile);
+  ResetCache(INFO::DEPENDS_PLAYER);
 
   SetChanged();
   NotifyObservers(ObservableMessageCurrentItem);
@@ -9782,21 +9785,96 @@ bool CGUIInfoManager::GetItemBool(const CGUIListItem *item, int contextWindow, i
 
 void CGUIInfoManager::ResetCache()
 {
-  // mark our infobools as dirty
+  ResetCache(INFO::DEPENDS_ALL);
+}
+
+void CGUIInfoManager::ResetCache(unsigned int dependencies)
+{
+  // mark our infobools depending on these sources as dirty
   CSingleLock lock(m_critInfo);
-  ++m_refreshCounter;
+  m_changeTracker.Changed(dependencies);
+}
+
+void CGUIInfoManager::ResetFrameCache()
+{
+  unsigned int dependencies = INFO::DEPENDS_SYSTEM | INFO::DEPENDS_LISTITEM;
+
+  // player state only changes while playing, and once more after playback ended
+  bool playing = g_application.GetAppPlayer().IsPlaying();
+  if (playing || m_wasPlaying)
+    dependencies |= INFO::DEPENDS_PLAYER;
+  m_wasPlaying = playing;
+
+  unsigned int libraryVersion = m_infoProviders.GetLibraryInfoProvider().GetVersion();
+  if (libraryVersion != m_libraryVersion)
+  {
+    dependencies |= INFO::DEPENDS_LIBRARY;
+    m_libraryVersion = libraryVersion;
+  }
+
+  ResetCache(dependencies);
+}
+
+unsigned int CGUIInfoManager::GetDependencies(int condition) const
+{
+  int info = std::abs(condition);
+  if (info >= MULTI_INFO_START && info <= MULTI_INFO_END)
+  {
+    size_t index = static_cast<size_t>(info - MULTI_INFO_START);
+    if (index >= m_multiInfo.size())
+      return INFO::DEPENDS_ALL;
+    info = std::abs(m_multiInfo[index].m_info);
+  }
+
+  if (info == 0 || info == SYSTEM_ALWAYS_TRUE || info == SYSTEM_ALWAYS_FALSE)
+    return INFO::DEPENDS_NONE;
+
+  if ((info >= LISTITEM_START && info <= LISTITEM_END) ||
+      (info >= CONTAINER_HAS_PARENT_ITEM && info <= CONTAINER_NUM_NONFOLDER_ITEMS))
+    return INFO::DEPENDS_LISTITEM;
+
+  if ((info >= LIBRARY_HAS_MUSIC && info <= LIBRARY_HAS_COMPILATIONS) || info == LIBRARY_HAS_ROLE)
+    return INFO::DEPENDS_LIBRARY;
+
+  switch (info)
+  {
+    // may change while nothing is playing
+    case PLAYER_VOLUME:
+    case PLAYER_MUTED:
+    case MUSICPLAYER_PLAYLISTLEN:
+    case MUSICPLAYER_PLAYLISTPOS:
+    case MUSICPLAYER_HASPREVIOUS:
+    case MUSICPLAYER_HASNEXT:
+    case MUSICPLAYER_EXISTS:
+    case MUSICPLAYER_PLAYLISTPLAYING:
+    case VIDEOPLAYER_PLAYLISTLEN:
+    case VIDEOPLAYER_PLAYLISTPOS:
+    case VIDEOPLAYER_ISFULLSCREEN:
+      return INFO::DEPENDS_SYSTEM;
+    default:
+      break;
+  }
+
+  if ((info >= PLAYER_HAS_MEDIA && info < WEATHER_CONDITIONS_TEXT) ||
+      (info >= MUSICPLAYER_TITLE && info <= RETROPLAYER_VIDEO_ROTATION) ||
+      (info >= PLAYER_PROCESS && info <= PLAYER_PROCESS_AUDIOBITSPERSAMPLE))
+    return INFO::DEPENDS_PLAYER;
+
+  return INFO::DEPENDS_SYSTEM;
 }
 
 void CGUIInfoManager::SetCurrentVideoTag(const CVideoInfoTag &tag)
 {
   m_currentFile->SetFromVideoInfoTag(tag);
   m_currentFile->m_lStartOffset = 0;
+  ResetCache(INFO::DEPENDS_PLAYER);
 }
 
 void CGUIInfoManager::SetCurrentSongTag(const MUSIC_INFO::CMusicInfoTag &tag)
 {
   m_currentFile->SetFromMusicInfoTag(tag);
   m_currentFile->m_lStartOffset = 0;
+  ResetCache(INFO::DEPENDS_PLAYER);
 }
 
 const MUSIC_INFO::CMusicInfoTag* CGUIInfoManager::GetCurrentSongTag() const
@@ -60,8 +60,30 @@ public:
   void Initialize();
 
   void Clear();
+
+  /*! \brief Mark all info bools dirty, they are re-evaluated on next use
+   */
   void ResetCache();
 
+  /*! \brief Mark info bools that depend on the given state sources dirty
+   \param dependencies the changed sources, INFO::InfoDependency flags
+   */
+  void ResetCache(unsigned int dependencies);
+
+  /*! \brief Mark the info bools dirty whose sources may have changed since the last frame
+   Sources that only change on events (e.g. the library, or the player while nothing
+   is playing) are left alone, so conditions depending only on them keep their cached value.
+   */
+  void ResetFrameCache();
+
+  /*! \brief Get the state sources a condition depends on
+   \param condition the condition as returned by TranslateSingleString()
+   \return INFO::InfoDependency flags
+   */
+  unsigned int GetDependencies(int condition) const;
+
+  const INFO::InfoChangeTracker& GetChangeTracker() const { return m_changeTracker; }
+
   // KODI::MESSAGING::IMessageTarget implementation
   int GetMessageMask() override;
   void OnApplicationMessage(KODI::MESSAGING::ThreadMessage* pMsg) override;
@@ -201,7 +223,9 @@ private:
 
   typedef std::set<INFO::InfoPtr, bool(*)(const INFO::InfoPtr&, const INFO::InfoPtr&)> INFOBOOLTYPE;
   INFOBOOLTYPE m_bools;
-  unsigned int m_refreshCounter = 0;
+  INFO::InfoChangeTracker m_changeTracker;
+  bool m_wasPlaying = false;
+  unsigned int m_libraryVersion = 0;
   std::vector<INFO::CSkinVariableString> m_skinVariableStrings;
 
   CCriticalSection m_critInfo;
@@ -16,6 +16,7 @@
 #include "utils/log.h"
 #include "TextureCache.h"
 
+#include <algorithm>
 #include <cassert>
 
 CImageLoader::CImageLoader(const std::string &path, const bool useCache):
@@ -73,11 +74,13 @@ bool CImageLoader::DoWork()
   return (m_texture != NULL);
 }
 
-CGUILargeTextureManager::CLargeTexture::CLargeTexture(const std::string &path):
-  m_path(path)
+CGUILargeTextureManager::CLargeTexture::CLargeTexture(const std::string &path, const void *prefetchOwner):
+  m_path(path),
+  m_prefetchOwner(prefetchOwner)
 {
-  m_refCount = 1;
-  m_timeToDelete = 0;
+  // prefetched textures aren't referenced until someone asks for them
+  m_refCount = prefetchOwner ? 0 : 1;
+  m_timeToDelete = prefetchOwner ? CTimeUtils::GetFrameTime() + PREFETCH_TIME_TO_DELETE : 0;
 }
 
 CGUILargeTextureManager::CLargeTexture::~CLargeTexture()
@@ -89,6 +92,7 @@ CGUILargeTextureManager::CLargeTexture::~CLargeTexture()
 void CGUILargeTextureManager::CLargeTexture::AddRef()
 {
   m_refCount++;
+  m_prefetchOwner = nullptr;
 }
 
 bool CGUILargeTextureManager::CLargeTexture::DecrRef(bool deleteImmediately)
@@ -123,6 +127,34 @@ void CGUILargeTextureManager::CLargeTexture::SetTexture(CBaseTexture* texture)
     m_texture.Set(texture, texture->GetWidth(), texture->GetHeight());
 }
 
+void CGUILargeTextureManager::CLargeTexture::KeepUnused(unsigned int time)
+{
+  if (m_refCount == 0)
+    m_timeToDelete = std::max(m_timeToDelete, CTimeUtils::GetFrameTime() + time);
+}
+
+size_t CGUILargeTextureManager::CLargeTexture::GetMemoryUsage() const
+{
+  size_t size = 0;
+  for (const auto texture : m_texture.m_textures)
+    size += texture->GetPitch() * texture->GetRows();
+  return size;
+}
+
+bool CGUILargeTextureManager::CLargeTexture::UploadToGPU()
+{
+  bool uploaded = false;
+  for (const auto texture : m_texture.m_textures)
+  {
+    if (!texture->IsLoadedToGPU())
+    {
+      texture->LoadToGPU();
+      uploaded = true;
+    }
+  }
+  return uploaded;
+}
+
 CGUILargeTextureManager::CGUILargeTextureManager() = default;
 
 CGUILargeTextureManager::~CGUILargeTextureManager() = default;
@@ -140,6 +172,116 @@ void CGUILargeTextureManager::CleanupUnusedImages(bool immediately)
     else
       ++it;
   }
+
+  // keep the memory of unused textures within the prefetch limit, dropping those due first
+  size_t unusedMemory = GetUnusedMemory();
+  while (unusedMemory > PREFETCH_MEMORY_LIMIT)
+  {
+    listIterator oldest = m_allocated.end();
+    for (it = m_allocated.begin(); it != m_allocated.end(); ++it)
+    {
+      if ((*it)->IsUnused() && (oldest == m_allocated.end() || (*it)->GetTimeToDelete() < (*oldest)->GetTimeToDelete()))
+        oldest = it;
+    }
+    if (oldest == m_allocated.end())
+      break;
+
+    unusedMemory -= (*oldest)->GetMemoryUsage();
+    (*oldest)->DeleteIfRequired(true);
+    m_allocated.erase(oldest);
+  }
+}
+
+size_t CGUILargeTextureManager::GetUnusedMemory() const
+{
+  size_t memory = 0;
+  for (const auto image : m_allocated)
+  {
+    if (image->IsUnused())
+      memory += image->GetMemoryUsage();
+  }
+  return memory;
+}
+
+void CGUILargeTextureManager::PrefetchImages(const void *owner, const std::vector<std::string> &paths)
+{
+  CSingleLock lock(m_listSection);
+
+  // cancel the prefetches that are no longer wanted, e.g. as the scroll direction changed
+  size_t queuedPrefetches = 0;
+  queueIterator it = m_queued.begin();
+  while (it != m_queued.end())
+  {
+    CLargeTexture *image = it->second;
+    if (image->IsUnused() && image->GetPrefetchOwner() == owner &&
+        std::find(paths.begin(), paths.end(), image->GetPath()) == paths.end())
+    {
+      CJobManager::GetInstance().CancelJob(it->first);
+      delete image;
+      it = m_queued.erase(it);
+      continue;
+    }
+    if (image->IsUnused())
+      queuedPrefetches++;
+    ++it;
+  }
+
+  // upload a few of the loaded textures so they don't all hit the GPU in the frame they are shown
+  unsigned int uploads = 0;
+  for (auto image : m_allocated)
+  {
+    if (uploads >= PREFETCH_UPLOADS_PER_CALL)
+      break;
+    if (image->IsUnused() && image->GetPrefetchOwner() == owner && image->UploadToGPU())
+      uploads++;
+  }
+
+  size_t unusedMemory = GetUnusedMemory();
+  for (const auto &path : paths)
+  {
+    if (queuedPrefetches >= PREFETCH_MAX_QUEUED || unusedMemory >= PREFETCH_MEMORY_LIMIT)
+      break;
+    if (path.empty())
+      continue;
+
+    bool found = false;
+    for (auto image : m_allocated)
+    {
+      if (image->GetPath() == path)
+      {
+        image->KeepUnused(PREFETCH_TIME_TO_DELETE);
+        found = true;
+        break;
+      }
+    }
+    for (queueIterator queued = m_queued.begin(); queued != m_queued.end() && !found; ++queued)
+      found = queued->second->GetPath() == path;
+    if (found)
+      continue;
+
+    CLargeTexture *image = new CLargeTexture(path, owner);
+    unsigned int jobID = CJobManager::GetInstance().AddJob(CreateLoader(path, true), this, CJob::PRIORITY_LOW);
+    m_queued.push_back(std::make_pair(jobID, image));
+    queuedPrefetches++;
+  }
+}
+
+void CGUILargeTextureManager::CancelPrefetch(const void *owner)
+{
+  CSingleLock lock(m_listSection);
+  queueIterator it = m_queued.begin();
+  while (it != m_queued.end())
+  {
+    CLargeTexture *image = it->second;
+    if (image->IsUnused() && image->GetPrefetchOwner() == owner)
+    {
+      CJobManager::GetInstance().CancelJob(it->first);
+      delete image;
+      it = m_queued.erase(it);
+    }
+    else
+      ++it;
+  }
 }
 
 // if available, increment reference count, and return the image.
@@ -211,10 +353,15 @@ void CGUILargeTextureManager::QueueImage(const std::string &path, bool useCache)
 
   // queue the item
   CLargeTexture *image = new CLargeTexture(path);
-  unsigned int jobID = CJobManager::GetInstance().AddJob(new CImageLoader(path, useCache), this, CJob::PRIORITY_NORMAL);
+  unsigned int jobID = CJobManager::GetInstance().AddJob(CreateLoader(path, useCache), this, CJob::PRIORITY_NORMAL);
   m_queued.push_back(std::make_pair(jobID, image));
 }
 
+CImageLoader *CGUILargeTextureManager::CreateLoader(const std::string &path, bool useCache)
+{
+  return new CImageLoader(path, useCache);
+}
+
 void CGUILargeTextureManager::OnJobComplete(unsigned int jobID, bool success, CJob *job)
 {
   // see if we still have this job id
@@ -227,6 +374,7 @@ void CGUILargeTextureManager::OnJobComplete(unsigned int jobID, bool success, CJ
       CLargeTexture *image = it->second;
       image->SetTexture(loader->m_texture);
       loader->m_texture = NULL; // we want to keep the texture, and jobs are auto-deleted.
+      image->KeepUnused(PREFETCH_TIME_TO_DELETE);
       m_queued.erase(it);
       m_allocated.push_back(image);
       return;
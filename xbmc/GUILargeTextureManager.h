@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -103,20 +104,55 @@ public:
    */
   void CleanupUnusedImages(bool immediately = false);
 
-private:
+  /*!
+   \brief Request textures to be loaded ahead of use.
+
+   Prefetched textures are loaded at low priority and kept unreferenced for a while, so a later
+   GetImage() call for them returns immediately. Each call replaces the previous prefetch request
+   of the same owner: queued prefetches that are no longer requested are cancelled. Requests
+   beyond the prefetch memory limit are ignored. Textures that finished loading are uploaded to
+   the GPU a few at a time, so this must be called from the rendering thread.
+
+   \param owner the requesting control, used to tell apart the requests of different controls
+   \param paths paths of the images to load, the most urgent first
+   \sa CancelPrefetch
+   */
+  void PrefetchImages(const void *owner, const std::vector<std::string> &paths);
+
+  /*!
+   \brief Cancel all queued prefetches of an owner.
+   \param owner the control that requested the prefetch
+   \sa PrefetchImages
+   */
+  void CancelPrefetch(const void *owner);
+
+protected:
+  /*!
+   \brief Create the job that loads an image
+   \param path path of the image to load
+   \param useCache whether to use the texture cache
+   */
+  virtual CImageLoader *CreateLoader(const std::string &path, bool useCache);
+
   class CLargeTexture
   {
   public:
-    explicit CLargeTexture(const std::string &path);
+    explicit CLargeTexture(const std::string &path, const void *prefetchOwner = nullptr);
     virtual ~CLargeTexture();
 
     void AddRef();
     bool DecrRef(bool deleteImmediately);
     bool DeleteIfRequired(bool deleteImmediately = false);
     void SetTexture(CBaseTexture* texture);
+    void KeepUnused(unsigned int time);
 
     const std::string &GetPath() const { return m_path; };
     const CTextureArray &GetTexture() const { return m_texture; };
+    bool IsUnused() const { return m_refCount == 0; };
+    const void *GetPrefetchOwner() const { return m_prefetchOwner; };
+    unsigned int GetTimeToDelete() const { return m_timeToDelete; };
+    size_t GetMemoryUsage() const;
+    bool UploadToGPU();
 
   private:
     static const unsigned int TIME_TO_DELETE = 2000;
@@ -125,9 +161,16 @@ private:
     std::string m_path;
     CTextureArray m_texture;
     unsigned int m_timeToDelete;
+    const void *m_prefetchOwner; ///< control that prefetched this texture, nullptr if it was requested
   };
 
+  static const unsigned int PREFETCH_TIME_TO_DELETE = 10000;
+  static const size_t PREFETCH_MAX_QUEUED = 32;
+  static const size_t PREFETCH_MEMORY_LIMIT = 64 * 1024 * 1024;
+  static const unsigned int PREFETCH_UPLOADS_PER_CALL = 2;
+
   void QueueImage(const std::string &path, bool useCache = true);
+  size_t GetUnusedMemory() const;
 
   std::vector< std::pair<unsigned int, CLargeTexture *> > m_queued;
   std::vector<CLargeTexture *> m_allocated;
@@ -86,6 +86,7 @@ public:
   std::vector<std::string> vecPaths;
   bool m_ignore = false; /// <Do not store in xml
   bool m_allowSharing = true; /// <Allow browsing of source from UPnP / WebServer
+  int m_scanConcurrency = 0; /// <Directories listed at once by the video scanner, 0 for the default
 };
 
 /*!
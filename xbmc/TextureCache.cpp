@@ -28,7 +28,9 @@ CTextureCache &CTextureCache::GetInstance()
   return s_cache;
 }
 
-CTextureCache::CTextureCache() : CJobQueue(false, 1, CJob::PRIORITY_LOW_PAUSABLE)
+CTextureCache::CTextureCache() : CJobQueue(false, 1, CJob::PRIORITY_LOW_PAUSABLE),
+  m_indexLoaded(false),
+  m_useCountTotal(0)
 {
 }
 
@@ -39,12 +41,41 @@ void CTextureCache::Initialize()
   CSingleLock lock(m_databaseSection);
   if (!m_database.IsOpen())
     m_database.Open();
+
+  if (!m_indexLoaded && m_database.IsOpen())
+  {
+    m_index.Clear();
+    if (m_database.GetCachedTextures(m_index))
+    {
+      CLog::Log(LOGDEBUG, "%s - indexed %u cached textures", __FUNCTION__, static_cast<unsigned int>(m_index.Size()));
+      m_indexLoaded = true;
+    }
+    else
+      m_index.Clear();
+  }
 }
 
 void CTextureCache::Deinitialize()
 {
   CancelJobs();
+
+  std::map<int, std::pair<CTextureDetails, unsigned int>> useCounts;
+  {
+    CSingleLock lock(m_useCountSection);
+    useCounts.swap(m_useCounts);
+    m_useCountTotal = 0;
+  }
+
   CSingleLock lock(m_databaseSection);
+  if (!useCounts.empty() && m_database.IsOpen())
+  { // write out the pending use counts, there is no job queue to do it later
+    m_database.BeginTransaction();
+    for (const auto &useCount : useCounts)
+      m_database.IncrementUseCount(useCount.second.first, useCount.second.second);
+    m_database.CommitTransaction();
+  }
+  m_indexLoaded = false;
+  m_index.Clear();
   m_database.Close();
 }
 
@@ -205,6 +236,10 @@ bool CTextureCache::ClearCachedImage(int id)
 
 bool CTextureCache::GetCachedTexture(const std::string &url, CTextureDetails &details)
 {
+  // the index is only updated while holding m_databaseSection, so lookups don't need it
+  if (m_indexLoaded)
+    return m_index.Get(url, details);
+
   CSingleLock lock(m_databaseSection);
   return m_database.GetCachedTexture(url, details);
 }
@@ -212,38 +247,82 @@ bool CTextureCache::GetCachedTexture(const std::string &url, CTextureDetails &de
 bool CTextureCache::AddCachedTexture(const std::string &url, const CTextureDetails &details)
 {
   CSingleLock lock(m_databaseSection);
-  return m_database.AddCachedTexture(url, details);
+  bool ret = m_database.AddCachedTexture(url, details);
+  if (m_indexLoaded)
+  {
+    CTextureDetails added;
+    if (m_database.GetCachedTexture(url, added))
+    {
+      CTextureDetails indexed(details);
+      indexed.id = added.id;
+      m_index.Set(url, indexed, details.updateable ? CDateTime::GetCurrentDateTime() : CDateTime());
+    }
+    else
+      m_index.Erase(url);
+  }
+  return ret;
 }
 
 void CTextureCache::IncrementUseCount(const CTextureDetails &details)
 {
-  static const size_t count_before_update = 100;
+  static const unsigned int count_before_update = 100;
   CSingleLock lock(m_useCountSection);
-  m_useCounts.reserve(count_before_update);
-  m_useCounts.push_back(details);
-  if (m_useCounts.size() >= count_before_update)
+  auto it = m_useCounts.find(details.id);
+  if (it == m_useCounts.end())
+    m_useCounts.insert(std::make_pair(details.id, std::make_pair(details, 1u)));
+  else
+    it->second.second++;
+
+  if (++m_useCountTotal >= count_before_update)
   {
-    AddJob(new CTextureUseCountJob(m_useCounts));
+    std::vector<std::pair<CTextureDetails, unsigned int>> useCounts;
+    useCounts.reserve(m_useCounts.size());
+    for (const auto &useCount : m_useCounts)
+      useCounts.push_back(useCount.second);
+    AddJob(new CTextureUseCountJob(useCounts));
     m_useCounts.clear();
+    m_useCountTotal = 0;
   }
 }
 
 bool CTextureCache::SetCachedTextureValid(const std::string &url, bool updateable)
 {
   CSingleLock lock(m_databaseSection);
-  return m_database.SetCachedTextureValid(url, updateable);
+  bool ret = m_database.SetCachedTextureValid(url, updateable);
+  if (m_indexLoaded)
+    m_index.SetLastHashCheck(url, updateable ? CDateTime::GetCurrentDateTime() : CDateTime());
+  return ret;
+}
+
+bool CTextureCache::InvalidateCachedImage(const std::string &image)
+{
+  std::string url = CTextureUtils::UnwrapImageURL(image);
+  if (url.empty())
+    return false;
+
+  CSingleLock lock(m_databaseSection);
+  bool ret = m_database.InvalidateCachedTexture(url);
+  if (m_indexLoaded)
+    m_index.SetLastHashCheck(url, CDateTime::GetCurrentDateTime() - CDateTimeSpan(2, 0, 0, 0));
+  return ret;
 }
 
 bool CTextureCache::ClearCachedTexture(const std::string &url, std::string &cachedURL)
 {
   CSingleLock lock(m_databaseSection);
-  return m_database.ClearCachedTexture(url, cachedURL);
+  bool ret = m_database.ClearCachedTexture(url, cachedURL);
+  if (m_indexLoaded)
+    m_index.Erase(url);
+  return ret;
 }
 
 bool CTextureCache::ClearCachedTexture(int id, std::string &cachedURL)
 {
   CSingleLock lock(m_databaseSection);
-  return m_database.ClearCachedTexture(id, cachedURL);
+  bool ret = m_database.ClearCachedTexture(id, cachedURL);
+  if (m_indexLoaded)
+    m_index.Erase(id);
+  return ret;
 }
 
 std::string CTextureCache::GetCacheFile(const std::string &url)
@@ -8,10 +8,14 @@
 
 #pragma once
 
+#include <atomic>
+#include <map>
 #include <set>
 #include <string>
+#include <utility>
 #include <vector>
 #include "utils/JobManager.h"
+#include "TextureCacheIndex.h"
 #include "TextureDatabase.h"
 #include "threads/Event.h"
 
@@ -108,6 +112,13 @@ public:
    */
   bool ClearCachedImage(int textureID);
 
+  /*! \brief mark the cached version of the given image as due for an update check
+   Thread-safe wrapper of CTextureDatabase::InvalidateCachedTexture
+   \param image url of the image
+   \return true if successful, false otherwise.
+   */
+  bool InvalidateCachedImage(const std::string &image);
+
   /*! \brief retrieve a cache file (relative to the cache path) to associate with the given image, excluding extension
    Use GetCachedPath(GetCacheFile(url)+extension) for the full path to the file.
    \param url location of the image
@@ -165,7 +176,7 @@ private:
    */
   std::string GetCachedImage(const std::string &image, CTextureDetails &details, bool trackUsage = false);
 
-  /*! \brief Get an image from the database
+  /*! \brief Get an image from the index, or from the database if the index isn't loaded
    Thread-safe wrapper of CTextureDatabase::GetCachedTexture
    \param image url of the original image
    \param details [out] texture details from the database (if available)
@@ -183,7 +194,7 @@ private:
   bool ClearCachedTexture(int textureID, std::string &cacheFile);
 
   /*! \brief Increment the use count of a texture
-   Stores locally before calling CTextureDatabase::IncrementUseCount via a CUseCountJob
+   Counts locally per texture before calling CTextureDatabase::IncrementUseCount via a CUseCountJob
    \sa CUseCountJob, CTextureDatabase::IncrementUseCount
    */
   void IncrementUseCount(const CTextureDetails &details);
@@ -207,12 +218,15 @@ private:
    */
   void OnCachingComplete(bool success, CTextureCacheJob *job);
 
-  CCriticalSection m_databaseSection;
+  CCriticalSection m_databaseSection; ///< serializes database access and updates of the index
   CTextureDatabase m_database;
+  CTextureCacheIndex m_index; ///< lookups of cached textures, kept coherent with m_database
+  std::atomic<bool> m_indexLoaded;
   std::set<std::string> m_processinglist; ///< currently processing list to avoid 2 jobs being processed at once
   CCriticalSection     m_processingSection;
   CEvent               m_completeEvent; ///< Set whenever a job has finished
-  std::vector<CTextureDetails> m_useCounts; ///< Use count tracking
+  std::map<int, std::pair<CTextureDetails, unsigned int>> m_useCounts; ///< Use count tracking, by texture id
+  unsigned int                 m_useCountTotal;
   CCriticalSection             m_useCountSection;
 };
 
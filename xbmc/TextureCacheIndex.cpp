@@ -0,0 +1,106 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "TextureCacheIndex.h"
+
+#include <functional>
+
+void CTextureCacheIndex::Clear()
+{
+  for (auto &stripe : m_stripes)
+  {
+    CExclusiveLock lock(stripe.section);
+    stripe.entries.clear();
+  }
+}
+
+size_t CTextureCacheIndex::Size() const
+{
+  size_t size = 0;
+  for (const auto &stripe : m_stripes)
+  {
+    CSharedLock lock(stripe.section);
+    size += stripe.entries.size();
+  }
+  return size;
+}
+
+void CTextureCacheIndex::Set(const std::string &url, const CTextureDetails &details, const CDateTime &lastHashCheck)
+{
+  Stripe &stripe = GetStripe(url);
+  CExclusiveLock lock(stripe.section);
+  Entry &entry = stripe.entries[url];
+  entry.details = details;
+  entry.lastHashCheck = lastHashCheck;
+}
+
+bool CTextureCacheIndex::Get(const std::string &url, CTextureDetails &details) const
+{
+  const Stripe &stripe = GetStripe(url);
+  CSharedLock lock(stripe.section);
+  auto it = stripe.entries.find(url);
+  if (it == stripe.entries.end())
+    return false;
+
+  const Entry &entry = it->second;
+  details.id = entry.details.id;
+  details.file = entry.details.file;
+  details.width = entry.details.width;
+  details.height = entry.details.height;
+  // images are checked for updates once a day
+  if (entry.lastHashCheck.IsValid() && entry.lastHashCheck + CDateTimeSpan(1,0,0,0) < CDateTime::GetCurrentDateTime())
+    details.hash = entry.details.hash;
+  return true;
+}
+
+bool CTextureCacheIndex::SetLastHashCheck(const std::string &url, const CDateTime &lastHashCheck)
+{
+  Stripe &stripe = GetStripe(url);
+  CExclusiveLock lock(stripe.section);
+  auto it = stripe.entries.find(url);
+  if (it == stripe.entries.end())
+    return false;
+
+  it->second.lastHashCheck = lastHashCheck;
+  return true;
+}
+
+bool CTextureCacheIndex::Erase(const std::string &url)
+{
+  Stripe &stripe = GetStripe(url);
+  CExclusiveLock lock(stripe.section);
+  return stripe.entries.erase(url) > 0;
+}
+
+bool CTextureCacheIndex::Erase(int textureID)
+{
+  // not indexed by id, this is only used when removing textures by hand
+  for (auto &stripe : m_stripes)
+  {
+    CExclusiveLock lock(stripe.section);
+    for (auto it = stripe.entries.begin(); it != stripe.entries.end(); ++it)
+    {
+      if (it->second.details.id == textureID)
+      {
+        stripe.entries.erase(it);
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+CTextureCacheIndex::Stripe &CTextureCacheIndex::GetStripe(const std::string &url)
+{
+  return m_stripes[std::hash<std::string>()(url) % STRIPES];
+}
+
+const CTextureCacheIndex::Stripe &CTextureCacheIndex::GetStripe(const std::string &url) const
+{
+  return m_stripes[std::hash<std::string>()(url) % STRIPES];
+}
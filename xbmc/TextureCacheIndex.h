@@ -0,0 +1,88 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "TextureCacheJob.h"
+#include "XBDateTime.h"
+#include "threads/SharedSection.h"
+
+#include <string>
+#include <unordered_map>
+
+/*!
+ \ingroup textures
+ \brief In-memory index of the textures in the texture database
+
+ Mirrors the url, cached file, size and hash check details of every cached
+ texture, so looking up images doesn't need to go through the database. The
+ index is split into stripes by url, each with its own lock, so lookups of
+ different images don't wait for each other or for updates.
+
+ The index doesn't access the database, CTextureCache keeps it coherent.
+ */
+class CTextureCacheIndex
+{
+public:
+  /*! \brief Remove all textures from the index */
+  void Clear();
+
+  /*! \brief Number of textures in the index */
+  size_t Size() const;
+
+  /*! \brief Add or replace a texture
+   \param url url of the original image
+   \param details the texture details, hash is the stored image hash
+   \param lastHashCheck time the image was last checked for updates, invalid if it's never checked
+   */
+  void Set(const std::string &url, const CTextureDetails &details, const CDateTime &lastHashCheck);
+
+  /*! \brief Get a texture
+   Mirrors CTextureDatabase::GetCachedTexture: the hash is only returned if the image is due to
+   be checked for updates.
+   \param url url of the original image
+   \param details [out] the texture details
+   \return true if the texture is in the index, false otherwise
+   */
+  bool Get(const std::string &url, CTextureDetails &details) const;
+
+  /*! \brief Update the time an image was last checked for updates
+   \return true if the texture is in the index, false otherwise
+   */
+  bool SetLastHashCheck(const std::string &url, const CDateTime &lastHashCheck);
+
+  /*! \brief Remove a texture by url
+   \return true if the texture was in the index, false otherwise
+   */
+  bool Erase(const std::string &url);
+
+  /*! \brief Remove a texture by database id
+   \return true if the texture was in the index, false otherwise
+   */
+  bool Erase(int textureID);
+
+private:
+  struct Entry
+  {
+    CTextureDetails details;
+    CDateTime lastHashCheck;
+  };
+
+  struct Stripe
+  {
+    mutable CSharedSection section;
+    std::unordered_map<std::string, Entry> entries;
+  };
+
+  static const size_t STRIPES = 16;
+
+  Stripe &GetStripe(const std::string &url);
+  const Stripe &GetStripe(const std::string &url) const;
+
+  Stripe m_stripes[STRIPES];
+};
@@ -251,7 +251,7 @@ std::string CTextureCacheJob::GetImageHash(const std::string &url)
   return "";
 }
 
-CTextureUseCountJob::CTextureUseCountJob(const std::vector<CTextureDetails> &textures) : m_textures(textures)
+CTextureUseCountJob::CTextureUseCountJob(const std::vector<std::pair<CTextureDetails, unsigned int>> &textures) : m_textures(textures)
 {
 }
 
@@ -272,8 +272,8 @@ bool CTextureUseCountJob::DoWork()
   if (db.Open())
   {
     db.BeginTransaction();
-    for (std::vector<CTextureDetails>::const_iterator i = m_textures.begin(); i != m_textures.end(); ++i)
-      db.IncrementUseCount(*i);
+    for (std::vector<std::pair<CTextureDetails, unsigned int>>::const_iterator i = m_textures.begin(); i != m_textures.end(); ++i)
+      db.IncrementUseCount(i->first, i->second);
     db.CommitTransaction();
   }
   return true;
@@ -10,6 +10,7 @@
 
 #include <stdint.h>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "pictures/PictureScalingAlgorithm.h"
@@ -120,12 +121,12 @@ private:
 class CTextureUseCountJob : public CJob
 {
 public:
-  explicit CTextureUseCountJob(const std::vector<CTextureDetails> &textures);
+  explicit CTextureUseCountJob(const std::vector<std::pair<CTextureDetails, unsigned int>> &textures);
 
   const char* GetType() const override { return "usecount"; };
   bool operator==(const CJob *job) const override;
   bool DoWork() override;
 
 private:
-  std::vector<CTextureDetails> m_textures;
+  std::vector<std::pair<CTextureDetails, unsigned int>> m_textures; ///< textures and their number of uses
 };
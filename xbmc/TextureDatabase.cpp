@@ -7,6 +7,7 @@
  */
 
 #include "TextureDatabase.h"
+#include "TextureCacheIndex.h"
 #include "utils/log.h"
 #include "XBDateTime.h"
 #include "dbwrappers/dataset.h"
@@ -229,9 +230,9 @@ void CTextureDatabase::UpdateTables(int version)
   }
 }
 
-bool CTextureDatabase::IncrementUseCount(const CTextureDetails &details)
+bool CTextureDatabase::IncrementUseCount(const CTextureDetails &details, unsigned int count /* = 1 */)
 {
-  std::string sql = PrepareSQL("UPDATE sizes SET usecount=usecount+1, lastusetime=CURRENT_TIMESTAMP WHERE idtexture=%u AND width=%u AND height=%u", details.id, details.width, details.height);
+  std::string sql = PrepareSQL("UPDATE sizes SET usecount=usecount+%u, lastusetime=CURRENT_TIMESTAMP WHERE idtexture=%u AND width=%u AND height=%u", count, details.id, details.width, details.height);
   return ExecuteQuery(sql);
 }
 
@@ -266,6 +267,40 @@ bool CTextureDatabase::GetCachedTexture(const std::string &url, CTextureDetails
   return false;
 }
 
+bool CTextureDatabase::GetCachedTextures(CTextureCacheIndex &index)
+{
+  try
+  {
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS.get()) return false;
+
+    std::string sql = "SELECT url, id, cachedurl, lasthashcheck, imagehash, width, height FROM texture JOIN sizes ON (texture.id=sizes.idtexture AND sizes.size=1)";
+    if (!m_pDS->query(sql))
+      return false;
+
+    while (!m_pDS->eof())
+    {
+      CTextureDetails details;
+      details.id = m_pDS->fv(1).get_asInt();
+      details.file = m_pDS->fv(2).get_asString();
+      CDateTime lastCheck;
+      lastCheck.SetFromDBDateTime(m_pDS->fv(3).get_asString());
+      details.hash = m_pDS->fv(4).get_asString();
+      details.width = m_pDS->fv(5).get_asInt();
+      details.height = m_pDS->fv(6).get_asInt();
+      index.Set(m_pDS->fv(0).get_asString(), details, lastCheck);
+      m_pDS->next();
+    }
+    m_pDS->close();
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s, failed", __FUNCTION__);
+  }
+  return false;
+}
+
 bool CTextureDatabase::GetTextures(CVariant &items, const Filter &filter)
 {
   try
@@ -15,6 +15,7 @@
 #include "TextureCacheJob.h"
 #include "dbwrappers/DatabaseQuery.h"
 
+class CTextureCacheIndex;
 class CVariant;
 
 class CTextureRule : public CDatabaseQueryRule
@@ -67,7 +68,13 @@ public:
   bool SetCachedTextureValid(const std::string &originalURL, bool updateable);
   bool ClearCachedTexture(const std::string &originalURL, std::string &cacheFile);
   bool ClearCachedTexture(int textureID, std::string &cacheFile);
-  bool IncrementUseCount(const CTextureDetails &details);
+  bool IncrementUseCount(const CTextureDetails &details, unsigned int count = 1);
+
+  /*! \brief Load all cached textures into an index
+   \param index [out] the index to fill
+   \return true if successful, false otherwise
+   */
+  bool GetCachedTextures(CTextureCacheIndex &index);
 
   /*! \brief Invalidate a previously cached texture
    Invalidates the texture hash, and sets the texture update time to the current time so that
@@ -22,7 +22,7 @@
 #include "filesystem/File.h"
 #include "filesystem/ZipFile.h"
 #include "messaging/helpers/DialogHelper.h"
-#include "TextureDatabase.h"
+#include "TextureCache.h"
 #include "URL.h"
 #include "utils/Base64.h"
 #include "utils/Digest.h"
@@ -310,10 +310,7 @@ bool CRepositoryUpdateJob::DoWork()
 
   //Invalidate art.
   {
-    CTextureDatabase textureDB;
-    textureDB.Open();
-    textureDB.BeginMultipleExecute();
-
+    CTextureCache& textureCache = CTextureCache::GetInstance();
     for (const auto& addon : addons)
     {
       AddonPtr oldAddon;
@@ -323,16 +320,15 @@ bool CRepositoryUpdateJob::DoWork()
           CLog::Log(LOGDEBUG, "CRepository: invalidating cached art for '%s'", addon->ID().c_str());
 
         if (!oldAddon->Icon().empty())
-          textureDB.InvalidateCachedTexture(oldAddon->Icon());
+          textureCache.InvalidateCachedImage(oldAddon->Icon());
 
         for (const auto& path : oldAddon->Screenshots())
-          textureDB.InvalidateCachedTexture(path);
+          textureCache.InvalidateCachedImage(path);
 
         for (const auto& art : oldAddon->Art())
-          textureDB.InvalidateCachedTexture(art.second);
+          textureCache.InvalidateCachedImage(art.second);
       }
     }
-    textureDB.CommitMultipleExecute();
   }
 
   database.UpdateRepositoryContent(m_repo->ID(), m_repo->Version(), newChecksum, addons);
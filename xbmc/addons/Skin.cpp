@@ -30,6 +30,7 @@
 #include "utils/URIUtils.h"
 #include "utils/XMLUtils.h"
 #include "utils/Variant.h"
+#include "windowing/WinSystem.h"
 
 #define XML_SETTINGS      "settings"
 #define XML_SETTING       "setting"
@@ -235,6 +236,16 @@ struct closestRes
   RESOLUTION_INFO m_target;
 };
 
+// the resolution the skin is displayed at, or its default resolution when
+// running without a windowing system (e.g. headless tools)
+static RESOLUTION_INFO GetTargetRes(const RESOLUTION_INFO& defaultRes)
+{
+  CWinSystemBase* winSystem = CServiceBroker::GetWinSystem();
+  if (!winSystem)
+    return defaultRes;
+  return winSystem->GetGfxContext().GetResInfo();
+}
+
 void CSkinInfo::Start()
 {
   if (!LoadUserSettings())
@@ -255,7 +266,7 @@ void CSkinInfo::Start()
   if (!m_resolutions.empty())
   {
     // find the closest resolution
-    const RESOLUTION_INFO &target = CServiceBroker::GetWinSystem()->GetGfxContext().GetResInfo();
+    const RESOLUTION_INFO target = GetTargetRes(m_defaultRes);
     RESOLUTION_INFO& res = *std::min_element(m_resolutions.begin(), m_resolutions.end(), closestRes(target));
     m_currentAspect = res.strId;
   }
@@ -276,7 +287,7 @@ std::string CSkinInfo::GetSkinPath(const std::string& strFile, RESOLUTION_INFO *
     res = &tempRes;
 
   // find the closest resolution
-  const RESOLUTION_INFO &target = CServiceBroker::GetWinSystem()->GetGfxContext().GetResInfo();
+  const RESOLUTION_INFO target = GetTargetRes(m_defaultRes);
   *res = *std::min_element(m_resolutions.begin(), m_resolutions.end(), closestRes(target));
 
   std::string strPath = URIUtils::AddFileToFolder(strPathToUse, res->strMode, strFile);
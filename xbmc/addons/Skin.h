@@ -165,6 +165,7 @@ public:
   const std::string& GetCurrentAspect() const { return m_currentAspect; }
 
   void LoadIncludes();
+  const std::vector<std::string>& GetIncludeFiles() const { return m_includes.GetFiles(); }
   void ToggleDebug();
   const INFO::CSkinVariableString* CreateSkinVariable(const std::string& name, int context);
 
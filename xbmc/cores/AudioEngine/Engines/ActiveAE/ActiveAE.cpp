@@ -2008,8 +2008,7 @@ bool CActiveAE::RunStages()
             out = (*it)->m_processingBuffers->m_outputSamples.front();
             (*it)->m_processingBuffers->m_outputSamples.pop_front();
 
-            int nb_floats = out->pkt->nb_samples * out->pkt->config.channels / out->pkt->planes;
-            int nb_loops = 1;
+            bool perFrame = false;
             float fadingStep = 0.0f;
 
             // fading
@@ -2027,8 +2026,7 @@ bool CActiveAE::RunStages()
             }
             if ((*it)->m_fadingSamples > 0)
             {
-              nb_floats = out->pkt->config.channels / out->pkt->planes;
-              nb_loops = out->pkt->nb_samples;
+              perFrame = true;
               float delta = (*it)->m_fadingTarget - (*it)->m_fadingBase;
               int samples = m_internalFormat.m_sampleRate * (float)(*it)->m_fadingTime / 1000.0f;
               fadingStep = delta / samples;
@@ -2039,43 +2037,21 @@ bool CActiveAE::RunStages()
             // or if sink format is float (in order to prevent from clipping)
             // we need to run on a per sample basis
             if ((*it)->m_amplify != 1.0 || !(*it)->m_processingBuffers->DoesNormalize() || (m_sinkFormat.m_dataFormat == AE_FMT_FLOAT))
+              perFrame = true;
+
+            int channels = out->pkt->config.channels / out->pkt->planes;
+            if (perFrame)
             {
-              nb_floats = out->pkt->config.channels / out->pkt->planes;
-              nb_loops = out->pkt->nb_samples;
+              CalcFrameGains(*it, *out->pkt, fadingStep);
+              for (int j=0; j<out->pkt->planes; j++)
+                CAEUtil::MulFrames((float*)out->pkt->data[j], m_frameGains.data(), channels, out->pkt->nb_samples);
             }
-
-            for(int i=0; i<nb_loops; i++)
+            else
             {
-              if ((*it)->m_fadingSamples > 0)
-              {
-                (*it)->m_volume += fadingStep;
-                (*it)->m_fadingSamples--;
-
-                if ((*it)->m_fadingSamples == 0)
-                {
-                  // set variables being polled via stream interface
-                  CSingleLock lock((*it)->m_streamLock);
-                  (*it)->m_streamFading = false;
-                }
-              }
-
               // volume for stream
               float volume = (*it)->m_volume * (*it)->m_rgain;
-              if(nb_loops > 1)
-                volume *= (*it)->m_limiter.Run((float**)out->pkt->data, out->pkt->config.channels, i*nb_floats, out->pkt->planes > 1);
-
-              for(int j=0; j<out->pkt->planes; j++)
-              {
-#if defined(HAVE_SSE) && defined(__SSE__)
-                CAEUtil::SSEMulArray((float*)out->pkt->data[j]+i*nb_floats, volume, nb_floats);
-#else
-                float* fbuffer = (float*) out->pkt->data[j]+i*nb_floats;
-                for (int k = 0; k < nb_floats; ++k)
-                {
-                  fbuffer[k] *= volume;
-                }
-#endif
-              }
+              for (int j=0; j<out->pkt->planes; j++)
+                CAEUtil::MulArray((float*)out->pkt->data[j], volume, out->pkt->nb_samples * channels);
             }
           }
           else
@@ -2084,8 +2060,7 @@ bool CActiveAE::RunStages()
             mix = (*it)->m_processingBuffers->m_outputSamples.front();
             (*it)->m_processingBuffers->m_outputSamples.pop_front();
 
-            int nb_floats = mix->pkt->nb_samples * mix->pkt->config.channels / mix->pkt->planes;
-            int nb_loops = 1;
+            bool perFrame = false;
             float fadingStep = 0.0f;
 
             // fading
@@ -2096,8 +2071,7 @@ bool CActiveAE::RunStages()
             }
             if ((*it)->m_fadingSamples > 0)
             {
-              nb_floats = mix->pkt->config.channels / mix->pkt->planes;
-              nb_loops = mix->pkt->nb_samples;
+              perFrame = true;
               float delta = (*it)->m_fadingTarget - (*it)->m_fadingBase;
               int samples = m_internalFormat.m_sampleRate * (float)(*it)->m_fadingTime / 1000.0f;
               fadingStep = delta / samples;
@@ -2106,55 +2080,33 @@ bool CActiveAE::RunStages()
             // for streams amplification of turned off downmix normalization
             // we need to run on a per sample basis
             if ((*it)->m_amplify != 1.0 || !(*it)->m_processingBuffers->DoesNormalize())
-            {
-              nb_floats = out->pkt->config.channels / out->pkt->planes;
-              nb_loops = out->pkt->nb_samples;
-            }
+              perFrame = true;
 
-            for(int i=0; i<nb_loops; i++)
+            int channels = mix->pkt->config.channels / mix->pkt->planes;
+            float peak = 0.0f;
+            if (perFrame)
             {
-              if ((*it)->m_fadingSamples > 0)
+              CalcFrameGains(*it, *mix->pkt, fadingStep);
+              for (int j=0; j<out->pkt->planes && j<mix->pkt->planes; j++)
               {
-                (*it)->m_volume += fadingStep;
-                (*it)->m_fadingSamples--;
-
-                if ((*it)->m_fadingSamples == 0)
-                {
-                  // set variables being polled via stream interface
-                  CSingleLock lock((*it)->m_streamLock);
-                  (*it)->m_streamFading = false;
-                }
+                float *dst = (float*)out->pkt->data[j];
+                float *src = (float*)mix->pkt->data[j];
+                peak = std::max(peak, CAEUtil::MulAddFrames(dst, src, m_frameGains.data(), channels, mix->pkt->nb_samples));
               }
-
+            }
+            else
+            {
               // volume for stream
               float volume = (*it)->m_volume * (*it)->m_rgain;
-              if(nb_loops > 1)
-                volume *= (*it)->m_limiter.Run((float**)mix->pkt->data, mix->pkt->config.channels, i*nb_floats, mix->pkt->planes > 1);
-
-              for(int j=0; j<out->pkt->planes && j<mix->pkt->planes; j++)
+              for (int j=0; j<out->pkt->planes && j<mix->pkt->planes; j++)
               {
-                float *dst = (float*)out->pkt->data[j]+i*nb_floats;
-                float *src = (float*)mix->pkt->data[j]+i*nb_floats;
-#if defined(HAVE_SSE) && defined(__SSE__)
-                CAEUtil::SSEMulAddArray(dst, src, volume, nb_floats);
-                for (int k = 0; k < nb_floats; ++k)
-                {
-                  if (fabs(dst[k]) > 1.0f)
-                  {
-                    needClamp = true;
-                    break;
-                  }
-                }
-#else
-                for (int k = 0; k < nb_floats; ++k)
-                {
-                  dst[k] += src[k] * volume;
-                  if (fabs(dst[k]) > 1.0f)
-                    needClamp = true;
-                }
-#endif
+                float *dst = (float*)out->pkt->data[j];
+                float *src = (float*)mix->pkt->data[j];
+                peak = std::max(peak, CAEUtil::MulAddArray(dst, src, volume, mix->pkt->nb_samples * channels));
               }
             }
+            if (peak > 1.0f)
+              needClamp = true;
             mix->Return();
           }
           busy = true;
@@ -2535,12 +2487,7 @@ void CActiveAE::MixSounds(CSoundPacket &dstSample)
       out = (float*)dstSample.data[j];
       sample_buffer = (float*)(it->sound->GetSound(false)->data[j]+start);
       int nb_floats = mix_samples * dstSample.config.channels / dstSample.planes;
-#if defined(HAVE_SSE) && defined(__SSE__)
-      CAEUtil::SSEMulAddArray(out, sample_buffer, volume, nb_floats);
-#else
-      for (int k = 0; k < nb_floats; ++k)
-        *out++ += *sample_buffer++ * volume;
-#endif
+      CAEUtil::MulAddArray(out, sample_buffer, volume, nb_floats);
     }
 
     it->samples_played += mix_samples;
@@ -2555,6 +2502,32 @@ void CActiveAE::MixSounds(CSoundPacket &dstSample)
   }
 }
 
+void CActiveAE::CalcFrameGains(CActiveAEStream *stream, CSoundPacket &pkt, float fadingStep)
+{
+  m_frameGains.resize(pkt.nb_samples);
+  for (int i = 0; i < pkt.nb_samples; i++)
+  {
+    if (stream->m_fadingSamples > 0)
+    {
+      stream->m_volume += fadingStep;
+      stream->m_fadingSamples--;
+
+      if (stream->m_fadingSamples == 0)
+      {
+        // set variables being polled via stream interface
+        CSingleLock lock(stream->m_streamLock);
+        stream->m_streamFading = false;
+      }
+    }
+
+    // volume for stream
+    m_frameGains[i] = stream->m_volume * stream->m_rgain;
+  }
+
+  if (pkt.nb_samples > 1)
+    stream->m_limiter.Run((float**)pkt.data, pkt.config.channels, pkt.nb_samples, pkt.planes > 1, m_frameGains.data());
+}
+
 void CActiveAE::Deamplify(CSoundPacket &dstSample)
 {
   if (m_volumeScaled < 1.0 || m_muted)
@@ -2565,13 +2538,7 @@ void CActiveAE::Deamplify(CSoundPacket &dstSample)
     for(int j=0; j<dstSample.planes; j++)
     {
       float* buffer = reinterpret_cast<float*>(dstSample.data[j]);
-#if defined(HAVE_SSE) && defined(__SSE__)
-      CAEUtil::SSEMulArray(buffer, volume, nb_floats);
-#else
-      float *fbuffer = buffer;
-      for (int i = 0; i < nb_floats; i++)
-        *fbuffer++ *= volume;
-#endif
+      CAEUtil::MulArray(buffer, volume, nb_floats);
     }
   }
 }
@@ -313,6 +313,7 @@ protected:
   bool ResampleSound(CActiveAESound *sound);
   void MixSounds(CSoundPacket &dstSample);
   void Deamplify(CSoundPacket &dstSample);
+  void CalcFrameGains(CActiveAEStream *stream, CSoundPacket &pkt, float fadingStep);
 
   bool CompareFormat(AEAudioFormat &lhs, AEAudioFormat &rhs);
 
@@ -375,6 +376,7 @@ protected:
   float m_volumeScaled; // multiplier to scale samples in order to achieve the volume specified in m_volume
   bool m_muted;
   bool m_sinkHasVolume;
+  std::vector<float> m_frameGains; // per frame gains of a stream, reused across packets
 
   // viz
   std::vector<IAudioCallback*> m_audioCallback;
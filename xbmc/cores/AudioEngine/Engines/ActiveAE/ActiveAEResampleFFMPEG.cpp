@@ -22,6 +22,7 @@ CActiveAEResampleFFMPEG::CActiveAEResampleFFMPEG()
 {
   m_pContext = NULL;
   m_doesResample = false;
+  m_directConvert = false;
 }
 
 CActiveAEResampleFFMPEG::~CActiveAEResampleFFMPEG()
@@ -166,9 +167,62 @@ bool CActiveAEResampleFFMPEG::Init(SampleConfig dstConfig, SampleConfig srcConfi
     CLog::Log(LOGERROR, "CActiveAEResampleFFMPEG::Init - init resampler failed");
     return false;
   }
+
+  m_directConvert = !force_resample && CanConvertDirect(remapLayout, upmix);
+
   return true;
 }
 
+bool CActiveAEResampleFFMPEG::CanConvertDirect(CAEChannelInfo *remapLayout, bool upmix) const
+{
+  if (m_doesResample || m_src_channels != m_dst_channels ||
+      av_sample_fmt_is_planar(m_src_fmt) != av_sample_fmt_is_planar(m_dst_fmt))
+    return false;
+
+  AVSampleFormat src = av_get_packed_sample_fmt(m_src_fmt);
+  AVSampleFormat dst = av_get_packed_sample_fmt(m_dst_fmt);
+  bool fromFloat = src == AV_SAMPLE_FMT_FLT && (dst == AV_SAMPLE_FMT_S16 || dst == AV_SAMPLE_FMT_S32);
+  bool toFloat = dst == AV_SAMPLE_FMT_FLT && (src == AV_SAMPLE_FMT_S16 || src == AV_SAMPLE_FMT_S32);
+  if (!fromFloat && !toFloat)
+    return false;
+
+  // channels must stay where they are
+  if (remapLayout)
+  {
+    if ((int)remapLayout->Count() != m_src_channels)
+      return false;
+    for (unsigned int out=0; out<remapLayout->Count(); out++)
+    {
+      if (CAEUtil::GetAVChannelIndex((*remapLayout)[out], m_src_chan_layout) != (int)out)
+        return false;
+    }
+    return true;
+  }
+
+  return !(upmix && m_src_channels == 2 && m_dst_channels > 2) &&
+         m_src_chan_layout == m_dst_chan_layout;
+}
+
+void CActiveAEResampleFFMPEG::ConvertDirect(uint8_t **dst_buffer, uint8_t **src_buffer, int samples)
+{
+  int planes = av_sample_fmt_is_planar(m_src_fmt) ? m_src_channels : 1;
+  uint32_t count = samples * m_src_channels / planes;
+  AVSampleFormat src = av_get_packed_sample_fmt(m_src_fmt);
+  AVSampleFormat dst = av_get_packed_sample_fmt(m_dst_fmt);
+
+  for (int i=0; i<planes; i++)
+  {
+    if (dst == AV_SAMPLE_FMT_S16)
+      CAEUtil::FloatToS16((float*)src_buffer[i], (int16_t*)dst_buffer[i], count);
+    else if (dst == AV_SAMPLE_FMT_S32)
+      CAEUtil::FloatToS32((float*)src_buffer[i], (int32_t*)dst_buffer[i], count);
+    else if (src == AV_SAMPLE_FMT_S16)
+      CAEUtil::S16ToFloat((int16_t*)src_buffer[i], (float*)dst_buffer[i], count);
+    else
+      CAEUtil::S32ToFloat((int32_t*)src_buffer[i], (float*)dst_buffer[i], count);
+  }
+}
+
 int CActiveAEResampleFFMPEG::Resample(uint8_t **dst_buffer, int dst_samples, uint8_t **src_buffer, int src_samples, double ratio)
 {
   int delta = 0;
@@ -189,12 +243,26 @@ int CActiveAEResampleFFMPEG::Resample(uint8_t **dst_buffer, int dst_samples, uin
     }
   }
 
-  //! @bug libavresample isn't const correct
-  int ret = swr_convert(m_pContext, dst_buffer, dst_samples, const_cast<const uint8_t**>(src_buffer), src_samples);
-  if (ret < 0)
+  int ret;
+  // swresample keeps samples which don't fit into dst, once it is used
+  // everything has to go through it
+  if (m_directConvert && !m_doesResample && src_samples <= dst_samples)
+  {
+    if (src_samples > 0)
+      ConvertDirect(dst_buffer, src_buffer, src_samples);
+    ret = src_samples;
+  }
+  else
   {
-    CLog::Log(LOGERROR, "CActiveAEResampleFFMPEG::Resample - resample failed");
-    return -1;
+    m_directConvert = false;
+
+    //! @bug libavresample isn't const correct
+    ret = swr_convert(m_pContext, dst_buffer, dst_samples, const_cast<const uint8_t**>(src_buffer), src_samples);
+    if (ret < 0)
+    {
+      CLog::Log(LOGERROR, "CActiveAEResampleFFMPEG::Resample - resample failed");
+      return -1;
+    }
   }
 
   // special handling for S24 formats which are carried in S32
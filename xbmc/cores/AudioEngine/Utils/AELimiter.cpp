@@ -7,6 +7,7 @@
  */
 
 #include "AELimiter.h"
+#include "AEUtil.h"
 #include "ServiceBroker.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/SettingsComponent.h"
@@ -41,6 +42,26 @@ float CAELimiter::Run(float* frame[AE_CH_MAX], int channels, int offset /*= 0*/,
     }
   }
 
+  return Step(highest);
+}
+
+void CAELimiter::Run(float* frame[AE_CH_MAX], int channels, int frames, bool planar, float *gains)
+{
+  m_peaks.assign(frames, 0.0f);
+  if (!planar)
+    CAEUtil::FramePeaks(frame[0], m_peaks.data(), channels, frames);
+  else
+  {
+    for (int i = 0; i < channels; i++)
+      CAEUtil::FramePeaks(frame[i], m_peaks.data(), 1, frames);
+  }
+
+  for (int i = 0; i < frames; i++)
+    gains[i] *= Step(m_peaks[i]);
+}
+
+float CAELimiter::Step(float highest)
+{
   float sample = highest * m_amplify;
   if (sample * m_attenuation > 1.0f)
   {
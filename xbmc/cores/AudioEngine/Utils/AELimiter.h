@@ -9,6 +9,7 @@
 #pragma once
 
 #include <algorithm>
+#include <vector>
 #include "AEAudioFormat.h"
 
 class CAELimiter
@@ -19,6 +20,9 @@ class CAELimiter
     float m_samplerate;
     int   m_holdcounter;
     float m_increase;
+    std::vector<float> m_peaks;
+
+    float Step(float highest);
 
   public:
     CAELimiter();
@@ -39,4 +43,13 @@ class CAELimiter
     }
 
     float Run(float* frame[AE_CH_MAX], int channels, int offset = 0, bool planar = false);
+
+    /*! \brief run the limiter over a block of frames
+     \param frame the sample planes
+     \param channels number of channels
+     \param frames number of frames in the block
+     \param planar true if every channel has its own plane
+     \param gains the gain of each frame, gets multiplied by the limiter gain
+     */
+    void Run(float* frame[AE_CH_MAX], int channels, int frames, bool planar, float *gains);
 };
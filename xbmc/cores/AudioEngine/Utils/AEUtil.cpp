@@ -10,10 +10,25 @@
 #endif
 
 #include "AEUtil.h"
+#include "utils/CPUInfo.h"
 #include "utils/log.h"
 #include "utils/TimeUtils.h"
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
+#include <stdint.h>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define HAS_AE_AVX2
+#define AE_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+#if defined(HAS_NEON) && (defined(__ARM_NEON__) || defined(__ARM_NEON))
+#include <arm_neon.h>
+#define HAS_AE_NEON
+#endif
 
 extern "C" {
 #include "libavutil/channel_layout.h"
@@ -221,219 +236,980 @@ const char* CAEUtil::DataFormatToStr(const enum AEDataFormat dataFormat)
   return formats[dataFormat];
 }
 
-#if defined(HAVE_SSE) && defined(__SSE__)
-void CAEUtil::SSEMulArray(float *data, const float mul, uint32_t count)
+/*
+ * Sample processing kernels
+ *
+ * Each kernel has a plain C++ version and versions for SSE2, AVX2 and NEON,
+ * picked at runtime from the CPU features. Multiplies and adds are always
+ * done as separate operations, never fused, so that all versions produce bit
+ * identical samples and the instruction set can be switched at any time.
+ *
+ * GCC fuses a multiply and a following add into fma whenever the target has
+ * it (always on aarch64), across statements and for intrinsics as well. This
+ * file is therefore built with -ffp-contract=off, see AudioEngine/CMakeLists.txt.
+ */
+namespace
+{
+
+struct AEKernels
+{
+  void (*mulArray)(float *data, float mul, uint32_t count);
+  float (*mulAddArray)(float *data, const float *add, float mul, uint32_t count);
+  void (*mulFrames)(float *data, const float *gains, uint32_t channels, uint32_t frames);
+  float (*mulAddFrames)(float *dst, const float *src, const float *gains, uint32_t channels, uint32_t frames);
+  void (*framePeaks)(const float *data, float *peaks, uint32_t channels, uint32_t frames);
+  void (*clampArray)(float *data, uint32_t count);
+  void (*floatToS16)(const float *src, int16_t *dst, uint32_t count);
+  void (*floatToS32)(const float *src, int32_t *dst, uint32_t count);
+  void (*s16ToFloat)(const int16_t *src, float *dst, uint32_t count);
+  void (*s32ToFloat)(const int32_t *src, float *dst, uint32_t count);
+};
+
+const float S16_SCALE = 32768.0f;
+const float S32_SCALE = 2147483648.0f;
+
+/*
+ This is a rational function to approximate a tanh-like soft clipper.
+ It is based on the pade-approximation of the tanh function with tweaked coefficients.
+ See: http://www.musicdsp.org/showone.php?id=238
+ Input is limited to +-3 where the function reaches +-1.
+*/
+inline float SoftClamp(float x)
+{
+  x = std::min(std::max(x, -3.0f), 3.0f);
+  float y = x * x;
+  float num = x * (27.0f + y);
+  float den = 9.0f * y;
+  den += 27.0f;
+  return num / den;
+}
+
+//-----------------------------------------------------------------------------
+// C++
+//-----------------------------------------------------------------------------
+
+void MulArrayC(float *data, float mul, uint32_t count)
+{
+  for (uint32_t i = 0; i < count; ++i)
+    data[i] *= mul;
+}
+
+float MulAddArrayC(float *data, const float *add, float mul, uint32_t count)
+{
+  float peak = 0.0f;
+  for (uint32_t i = 0; i < count; ++i)
+  {
+    float sample = add[i] * mul;
+    data[i] += sample;
+    peak = std::max(peak, fabsf(data[i]));
+  }
+  return peak;
+}
+
+void MulFramesC(float *data, const float *gains, uint32_t channels, uint32_t frames)
 {
-  const __m128 m = _mm_set_ps1(mul);
+  for (uint32_t f = 0; f < frames; ++f, data += channels)
+    MulArrayC(data, gains[f], channels);
+}
 
-  /* work around invalid alignment */
-  while (((uintptr_t)data & 0xF) && count > 0)
+float MulAddFramesC(float *dst, const float *src, const float *gains, uint32_t channels, uint32_t frames)
+{
+  float peak = 0.0f;
+  for (uint32_t f = 0; f < frames; ++f, dst += channels, src += channels)
+    peak = std::max(peak, MulAddArrayC(dst, src, gains[f], channels));
+  return peak;
+}
+
+void FramePeaksC(const float *data, float *peaks, uint32_t channels, uint32_t frames)
+{
+  for (uint32_t f = 0; f < frames; ++f, data += channels)
   {
-    data[0] *= mul;
-    ++data;
-    --count;
+    float peak = peaks[f];
+    for (uint32_t c = 0; c < channels; ++c)
+      peak = std::max(peak, fabsf(data[c]));
+    peaks[f] = peak;
   }
+}
 
-  uint32_t even = count & ~0x3;
-  for (uint32_t i = 0; i < even; i+=4, data+=4)
+void ClampArrayC(float *data, uint32_t count)
+{
+  for (uint32_t i = 0; i < count; ++i)
+    data[i] = SoftClamp(data[i]);
+}
+
+void FloatToS16C(const float *src, int16_t *dst, uint32_t count)
+{
+  for (uint32_t i = 0; i < count; ++i)
   {
-    __m128 to      = _mm_load_ps(data);
-    *(__m128*)data = _mm_mul_ps (to, m);
+    float sample = std::min(std::max(src[i] * S16_SCALE, -32768.0f), 32767.0f);
+    dst[i] = static_cast<int16_t>(lrintf(sample));
   }
+}
 
-  if (even != count)
+void FloatToS32C(const float *src, int32_t *dst, uint32_t count)
+{
+  for (uint32_t i = 0; i < count; ++i)
   {
-    uint32_t odd = count - even;
-    if (odd == 1)
-      data[0] *= mul;
+    float sample = src[i] * S32_SCALE;
+    if (sample >= S32_SCALE)
+      dst[i] = INT32_MAX;
+    else if (sample <= -S32_SCALE)
+      dst[i] = INT32_MIN;
     else
+      dst[i] = static_cast<int32_t>(lrintf(sample));
+  }
+}
+
+void S16ToFloatC(const int16_t *src, float *dst, uint32_t count)
+{
+  for (uint32_t i = 0; i < count; ++i)
+    dst[i] = src[i] * (1.0f / S16_SCALE);
+}
+
+void S32ToFloatC(const int32_t *src, float *dst, uint32_t count)
+{
+  for (uint32_t i = 0; i < count; ++i)
+    dst[i] = src[i] * (1.0f / S32_SCALE);
+}
+
+const AEKernels kernelsC =
+{
+  MulArrayC, MulAddArrayC, MulFramesC, MulAddFramesC, FramePeaksC, ClampArrayC,
+  FloatToS16C, FloatToS32C, S16ToFloatC, S32ToFloatC
+};
+
+//-----------------------------------------------------------------------------
+// SSE2
+//-----------------------------------------------------------------------------
+
+#if defined(HAVE_SSE2) && defined(__SSE2__)
+inline __m128 AbsSSE2(__m128 v)
+{
+  return _mm_andnot_ps(_mm_set1_ps(-0.0f), v);
+}
+
+inline float HMaxSSE2(__m128 v)
+{
+  v = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)));
+  v = _mm_max_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtss_f32(v);
+}
+
+void MulArraySSE2(float *data, float mul, uint32_t count)
+{
+  const __m128 m = _mm_set1_ps(mul);
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+    _mm_storeu_ps(data + i, _mm_mul_ps(_mm_loadu_ps(data + i), m));
+  MulArrayC(data + i, mul, count - i);
+}
+
+float MulAddArraySSE2(float *data, const float *add, float mul, uint32_t count)
+{
+  const __m128 m = _mm_set1_ps(mul);
+  __m128 peak = _mm_setzero_ps();
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    __m128 v = _mm_add_ps(_mm_loadu_ps(data + i), _mm_mul_ps(_mm_loadu_ps(add + i), m));
+    _mm_storeu_ps(data + i, v);
+    peak = _mm_max_ps(peak, AbsSSE2(v));
+  }
+  return std::max(HMaxSSE2(peak), MulAddArrayC(data + i, add + i, mul, count - i));
+}
+
+void MulFramesSSE2(float *data, const float *gains, uint32_t channels, uint32_t frames)
+{
+  uint32_t f = 0;
+  if (channels == 1)
+  {
+    for (; f + 4 <= frames; f += 4)
+      _mm_storeu_ps(data + f, _mm_mul_ps(_mm_loadu_ps(data + f), _mm_loadu_ps(gains + f)));
+  }
+  else if (channels == 2)
+  {
+    for (; f + 4 <= frames; f += 4)
     {
-      __m128 to;
-      if (odd == 2)
-      {
-        to = _mm_setr_ps(data[0], data[1], 0, 0);
-        __m128 ou = _mm_mul_ps(to, m);
-        data[0] = ((float*)&ou)[0];
-        data[1] = ((float*)&ou)[1];
-      }
-      else
-      {
-        to = _mm_setr_ps(data[0], data[1], data[2], 0);
-        __m128 ou = _mm_mul_ps(to, m);
-        data[0] = ((float*)&ou)[0];
-        data[1] = ((float*)&ou)[1];
-        data[2] = ((float*)&ou)[2];
-      }
+      __m128 g = _mm_loadu_ps(gains + f);
+      float *d = data + f * 2;
+      _mm_storeu_ps(d, _mm_mul_ps(_mm_loadu_ps(d), _mm_unpacklo_ps(g, g)));
+      _mm_storeu_ps(d + 4, _mm_mul_ps(_mm_loadu_ps(d + 4), _mm_unpackhi_ps(g, g)));
+    }
+  }
+  else if (channels >= 4)
+  {
+    for (; f < frames; ++f)
+      MulArraySSE2(data + f * channels, gains[f], channels);
+  }
+  MulFramesC(data + f * channels, gains + f, channels, frames - f);
+}
+
+float MulAddFramesSSE2(float *dst, const float *src, const float *gains, uint32_t channels, uint32_t frames)
+{
+  __m128 peak = _mm_setzero_ps();
+  float framePeak = 0.0f;
+  uint32_t f = 0;
+  if (channels == 1)
+  {
+    for (; f + 4 <= frames; f += 4)
+    {
+      __m128 v = _mm_add_ps(_mm_loadu_ps(dst + f), _mm_mul_ps(_mm_loadu_ps(src + f), _mm_loadu_ps(gains + f)));
+      _mm_storeu_ps(dst + f, v);
+      peak = _mm_max_ps(peak, AbsSSE2(v));
+    }
+  }
+  else if (channels == 2)
+  {
+    for (; f + 4 <= frames; f += 4)
+    {
+      __m128 g = _mm_loadu_ps(gains + f);
+      float *d = dst + f * 2;
+      const float *s = src + f * 2;
+      __m128 lo = _mm_add_ps(_mm_loadu_ps(d), _mm_mul_ps(_mm_loadu_ps(s), _mm_unpacklo_ps(g, g)));
+      __m128 hi = _mm_add_ps(_mm_loadu_ps(d + 4), _mm_mul_ps(_mm_loadu_ps(s + 4), _mm_unpackhi_ps(g, g)));
+      _mm_storeu_ps(d, lo);
+      _mm_storeu_ps(d + 4, hi);
+      peak = _mm_max_ps(peak, _mm_max_ps(AbsSSE2(lo), AbsSSE2(hi)));
+    }
+  }
+  else if (channels >= 4)
+  {
+    for (; f < frames; ++f)
+      framePeak = std::max(framePeak, MulAddArraySSE2(dst + f * channels, src + f * channels, gains[f], channels));
+  }
+  float tail = MulAddFramesC(dst + f * channels, src + f * channels, gains + f, channels, frames - f);
+  return std::max(std::max(HMaxSSE2(peak), framePeak), tail);
+}
+
+void FramePeaksSSE2(const float *data, float *peaks, uint32_t channels, uint32_t frames)
+{
+  uint32_t f = 0;
+  if (channels == 1)
+  {
+    for (; f + 4 <= frames; f += 4)
+      _mm_storeu_ps(peaks + f, _mm_max_ps(_mm_loadu_ps(peaks + f), AbsSSE2(_mm_loadu_ps(data + f))));
+  }
+  else if (channels == 2)
+  {
+    for (; f + 4 <= frames; f += 4)
+    {
+      __m128 a = AbsSSE2(_mm_loadu_ps(data + f * 2));
+      __m128 b = AbsSSE2(_mm_loadu_ps(data + f * 2 + 4));
+      __m128 left = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+      __m128 right = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+      _mm_storeu_ps(peaks + f, _mm_max_ps(_mm_loadu_ps(peaks + f), _mm_max_ps(left, right)));
     }
   }
+  else if (channels >= 4)
+  {
+    for (; f < frames; ++f)
+    {
+      const float *d = data + f * channels;
+      __m128 peak = AbsSSE2(_mm_loadu_ps(d));
+      uint32_t c = 4;
+      for (; c + 4 <= channels; c += 4)
+        peak = _mm_max_ps(peak, AbsSSE2(_mm_loadu_ps(d + c)));
+      float p = std::max(peaks[f], HMaxSSE2(peak));
+      for (; c < channels; ++c)
+        p = std::max(p, fabsf(d[c]));
+      peaks[f] = p;
+    }
+  }
+  FramePeaksC(data + f * channels, peaks + f, channels, frames - f);
+}
+
+void ClampArraySSE2(float *data, uint32_t count)
+{
+  const __m128 lo = _mm_set1_ps(-3.0f);
+  const __m128 hi = _mm_set1_ps(3.0f);
+  const __m128 c27 = _mm_set1_ps(27.0f);
+  const __m128 c9 = _mm_set1_ps(9.0f);
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    __m128 x = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(data + i), lo), hi);
+    __m128 y = _mm_mul_ps(x, x);
+    __m128 num = _mm_mul_ps(x, _mm_add_ps(c27, y));
+    __m128 den = _mm_add_ps(_mm_mul_ps(c9, y), c27);
+    _mm_storeu_ps(data + i, _mm_div_ps(num, den));
+  }
+  ClampArrayC(data + i, count - i);
 }
 
-void CAEUtil::SSEMulAddArray(float *data, float *add, const float mul, uint32_t count)
+void FloatToS16SSE2(const float *src, int16_t *dst, uint32_t count)
 {
-  const __m128 m = _mm_set_ps1(mul);
+  const __m128 scale = _mm_set1_ps(S16_SCALE);
+  const __m128 lo = _mm_set1_ps(-32768.0f);
+  const __m128 hi = _mm_set1_ps(32767.0f);
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    __m128 a = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(src + i), scale), lo), hi);
+    __m128 b = _mm_min_ps(_mm_max_ps(_mm_mul_ps(_mm_loadu_ps(src + i + 4), scale), lo), hi);
+    __m128i v = _mm_packs_epi32(_mm_cvtps_epi32(a), _mm_cvtps_epi32(b));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), v);
+  }
+  FloatToS16C(src + i, dst + i, count - i);
+}
 
-  /* work around invalid alignment */
-  while ((((uintptr_t)data & 0xF) || ((uintptr_t)add & 0xF)) && count > 0)
+void FloatToS32SSE2(const float *src, int32_t *dst, uint32_t count)
+{
+  const __m128 scale = _mm_set1_ps(S32_SCALE);
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
   {
-    data[0] += add[0] * mul;
-    ++add;
-    ++data;
-    --count;
+    __m128 v = _mm_mul_ps(_mm_loadu_ps(src + i), scale);
+    // overflow converts to INT32_MIN, flip it to INT32_MAX for positive samples
+    __m128i overflow = _mm_castps_si128(_mm_cmpge_ps(v, scale));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_xor_si128(_mm_cvtps_epi32(v), overflow));
   }
+  FloatToS32C(src + i, dst + i, count - i);
+}
 
-  uint32_t even = count & ~0x3;
-  for (uint32_t i = 0; i < even; i+=4, data+=4, add+=4)
+void S16ToFloatSSE2(const int16_t *src, float *dst, uint32_t count)
+{
+  const __m128 scale = _mm_set1_ps(1.0f / S16_SCALE);
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
   {
-    __m128 ad      = _mm_load_ps(add );
-    __m128 to      = _mm_load_ps(data);
-    *(__m128*)data = _mm_add_ps (to, _mm_mul_ps(ad, m));
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    // sign extend by moving each sample to the upper half and shifting back
+    __m128i lo = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+    __m128i hi = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+    _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(lo), scale));
+    _mm_storeu_ps(dst + i + 4, _mm_mul_ps(_mm_cvtepi32_ps(hi), scale));
   }
+  S16ToFloatC(src + i, dst + i, count - i);
+}
 
-  if (even != count)
+void S32ToFloatSSE2(const int32_t *src, float *dst, uint32_t count)
+{
+  const __m128 scale = _mm_set1_ps(1.0f / S32_SCALE);
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
   {
-    uint32_t odd = count - even;
-    if (odd == 1)
-      data[0] += add[0] * mul;
-    else
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(v), scale));
+  }
+  S32ToFloatC(src + i, dst + i, count - i);
+}
+
+const AEKernels kernelsSSE2 =
+{
+  MulArraySSE2, MulAddArraySSE2, MulFramesSSE2, MulAddFramesSSE2, FramePeaksSSE2, ClampArraySSE2,
+  FloatToS16SSE2, FloatToS32SSE2, S16ToFloatSSE2, S32ToFloatSSE2
+};
+#endif
+
+//-----------------------------------------------------------------------------
+// AVX2
+//-----------------------------------------------------------------------------
+
+#if defined(HAS_AE_AVX2)
+AE_TARGET_AVX2 inline __m256 AbsAVX2(__m256 v)
+{
+  return _mm256_andnot_ps(_mm256_set1_ps(-0.0f), v);
+}
+
+AE_TARGET_AVX2 inline float HMaxAVX2(__m256 v)
+{
+  __m128 m = _mm_max_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+  m = _mm_max_ps(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(1, 0, 3, 2)));
+  m = _mm_max_ps(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtss_f32(m);
+}
+
+// duplicates 4 gains to g0 g0 g1 g1 g2 g2 g3 g3 for stereo frames
+AE_TARGET_AVX2 inline __m256 StereoGainsAVX2(const float *gains)
+{
+  const __m256i idx = _mm256_setr_epi32(0, 0, 1, 1, 2, 2, 3, 3);
+  return _mm256_permutevar8x32_ps(_mm256_castps128_ps256(_mm_loadu_ps(gains)), idx);
+}
+
+AE_TARGET_AVX2 void MulArrayAVX2(float *data, float mul, uint32_t count)
+{
+  const __m256 m = _mm256_set1_ps(mul);
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+    _mm256_storeu_ps(data + i, _mm256_mul_ps(_mm256_loadu_ps(data + i), m));
+  if (i + 4 <= count)
+  {
+    _mm_storeu_ps(data + i, _mm_mul_ps(_mm_loadu_ps(data + i), _mm256_castps256_ps128(m)));
+    i += 4;
+  }
+  MulArrayC(data + i, mul, count - i);
+}
+
+AE_TARGET_AVX2 float MulAddArrayAVX2(float *data, const float *add, float mul, uint32_t count)
+{
+  const __m256 m = _mm256_set1_ps(mul);
+  __m256 peak = _mm256_setzero_ps();
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    __m256 v = _mm256_add_ps(_mm256_loadu_ps(data + i), _mm256_mul_ps(_mm256_loadu_ps(add + i), m));
+    _mm256_storeu_ps(data + i, v);
+    peak = _mm256_max_ps(peak, AbsAVX2(v));
+  }
+  if (i + 4 <= count)
+  {
+    __m128 v = _mm_add_ps(_mm_loadu_ps(data + i), _mm_mul_ps(_mm_loadu_ps(add + i), _mm256_castps256_ps128(m)));
+    _mm_storeu_ps(data + i, v);
+    peak = _mm256_max_ps(peak, AbsAVX2(_mm256_castps128_ps256(v)));
+    i += 4;
+  }
+  return std::max(HMaxAVX2(peak), MulAddArrayC(data + i, add + i, mul, count - i));
+}
+
+AE_TARGET_AVX2 void MulFramesAVX2(float *data, const float *gains, uint32_t channels, uint32_t frames)
+{
+  uint32_t f = 0;
+  if (channels == 1)
+  {
+    for (; f + 8 <= frames; f += 8)
+      _mm256_storeu_ps(data + f, _mm256_mul_ps(_mm256_loadu_ps(data + f), _mm256_loadu_ps(gains + f)));
+  }
+  else if (channels == 2)
+  {
+    for (; f + 4 <= frames; f += 4)
     {
-      __m128 ad;
-      __m128 to;
-      if (odd == 2)
-      {
-        ad = _mm_setr_ps(add [0], add [1], 0, 0);
-        to = _mm_setr_ps(data[0], data[1], 0, 0);
-        __m128 ou = _mm_add_ps(to, _mm_mul_ps(ad, m));
-        data[0] = ((float*)&ou)[0];
-        data[1] = ((float*)&ou)[1];
-      }
-      else
+      float *d = data + f * 2;
+      _mm256_storeu_ps(d, _mm256_mul_ps(_mm256_loadu_ps(d), StereoGainsAVX2(gains + f)));
+    }
+  }
+  else if (channels >= 4)
+  {
+    for (; f < frames; ++f)
+      MulArrayAVX2(data + f * channels, gains[f], channels);
+  }
+  MulFramesC(data + f * channels, gains + f, channels, frames - f);
+}
+
+AE_TARGET_AVX2 float MulAddFramesAVX2(float *dst, const float *src, const float *gains, uint32_t channels, uint32_t frames)
+{
+  __m256 peak = _mm256_setzero_ps();
+  float framePeak = 0.0f;
+  uint32_t f = 0;
+  if (channels == 1)
+  {
+    for (; f + 8 <= frames; f += 8)
+    {
+      __m256 v = _mm256_add_ps(_mm256_loadu_ps(dst + f), _mm256_mul_ps(_mm256_loadu_ps(src + f), _mm256_loadu_ps(gains + f)));
+      _mm256_storeu_ps(dst + f, v);
+      peak = _mm256_max_ps(peak, AbsAVX2(v));
+    }
+  }
+  else if (channels == 2)
+  {
+    for (; f + 4 <= frames; f += 4)
+    {
+      float *d = dst + f * 2;
+      __m256 v = _mm256_add_ps(_mm256_loadu_ps(d), _mm256_mul_ps(_mm256_loadu_ps(src + f * 2), StereoGainsAVX2(gains + f)));
+      _mm256_storeu_ps(d, v);
+      peak = _mm256_max_ps(peak, AbsAVX2(v));
+    }
+  }
+  else if (channels >= 4)
+  {
+    for (; f < frames; ++f)
+      framePeak = std::max(framePeak, MulAddArrayAVX2(dst + f * channels, src + f * channels, gains[f], channels));
+  }
+  float tail = MulAddFramesC(dst + f * channels, src + f * channels, gains + f, channels, frames - f);
+  return std::max(std::max(HMaxAVX2(peak), framePeak), tail);
+}
+
+AE_TARGET_AVX2 void FramePeaksAVX2(const float *data, float *peaks, uint32_t channels, uint32_t frames)
+{
+  uint32_t f = 0;
+  if (channels == 1)
+  {
+    for (; f + 8 <= frames; f += 8)
+      _mm256_storeu_ps(peaks + f, _mm256_max_ps(_mm256_loadu_ps(peaks + f), AbsAVX2(_mm256_loadu_ps(data + f))));
+  }
+  else if (channels == 2)
+  {
+    for (; f + 8 <= frames; f += 8)
+    {
+      __m256 a = AbsAVX2(_mm256_loadu_ps(data + f * 2));
+      __m256 b = AbsAVX2(_mm256_loadu_ps(data + f * 2 + 8));
+      // shuffles work per 128 bit lane, frames end up as 0 1 4 5 2 3 6 7
+      __m256 left = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+      __m256 right = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+      __m256 peak = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(_mm256_max_ps(left, right)), _MM_SHUFFLE(3, 1, 2, 0)));
+      _mm256_storeu_ps(peaks + f, _mm256_max_ps(_mm256_loadu_ps(peaks + f), peak));
+    }
+  }
+  else if (channels >= 4)
+  {
+    for (; f < frames; ++f)
+    {
+      const float *d = data + f * channels;
+      __m256 peak = _mm256_setzero_ps();
+      uint32_t c = 0;
+      for (; c + 8 <= channels; c += 8)
+        peak = _mm256_max_ps(peak, AbsAVX2(_mm256_loadu_ps(d + c)));
+      if (c + 4 <= channels)
       {
-        ad = _mm_setr_ps(add [0], add [1], add [2], 0);
-        to = _mm_setr_ps(data[0], data[1], data[2], 0);
-        __m128 ou = _mm_add_ps(to, _mm_mul_ps(ad, m));
-        data[0] = ((float*)&ou)[0];
-        data[1] = ((float*)&ou)[1];
-        data[2] = ((float*)&ou)[2];
+        peak = _mm256_max_ps(peak, AbsAVX2(_mm256_castps128_ps256(_mm_loadu_ps(d + c))));
+        c += 4;
       }
+      float p = std::max(peaks[f], HMaxAVX2(peak));
+      for (; c < channels; ++c)
+        p = std::max(p, fabsf(d[c]));
+      peaks[f] = p;
     }
   }
+  FramePeaksC(data + f * channels, peaks + f, channels, frames - f);
+}
+
+AE_TARGET_AVX2 void ClampArrayAVX2(float *data, uint32_t count)
+{
+  const __m256 lo = _mm256_set1_ps(-3.0f);
+  const __m256 hi = _mm256_set1_ps(3.0f);
+  const __m256 c27 = _mm256_set1_ps(27.0f);
+  const __m256 c9 = _mm256_set1_ps(9.0f);
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    __m256 x = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(data + i), lo), hi);
+    __m256 y = _mm256_mul_ps(x, x);
+    __m256 num = _mm256_mul_ps(x, _mm256_add_ps(c27, y));
+    __m256 den = _mm256_add_ps(_mm256_mul_ps(c9, y), c27);
+    _mm256_storeu_ps(data + i, _mm256_div_ps(num, den));
+  }
+  ClampArrayC(data + i, count - i);
+}
+
+AE_TARGET_AVX2 void FloatToS16AVX2(const float *src, int16_t *dst, uint32_t count)
+{
+  const __m256 scale = _mm256_set1_ps(S16_SCALE);
+  const __m256 lo = _mm256_set1_ps(-32768.0f);
+  const __m256 hi = _mm256_set1_ps(32767.0f);
+  uint32_t i = 0;
+  for (; i + 16 <= count; i += 16)
+  {
+    __m256 a = _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_loadu_ps(src + i), scale), lo), hi);
+    __m256 b = _mm256_min_ps(_mm256_max_ps(_mm256_mul_ps(_mm256_loadu_ps(src + i + 8), scale), lo), hi);
+    // packs works per 128 bit lane, restore sample order afterwards
+    __m256i v = _mm256_packs_epi32(_mm256_cvtps_epi32(a), _mm256_cvtps_epi32(b));
+    v = _mm256_permute4x64_epi64(v, _MM_SHUFFLE(3, 1, 2, 0));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), v);
+  }
+  FloatToS16C(src + i, dst + i, count - i);
+}
+
+AE_TARGET_AVX2 void FloatToS32AVX2(const float *src, int32_t *dst, uint32_t count)
+{
+  const __m256 scale = _mm256_set1_ps(S32_SCALE);
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    __m256 v = _mm256_mul_ps(_mm256_loadu_ps(src + i), scale);
+    // overflow converts to INT32_MIN, flip it to INT32_MAX for positive samples
+    __m256i overflow = _mm256_castps_si256(_mm256_cmp_ps(v, scale, _CMP_GE_OQ));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), _mm256_xor_si256(_mm256_cvtps_epi32(v), overflow));
+  }
+  FloatToS32C(src + i, dst + i, count - i);
+}
+
+AE_TARGET_AVX2 void S16ToFloatAVX2(const int16_t *src, float *dst, uint32_t count)
+{
+  const __m256 scale = _mm256_set1_ps(1.0f / S16_SCALE);
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    __m256i v = _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i)));
+    _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_cvtepi32_ps(v), scale));
+  }
+  S16ToFloatC(src + i, dst + i, count - i);
+}
+
+AE_TARGET_AVX2 void S32ToFloatAVX2(const int32_t *src, float *dst, uint32_t count)
+{
+  const __m256 scale = _mm256_set1_ps(1.0f / S32_SCALE);
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_cvtepi32_ps(v), scale));
+  }
+  S32ToFloatC(src + i, dst + i, count - i);
 }
+
+const AEKernels kernelsAVX2 =
+{
+  MulArrayAVX2, MulAddArrayAVX2, MulFramesAVX2, MulAddFramesAVX2, FramePeaksAVX2, ClampArrayAVX2,
+  FloatToS16AVX2, FloatToS32AVX2, S16ToFloatAVX2, S32ToFloatAVX2
+};
 #endif
 
-inline float CAEUtil::SoftClamp(const float x)
-{
-#if 1
-    /*
-       This is a rational function to approximate a tanh-like soft clipper.
-       It is based on the pade-approximation of the tanh function with tweaked coefficients.
-       See: http://www.musicdsp.org/showone.php?id=238
-    */
-    if (x < -3.0f)
-      return -1.0f;
-    else if (x >  3.0f)
-      return 1.0f;
-    float y = x * x;
-    return x * (27.0f + y) / (27.0f + 9.0f * y);
+//-----------------------------------------------------------------------------
+// NEON
+//-----------------------------------------------------------------------------
+
+#if defined(HAS_AE_NEON)
+inline float HMaxNEON(float32x4_t v)
+{
+#if defined(__aarch64__)
+  return vmaxvq_f32(v);
 #else
-    /* slower method using tanh, but more accurate */
-
-    static const double k = 0.9f;
-    /* perform a soft clamp */
-    if (x >  k)
-      x = (float) (tanh((x - k) / (1 - k)) * (1 - k) + k);
-    else if (x < -k)
-      x = (float) (tanh((x + k) / (1 - k)) * (1 - k) - k);
-
-    /* hard clamp anything still outside the bounds */
-    if (x >  1.0f)
-      return  1.0f;
-    if (x < -1.0f)
-      return -1.0f;
-
-    /* return the final sample */
-    return x;
+  float32x2_t m = vmax_f32(vget_low_f32(v), vget_high_f32(v));
+  return vget_lane_f32(vpmax_f32(m, m), 0);
 #endif
 }
 
-void CAEUtil::ClampArray(float *data, uint32_t count)
+void MulArrayNEON(float *data, float mul, uint32_t count)
 {
-#if !defined(HAVE_SSE) || !defined(__SSE__)
-  for (uint32_t i = 0; i < count; ++i)
-    data[i] = SoftClamp(data[i]);
+  const float32x4_t m = vdupq_n_f32(mul);
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+    vst1q_f32(data + i, vmulq_f32(vld1q_f32(data + i), m));
+  MulArrayC(data + i, mul, count - i);
+}
 
-#else
-  const __m128 c1 = _mm_set_ps1(27.0f);
-  const __m128 c2 = _mm_set_ps1(27.0f + 9.0f);
+float MulAddArrayNEON(float *data, const float *add, float mul, uint32_t count)
+{
+  const float32x4_t m = vdupq_n_f32(mul);
+  float32x4_t peak = vdupq_n_f32(0.0f);
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    float32x4_t v = vaddq_f32(vld1q_f32(data + i), vmulq_f32(vld1q_f32(add + i), m));
+    vst1q_f32(data + i, v);
+    peak = vmaxq_f32(peak, vabsq_f32(v));
+  }
+  return std::max(HMaxNEON(peak), MulAddArrayC(data + i, add + i, mul, count - i));
+}
 
-  /* work around invalid alignment */
-  while (((uintptr_t)data & 0xF) && count > 0)
+void MulFramesNEON(float *data, const float *gains, uint32_t channels, uint32_t frames)
+{
+  uint32_t f = 0;
+  if (channels == 1)
+  {
+    for (; f + 4 <= frames; f += 4)
+      vst1q_f32(data + f, vmulq_f32(vld1q_f32(data + f), vld1q_f32(gains + f)));
+  }
+  else if (channels == 2)
+  {
+    for (; f + 4 <= frames; f += 4)
+    {
+      float32x4_t g = vld1q_f32(gains + f);
+      float32x4x2_t gg = vzipq_f32(g, g);
+      float *d = data + f * 2;
+      vst1q_f32(d, vmulq_f32(vld1q_f32(d), gg.val[0]));
+      vst1q_f32(d + 4, vmulq_f32(vld1q_f32(d + 4), gg.val[1]));
+    }
+  }
+  else if (channels >= 4)
   {
-    data[0] = SoftClamp(data[0]);
-    ++data;
-    --count;
+    for (; f < frames; ++f)
+      MulArrayNEON(data + f * channels, gains[f], channels);
   }
+  MulFramesC(data + f * channels, gains + f, channels, frames - f);
+}
 
-  uint32_t even = count & ~0x3;
-  for (uint32_t i = 0; i < even; i+=4, data+=4)
+float MulAddFramesNEON(float *dst, const float *src, const float *gains, uint32_t channels, uint32_t frames)
+{
+  float32x4_t peak = vdupq_n_f32(0.0f);
+  float framePeak = 0.0f;
+  uint32_t f = 0;
+  if (channels == 1)
   {
-    /* tanh approx clamp */
-    __m128 dt = _mm_load_ps(data);
-    __m128 tmp     = _mm_mul_ps(dt, dt);
-    *(__m128*)data = _mm_div_ps(
-      _mm_mul_ps(
-        dt,
-        _mm_add_ps(c1, tmp)
-      ),
-      _mm_add_ps(c2, tmp)
-    );
+    for (; f + 4 <= frames; f += 4)
+    {
+      float32x4_t v = vaddq_f32(vld1q_f32(dst + f), vmulq_f32(vld1q_f32(src + f), vld1q_f32(gains + f)));
+      vst1q_f32(dst + f, v);
+      peak = vmaxq_f32(peak, vabsq_f32(v));
+    }
   }
+  else if (channels == 2)
+  {
+    for (; f + 4 <= frames; f += 4)
+    {
+      float32x4_t g = vld1q_f32(gains + f);
+      float32x4x2_t gg = vzipq_f32(g, g);
+      float *d = dst + f * 2;
+      const float *s = src + f * 2;
+      float32x4_t lo = vaddq_f32(vld1q_f32(d), vmulq_f32(vld1q_f32(s), gg.val[0]));
+      float32x4_t hi = vaddq_f32(vld1q_f32(d + 4), vmulq_f32(vld1q_f32(s + 4), gg.val[1]));
+      vst1q_f32(d, lo);
+      vst1q_f32(d + 4, hi);
+      peak = vmaxq_f32(peak, vmaxq_f32(vabsq_f32(lo), vabsq_f32(hi)));
+    }
+  }
+  else if (channels >= 4)
+  {
+    for (; f < frames; ++f)
+      framePeak = std::max(framePeak, MulAddArrayNEON(dst + f * channels, src + f * channels, gains[f], channels));
+  }
+  float tail = MulAddFramesC(dst + f * channels, src + f * channels, gains + f, channels, frames - f);
+  return std::max(std::max(HMaxNEON(peak), framePeak), tail);
+}
 
-  if (even != count)
+void FramePeaksNEON(const float *data, float *peaks, uint32_t channels, uint32_t frames)
+{
+  uint32_t f = 0;
+  if (channels == 1)
   {
-    uint32_t odd = count - even;
-    if (odd == 1)
-      data[0] = SoftClamp(data[0]);
-    else
+    for (; f + 4 <= frames; f += 4)
+      vst1q_f32(peaks + f, vmaxq_f32(vld1q_f32(peaks + f), vabsq_f32(vld1q_f32(data + f))));
+  }
+  else if (channels == 2)
+  {
+    for (; f + 4 <= frames; f += 4)
     {
-      __m128 dt;
-      __m128 tmp;
-      __m128 out;
-      if (odd == 2)
-      {
-        /* tanh approx clamp */
-        dt  = _mm_setr_ps(data[0], data[1], 0, 0);
-        tmp = _mm_mul_ps(dt, dt);
-        out = _mm_div_ps(
-          _mm_mul_ps(
-            dt,
-            _mm_add_ps(c1, tmp)
-          ),
-          _mm_add_ps(c2, tmp)
-        );
-
-        data[0] = ((float*)&out)[0];
-        data[1] = ((float*)&out)[1];
-      }
-      else
-      {
-        /* tanh approx clamp */
-        dt  = _mm_setr_ps(data[0], data[1], data[2], 0);
-        tmp = _mm_mul_ps(dt, dt);
-        out = _mm_div_ps(
-          _mm_mul_ps(
-            dt,
-            _mm_add_ps(c1, tmp)
-          ),
-          _mm_add_ps(c2, tmp)
-        );
-
-        data[0] = ((float*)&out)[0];
-        data[1] = ((float*)&out)[1];
-        data[2] = ((float*)&out)[2];
-      }
+      // de-interleaving load puts left and right samples in separate registers
+      float32x4x2_t lr = vld2q_f32(data + f * 2);
+      float32x4_t peak = vmaxq_f32(vabsq_f32(lr.val[0]), vabsq_f32(lr.val[1]));
+      vst1q_f32(peaks + f, vmaxq_f32(vld1q_f32(peaks + f), peak));
+    }
+  }
+  else if (channels >= 4)
+  {
+    for (; f < frames; ++f)
+    {
+      const float *d = data + f * channels;
+      float32x4_t peak = vabsq_f32(vld1q_f32(d));
+      uint32_t c = 4;
+      for (; c + 4 <= channels; c += 4)
+        peak = vmaxq_f32(peak, vabsq_f32(vld1q_f32(d + c)));
+      float p = std::max(peaks[f], HMaxNEON(peak));
+      for (; c < channels; ++c)
+        p = std::max(p, fabsf(d[c]));
+      peaks[f] = p;
     }
   }
+  FramePeaksC(data + f * channels, peaks + f, channels, frames - f);
+}
+
+#if defined(__aarch64__)
+// division and rounding conversions are only available on ARMv8
+void ClampArrayNEON(float *data, uint32_t count)
+{
+  const float32x4_t lo = vdupq_n_f32(-3.0f);
+  const float32x4_t hi = vdupq_n_f32(3.0f);
+  const float32x4_t c27 = vdupq_n_f32(27.0f);
+  const float32x4_t c9 = vdupq_n_f32(9.0f);
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+  {
+    float32x4_t x = vminq_f32(vmaxq_f32(vld1q_f32(data + i), lo), hi);
+    float32x4_t y = vmulq_f32(x, x);
+    float32x4_t num = vmulq_f32(x, vaddq_f32(c27, y));
+    float32x4_t den = vaddq_f32(vmulq_f32(c9, y), c27);
+    vst1q_f32(data + i, vdivq_f32(num, den));
+  }
+  ClampArrayC(data + i, count - i);
+}
+
+void FloatToS16NEON(const float *src, int16_t *dst, uint32_t count)
+{
+  const float32x4_t scale = vdupq_n_f32(S16_SCALE);
+  const float32x4_t lo = vdupq_n_f32(-32768.0f);
+  const float32x4_t hi = vdupq_n_f32(32767.0f);
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    float32x4_t a = vminq_f32(vmaxq_f32(vmulq_f32(vld1q_f32(src + i), scale), lo), hi);
+    float32x4_t b = vminq_f32(vmaxq_f32(vmulq_f32(vld1q_f32(src + i + 4), scale), lo), hi);
+    vst1q_s16(dst + i, vcombine_s16(vqmovn_s32(vcvtnq_s32_f32(a)), vqmovn_s32(vcvtnq_s32_f32(b))));
+  }
+  FloatToS16C(src + i, dst + i, count - i);
+}
+
+void FloatToS32NEON(const float *src, int32_t *dst, uint32_t count)
+{
+  const float32x4_t scale = vdupq_n_f32(S32_SCALE);
+  uint32_t i = 0;
+  // the conversion saturates, just like FloatToS32C
+  for (; i + 4 <= count; i += 4)
+    vst1q_s32(dst + i, vcvtnq_s32_f32(vmulq_f32(vld1q_f32(src + i), scale)));
+  FloatToS32C(src + i, dst + i, count - i);
+}
+#else
+#define ClampArrayNEON ClampArrayC
+#define FloatToS16NEON FloatToS16C
+#define FloatToS32NEON FloatToS32C
+#endif
+
+void S16ToFloatNEON(const int16_t *src, float *dst, uint32_t count)
+{
+  const float32x4_t scale = vdupq_n_f32(1.0f / S16_SCALE);
+  uint32_t i = 0;
+  for (; i + 8 <= count; i += 8)
+  {
+    int16x8_t v = vld1q_s16(src + i);
+    vst1q_f32(dst + i, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(v))), scale));
+    vst1q_f32(dst + i + 4, vmulq_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(v))), scale));
+  }
+  S16ToFloatC(src + i, dst + i, count - i);
+}
+
+void S32ToFloatNEON(const int32_t *src, float *dst, uint32_t count)
+{
+  const float32x4_t scale = vdupq_n_f32(1.0f / S32_SCALE);
+  uint32_t i = 0;
+  for (; i + 4 <= count; i += 4)
+    vst1q_f32(dst + i, vmulq_f32(vcvtq_f32_s32(vld1q_s32(src + i)), scale));
+  S32ToFloatC(src + i, dst + i, count - i);
+}
+
+const AEKernels kernelsNEON =
+{
+  MulArrayNEON, MulAddArrayNEON, MulFramesNEON, MulAddFramesNEON, FramePeaksNEON, ClampArrayNEON,
+  FloatToS16NEON, FloatToS32NEON, S16ToFloatNEON, S32ToFloatNEON
+};
+#endif
+
+const AEKernels* GetKernels(CAEUtil::SIMDLevel level)
+{
+  switch (level)
+  {
+    case CAEUtil::SIMD_NONE:
+      return &kernelsC;
+#if defined(HAVE_SSE2) && defined(__SSE2__)
+    case CAEUtil::SIMD_SSE2:
+      return &kernelsSSE2;
 #endif
+#if defined(HAS_AE_AVX2)
+    case CAEUtil::SIMD_AVX2:
+      return &kernelsAVX2;
+#endif
+#if defined(HAS_AE_NEON)
+    case CAEUtil::SIMD_NEON:
+      return &kernelsNEON;
+#endif
+    default:
+      return nullptr;
+  }
+}
+
+std::atomic<int> simdLevel(-1);
+
+inline const AEKernels& Kernels()
+{
+  int level = simdLevel.load(std::memory_order_relaxed);
+  if (level < 0)
+    level = CAEUtil::GetSIMDLevel();
+  return *GetKernels(static_cast<CAEUtil::SIMDLevel>(level));
+}
+
+} // unnamed namespace
+
+bool CAEUtil::IsSIMDLevelSupported(SIMDLevel level)
+{
+  if (!GetKernels(level))
+    return false;
+
+  unsigned int features = g_cpuInfo.GetCPUFeatures();
+  switch (level)
+  {
+    case SIMD_SSE2:
+      return (features & CPU_FEATURE_SSE2) != 0;
+    case SIMD_AVX2:
+      return (features & CPU_FEATURE_AVX2) != 0;
+    case SIMD_NEON:
+      return (features & CPU_FEATURE_NEON) != 0;
+    default:
+      return true;
+  }
+}
+
+CAEUtil::SIMDLevel CAEUtil::GetSIMDLevel()
+{
+  int level = simdLevel.load(std::memory_order_relaxed);
+  if (level >= 0)
+    return static_cast<SIMDLevel>(level);
+
+  SIMDLevel detected = SIMD_NONE;
+  for (SIMDLevel candidate : { SIMD_AVX2, SIMD_NEON, SIMD_SSE2 })
+  {
+    if (IsSIMDLevelSupported(candidate))
+    {
+      detected = candidate;
+      break;
+    }
+  }
+
+  CLog::Log(LOGDEBUG, "CAEUtil::GetSIMDLevel - using %s sample processing kernels", SIMDLevelToStr(detected));
+  simdLevel = detected;
+  return detected;
+}
+
+bool CAEUtil::SetSIMDLevel(SIMDLevel level)
+{
+  if (!IsSIMDLevelSupported(level))
+    return false;
+
+  simdLevel = level;
+  return true;
+}
+
+const char* CAEUtil::SIMDLevelToStr(SIMDLevel level)
+{
+  switch (level)
+  {
+    case SIMD_NONE:
+      return "C++";
+    case SIMD_SSE2:
+      return "SSE2";
+    case SIMD_AVX2:
+      return "AVX2";
+    case SIMD_NEON:
+      return "NEON";
+    default:
+      return "UNKNOWN";
+  }
+}
+
+void CAEUtil::MulArray(float *data, const float mul, uint32_t count)
+{
+  Kernels().mulArray(data, mul, count);
+}
+
+float CAEUtil::MulAddArray(float *data, const float *add, const float mul, uint32_t count)
+{
+  return Kernels().mulAddArray(data, add, mul, count);
+}
+
+void CAEUtil::MulFrames(float *data, const float *gains, uint32_t channels, uint32_t frames)
+{
+  Kernels().mulFrames(data, gains, channels, frames);
+}
+
+float CAEUtil::MulAddFrames(float *dst, const float *src, const float *gains, uint32_t channels, uint32_t frames)
+{
+  return Kernels().mulAddFrames(dst, src, gains, channels, frames);
+}
+
+void CAEUtil::FramePeaks(const float *data, float *peaks, uint32_t channels, uint32_t frames)
+{
+  Kernels().framePeaks(data, peaks, channels, frames);
+}
+
+void CAEUtil::ClampArray(float *data, uint32_t count)
+{
+  Kernels().clampArray(data, count);
+}
+
+void CAEUtil::FloatToS16(const float *src, int16_t *dst, uint32_t count)
+{
+  Kernels().floatToS16(src, dst, count);
+}
+
+void CAEUtil::FloatToS32(const float *src, int32_t *dst, uint32_t count)
+{
+  Kernels().floatToS32(src, dst, count);
+}
+
+void CAEUtil::S16ToFloat(const int16_t *src, float *dst, uint32_t count)
+{
+  Kernels().s16ToFloat(src, dst, count);
+}
+
+void CAEUtil::S32ToFloat(const int32_t *src, float *dst, uint32_t count)
+{
+  Kernels().s32ToFloat(src, dst, count);
 }
 
 bool CAEUtil::S16NeedsByteSwap(AEDataFormat in, AEDataFormat out)
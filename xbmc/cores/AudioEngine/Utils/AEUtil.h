@@ -111,8 +111,6 @@ private:
     static __m128i m_sseSeed;
   #endif
 
-  static float SoftClamp(const float x);
-
 public:
   static CAEChannelInfo          GuessChLayout     (const unsigned int channels);
   static const char*             GetStdChLayoutName(const enum AEStdChLayout layout);
@@ -180,12 +178,66 @@ public:
     return 20*log10(scale);
   }
 
-  #if defined(HAVE_SSE) && defined(__SSE__)
-  static void SSEMulArray     (float *data, const float mul, uint32_t count);
-  static void SSEMulAddArray  (float *data, float *add, const float mul, uint32_t count);
-  #endif
+  /*! \brief instruction sets available for the sample processing kernels
+   All kernels produce bit identical results, whatever the instruction set.
+   \sa SetSIMDLevel
+   */
+  enum SIMDLevel
+  {
+    SIMD_NONE = 0,
+    SIMD_SSE2,
+    SIMD_AVX2,
+    SIMD_NEON,
+    SIMD_MAX
+  };
+
+  /*! \brief get the instruction set used by the sample processing kernels
+   Detected from the CPU features on first use.
+   */
+  static SIMDLevel GetSIMDLevel();
+
+  /*! \brief force the instruction set used by the sample processing kernels
+   \param level the instruction set, SIMD_NONE for the plain C++ kernels
+   \return false if the instruction set is not supported by the build or the CPU
+   */
+  static bool SetSIMDLevel(SIMDLevel level);
+  static bool IsSIMDLevelSupported(SIMDLevel level);
+  static const char* SIMDLevelToStr(SIMDLevel level);
+
+  /*! \brief data[i] *= mul */
+  static void MulArray(float *data, const float mul, uint32_t count);
+
+  /*! \brief data[i] += add[i] * mul
+   \return the peak magnitude of data after mixing
+   */
+  static float MulAddArray(float *data, const float *add, const float mul, uint32_t count);
+
+  /*! \brief apply a gain per frame of interleaved samples
+   data[f * channels + c] *= gains[f]
+   */
+  static void MulFrames(float *data, const float *gains, uint32_t channels, uint32_t frames);
+
+  /*! \brief mix interleaved samples with a gain per frame
+   dst[f * channels + c] += src[f * channels + c] * gains[f]
+   \return the peak magnitude of dst after mixing
+   */
+  static float MulAddFrames(float *dst, const float *src, const float *gains, uint32_t channels, uint32_t frames);
+
+  /*! \brief accumulate the peak magnitude of each frame of interleaved samples
+   peaks[f] = max(peaks[f], |data[f * channels + c]|) for all channels c
+   */
+  static void FramePeaks(const float *data, float *peaks, uint32_t channels, uint32_t frames);
+
   static void ClampArray(float *data, uint32_t count);
 
+  /*! \brief convert between float and native endian integer samples
+   Rounding and clipping match the conversions of swresample.
+   */
+  static void FloatToS16(const float *src, int16_t *dst, uint32_t count);
+  static void FloatToS32(const float *src, int32_t *dst, uint32_t count);
+  static void S16ToFloat(const int16_t *src, float *dst, uint32_t count);
+  static void S32ToFloat(const int32_t *src, float *dst, uint32_t count);
+
   static bool S16NeedsByteSwap(AEDataFormat in, AEDataFormat out);
 
   static uint64_t GetAVChannelLayout(const CAEChannelInfo &info);
@@ -0,0 +1,254 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/AudioEngine/Utils/AELimiter.h"
+#include "cores/AudioEngine/Utils/AEUtil.h"
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace
+{
+const uint32_t COUNTS[] = { 0, 1, 3, 4, 7, 8, 15, 16, 17, 31, 1021 };
+const uint32_t CHANNELS[] = { 1, 2, 3, 6, 8, 10 };
+
+std::vector<float> MakeSamples(uint32_t count, float range, unsigned int seed)
+{
+  std::mt19937 rng(seed);
+  std::uniform_real_distribution<float> dist(-range, range);
+  std::vector<float> samples(count);
+  for (auto& sample : samples)
+    sample = dist(rng);
+
+  // edges of the clamping and conversion ranges
+  const float edges[] = { 0.0f, -0.0f, 1.0f, -1.0f, 3.0f, -3.0f, 3.5f, -4.0f, 0.99999f, 1.00001f, 100.0f };
+  for (uint32_t i = 0; i < count && i < sizeof(edges) / sizeof(edges[0]); i++)
+    samples[count - 1 - i] = edges[i];
+  return samples;
+}
+
+template<typename T>
+bool BitExact(const std::vector<T>& lhs, const std::vector<T>& rhs)
+{
+  return lhs.size() == rhs.size() && memcmp(lhs.data(), rhs.data(), lhs.size() * sizeof(T)) == 0;
+}
+
+std::vector<CAEUtil::SIMDLevel> SupportedLevels()
+{
+  std::vector<CAEUtil::SIMDLevel> levels;
+  for (int level = CAEUtil::SIMD_SSE2; level < CAEUtil::SIMD_MAX; level++)
+  {
+    if (CAEUtil::IsSIMDLevelSupported(static_cast<CAEUtil::SIMDLevel>(level)))
+      levels.push_back(static_cast<CAEUtil::SIMDLevel>(level));
+  }
+  return levels;
+}
+}
+
+class TestAEUtil : public testing::Test
+{
+protected:
+  TestAEUtil() : m_level(CAEUtil::GetSIMDLevel()) {}
+  ~TestAEUtil() override { CAEUtil::SetSIMDLevel(m_level); }
+
+  CAEUtil::SIMDLevel m_level;
+};
+
+TEST_F(TestAEUtil, SIMDLevel)
+{
+  EXPECT_TRUE(CAEUtil::IsSIMDLevelSupported(CAEUtil::SIMD_NONE));
+  EXPECT_TRUE(CAEUtil::IsSIMDLevelSupported(m_level));
+  EXPECT_FALSE(CAEUtil::SetSIMDLevel(CAEUtil::SIMD_MAX));
+  EXPECT_TRUE(CAEUtil::SetSIMDLevel(CAEUtil::SIMD_NONE));
+  EXPECT_EQ(CAEUtil::SIMD_NONE, CAEUtil::GetSIMDLevel());
+}
+
+TEST_F(TestAEUtil, ArrayKernelsBitExact)
+{
+  for (auto level : SupportedLevels())
+  {
+    for (uint32_t count : COUNTS)
+    {
+      SCOPED_TRACE(std::string(CAEUtil::SIMDLevelToStr(level)) + " count " + std::to_string(count));
+      const std::vector<float> data = MakeSamples(count, 2.0f, count);
+      const std::vector<float> add = MakeSamples(count, 1.0f, count + 1);
+
+      std::vector<float> mulRef(data), mul(data);
+      std::vector<float> mixRef(data), mix(data);
+      std::vector<float> clampRef(data), clamp(data);
+
+      CAEUtil::SetSIMDLevel(CAEUtil::SIMD_NONE);
+      CAEUtil::MulArray(mulRef.data(), 0.7f, count);
+      float peakRef = CAEUtil::MulAddArray(mixRef.data(), add.data(), 0.3f, count);
+      CAEUtil::ClampArray(clampRef.data(), count);
+
+      ASSERT_TRUE(CAEUtil::SetSIMDLevel(level));
+      CAEUtil::MulArray(mul.data(), 0.7f, count);
+      float peak = CAEUtil::MulAddArray(mix.data(), add.data(), 0.3f, count);
+      CAEUtil::ClampArray(clamp.data(), count);
+
+      EXPECT_TRUE(BitExact(mulRef, mul));
+      EXPECT_TRUE(BitExact(mixRef, mix));
+      EXPECT_EQ(peakRef, peak);
+      EXPECT_TRUE(BitExact(clampRef, clamp));
+    }
+  }
+}
+
+TEST_F(TestAEUtil, FrameKernelsBitExact)
+{
+  for (auto level : SupportedLevels())
+  {
+    for (uint32_t channels : CHANNELS)
+    {
+      for (uint32_t frames : COUNTS)
+      {
+        SCOPED_TRACE(std::string(CAEUtil::SIMDLevelToStr(level)) + " channels " +
+                     std::to_string(channels) + " frames " + std::to_string(frames));
+        const uint32_t count = channels * frames;
+        const std::vector<float> data = MakeSamples(count, 1.5f, count);
+        const std::vector<float> src = MakeSamples(count, 1.0f, count + 1);
+        const std::vector<float> gains = MakeSamples(frames, 1.0f, frames + 2);
+
+        std::vector<float> mulRef(data), mul(data);
+        std::vector<float> mixRef(data), mix(data);
+        std::vector<float> peaksRef(gains), peaks(gains);
+        for (auto& peak : peaksRef)
+          peak = fabsf(peak);
+        peaks = peaksRef;
+
+        CAEUtil::SetSIMDLevel(CAEUtil::SIMD_NONE);
+        CAEUtil::MulFrames(mulRef.data(), gains.data(), channels, frames);
+        float peakRef = CAEUtil::MulAddFrames(mixRef.data(), src.data(), gains.data(), channels, frames);
+        CAEUtil::FramePeaks(data.data(), peaksRef.data(), channels, frames);
+
+        ASSERT_TRUE(CAEUtil::SetSIMDLevel(level));
+        CAEUtil::MulFrames(mul.data(), gains.data(), channels, frames);
+        float peak = CAEUtil::MulAddFrames(mix.data(), src.data(), gains.data(), channels, frames);
+        CAEUtil::FramePeaks(data.data(), peaks.data(), channels, frames);
+
+        EXPECT_TRUE(BitExact(mulRef, mul));
+        EXPECT_TRUE(BitExact(mixRef, mix));
+        EXPECT_EQ(peakRef, peak);
+        EXPECT_TRUE(BitExact(peaksRef, peaks));
+      }
+    }
+  }
+}
+
+TEST_F(TestAEUtil, ConversionReference)
+{
+  CAEUtil::SetSIMDLevel(CAEUtil::SIMD_NONE);
+
+  const std::vector<float> in = { 0.0f, 0.5f, -0.5f, 1.0f, -1.0f, 2.0f, -2.0f, 1.5f / 32768.0f, 2.5f / 32768.0f };
+  std::vector<int16_t> s16(in.size());
+  std::vector<int32_t> s32(in.size());
+  CAEUtil::FloatToS16(in.data(), s16.data(), in.size());
+  CAEUtil::FloatToS32(in.data(), s32.data(), in.size());
+
+  const std::vector<int16_t> s16Expected = { 0, 16384, -16384, 32767, -32768, 32767, -32768, 2, 2 };
+  const std::vector<int32_t> s32Expected = { 0, 1 << 30, -(1 << 30), INT32_MAX, INT32_MIN, INT32_MAX, INT32_MIN, 98304, 163840 };
+  EXPECT_EQ(s16Expected, s16);
+  EXPECT_EQ(s32Expected, s32);
+
+  std::vector<float> out(in.size());
+  CAEUtil::S16ToFloat(s16.data(), out.data(), s16.size());
+  EXPECT_EQ(0.5f, out[1]);
+  EXPECT_EQ(-1.0f, out[4]);
+  CAEUtil::S32ToFloat(s32.data(), out.data(), s32.size());
+  EXPECT_EQ(-0.5f, out[2]);
+  EXPECT_EQ(1.0f, out[3]);
+}
+
+TEST_F(TestAEUtil, ConversionKernelsBitExact)
+{
+  for (auto level : SupportedLevels())
+  {
+    for (uint32_t count : COUNTS)
+    {
+      SCOPED_TRACE(std::string(CAEUtil::SIMDLevelToStr(level)) + " count " + std::to_string(count));
+      const std::vector<float> data = MakeSamples(count, 1.2f, count);
+
+      std::vector<int16_t> s16Ref(count), s16(count);
+      std::vector<int32_t> s32Ref(count), s32(count);
+      std::vector<float> f16Ref(count), f16(count);
+      std::vector<float> f32Ref(count), f32(count);
+
+      CAEUtil::SetSIMDLevel(CAEUtil::SIMD_NONE);
+      CAEUtil::FloatToS16(data.data(), s16Ref.data(), count);
+      CAEUtil::FloatToS32(data.data(), s32Ref.data(), count);
+      CAEUtil::S16ToFloat(s16Ref.data(), f16Ref.data(), count);
+      CAEUtil::S32ToFloat(s32Ref.data(), f32Ref.data(), count);
+
+      ASSERT_TRUE(CAEUtil::SetSIMDLevel(level));
+      CAEUtil::FloatToS16(data.data(), s16.data(), count);
+      CAEUtil::FloatToS32(data.data(), s32.data(), count);
+      CAEUtil::S16ToFloat(s16Ref.data(), f16.data(), count);
+      CAEUtil::S32ToFloat(s32Ref.data(), f32.data(), count);
+
+      EXPECT_TRUE(BitExact(s16Ref, s16));
+      EXPECT_TRUE(BitExact(s32Ref, s32));
+      EXPECT_TRUE(BitExact(f16Ref, f16));
+      EXPECT_TRUE(BitExact(f32Ref, f32));
+    }
+  }
+}
+
+TEST_F(TestAEUtil, LimiterBlock)
+{
+  const int channels = 6;
+  const int frames = 1024;
+  std::vector<float> data = MakeSamples(channels * frames, 1.0f, 42);
+  float* planes[AE_CH_MAX] = { data.data() };
+
+  CAELimiter perFrame;
+  CAELimiter block;
+  perFrame.SetAmplification(2.0f);
+  block.SetAmplification(2.0f);
+
+  std::vector<float> gains(frames, 0.5f);
+  block.Run(planes, channels, frames, false, gains.data());
+
+  for (int i = 0; i < frames; i++)
+    EXPECT_EQ(0.5f * perFrame.Run(planes, channels, i * channels, false), gains[i]) << "frame " << i;
+}
+
+// Throughput of each SIMD level, run with --gtest_also_run_disabled_tests
+TEST_F(TestAEUtil, DISABLED_Benchmark)
+{
+  const uint32_t channels = 8;
+  const uint32_t frames = 1024;
+  const int iterations = 2000;
+  std::vector<float> dst = MakeSamples(channels * frames, 0.5f, 1);
+  const std::vector<float> src = MakeSamples(channels * frames, 0.5f, 2);
+  const std::vector<float> gains(frames, 0.999f);
+  std::vector<int16_t> s16(channels * frames);
+
+  std::vector<CAEUtil::SIMDLevel> levels = SupportedLevels();
+  levels.insert(levels.begin(), CAEUtil::SIMD_NONE);
+  for (auto level : levels)
+  {
+    CAEUtil::SetSIMDLevel(level);
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+    {
+      CAEUtil::MulAddFrames(dst.data(), src.data(), gains.data(), channels, frames);
+      CAEUtil::MulFrames(dst.data(), gains.data(), channels, frames);
+      CAEUtil::FloatToS16(dst.data(), s16.data(), channels * frames);
+    }
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double rate = elapsed > 0 ? iterations * frames / elapsed / 1000000 : 0;
+    std::cout << "7.1 mix, gain and S16 conversion " << CAEUtil::SIMDLevelToStr(level) << ": "
+              << rate << " Mframes/s" << std::endl;
+  }
+}
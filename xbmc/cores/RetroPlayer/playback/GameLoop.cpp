@@ -8,7 +8,10 @@
 
 #include "GameLoop.h"
 #include "threads/SystemClock.h"
+#include "utils/log.h"
+#include "utils/TimeUtils.h"
 
+#include <algorithm>
 #include <cmath>
 
 using namespace KODI;
@@ -67,11 +70,15 @@ void CGameLoop::Process(void)
     }
     else
     {
+      const int64_t frameStart = CurrentHostCounter();
+
       if (m_speedFactor > 0.0)
         m_callback->FrameEvent();
       else if (m_speedFactor < 0.0)
         m_callback->RewindEvent();
 
+      UpdateFrameStats(CurrentHostCounter() - frameStart);
+
       if (m_lastFrameMs > 0.0)
       {
         m_lastFrameMs += FrameTimeMs();
@@ -99,6 +106,8 @@ void CGameLoop::Process(void)
       }
     }
   }
+
+  LogFrameStats();
 }
 
 double CGameLoop::FrameTimeMs() const
@@ -130,3 +139,26 @@ double CGameLoop::NowMs() const
 {
   return static_cast<double>(XbmcThreads::SystemClockMillis());
 }
+
+void CGameLoop::UpdateFrameStats(int64_t frameTicks)
+{
+  m_frameCount++;
+  m_totalFrameTicks += frameTicks;
+  m_maxFrameTicks = std::max(m_maxFrameTicks, frameTicks);
+
+  if (1000.0 * frameTicks / CurrentHostFrequency() > FrameTimeMs())
+    m_lateFrameCount++;
+}
+
+void CGameLoop::LogFrameStats()
+{
+  if (m_frameCount == 0)
+    return;
+
+  const double msPerTick = 1000.0 / CurrentHostFrequency();
+
+  CLog::Log(LOGDEBUG, "GameLoop: Ran %llu frames, average %.3f ms, max %.3f ms, %llu frames late",
+            static_cast<unsigned long long>(m_frameCount),
+            m_totalFrameTicks * msPerTick / m_frameCount, m_maxFrameTicks * msPerTick,
+            static_cast<unsigned long long>(m_lateFrameCount));
+}
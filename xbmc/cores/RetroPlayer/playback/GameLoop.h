@@ -9,6 +9,7 @@
 #pragma once
 
 #include <atomic>
+#include <stdint.h>
 
 #include "threads/Event.h"
 #include "threads/Thread.h"
@@ -57,6 +58,8 @@ namespace RETRO
     double FrameTimeMs() const;
     double SleepTimeMs() const;
     double NowMs() const;
+    void UpdateFrameStats(int64_t frameTicks);
+    void LogFrameStats();
 
     IGameLoopCallback* const m_callback;
     const double             m_fps;
@@ -64,6 +67,12 @@ namespace RETRO
     double                   m_lastFrameMs;
     mutable double           m_adjustTime;
     CEvent                   m_sleepEvent;
+
+    // Frame time stats, only accessed by the game loop thread
+    uint64_t                 m_frameCount = 0;
+    uint64_t                 m_lateFrameCount = 0; // Frames that took longer than their frame time
+    int64_t                  m_totalFrameTicks = 0;
+    int64_t                  m_maxFrameTicks = 0;
   };
 }
 }
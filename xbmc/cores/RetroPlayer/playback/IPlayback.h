@@ -37,7 +37,7 @@ namespace RETRO
     virtual void PauseAsync() = 0; // Pauses after the following frame
 
     // Savestates
-    virtual std::string CreateSavestate() = 0; // Returns the path of savestate on success
+    virtual std::string CreateSavestate() = 0; // Returns the path of savestate on success, may be written asynchronously
     virtual bool LoadSavestate(const std::string& path) = 0;
   };
 }
@@ -9,14 +9,17 @@
 #include "ReversiblePlayback.h"
 #include "cores/RetroPlayer/savestates/ISavestate.h"
 #include "cores/RetroPlayer/savestates/SavestateDatabase.h"
-#include "cores/RetroPlayer/streams/memory/DeltaPairMemoryStream.h"
+#include "cores/RetroPlayer/streams/memory/CompressedDeltaMemoryStream.h"
 #include "games/addons/GameClient.h"
 #include "games/GameServices.h"
 #include "games/GameSettings.h"
 #include "threads/SingleLock.h"
+#include "utils/log.h"
 #include "utils/MathUtils.h"
+#include "utils/TimeUtils.h"
 #include "utils/URIUtils.h"
 #include "ServiceBroker.h"
+#include "URL.h"
 
 #include <algorithm>
 
@@ -24,6 +27,8 @@ using namespace KODI;
 using namespace RETRO;
 
 #define REWIND_FACTOR  0.25  // Rewind at 25% of gameplay speed
+#define SNAPSHOT_TIMEOUT_MS  1000 // Time to wait for the game loop to take a snapshot
+#define MAX_SNAPSHOT_BUFFERS  2  // Savestate snapshots kept for reuse
 
 CReversiblePlayback::CReversiblePlayback(GAME::CGameClient* gameClient, double fps, size_t serializeSize) :
   m_gameClient(gameClient),
@@ -58,6 +63,8 @@ void CReversiblePlayback::Initialize()
 void CReversiblePlayback::Deinitialize()
 {
   m_gameLoop.Stop();
+
+  m_savestateWriter.Wait();
 }
 
 void CReversiblePlayback::SeekTimeMs(unsigned int timeMs)
@@ -121,45 +128,74 @@ std::string CReversiblePlayback::CreateSavestate()
 
   const CDateTime now = CDateTime::GetCurrentDateTime();
   const std::string label = now.GetAsLocalizedDateTime();
-  const std::string gameFileName = URIUtils::GetFileName(m_gameClient->GetGamePath());
+  const std::string gamePath = m_gameClient->GetGamePath();
+  const std::string gameFileName = URIUtils::GetFileName(gamePath);
   const uint64_t timestampFrames = m_totalFrameCount;
   const double timestampWallClock = (m_totalFrameCount / m_gameClient->GetFrameRate()); //! @todo Accumulate playtime instead of deriving it
   const std::string gameClientId = m_gameClient->ID();
   const std::string gameClientVersion = m_gameClient->Version().asString();
 
-  std::unique_ptr<ISavestate> savestate = m_savestateDatabase->CreateSavestate();
-
-  savestate->SetType(SAVE_TYPE::AUTO);
-  savestate->SetLabel(label);
-  savestate->SetCreated(now);
-  savestate->SetGameFileName(gameFileName);
-  savestate->SetTimestampFrames(timestampFrames);
-  savestate->SetTimestampWallClock(timestampWallClock);
-  savestate->SetGameClientID(gameClientId);
-  savestate->SetGameClientVersion(gameClientVersion);
-
-  uint8_t *memoryData = savestate->GetMemoryBuffer(memorySize);
+  std::shared_ptr<SnapshotBuffer> buffer = std::make_shared<SnapshotBuffer>();
 
   {
-    CSingleLock lock(m_mutex);
-    if (m_memoryStream && m_memoryStream->CurrentFrame() != nullptr)
-    {
-      std::memcpy(memoryData, m_memoryStream->CurrentFrame(), memorySize);
-    }
-    else
+    CSingleLock lock(m_savestateMutex);
+
+    if (!m_snapshotBuffers.empty())
     {
-      lock.Leave();
-      if (!m_gameClient->Serialize(memoryData, memorySize))
-        return "";
+      *buffer = std::move(m_snapshotBuffers.back());
+      m_snapshotBuffers.pop_back();
     }
   }
 
-  savestate->Finalize();
+  buffer->resize(memorySize);
 
-  if (!m_savestateDatabase->AddSavestate(m_gameClient->GetGamePath(), *savestate))
+  // Only the copy of the game's memory holds up the game loop
+  const int64_t start = CurrentHostCounter();
+  if (!TakeSnapshot(*buffer))
+  {
+    ReleaseSnapshotBuffer(std::move(*buffer));
     return "";
+  }
+  CLog::Log(LOGDEBUG, "RetroPlayer[SAVE]: Took snapshot of %u bytes in %.3f ms",
+            static_cast<unsigned int>(memorySize),
+            1000.0 * (CurrentHostCounter() - start) / CurrentHostFrequency());
 
-  return m_gameClient->GetGamePath();
+  // Build the savestate and write it off the game loop
+  m_savestateWriter.Submit([this, gamePath, label, now, gameFileName, timestampFrames,
+                          timestampWallClock, gameClientId, gameClientVersion, buffer]()
+  {
+    const int64_t start = CurrentHostCounter();
+
+    std::unique_ptr<ISavestate> savestate = m_savestateDatabase->CreateSavestate();
+
+    savestate->SetType(SAVE_TYPE::AUTO);
+    savestate->SetLabel(label);
+    savestate->SetCreated(now);
+    savestate->SetGameFileName(gameFileName);
+    savestate->SetTimestampFrames(timestampFrames);
+    savestate->SetTimestampWallClock(timestampWallClock);
+    savestate->SetGameClientID(gameClientId);
+    savestate->SetGameClientVersion(gameClientVersion);
+
+    uint8_t *memoryData = savestate->GetMemoryBuffer(buffer->size());
+    std::memcpy(memoryData, buffer->data(), buffer->size());
+
+    savestate->Finalize();
+
+    if (m_savestateDatabase->AddSavestate(gamePath, *savestate))
+      CLog::Log(LOGDEBUG, "RetroPlayer[SAVE]: Wrote savestate for %s in %.3f ms",
+                CURL::GetRedacted(gamePath).c_str(),
+                1000.0 * (CurrentHostCounter() - start) / CurrentHostFrequency());
+    else
+      CLog::Log(LOGERROR, "RetroPlayer[SAVE]: Failed to write savestate for %s",
+                CURL::GetRedacted(gamePath).c_str());
+
+    ReleaseSnapshotBuffer(std::move(*buffer));
+  });
+
+  // The savestate path is derived from the game path, so it is known before
+  // the write finishes
+  return gamePath;
 }
 
 bool CReversiblePlayback::LoadSavestate(const std::string& path)
@@ -172,6 +208,9 @@ bool CReversiblePlayback::LoadSavestate(const std::string& path)
 
   bool bSuccess = false;
 
+  // Don't read a savestate that is still being written
+  m_savestateWriter.Wait();
+
   std::unique_ptr<ISavestate> savestate = m_savestateDatabase->CreateSavestate();
   if (m_savestateDatabase->GetSavestate(path, *savestate) && savestate->GetMemorySize() == memorySize)
   {
@@ -200,6 +239,8 @@ void CReversiblePlayback::FrameEvent()
   m_gameClient->RunFrame();
 
   AddFrame();
+
+  TakeRequestedSnapshot();
 }
 
 void CReversiblePlayback::RewindEvent()
@@ -207,6 +248,8 @@ void CReversiblePlayback::RewindEvent()
   RewindFrames(1);
 
   m_gameClient->RunFrame();
+
+  TakeRequestedSnapshot();
 }
 
 void CReversiblePlayback::AddFrame()
@@ -225,13 +268,56 @@ void CReversiblePlayback::AddFrame()
   m_totalFrameCount++;
 }
 
+void CReversiblePlayback::TakeRequestedSnapshot()
+{
+  m_snapshotHandoff.Serve([this](uint8_t* data, size_t size)
+  {
+    return m_gameClient->Serialize(data, size);
+  });
+}
+
+bool CReversiblePlayback::TakeSnapshot(SnapshotBuffer& buffer)
+{
+  {
+    CSingleLock lock(m_mutex);
+
+    // The rewind buffer already holds the current frame
+    if (m_memoryStream && m_memoryStream->CurrentFrame() != nullptr)
+    {
+      std::memcpy(buffer.data(), m_memoryStream->CurrentFrame(), buffer.size());
+      return true;
+    }
+  }
+
+  // Otherwise the game has to be serialized between two frames. If the game
+  // loop is running, let it do this after the next frame.
+  bool result = false;
+  if (m_gameLoop.GetSpeed() != 0.0 &&
+      m_snapshotHandoff.Request(buffer.data(), buffer.size(), SNAPSHOT_TIMEOUT_MS, result))
+    return result;
+
+  // The game loop is paused or stopped, so serialize the game here
+  CSingleLock lock(m_mutex);
+
+  return m_gameClient->Serialize(buffer.data(), buffer.size());
+}
+
+void CReversiblePlayback::ReleaseSnapshotBuffer(SnapshotBuffer buffer)
+{
+  CSingleLock lock(m_savestateMutex);
+
+  if (m_snapshotBuffers.size() < MAX_SNAPSHOT_BUFFERS)
+    m_snapshotBuffers.emplace_back(std::move(buffer));
+}
+
 void CReversiblePlayback::RewindFrames(uint64_t frames)
 {
   CSingleLock lock(m_mutex);
 
   if (m_memoryStream)
   {
-    m_memoryStream->RewindFrames(frames);
+    // Rewinding into the keyframe tier can go back further than requested
+    frames = m_memoryStream->RewindFrames(frames);
     m_gameClient->Deserialize(m_memoryStream->CurrentFrame(), m_memoryStream->FrameSize());
     UpdatePlaybackStats();
   }
@@ -300,7 +386,7 @@ void CReversiblePlayback::UpdateMemoryStream()
 
     if (!m_memoryStream)
     {
-      m_memoryStream.reset(new CDeltaPairMemoryStream);
+      m_memoryStream.reset(new CCompressedDeltaMemoryStream);
       m_memoryStream->Init(m_gameClient->SerializeSize(), frameCount);
     }
 
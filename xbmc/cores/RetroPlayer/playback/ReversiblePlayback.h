@@ -10,12 +10,15 @@
 
 #include "IPlayback.h"
 #include "GameLoop.h"
+#include "SavestateWriter.h"
+#include "SnapshotHandoff.h"
 #include "threads/CriticalSection.h"
 #include "utils/Observer.h"
 
 #include <memory>
 #include <stddef.h>
 #include <stdint.h>
+#include <vector>
 
 namespace KODI
 {
@@ -61,7 +64,12 @@ namespace RETRO
     virtual void Notify(const Observable &obs, const ObservableMessage msg) override;
 
   private:
+    using SnapshotBuffer = std::vector<uint8_t>;
+
     void AddFrame();
+    void TakeRequestedSnapshot();
+    bool TakeSnapshot(SnapshotBuffer& buffer);
+    void ReleaseSnapshotBuffer(SnapshotBuffer buffer);
     void RewindFrames(uint64_t frames);
     void AdvanceFrames(uint64_t frames);
     void UpdatePlaybackStats();
@@ -77,6 +85,10 @@ namespace RETRO
 
     // Savestate functionality
     std::unique_ptr<CSavestateDatabase> m_savestateDatabase;
+    CCriticalSection m_savestateMutex;
+    std::vector<SnapshotBuffer> m_snapshotBuffers; // Pooled snapshot buffers
+    CSavestateWriter m_savestateWriter; // Destroyed first, writes use the above
+    CSnapshotHandoff m_snapshotHandoff;
 
     // Playback stats
     uint64_t m_totalFrameCount;
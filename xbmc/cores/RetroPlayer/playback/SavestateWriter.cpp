@@ -0,0 +1,55 @@
+/*
+ *  Copyright (C) 2016-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "SavestateWriter.h"
+#include "threads/SingleLock.h"
+
+using namespace KODI;
+using namespace RETRO;
+
+CSavestateWriter::CSavestateWriter() :
+  m_written(true, true)
+{
+}
+
+CSavestateWriter::~CSavestateWriter()
+{
+  Wait();
+}
+
+void CSavestateWriter::Submit(std::function<void()> write)
+{
+  {
+    CSingleLock lock(m_mutex);
+
+    m_pending++;
+    m_written.Reset();
+  }
+
+  // The queue runs one job at a time, in submission order
+  m_jobs.Submit([this, write]()
+  {
+    write();
+
+    CSingleLock lock(m_mutex);
+
+    if (--m_pending == 0)
+      m_written.Set();
+  });
+}
+
+void CSavestateWriter::Wait()
+{
+  CSingleLock lock(m_mutex);
+
+  while (m_pending > 0)
+  {
+    CSingleExit exit(m_mutex);
+    m_written.Wait();
+  }
+}
@@ -0,0 +1,52 @@
+/*
+ *  Copyright (C) 2016-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "utils/JobManager.h"
+
+#include <functional>
+
+namespace KODI
+{
+namespace RETRO
+{
+  /*!
+   * \brief Writes savestates off the game loop, one at a time and in the
+   *        order they were submitted, so the newest savestate is written last
+   */
+  class CSavestateWriter
+  {
+  public:
+    CSavestateWriter();
+
+    /*!
+     * \brief Waits for all submitted writes
+     */
+    ~CSavestateWriter();
+
+    /*!
+     * \brief Queue a write after all previously submitted ones
+     */
+    void Submit(std::function<void()> write);
+
+    /*!
+     * \brief Wait until all writes submitted so far are done
+     */
+    void Wait();
+
+  private:
+    CJobQueue m_jobs;
+    CCriticalSection m_mutex;
+    unsigned int m_pending = 0;
+    CEvent m_written;
+  };
+}
+}
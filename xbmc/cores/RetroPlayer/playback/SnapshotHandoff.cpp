@@ -0,0 +1,54 @@
+/*
+ *  Copyright (C) 2016-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "SnapshotHandoff.h"
+#include "threads/SingleLock.h"
+
+using namespace KODI;
+using namespace RETRO;
+
+bool CSnapshotHandoff::Request(uint8_t* data, size_t size, unsigned int timeoutMs, bool& result)
+{
+  // One request to the game loop at a time
+  CSingleLock requestLock(m_requestMutex);
+
+  {
+    CSingleLock lock(m_mutex);
+
+    m_data = data;
+    m_size = size;
+    m_result = false;
+    m_served.Reset();
+  }
+
+  m_served.WaitMSec(timeoutMs);
+
+  CSingleLock lock(m_mutex);
+
+  if (m_data == nullptr)
+  {
+    result = m_result;
+    return true;
+  }
+
+  // The game loop was paused or stopped before serving the request
+  m_data = nullptr;
+  return false;
+}
+
+void CSnapshotHandoff::Serve(const SerializeFunc& serialize)
+{
+  CSingleLock lock(m_mutex);
+
+  if (m_data != nullptr)
+  {
+    m_result = serialize(m_data, m_size);
+    m_data = nullptr;
+    m_served.Set();
+  }
+}
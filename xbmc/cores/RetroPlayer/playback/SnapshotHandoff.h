@@ -0,0 +1,60 @@
+/*
+ *  Copyright (C) 2016-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+
+#include <functional>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace KODI
+{
+namespace RETRO
+{
+  /*!
+   * \brief Lets a thread have the game loop serialize the game between two
+   *        frames
+   *
+   * A request the game loop doesn't serve in time is withdrawn, after which
+   * the game loop no longer writes to its buffer.
+   */
+  class CSnapshotHandoff
+  {
+  public:
+    using SerializeFunc = std::function<bool(uint8_t* data, size_t size)>;
+
+    /*!
+     * \brief Wait for the game loop to serialize the game into a buffer
+     *
+     * \param data The buffer
+     * \param size The size of the buffer
+     * \param timeoutMs Time to wait for the game loop
+     * \param[out] result The result of the serialization, if served
+     *
+     * \return True if the game loop served the request, false on timeout
+     */
+    bool Request(uint8_t* data, size_t size, unsigned int timeoutMs, bool& result);
+
+    /*!
+     * \brief Serve a pending request, called by the game loop after a frame
+     */
+    void Serve(const SerializeFunc& serialize);
+
+  private:
+    CCriticalSection m_requestMutex; // Held by the thread waiting for the snapshot
+    CCriticalSection m_mutex;
+    uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+    bool m_result = false;
+    CEvent m_served;
+  };
+}
+}
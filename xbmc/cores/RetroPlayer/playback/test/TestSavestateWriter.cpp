@@ -0,0 +1,119 @@
+/*
+ *  Copyright (C) 2016-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/RetroPlayer/playback/SavestateWriter.h"
+#include "threads/Event.h"
+#include "threads/IRunnable.h"
+#include "threads/SingleLock.h"
+#include "threads/test/TestHelpers.h"
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace KODI;
+using namespace RETRO;
+
+namespace
+{
+  //! Records the order in which savestates were written
+  class CWriteLog
+  {
+  public:
+    void Write(int savestate)
+    {
+      CSingleLock lock(m_mutex);
+      m_written.push_back(savestate);
+    }
+
+    std::vector<int> Written()
+    {
+      CSingleLock lock(m_mutex);
+      return m_written;
+    }
+
+  private:
+    CCriticalSection m_mutex;
+    std::vector<int> m_written;
+  };
+
+  /*!
+   * \brief Waits for the writes before reading a savestate, like
+   *        CReversiblePlayback::LoadSavestate() does
+   */
+  class CReader : public IRunnable
+  {
+  public:
+    CReader(CSavestateWriter& writer, CWriteLog& log) : m_writer(writer), m_log(log) {}
+
+    void Run() override
+    {
+      m_writer.Wait();
+      m_written = m_log.Written();
+    }
+
+    CSavestateWriter& m_writer;
+    CWriteLog& m_log;
+    std::vector<int> m_written;
+  };
+}
+
+TEST(TestSavestateWriter, WaitForWrites)
+{
+  CSavestateWriter writer;
+  CWriteLog log;
+  CEvent release(true);
+
+  writer.Submit([&log, &release]() { release.Wait(); log.Write(1); });
+  writer.Submit([&log]() { log.Write(2); });
+  writer.Submit([&log]() { log.Write(3); });
+
+  CReader reader(writer, log);
+  thread readerThread(reader);
+
+  // Blocked by the first write, which holds up the others
+  EXPECT_FALSE(readerThread.timed_join(100));
+  EXPECT_TRUE(log.Written().empty());
+
+  release.Set();
+  ASSERT_TRUE(readerThread.timed_join(10000));
+  EXPECT_EQ(std::vector<int>({ 1, 2, 3 }), reader.m_written);
+}
+
+TEST(TestSavestateWriter, WaitWithoutWrites)
+{
+  CSavestateWriter writer;
+  CWriteLog log;
+  CReader reader(writer, log);
+  thread readerThread(reader);
+  EXPECT_TRUE(readerThread.timed_join(10000));
+}
+
+TEST(TestSavestateWriter, WaitAgain)
+{
+  CSavestateWriter writer;
+  CWriteLog log;
+
+  writer.Submit([&log]() { log.Write(1); });
+  writer.Wait();
+  EXPECT_EQ(std::vector<int>({ 1 }), log.Written());
+
+  writer.Submit([&log]() { SleepMillis(50); log.Write(2); });
+  writer.Wait();
+  EXPECT_EQ(std::vector<int>({ 1, 2 }), log.Written());
+}
+
+TEST(TestSavestateWriter, DestructorWaits)
+{
+  CWriteLog log;
+  {
+    CSavestateWriter writer;
+    writer.Submit([&log]() { SleepMillis(50); log.Write(1); });
+  }
+  EXPECT_EQ(std::vector<int>({ 1 }), log.Written());
+}
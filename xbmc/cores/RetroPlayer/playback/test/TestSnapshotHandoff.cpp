@@ -0,0 +1,131 @@
+/*
+ *  Copyright (C) 2016-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/RetroPlayer/playback/SnapshotHandoff.h"
+#include "threads/IRunnable.h"
+#include "threads/test/TestHelpers.h"
+
+#include <algorithm>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace KODI;
+using namespace RETRO;
+
+namespace
+{
+  const size_t SNAPSHOT_SIZE = 16;
+
+  /*!
+   * \brief Requests a snapshot from outside the game loop, like
+   *        CReversiblePlayback::CreateSavestate() does
+   */
+  class CRequester : public IRunnable
+  {
+  public:
+    CRequester(CSnapshotHandoff& handoff, unsigned int timeoutMs) :
+      m_handoff(handoff),
+      m_timeoutMs(timeoutMs),
+      m_buffer(SNAPSHOT_SIZE)
+    {
+    }
+
+    void Run() override
+    {
+      m_served = m_handoff.Request(m_buffer.data(), m_buffer.size(), m_timeoutMs, m_result);
+    }
+
+    CSnapshotHandoff& m_handoff;
+    const unsigned int m_timeoutMs;
+    std::vector<uint8_t> m_buffer;
+    bool m_served = false;
+    bool m_result = false;
+  };
+
+  /*!
+   * \brief Serves requests like the game loop does after every frame, until
+   *        one was served
+   */
+  unsigned int RunGameLoop(CSnapshotHandoff& handoff, bool result)
+  {
+    unsigned int serialized = 0;
+    for (unsigned int frame = 0; frame < 10000 && serialized == 0; frame++)
+    {
+      handoff.Serve([&serialized, result](uint8_t* data, size_t size)
+      {
+        serialized++;
+        std::fill(data, data + size, 0xab);
+        return result;
+      });
+      SleepMillis(1);
+    }
+    return serialized;
+  }
+}
+
+TEST(TestSnapshotHandoff, Served)
+{
+  CSnapshotHandoff handoff;
+  CRequester requester(handoff, 10000);
+  thread requesterThread(requester);
+
+  EXPECT_EQ(1u, RunGameLoop(handoff, true));
+  ASSERT_TRUE(requesterThread.timed_join(10000));
+  EXPECT_TRUE(requester.m_served);
+  EXPECT_TRUE(requester.m_result);
+  EXPECT_EQ(std::vector<uint8_t>(SNAPSHOT_SIZE, 0xab), requester.m_buffer);
+}
+
+TEST(TestSnapshotHandoff, SerializeFailed)
+{
+  CSnapshotHandoff handoff;
+  CRequester requester(handoff, 10000);
+  thread requesterThread(requester);
+
+  EXPECT_EQ(1u, RunGameLoop(handoff, false));
+  ASSERT_TRUE(requesterThread.timed_join(10000));
+  EXPECT_TRUE(requester.m_served);
+  EXPECT_FALSE(requester.m_result);
+}
+
+TEST(TestSnapshotHandoff, ServedOnce)
+{
+  CSnapshotHandoff handoff;
+  CRequester requester(handoff, 10000);
+  thread requesterThread(requester);
+
+  EXPECT_EQ(1u, RunGameLoop(handoff, true));
+  ASSERT_TRUE(requesterThread.timed_join(10000));
+
+  bool serialized = false;
+  handoff.Serve([&serialized](uint8_t* data, size_t size) { return serialized = true; });
+  EXPECT_FALSE(serialized);
+}
+
+TEST(TestSnapshotHandoff, TimedOut)
+{
+  CSnapshotHandoff handoff;
+  CRequester requester(handoff, 10);
+  thread requesterThread(requester);
+  ASSERT_TRUE(requesterThread.timed_join(10000));
+  EXPECT_FALSE(requester.m_served);
+
+  // e.g. the game loop resumes after a pause, the buffer is gone by now
+  bool serialized = false;
+  handoff.Serve([&serialized](uint8_t* data, size_t size) { return serialized = true; });
+  EXPECT_FALSE(serialized);
+}
+
+TEST(TestSnapshotHandoff, NotRequested)
+{
+  CSnapshotHandoff handoff;
+  bool serialized = false;
+  handoff.Serve([&serialized](uint8_t* data, size_t size) { return serialized = true; });
+  EXPECT_FALSE(serialized);
+}
@@ -0,0 +1,363 @@
+/*
+ *  Copyright (C) 2016-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "CompressedDeltaMemoryStream.h"
+#include "utils/log.h"
+
+#include <lzo/lzo1x.h>
+
+#include <algorithm>
+#include <cstring>
+
+using namespace KODI;
+using namespace RETRO;
+
+namespace
+{
+  // Deltas smaller than this aren't worth running through LZO
+  const size_t MIN_LZO_SIZE = 64;
+
+  // Maximum size of a varint encoded 32-bit value
+  const size_t MAX_VARINT_SIZE = 5;
+
+  inline uint8_t* WriteVarint(uint8_t* out, uint32_t value)
+  {
+    while (value >= 0x80)
+    {
+      *out++ = static_cast<uint8_t>(value | 0x80);
+      value >>= 7;
+    }
+    *out++ = static_cast<uint8_t>(value);
+    return out;
+  }
+
+  inline const uint8_t* ReadVarint(const uint8_t* in, const uint8_t* end, uint32_t& value)
+  {
+    value = 0;
+    for (unsigned int shift = 0; in < end && shift < 35; shift += 7)
+    {
+      uint8_t byte = *in++;
+      value |= static_cast<uint32_t>(byte & 0x7f) << shift;
+      if (!(byte & 0x80))
+        break;
+    }
+    return in;
+  }
+}
+
+const size_t CCompressedDeltaMemoryStream::DEFAULT_MAX_MEMORY;
+const uint64_t CCompressedDeltaMemoryStream::KEYFRAME_INTERVAL;
+
+void CCompressedDeltaMemoryStream::Init(size_t frameSize, uint64_t maxFrameCount)
+{
+  CLinearMemoryStream::Init(frameSize, maxFrameCount);
+
+  if (lzo_init() != LZO_E_OK)
+    CLog::Log(LOGERROR, "CCompressedDeltaMemoryStream: Failed to initialize LZO");
+
+  m_tailFrame.reset(new uint32_t[m_paddedFrameSize]);
+  m_lzoWorkMemory.reset(new uint8_t[LZO1X_1_MEM_COMPRESS]);
+}
+
+void CCompressedDeltaMemoryStream::Reset()
+{
+  CLinearMemoryStream::Reset();
+
+  m_recentFrames.clear();
+  m_recentBytes = 0;
+  m_keyframes.clear();
+  m_keyframeBytes = 0;
+  m_tailFrame.reset();
+  m_position = 0;
+  m_rleBuffer.clear();
+  m_lzoBuffer.clear();
+  m_lzoWorkMemory.reset();
+}
+
+void CCompressedDeltaMemoryStream::SetMaxMemory(size_t maxMemory)
+{
+  m_maxMemory = maxMemory;
+
+  EnforceLimits();
+}
+
+void CCompressedDeltaMemoryStream::SubmitFrameInternal()
+{
+  // The tail of an empty recent tier is the frame the first delta restores
+  if (m_recentFrames.empty())
+    std::memcpy(m_tailFrame.get(), m_currentFrame.get(), m_paddedFrameSize * sizeof(uint32_t));
+
+  m_recentFrames.push_back(CompressedFrame());
+  CompressedFrame& frame = m_recentFrames.back();
+
+  Compress(m_nextFrame.get(), m_currentFrame.get(), frame);
+  m_recentBytes += frame.data.capacity() + sizeof(CompressedFrame);
+
+  // Record frame history
+  frame.frameHistoryCount = m_currentFrameHistory++;
+  frame.position = m_position++;
+
+  // Delta is generated, bring the new frame forward (m_nextFrame is now disposable)
+  std::swap(m_currentFrame, m_nextFrame);
+
+  m_bHasNextFrame = false;
+
+  EnforceLimits();
+}
+
+uint64_t CCompressedDeltaMemoryStream::PastFramesAvailable() const
+{
+  return m_position - OldestPosition();
+}
+
+uint64_t CCompressedDeltaMemoryStream::RewindFrames(uint64_t frameCount)
+{
+  uint64_t rewound;
+
+  // Frame accurate rewind through the recent tier
+  for (rewound = 0; rewound < frameCount; rewound++)
+  {
+    if (m_recentFrames.empty())
+      break;
+
+    const CompressedFrame& frame = m_recentFrames.back();
+
+    Apply(frame, m_currentFrame.get());
+
+    // Restore frame history
+    m_currentFrameHistory = frame.frameHistoryCount;
+    m_position--;
+
+    m_recentBytes -= frame.data.capacity() + sizeof(CompressedFrame);
+    m_recentFrames.pop_back();
+  }
+
+  if (rewound < frameCount && !m_keyframes.empty())
+  {
+    // Jump to the newest keyframe at or before the requested frame
+    const uint64_t target = m_position - std::min(m_position, frameCount - rewound);
+    while (m_keyframes.size() > 1 && m_keyframes.back().position > target)
+    {
+      m_keyframeBytes -= m_keyframes.back().data.capacity() + sizeof(CompressedFrame);
+      m_keyframes.pop_back();
+    }
+
+    const CompressedFrame& keyframe = m_keyframes.back();
+
+    std::memset(m_currentFrame.get(), 0, m_paddedFrameSize * sizeof(uint32_t));
+    Apply(keyframe, m_currentFrame.get());
+
+    m_currentFrameHistory = keyframe.frameHistoryCount;
+    rewound += m_position - keyframe.position;
+    m_position = keyframe.position;
+
+    m_keyframeBytes -= keyframe.data.capacity() + sizeof(CompressedFrame);
+    m_keyframes.pop_back();
+  }
+
+  return rewound;
+}
+
+void CCompressedDeltaMemoryStream::CullPastFrames(uint64_t frameCount)
+{
+  const uint64_t target = OldestPosition() + frameCount;
+
+  while (!m_keyframes.empty() && m_keyframes.front().position < target)
+    DropKeyframe();
+
+  if (m_keyframes.empty())
+  {
+    while (!m_recentFrames.empty() && m_recentFrames.front().position < target)
+      EvictRecentFrame(false);
+  }
+
+  if (OldestPosition() < target)
+    CLog::Log(LOGDEBUG, "CCompressedDeltaMemoryStream: Tried to cull %llu frames too many. Check your math!",
+              static_cast<unsigned long long>(target - OldestPosition()));
+}
+
+void CCompressedDeltaMemoryStream::Compress(const uint32_t* frame, const uint32_t* base, CompressedFrame& compressed)
+{
+  // Run-length encode as pairs of (unchanged words, changed words) followed
+  // by the changed words
+  if (m_rleBuffer.size() < 1024)
+    m_rleBuffer.resize(1024);
+
+  size_t size = 0;
+  size_t i = 0;
+  while (i < m_paddedFrameSize)
+  {
+    const size_t zeroStart = i;
+    if (base)
+    {
+      while (i < m_paddedFrameSize && frame[i] == base[i])
+        i++;
+    }
+    else
+    {
+      while (i < m_paddedFrameSize && frame[i] == 0)
+        i++;
+    }
+
+    const size_t literalStart = i;
+    if (base)
+    {
+      while (i < m_paddedFrameSize && frame[i] != base[i])
+        i++;
+    }
+    else
+    {
+      while (i < m_paddedFrameSize && frame[i] != 0)
+        i++;
+    }
+
+    const size_t literalCount = i - literalStart;
+    const size_t needed = size + 2 * MAX_VARINT_SIZE + literalCount * sizeof(uint32_t);
+    if (needed > m_rleBuffer.size())
+      m_rleBuffer.resize(std::max(needed, m_rleBuffer.size() * 2));
+
+    uint8_t* out = m_rleBuffer.data() + size;
+    out = WriteVarint(out, static_cast<uint32_t>(literalStart - zeroStart));
+    out = WriteVarint(out, static_cast<uint32_t>(literalCount));
+    for (size_t j = literalStart; j < i; j++)
+    {
+      const uint32_t value = base ? frame[j] ^ base[j] : frame[j];
+      std::memcpy(out, &value, sizeof(value));
+      out += sizeof(value);
+    }
+    size = out - m_rleBuffer.data();
+  }
+
+  compressed.rleSize = size;
+  compressed.lzo = false;
+
+  if (size >= MIN_LZO_SIZE && m_lzoWorkMemory)
+  {
+    m_lzoBuffer.resize(size + size / 16 + 64 + 3);
+
+    lzo_uint lzoSize = 0;
+    if (lzo1x_1_compress(m_rleBuffer.data(), static_cast<lzo_uint>(size), m_lzoBuffer.data(),
+                         &lzoSize, m_lzoWorkMemory.get()) == LZO_E_OK && lzoSize < size)
+    {
+      compressed.data.assign(m_lzoBuffer.data(), m_lzoBuffer.data() + lzoSize);
+      compressed.lzo = true;
+      return;
+    }
+  }
+
+  compressed.data.assign(m_rleBuffer.data(), m_rleBuffer.data() + size);
+}
+
+void CCompressedDeltaMemoryStream::Apply(const CompressedFrame& compressed, uint32_t* frame)
+{
+  const uint8_t* in = compressed.data.data();
+  const uint8_t* end = in + compressed.data.size();
+
+  if (compressed.lzo)
+  {
+    if (m_rleBuffer.size() < compressed.rleSize)
+      m_rleBuffer.resize(compressed.rleSize);
+
+    lzo_uint size = static_cast<lzo_uint>(compressed.rleSize);
+    if (lzo1x_decompress_safe(in, static_cast<lzo_uint>(compressed.data.size()), m_rleBuffer.data(),
+                              &size, nullptr) != LZO_E_OK || size != compressed.rleSize)
+    {
+      CLog::Log(LOGERROR, "CCompressedDeltaMemoryStream: Failed to decompress frame");
+      return;
+    }
+
+    in = m_rleBuffer.data();
+    end = in + size;
+  }
+
+  size_t i = 0;
+  while (i < m_paddedFrameSize && in < end)
+  {
+    uint32_t zeroCount;
+    uint32_t literalCount;
+    in = ReadVarint(in, end, zeroCount);
+    in = ReadVarint(in, end, literalCount);
+
+    i += zeroCount;
+    if (i + literalCount > m_paddedFrameSize ||
+        static_cast<size_t>(end - in) < literalCount * sizeof(uint32_t))
+      break;
+
+    for (uint32_t j = 0; j < literalCount; j++)
+    {
+      uint32_t value;
+      std::memcpy(&value, in, sizeof(value));
+      frame[i++] ^= value;
+      in += sizeof(value);
+    }
+  }
+}
+
+void CCompressedDeltaMemoryStream::EvictRecentFrame(bool keepKeyframe)
+{
+  const CompressedFrame& oldest = m_recentFrames.front();
+
+  // The tail frame is the frame restored by the oldest delta
+  if (keepKeyframe && oldest.position % KEYFRAME_INTERVAL == 0)
+  {
+    m_keyframes.push_back(CompressedFrame());
+    CompressedFrame& keyframe = m_keyframes.back();
+
+    Compress(m_tailFrame.get(), nullptr, keyframe);
+    keyframe.frameHistoryCount = oldest.frameHistoryCount;
+    keyframe.position = oldest.position;
+    m_keyframeBytes += keyframe.data.capacity() + sizeof(CompressedFrame);
+  }
+
+  // Not needed for the last delta, the new tail is the current frame
+  if (m_recentFrames.size() > 1)
+    Apply(oldest, m_tailFrame.get());
+
+  m_recentBytes -= oldest.data.capacity() + sizeof(CompressedFrame);
+  m_recentFrames.pop_front();
+}
+
+void CCompressedDeltaMemoryStream::DropKeyframe()
+{
+  m_keyframeBytes -= m_keyframes.front().data.capacity() + sizeof(CompressedFrame);
+  m_keyframes.pop_front();
+}
+
+void CCompressedDeltaMemoryStream::EnforceLimits()
+{
+  const size_t maxRecentBytes = m_maxMemory / 4 * 3;
+  const size_t maxKeyframeBytes = m_maxMemory - maxRecentBytes;
+
+  while (m_recentBytes > maxRecentBytes && m_recentFrames.size() > 1)
+    EvictRecentFrame(true);
+
+  while (m_keyframeBytes > maxKeyframeBytes && !m_keyframes.empty())
+    DropKeyframe();
+
+  // Leave room for the current frame
+  while (PastFramesAvailable() + 1 > MaxFrameCount())
+  {
+    if (!m_keyframes.empty())
+      DropKeyframe();
+    else if (!m_recentFrames.empty())
+      EvictRecentFrame(false);
+    else
+      break;
+  }
+}
+
+uint64_t CCompressedDeltaMemoryStream::OldestPosition() const
+{
+  if (!m_keyframes.empty())
+    return m_keyframes.front().position;
+
+  if (!m_recentFrames.empty())
+    return m_recentFrames.front().position;
+
+  return m_position;
+}
@@ -0,0 +1,138 @@
+/*
+ *  Copyright (C) 2016-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "LinearMemoryStream.h"
+
+#include <deque>
+#include <memory>
+#include <vector>
+
+namespace KODI
+{
+namespace RETRO
+{
+  /*!
+   * \brief Implementation of a linear memory stream using compressed XOR
+   *        deltas and sparse keyframes
+   *
+   * Like CDeltaPairMemoryStream, every submitted frame is stored as the XOR
+   * delta to the next frame. The deltas are run-length encoded (runs of
+   * unchanged words are skipped) and then compressed with LZO1X-1.
+   *
+   * Memory is limited in two tiers:
+   *
+   *   - Recent tier: the deltas of the most recent frames. Rewinding through
+   *         this tier is frame accurate.
+   *
+   *   - Keyframe tier: when the recent tier is over its budget, its oldest
+   *         deltas are folded into a full copy of the oldest frame. One of
+   *         every KEYFRAME_INTERVAL frames passing through is kept as a
+   *         compressed keyframe. Rewinding into this tier jumps back to the
+   *         keyframe at or before the requested frame.
+   *
+   * Frames older than MaxFrameCount() or beyond the memory budget of the
+   * keyframe tier are dropped, so the rewind window stays minutes long at a
+   * fixed memory cost.
+   */
+  class CCompressedDeltaMemoryStream : public CLinearMemoryStream
+  {
+  public:
+    CCompressedDeltaMemoryStream() = default;
+
+    virtual ~CCompressedDeltaMemoryStream() = default;
+
+    // implementation of IMemoryStream via CLinearMemoryStream
+    virtual void Init(size_t frameSize, uint64_t maxFrameCount) override;
+    virtual void Reset() override;
+    virtual uint64_t PastFramesAvailable() const override;
+    virtual uint64_t RewindFrames(uint64_t frameCount) override;
+
+    /*!
+     * \brief Set the memory budget of both tiers, in bytes
+     *
+     * Three quarters are given to the recent tier, the rest to keyframes.
+     */
+    void SetMaxMemory(size_t maxMemory);
+
+    /*!
+     * \brief Get the number of bytes used by stored deltas and keyframes
+     */
+    size_t MemoryUsage() const { return m_recentBytes + m_keyframeBytes; }
+
+    /*!
+     * \brief Get the number of frames that can be rewound frame by frame
+     */
+    uint64_t RecentFramesAvailable() const { return static_cast<uint64_t>(m_recentFrames.size()); }
+
+    static const size_t DEFAULT_MAX_MEMORY = 64 * 1024 * 1024;
+    static const uint64_t KEYFRAME_INTERVAL = 60;
+
+  protected:
+    // implementation of CLinearMemoryStream
+    virtual void SubmitFrameInternal() override;
+    virtual void CullPastFrames(uint64_t frameCount) override;
+
+    struct CompressedFrame
+    {
+      std::vector<uint8_t> data;
+      bool lzo; ///< data is LZO compressed
+      size_t rleSize; ///< size of the run-length encoded data
+      uint64_t frameHistoryCount;
+      uint64_t position; ///< index of the restored frame in the stream
+    };
+
+  private:
+    /*!
+     * \brief Run-length encode the XOR of two frames and compress the result
+     *
+     * \param base The older frame, or nullptr to encode the frame itself
+     */
+    void Compress(const uint32_t* frame, const uint32_t* base, CompressedFrame& compressed);
+
+    /*!
+     * \brief XOR a compressed frame onto the given frame
+     */
+    void Apply(const CompressedFrame& compressed, uint32_t* frame);
+
+    /*!
+     * \brief Fold the oldest delta of the recent tier into the tail frame,
+     *        keeping it as a keyframe if it is due
+     */
+    void EvictRecentFrame(bool keepKeyframe);
+
+    void DropKeyframe();
+    void EnforceLimits();
+
+    uint64_t OldestPosition() const;
+
+    // recent tier, ordered from old to new
+    std::deque<CompressedFrame> m_recentFrames;
+    size_t m_recentBytes = 0;
+
+    // keyframe tier, ordered from old to new
+    std::deque<CompressedFrame> m_keyframes;
+    size_t m_keyframeBytes = 0;
+
+    /*!
+     * Full copy of the oldest frame of the recent tier. The oldest delta is
+     * applied to it when it leaves the recent tier.
+     */
+    std::unique_ptr<uint32_t[]> m_tailFrame;
+
+    uint64_t m_position = 0; ///< index of the current frame in the stream
+    size_t m_maxMemory = DEFAULT_MAX_MEMORY;
+
+    // scratch buffers, kept to avoid allocations per frame
+    std::vector<uint8_t> m_rleBuffer;
+    std::vector<uint8_t> m_lzoBuffer;
+    std::unique_ptr<uint8_t[]> m_lzoWorkMemory;
+  };
+}
+}
@@ -0,0 +1,243 @@
+/*
+ *  Copyright (C) 2016-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/RetroPlayer/streams/memory/CompressedDeltaMemoryStream.h"
+#include "cores/RetroPlayer/streams/memory/DeltaPairMemoryStream.h"
+#include "utils/TimeUtils.h"
+
+#include <cstring>
+#include <stdio.h>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace KODI;
+using namespace RETRO;
+
+namespace
+{
+  /*!
+   * \brief Generates savestates that change like those of a real core: a
+   *        few scattered words of work RAM, a scrolling block of video RAM
+   *        and a frame counter, the rest stays the same
+   */
+  class CSyntheticCore
+  {
+  public:
+    explicit CSyntheticCore(size_t size) : m_state(size)
+    {
+      for (size_t i = size / 2; i < size; i++)
+        m_state[i] = static_cast<uint8_t>(i / 256);
+    }
+
+    void RunFrame()
+    {
+      const size_t workRam = m_state.size() / 16;
+      for (size_t i = 0; i < workRam / 100; i++)
+        m_state[Random() % workRam] = static_cast<uint8_t>(Random());
+
+      const size_t videoRam = m_state.size() / 4;
+      const size_t block = std::min<size_t>(4096, videoRam / 2);
+      const size_t offset = workRam + (m_frame * block) % (videoRam - block);
+      for (size_t i = 0; i < block; i++)
+        m_state[offset + i] = static_cast<uint8_t>(m_frame + i);
+
+      m_frame++;
+      std::memcpy(m_state.data(), &m_frame, sizeof(m_frame));
+    }
+
+    const std::vector<uint8_t>& State() const { return m_state; }
+
+  private:
+    uint32_t Random()
+    {
+      m_seed = m_seed * 1103515245 + 12345;
+      return m_seed >> 8;
+    }
+
+    std::vector<uint8_t> m_state;
+    uint32_t m_frame = 0;
+    uint32_t m_seed = 1;
+  };
+
+  void SubmitFrame(IMemoryStream& stream, const std::vector<uint8_t>& state)
+  {
+    std::memcpy(stream.BeginFrame(), state.data(), state.size());
+    stream.SubmitFrame();
+  }
+
+  class CDeltaPairMemoryStreamStats : public CDeltaPairMemoryStream
+  {
+  public:
+    size_t MemoryUsage() const
+    {
+      size_t bytes = 0;
+      for (const auto& frame : m_rewindBuffer)
+        bytes += frame.buffer.capacity() * sizeof(DeltaPair) + sizeof(MemoryFrame);
+      return bytes;
+    }
+  };
+}
+
+TEST(TestCompressedDeltaMemoryStream, RewindRecentFrames)
+{
+  // Not a multiple of 4 bytes to exercise the padding
+  const size_t frameSize = 64 * 1024 + 3;
+  CSyntheticCore core(frameSize);
+  CCompressedDeltaMemoryStream stream;
+  stream.Init(frameSize, 1000);
+
+  std::vector<std::vector<uint8_t>> states;
+  for (unsigned int i = 0; i < 200; i++)
+  {
+    core.RunFrame();
+    states.push_back(core.State());
+    SubmitFrame(stream, states.back());
+  }
+
+  EXPECT_EQ(199u, stream.PastFramesAvailable());
+  EXPECT_EQ(199u, stream.RecentFramesAvailable());
+  EXPECT_EQ(199u, stream.GetFrameCounter());
+
+  for (int i = 198; i >= 0; i--)
+  {
+    ASSERT_EQ(1u, stream.RewindFrames(1));
+    ASSERT_EQ(0, std::memcmp(stream.CurrentFrame(), states[i].data(), frameSize));
+    EXPECT_EQ(static_cast<uint64_t>(i), stream.GetFrameCounter());
+  }
+
+  EXPECT_EQ(0u, stream.PastFramesAvailable());
+  EXPECT_EQ(0u, stream.RewindFrames(1));
+  EXPECT_EQ(0u, stream.MemoryUsage());
+}
+
+TEST(TestCompressedDeltaMemoryStream, RewindToKeyframe)
+{
+  const size_t frameSize = 64 * 1024;
+  CSyntheticCore core(frameSize);
+  CCompressedDeltaMemoryStream stream;
+  stream.Init(frameSize, 100000);
+
+  // Small enough that most frames only survive as keyframes
+  const size_t maxMemory = 512 * 1024;
+  stream.SetMaxMemory(maxMemory);
+
+  std::vector<std::vector<uint8_t>> states;
+  for (unsigned int i = 0; i < 2000; i++)
+  {
+    core.RunFrame();
+    states.push_back(core.State());
+    SubmitFrame(stream, states.back());
+    ASSERT_LE(stream.MemoryUsage(), maxMemory);
+  }
+
+  ASSERT_LT(stream.RecentFramesAvailable(), stream.PastFramesAvailable());
+
+  // Rewinding frame by frame goes through the recent tier first
+  const uint64_t recent = stream.RecentFramesAvailable();
+  ASSERT_EQ(recent, stream.RewindFrames(recent));
+  uint64_t current = 1999 - recent;
+  ASSERT_EQ(0, std::memcmp(stream.CurrentFrame(), states[current].data(), frameSize));
+
+  // Then jumps from keyframe to keyframe
+  while (stream.PastFramesAvailable() > 0)
+  {
+    const uint64_t rewound = stream.RewindFrames(1);
+    ASSERT_GE(rewound, 1u);
+    ASSERT_LE(rewound, CCompressedDeltaMemoryStream::KEYFRAME_INTERVAL);
+    current -= rewound;
+    ASSERT_EQ(0u, current % CCompressedDeltaMemoryStream::KEYFRAME_INTERVAL);
+    ASSERT_EQ(0, std::memcmp(stream.CurrentFrame(), states[current].data(), frameSize));
+    EXPECT_EQ(current, stream.GetFrameCounter());
+  }
+
+  // Playing on after rewinding keeps the stream consistent
+  for (unsigned int i = 0; i < 10; i++)
+    SubmitFrame(stream, states[current + 1 + i]);
+  ASSERT_EQ(10u, stream.RewindFrames(10));
+  EXPECT_EQ(0, std::memcmp(stream.CurrentFrame(), states[current].data(), frameSize));
+}
+
+TEST(TestCompressedDeltaMemoryStream, MaxFrameCount)
+{
+  const size_t frameSize = 4096;
+  CSyntheticCore core(frameSize);
+  CCompressedDeltaMemoryStream stream;
+  stream.Init(frameSize, 100);
+
+  for (unsigned int i = 0; i < 500; i++)
+  {
+    core.RunFrame();
+    SubmitFrame(stream, core.State());
+    ASSERT_LT(stream.PastFramesAvailable(), 100u);
+  }
+
+  stream.SetMaxFrameCount(10);
+  EXPECT_LT(stream.PastFramesAvailable(), 10u);
+}
+
+TEST(TestCompressedDeltaMemoryStream, SmallerThanDeltaPair)
+{
+  const size_t frameSize = 64 * 1024;
+  const unsigned int frameCount = 200;
+
+  CDeltaPairMemoryStreamStats deltaPair;
+  deltaPair.Init(frameSize, frameCount);
+
+  CCompressedDeltaMemoryStream compressed;
+  compressed.Init(frameSize, frameCount);
+
+  CSyntheticCore core(frameSize);
+  for (unsigned int i = 0; i < frameCount; i++)
+  {
+    core.RunFrame();
+    SubmitFrame(deltaPair, core.State());
+    SubmitFrame(compressed, core.State());
+  }
+
+  EXPECT_EQ(deltaPair.PastFramesAvailable(), compressed.PastFramesAvailable());
+  EXPECT_LT(compressed.MemoryUsage(), deltaPair.MemoryUsage());
+}
+
+// Speed and memory use per frame, run with --gtest_also_run_disabled_tests
+TEST(TestCompressedDeltaMemoryStream, DISABLED_Benchmark)
+{
+  const size_t frameSize = 1024 * 1024;
+  const unsigned int frameCount = 600;
+
+  CDeltaPairMemoryStreamStats deltaPair;
+  deltaPair.Init(frameSize, frameCount);
+
+  CCompressedDeltaMemoryStream compressed;
+  compressed.Init(frameSize, frameCount);
+
+  IMemoryStream* streams[] = { &deltaPair, &compressed };
+  const char* names[] = { "delta pair", "compressed" };
+
+  for (unsigned int s = 0; s < 2; s++)
+  {
+    CSyntheticCore core(frameSize);
+    int64_t ticks = 0;
+    for (unsigned int i = 0; i < frameCount; i++)
+    {
+      core.RunFrame();
+      int64_t start = CurrentHostCounter();
+      SubmitFrame(*streams[s], core.State());
+      ticks += CurrentHostCounter() - start;
+    }
+
+    const size_t bytes = s == 0 ? deltaPair.MemoryUsage() : compressed.MemoryUsage();
+    const uint64_t frames = streams[s]->PastFramesAvailable();
+    ASSERT_GT(frames, 0u);
+
+    printf("%-10s %u KiB savestates: %.1f us per submitted frame, %.0f bytes per frame\n",
+           names[s], static_cast<unsigned int>(frameSize / 1024),
+           1000000.0 * ticks / CurrentHostFrequency() / frameCount,
+           static_cast<double>(bytes) / frames);
+  }
+}
@@ -29,6 +29,7 @@
 #include "URL.h"
 #include "utils/log.h"
 #include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
 #include "utils/URIUtils.h"
 
 #ifdef HAVE_LIBBLURAY
@@ -134,8 +135,16 @@ static int dvd_file_read(void *h, uint8_t* buf, int size)
   if(interrupt_cb(h))
     return AVERROR_EXIT;
 
-  std::shared_ptr<CDVDInputStream> pInputStream = static_cast<CDVDDemuxFFmpeg*>(h)->m_pInput;
+  CDVDDemuxFFmpeg* demuxer = static_cast<CDVDDemuxFFmpeg*>(h);
+  std::shared_ptr<CDVDInputStream> pInputStream = demuxer->m_pInput;
+  int64_t start = CurrentHostCounter();
   int len = pInputStream->Read(buf, size);
+  DemuxIOStats& stats = demuxer->IOStats();
+  stats.readTicks += CurrentHostCounter() - start;
+  stats.reads++;
+  if (len > 0)
+    stats.readBytes += len;
+
   if (len == 0)
     return AVERROR_EOF;
   else
@@ -152,11 +161,16 @@ static int64_t dvd_file_seek(void *h, int64_t pos, int whence)
   if(interrupt_cb(h))
     return AVERROR_EXIT;
 
-  std::shared_ptr<CDVDInputStream> pInputStream = static_cast<CDVDDemuxFFmpeg*>(h)->m_pInput;
+  CDVDDemuxFFmpeg* demuxer = static_cast<CDVDDemuxFFmpeg*>(h);
+  std::shared_ptr<CDVDInputStream> pInputStream = demuxer->m_pInput;
   if(whence == AVSEEK_SIZE)
     return pInputStream->GetLength();
-  else
-    return pInputStream->Seek(pos, whence & ~AVSEEK_FORCE);
+
+  int64_t start = CurrentHostCounter();
+  int64_t ret = pInputStream->Seek(pos, whence & ~AVSEEK_FORCE);
+  demuxer->IOStats().seekTicks += CurrentHostCounter() - start;
+  demuxer->IOStats().seeks++;
+  return ret;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////
@@ -905,7 +919,9 @@ DemuxPacket* CDVDDemuxFFmpeg::Read()
 
       // timeout reads after 100ms
       m_timeout.Set(20000);
+      int64_t start = CurrentHostCounter();
       m_pkt.result = av_read_frame(m_pFormatContext, &m_pkt.pkt);
+      m_ioStats.frameTicks += CurrentHostCounter() - start;
       m_timeout.SetInfinite();
     }
 
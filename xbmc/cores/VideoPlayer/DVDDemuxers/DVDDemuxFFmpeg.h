@@ -70,6 +70,17 @@ public:
 
 struct StereoModeConversionMap;
 
+//! time spent below the demuxer, in host counter ticks
+struct DemuxIOStats
+{
+  uint64_t reads = 0; ///< AVIO read callbacks
+  uint64_t readBytes = 0;
+  int64_t readTicks = 0; ///< in CDVDInputStream::Read
+  uint64_t seeks = 0; ///< AVIO seek callbacks
+  int64_t seekTicks = 0; ///< in CDVDInputStream::Seek
+  int64_t frameTicks = 0; ///< in av_read_frame, including the callbacks it made
+};
+
 class CDVDDemuxFFmpeg : public CDVDDemux
 {
 public:
@@ -104,6 +115,9 @@ public:
 
   bool Aborted();
 
+  const DemuxIOStats& GetIOStats() const { return m_ioStats; }
+  DemuxIOStats& IOStats() { return m_ioStats; } // updated by the AVIO callbacks
+
   AVFormatContext* m_pFormatContext;
   std::shared_ptr<CDVDInputStream> m_pInput;
 
@@ -163,5 +177,6 @@ protected:
   double m_dtsAtDisplayTime;
   bool m_seekToKeyFrame = false;
   double m_startTime = 0;
+  DemuxIOStats m_ioStats;
 };
 
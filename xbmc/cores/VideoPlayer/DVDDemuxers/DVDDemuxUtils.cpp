@@ -7,13 +7,9 @@
  */
 
 #include "DVDDemuxUtils.h"
-#include "cores/VideoPlayer/Interface/Addon/DemuxCrypto.h"
+#include "DemuxPacketPool.h"
 #include "utils/log.h"
 
-#if defined TARGET_POSIX
-#include "platform/linux/XMemUtils.h"
-#endif
-
 extern "C" {
 #include "libavcodec/avcodec.h"
 }
@@ -22,8 +18,6 @@ void CDVDDemuxUtils::FreeDemuxPacket(DemuxPacket* pPacket)
 {
   if (pPacket)
   {
-    if (pPacket->pData)
-      _aligned_free(pPacket->pData);
     if (pPacket->iSideDataElems)
     {
       AVPacket avPkt;
@@ -32,13 +26,18 @@ void CDVDDemuxUtils::FreeDemuxPacket(DemuxPacket* pPacket)
       avPkt.side_data_elems = pPacket->iSideDataElems;
       av_packet_free_side_data(&avPkt);
     }
-    delete pPacket;
+    CDemuxPacketPool::GetInstance().Free(pPacket);
   }
 }
 
 DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacket(int iDataSize)
 {
-  DemuxPacket* pPacket = new DemuxPacket();
+  return AllocateDemuxPacket(iDataSize > 0 ? iDataSize : 0, 0);
+}
+
+DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacket(unsigned int iDataSize, unsigned int encryptedSubsampleCount)
+{
+  DemuxPacket* pPacket;
 
   if (iDataSize > 0)
   {
@@ -51,28 +50,19 @@ DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacket(int iDataSize)
      * Note, if the first 23 bits of the additional bytes are not 0 then damaged
      * MPEG bitstreams could cause overread and segfault
      */
-    pPacket->pData =(uint8_t*)_aligned_malloc(iDataSize + AV_INPUT_BUFFER_PADDING_SIZE, 16);
-    if (!pPacket->pData)
-    {
-      FreeDemuxPacket(pPacket);
+    pPacket = CDemuxPacketPool::GetInstance().Allocate(iDataSize + AV_INPUT_BUFFER_PADDING_SIZE, encryptedSubsampleCount);
+    if (!pPacket)
       return NULL;
-    }
 
     // reset the last 8 bytes to 0;
     memset(pPacket->pData + iDataSize, 0, AV_INPUT_BUFFER_PADDING_SIZE);
   }
+  else
+    pPacket = CDemuxPacketPool::GetInstance().Allocate(0, encryptedSubsampleCount);
 
   return pPacket;
 }
 
-DemuxPacket* CDVDDemuxUtils::AllocateDemuxPacket(unsigned int iDataSize, unsigned int encryptedSubsampleCount)
-{
-  DemuxPacket *ret(AllocateDemuxPacket(iDataSize));
-  if (ret && encryptedSubsampleCount > 0)
-    ret->cryptoInfo = std::shared_ptr<DemuxCryptoInfo>(new DemuxCryptoInfo(encryptedSubsampleCount));
-  return ret;
-}
-
 void CDVDDemuxUtils::StoreSideData(DemuxPacket *pkt, AVPacket *src)
 {
   AVPacket avPkt;
@@ -81,3 +71,10 @@ void CDVDDemuxUtils::StoreSideData(DemuxPacket *pkt, AVPacket *src)
   pkt->pSideData = avPkt.side_data;
   pkt->iSideDataElems = avPkt.side_data_elems;
 }
+
+void CDVDDemuxUtils::TrimPacketPool()
+{
+  CDemuxPacketPool& pool = CDemuxPacketPool::GetInstance();
+  pool.LogStats();
+  pool.Trim();
+}
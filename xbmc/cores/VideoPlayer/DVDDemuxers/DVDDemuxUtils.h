@@ -20,5 +20,8 @@ public:
   static DemuxPacket* AllocateDemuxPacket(int iDataSize = 0);
   static DemuxPacket* AllocateDemuxPacket(unsigned int iDataSize, unsigned int encryptedSubsampleCount);
   static void StoreSideData(DemuxPacket *pkt, AVPacket *src);
+
+  /*! \brief Release the packets and buffers kept for reuse, and log the allocation statistics */
+  static void TrimPacketPool();
 };
 
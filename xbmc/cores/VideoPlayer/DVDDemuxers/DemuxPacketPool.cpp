@@ -0,0 +1,248 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "DemuxPacketPool.h"
+#include "cores/VideoPlayer/Interface/Addon/DemuxCrypto.h"
+#include "cores/VideoPlayer/Interface/Addon/DemuxPacket.h"
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+
+#if defined TARGET_POSIX
+#include "platform/linux/XMemUtils.h"
+#endif
+
+#include <memory>
+
+struct CDemuxPacketPool::Packet : public DemuxPacket
+{
+  unsigned int sizeClass = NO_CLASS;
+  size_t capacity = 0;
+};
+
+struct CDemuxPacketPool::CryptoInfoDeleter
+{
+  void operator()(DemuxCryptoInfo* info) const
+  {
+    CDemuxPacketPool::GetInstance().FreeCryptoInfo(info);
+  }
+};
+
+CDemuxPacketPool& CDemuxPacketPool::GetInstance()
+{
+  static CDemuxPacketPool pool;
+  return pool;
+}
+
+CDemuxPacketPool::~CDemuxPacketPool()
+{
+  Trim();
+}
+
+size_t CDemuxPacketPool::GetClassSize(unsigned int sizeClass)
+{
+  // 256, 384, 512, 768, 1024, ... so at most a third of a buffer is unused
+  size_t size = static_cast<size_t>(256) << (sizeClass / 2);
+  return (sizeClass % 2) ? size + size / 2 : size;
+}
+
+unsigned int CDemuxPacketPool::GetClass(size_t size)
+{
+  for (unsigned int sizeClass = 0; sizeClass < NUM_CLASSES; sizeClass++)
+  {
+    if (GetClassSize(sizeClass) >= size)
+      return sizeClass;
+  }
+  return NO_CLASS;
+}
+
+DemuxPacket* CDemuxPacketPool::Allocate(size_t bufferSize, unsigned int encryptedSubsampleCount)
+{
+  Packet* packet = nullptr;
+  {
+    CSingleLock lock(m_packetSection);
+    if (!m_packets.empty())
+    {
+      packet = m_packets.back();
+      m_packets.pop_back();
+    }
+  }
+  if (!packet)
+    packet = new Packet();
+
+  if (bufferSize > 0)
+  {
+    packet->pData = AllocateBuffer(bufferSize, packet->sizeClass, packet->capacity);
+    if (!packet->pData)
+    {
+      Free(packet);
+      return nullptr;
+    }
+  }
+
+  if (encryptedSubsampleCount > 0)
+    packet->cryptoInfo = std::shared_ptr<DemuxCryptoInfo>(AllocateCryptoInfo(encryptedSubsampleCount), CryptoInfoDeleter());
+
+  return packet;
+}
+
+void CDemuxPacketPool::Free(DemuxPacket* demuxPacket)
+{
+  // every packet is allocated by Allocate()
+  Packet* packet = static_cast<Packet*>(demuxPacket);
+  if (packet->pData)
+    FreeBuffer(packet->pData, packet->sizeClass, packet->capacity);
+
+  static_cast<DemuxPacket&>(*packet) = DemuxPacket();
+  packet->sizeClass = NO_CLASS;
+  packet->capacity = 0;
+
+  {
+    CSingleLock lock(m_packetSection);
+    if (m_packets.size() < MAX_CACHED_PACKETS)
+    {
+      m_packets.push_back(packet);
+      return;
+    }
+  }
+  delete packet;
+}
+
+uint8_t* CDemuxPacketPool::AllocateBuffer(size_t size, unsigned int &sizeClass, size_t &capacity)
+{
+  m_allocations++;
+
+  uint8_t* buffer = nullptr;
+  sizeClass = GetClass(size);
+  if (sizeClass == NO_CLASS)
+    capacity = size;
+  else
+  {
+    capacity = GetClassSize(sizeClass);
+    BufferClass& bufferClass = m_classes[sizeClass];
+    CSingleLock lock(bufferClass.section);
+    if (!bufferClass.buffers.empty())
+    {
+      buffer = bufferClass.buffers.back();
+      bufferClass.buffers.pop_back();
+      m_bytesCached -= capacity;
+      m_hits++;
+    }
+  }
+
+  if (!buffer)
+    buffer = static_cast<uint8_t*>(_aligned_malloc(capacity, 16));
+  if (buffer)
+    AddBytesInUse(capacity);
+  return buffer;
+}
+
+void CDemuxPacketPool::FreeBuffer(uint8_t* buffer, unsigned int sizeClass, size_t capacity)
+{
+  m_bytesInUse -= capacity;
+
+  if (sizeClass != NO_CLASS && m_bytesCached + capacity <= MAX_CACHED_BYTES)
+  {
+    BufferClass& bufferClass = m_classes[sizeClass];
+    CSingleLock lock(bufferClass.section);
+    if (bufferClass.buffers.size() < MAX_CACHED_BUFFERS)
+    {
+      bufferClass.buffers.push_back(buffer);
+      m_bytesCached += capacity;
+      return;
+    }
+  }
+  _aligned_free(buffer);
+}
+
+void CDemuxPacketPool::AddBytesInUse(size_t bytes)
+{
+  size_t inUse = m_bytesInUse += bytes;
+  size_t peak = m_peakBytesInUse;
+  while (inUse > peak && !m_peakBytesInUse.compare_exchange_weak(peak, inUse))
+    ;
+}
+
+DemuxCryptoInfo* CDemuxPacketPool::AllocateCryptoInfo(unsigned int numSubSamples)
+{
+  if (numSubSamples <= MAX_POOLED_SUBSAMPLES)
+  {
+    CSingleLock lock(m_cryptoSection);
+    std::vector<DemuxCryptoInfo*>& infos = m_cryptoInfos[numSubSamples];
+    if (!infos.empty())
+    {
+      DemuxCryptoInfo* info = infos.back();
+      infos.pop_back();
+      info->flags = 0;
+      return info;
+    }
+  }
+  return new DemuxCryptoInfo(numSubSamples);
+}
+
+void CDemuxPacketPool::FreeCryptoInfo(DemuxCryptoInfo* info)
+{
+  if (info->numSubSamples <= MAX_POOLED_SUBSAMPLES)
+  {
+    CSingleLock lock(m_cryptoSection);
+    std::vector<DemuxCryptoInfo*>& infos = m_cryptoInfos[info->numSubSamples];
+    if (infos.size() < MAX_CACHED_CRYPTO_INFOS)
+    {
+      infos.push_back(info);
+      return;
+    }
+  }
+  delete info;
+}
+
+void CDemuxPacketPool::Trim()
+{
+  for (unsigned int sizeClass = 0; sizeClass < NUM_CLASSES; sizeClass++)
+  {
+    BufferClass& bufferClass = m_classes[sizeClass];
+    CSingleLock lock(bufferClass.section);
+    for (auto buffer : bufferClass.buffers)
+      _aligned_free(buffer);
+    m_bytesCached -= bufferClass.buffers.size() * GetClassSize(sizeClass);
+    bufferClass.buffers.clear();
+  }
+
+  {
+    CSingleLock lock(m_packetSection);
+    for (auto packet : m_packets)
+      delete packet;
+    m_packets.clear();
+  }
+
+  CSingleLock lock(m_cryptoSection);
+  for (auto& infos : m_cryptoInfos)
+  {
+    for (auto info : infos)
+      delete info;
+    infos.clear();
+  }
+}
+
+CDemuxPacketPool::Stats CDemuxPacketPool::GetStats() const
+{
+  Stats stats;
+  stats.allocations = m_allocations;
+  stats.hits = m_hits;
+  stats.bytesInUse = m_bytesInUse;
+  stats.peakBytesInUse = m_peakBytesInUse;
+  stats.bytesCached = m_bytesCached;
+  return stats;
+}
+
+void CDemuxPacketPool::LogStats() const
+{
+  Stats stats = GetStats();
+  CLog::Log(LOGDEBUG, "CDemuxPacketPool: %llu buffer allocations, %llu from the pool, %llu bytes in use (peak %llu), %llu bytes cached",
+            static_cast<unsigned long long>(stats.allocations), static_cast<unsigned long long>(stats.hits),
+            static_cast<unsigned long long>(stats.bytesInUse), static_cast<unsigned long long>(stats.peakBytesInUse),
+            static_cast<unsigned long long>(stats.bytesCached));
+}
@@ -0,0 +1,110 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/CriticalSection.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+struct DemuxCryptoInfo;
+struct DemuxPacket;
+
+/*!
+ \brief Recycles demux packets, their data buffers and crypto info blocks
+
+ Data buffers are kept in size classes (steps of 1 and 1.5 times a power of two,
+ from 256 bytes to 4 MiB), so a freed buffer can be reused for any packet of up
+ to its class size. Larger buffers are not pooled. The number of cached buffers
+ is bounded, and Trim() releases all of them, e.g. at the end of playback.
+
+ All methods are thread-safe, packets are typically allocated by the demux
+ thread and freed by the audio and video threads.
+ */
+class CDemuxPacketPool
+{
+public:
+  struct Stats
+  {
+    uint64_t allocations = 0; ///< number of data buffers requested
+    uint64_t hits = 0; ///< number of data buffers served from the pool
+    size_t bytesInUse = 0; ///< size of the data buffers of all live packets
+    size_t peakBytesInUse = 0; ///< maximum of bytesInUse
+    size_t bytesCached = 0; ///< size of the data buffers in the pool
+  };
+
+  static CDemuxPacketPool& GetInstance();
+
+  /*!
+   \brief Allocate a packet
+   \param bufferSize size of the data buffer including any padding, 0 for none
+   \param encryptedSubsampleCount number of subsamples of the crypto info, 0 for none
+   \return the packet, nullptr if out of memory
+   */
+  DemuxPacket* Allocate(size_t bufferSize, unsigned int encryptedSubsampleCount);
+
+  /*!
+   \brief Return a packet allocated by Allocate() to the pool
+   Side data has to be freed by the caller.
+   */
+  void Free(DemuxPacket* packet);
+
+  /*! \brief Release all cached packets and buffers */
+  void Trim();
+
+  Stats GetStats() const;
+  void LogStats() const;
+
+private:
+  CDemuxPacketPool() = default;
+  ~CDemuxPacketPool();
+  CDemuxPacketPool(const CDemuxPacketPool&) = delete;
+  CDemuxPacketPool& operator=(const CDemuxPacketPool&) = delete;
+
+  struct Packet;
+  struct CryptoInfoDeleter;
+
+  static const unsigned int NUM_CLASSES = 29;
+  static const unsigned int NO_CLASS = NUM_CLASSES;
+  static const size_t MAX_CACHED_BUFFERS = 64; ///< per class
+  static const size_t MAX_CACHED_BYTES = 32 * 1024 * 1024;
+  static const size_t MAX_CACHED_PACKETS = 512;
+  static const unsigned int MAX_POOLED_SUBSAMPLES = 32;
+  static const size_t MAX_CACHED_CRYPTO_INFOS = 64; ///< per number of subsamples
+
+  static size_t GetClassSize(unsigned int sizeClass);
+  static unsigned int GetClass(size_t size);
+
+  uint8_t* AllocateBuffer(size_t size, unsigned int &sizeClass, size_t &capacity);
+  void FreeBuffer(uint8_t* buffer, unsigned int sizeClass, size_t capacity);
+  DemuxCryptoInfo* AllocateCryptoInfo(unsigned int numSubSamples);
+  void FreeCryptoInfo(DemuxCryptoInfo* info);
+  void AddBytesInUse(size_t bytes);
+
+  struct BufferClass
+  {
+    CCriticalSection section;
+    std::vector<uint8_t*> buffers;
+  };
+  BufferClass m_classes[NUM_CLASSES];
+
+  CCriticalSection m_packetSection;
+  std::vector<Packet*> m_packets;
+
+  CCriticalSection m_cryptoSection;
+  std::vector<DemuxCryptoInfo*> m_cryptoInfos[MAX_POOLED_SUBSAMPLES + 1];
+
+  std::atomic<uint64_t> m_allocations{0};
+  std::atomic<uint64_t> m_hits{0};
+  std::atomic<size_t> m_bytesInUse{0};
+  std::atomic<size_t> m_peakBytesInUse{0};
+  std::atomic<size_t> m_bytesCached{0};
+};
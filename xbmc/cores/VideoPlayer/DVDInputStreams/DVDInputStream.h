@@ -185,7 +185,7 @@ public:
   virtual IDisplayTime* GetIDisplayTime() { return nullptr; }
   virtual ITimes* GetITimes() { return nullptr; }
 
-  const CVariant &GetProperty(const std::string key){ return m_item.GetProperty(key); }
+  CVariant GetProperty(const std::string key){ return m_item.GetProperty(key); }
 
 protected:
   DVDStreamType m_streamType;
@@ -13,6 +13,52 @@
 #include "cores/VideoPlayer/Interface/Addon/TimingConstants.h"
 #include "math.h"
 
+CDVDMessageRing::CDVDMessageRing() : m_slots(256), m_head(0), m_size(0)
+{
+}
+
+void CDVDMessageRing::push_front(CDVDMsg* msg, int priority)
+{
+  if (m_size == m_slots.size())
+    Grow();
+
+  m_head = (m_head - 1) & (m_slots.size() - 1);
+  m_size++;
+  front() = DVDMessageListItem(msg, priority);
+}
+
+void CDVDMessageRing::push_back(CDVDMsg* msg, int priority)
+{
+  if (m_size == m_slots.size())
+    Grow();
+
+  m_size++;
+  back() = DVDMessageListItem(msg, priority);
+}
+
+void CDVDMessageRing::insert(size_t index, CDVDMsg* msg, int priority)
+{
+  // the priority lane is short, shifting the items in front is cheap
+  push_front(msg, priority);
+  for (size_t i = 0; i < index; i++)
+    std::swap((*this)[i], (*this)[i + 1]);
+}
+
+void CDVDMessageRing::pop_back()
+{
+  back() = DVDMessageListItem();
+  m_size--;
+}
+
+void CDVDMessageRing::Grow()
+{
+  std::vector<DVDMessageListItem> slots(m_slots.size() * 2);
+  for (size_t i = 0; i < m_size; i++)
+    slots[i] = std::move((*this)[i]);
+  m_slots.swap(slots);
+  m_head = 0;
+}
+
 CDVDMessageQueue::CDVDMessageQueue(const std::string &owner) : m_hEvent(true), m_owner(owner)
 {
   m_iDataSize     = 0;
@@ -114,11 +160,10 @@ MsgQueueReturnCode CDVDMessageQueue::Put(CDVDMsg* pMsg, int priority, bool front
     if (!front)
       prio++;
 
-    auto it = std::find_if(m_prioMessages.begin(), m_prioMessages.end(),
-                           [prio](const DVDMessageListItem &item){
-                             return prio <= item.priority;
-                           });
-    m_prioMessages.emplace(it, pMsg, priority);
+    size_t index = 0;
+    while (index < m_prioMessages.size() && prio > m_prioMessages[index].priority)
+      index++;
+    m_prioMessages.insert(index, pMsg, priority);
   }
   else
   {
@@ -130,9 +175,9 @@ MsgQueueReturnCode CDVDMessageQueue::Put(CDVDMsg* pMsg, int priority, bool front
     }
 
     if (front)
-      m_messages.emplace_front(pMsg, priority);
+      m_messages.push_front(pMsg, priority);
     else
-      m_messages.emplace_back(pMsg, priority);
+      m_messages.push_back(pMsg, priority);
   }
 
   if (pMsg->IsType(CDVDMsg::DEMUXER_PACKET) && priority == 0)
@@ -150,8 +195,9 @@ MsgQueueReturnCode CDVDMessageQueue::Put(CDVDMsg* pMsg, int priority, bool front
 
   pMsg->Release();
 
-  // inform waiter for new packet
-  m_hEvent.Set();
+  // inform waiter for new packet, nobody needs to be woken up otherwise
+  if (m_waiting)
+    m_hEvent.Set();
 
   return MSGQ_OK;
 }
@@ -172,7 +218,7 @@ MsgQueueReturnCode CDVDMessageQueue::Get(CDVDMsg** pMsg, unsigned int iTimeoutIn
 
   while (!m_bAbortRequest)
   {
-    std::list<DVDMessageListItem> &msgs = (priority > 0 || !m_prioMessages.empty()) ? m_prioMessages : m_messages;
+    CDVDMessageRing &msgs = (priority > 0 || !m_prioMessages.empty()) ? m_prioMessages : m_messages;
 
     if (!msgs.empty() && (msgs.back().priority >= priority || m_drain))
     {
@@ -202,13 +248,16 @@ MsgQueueReturnCode CDVDMessageQueue::Get(CDVDMsg** pMsg, unsigned int iTimeoutIn
     else
     {
       m_hEvent.Reset();
+      m_waiting++;
       lock.Leave();
 
       // wait for a new message
-      if (!m_hEvent.WaitMSec(iTimeoutInMilliSeconds))
-        return MSGQ_TIMEOUT;
+      bool signaled = m_hEvent.WaitMSec(iTimeoutInMilliSeconds);
 
       lock.Enter();
+      m_waiting--;
+      if (!signaled)
+        return MSGQ_TIMEOUT;
     }
   }
 
@@ -270,14 +319,14 @@ unsigned CDVDMessageQueue::GetPacketCount(CDVDMsg::Message type)
     return 0;
 
   unsigned count = 0;
-  for (const auto &item : m_messages)
+  for (size_t i = 0; i < m_messages.size(); i++)
   {
-    if(item.message->IsType(type))
+    if(m_messages[i].message->IsType(type))
       count++;
   }
-  for (const auto &item : m_prioMessages)
+  for (size_t i = 0; i < m_prioMessages.size(); i++)
   {
-    if(item.message->IsType(type))
+    if(m_prioMessages[i].message->IsType(type))
       count++;
   }
 
@@ -13,6 +13,7 @@
 #include <string>
 #include <list>
 #include <algorithm>
+#include <vector>
 #include "threads/CriticalSection.h"
 #include "threads/Event.h"
 
@@ -29,6 +30,12 @@ struct DVDMessageListItem
     priority = 0;
   }
   DVDMessageListItem(const DVDMessageListItem&) = delete;
+  DVDMessageListItem(DVDMessageListItem&& other)
+  {
+    message = other.message;
+    priority = other.priority;
+    other.message = NULL;
+  }
  ~DVDMessageListItem()
   {
     if(message)
@@ -36,6 +43,18 @@ struct DVDMessageListItem
   }
 
   DVDMessageListItem& operator=(const DVDMessageListItem&) = delete;
+  DVDMessageListItem& operator=(DVDMessageListItem&& other)
+  {
+    if (this != &other)
+    {
+      if (message)
+        message->Release();
+      message = other.message;
+      priority = other.priority;
+      other.message = NULL;
+    }
+    return *this;
+  }
 
   CDVDMsg* message;
   int priority;
@@ -53,6 +72,56 @@ enum MsgQueueReturnCode
 
 #define MSGQ_IS_ERROR(c)    (c < 0)
 
+/*!
+ \brief Circular buffer of message slots
+
+ Replaces a std::list of messages without allocating per message: the slots are
+ only allocated when the buffer has to grow, and it never shrinks. Index 0 is
+ the front (the last message put), the back is the next message to get.
+ */
+class CDVDMessageRing
+{
+public:
+  CDVDMessageRing();
+
+  bool empty() const { return m_size == 0; }
+  size_t size() const { return m_size; }
+
+  DVDMessageListItem& operator[](size_t index) { return m_slots[(m_head + index) & (m_slots.size() - 1)]; }
+  const DVDMessageListItem& operator[](size_t index) const { return m_slots[(m_head + index) & (m_slots.size() - 1)]; }
+  DVDMessageListItem& front() { return (*this)[0]; }
+  DVDMessageListItem& back() { return (*this)[m_size - 1]; }
+
+  void push_front(CDVDMsg* msg, int priority);
+  void push_back(CDVDMsg* msg, int priority);
+  void insert(size_t index, CDVDMsg* msg, int priority);
+  void pop_back();
+
+  template<typename Predicate>
+  void remove_if(Predicate pred)
+  {
+    size_t kept = 0;
+    for (size_t i = 0; i < m_size; i++)
+    {
+      if (pred((*this)[i]))
+        continue;
+      if (kept != i)
+        (*this)[kept] = std::move((*this)[i]);
+      kept++;
+    }
+    for (size_t i = kept; i < m_size; i++)
+      (*this)[i] = DVDMessageListItem();
+    m_size = kept;
+  }
+
+private:
+  void Grow();
+
+  std::vector<DVDMessageListItem> m_slots; ///< size is a power of two
+  size_t m_head; ///< slot of the front
+  size_t m_size;
+};
+
 class CDVDMessageQueue
 {
 public:
@@ -104,6 +173,7 @@ private:
 
   CEvent m_hEvent;
   mutable CCriticalSection m_section;
+  int m_waiting = 0; ///< number of Get calls waiting for a message
 
   std::atomic<bool> m_bAbortRequest;
   bool m_bInitialized;
@@ -117,7 +187,7 @@ private:
   int m_iMaxDataSize;
   std::string m_owner;
 
-  std::list<DVDMessageListItem> m_messages;
-  std::list<DVDMessageListItem> m_prioMessages;
+  CDVDMessageRing m_messages;
+  CDVDMessageRing m_prioMessages;
 };
 
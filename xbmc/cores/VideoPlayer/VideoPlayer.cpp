@@ -2540,6 +2540,9 @@ void CVideoPlayer::OnExit()
 
   m_messenger.End();
 
+  // all packets are freed, give back the memory kept for reuse
+  CDVDDemuxUtils::TrimPacketPool();
+
   if (m_omxplayer_mode)
   {
     m_OmxPlayerState.av_clock.OMXStop();
@@ -0,0 +1,248 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "DVDMessageQueue.h"
+#include "DVDDemuxers/DVDDemuxUtils.h"
+#include "threads/IRunnable.h"
+#include "threads/test/TestHelpers.h"
+#include "utils/TimeUtils.h"
+
+#include <algorithm>
+#include <stdio.h>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+namespace
+{
+
+CDVDMsgDemuxerPacket* CreatePacket(int size, int streamId, double dts)
+{
+  DemuxPacket* packet = CDVDDemuxUtils::AllocateDemuxPacket(size);
+  packet->iSize = size;
+  packet->iStreamId = streamId;
+  packet->dts = dts;
+  return new CDVDMsgDemuxerPacket(packet);
+}
+
+int GetStreamId(CDVDMsg* msg)
+{
+  return static_cast<CDVDMsgDemuxerPacket*>(msg)->GetPacket()->iStreamId;
+}
+
+double GetDts(CDVDMsg* msg)
+{
+  return static_cast<CDVDMsgDemuxerPacket*>(msg)->GetPacket()->dts;
+}
+
+const int PRODUCERS = 4;
+const int PACKETS_PER_PRODUCER = 20000;
+
+class CProducer : public IRunnable
+{
+public:
+  CProducer(CDVDMessageQueue& queue, int id, std::vector<int64_t>& putTimes)
+    : m_queue(queue), m_id(id), m_putTimes(putTimes)
+  {
+  }
+
+  void Run() override
+  {
+    for (int i = 0; i < PACKETS_PER_PRODUCER; i++)
+    {
+      // the queue lock orders this store before the consumer reads it
+      m_putTimes[i] = CurrentHostCounter();
+      m_queue.Put(CreatePacket(188, m_id, i));
+      if (i % 1000 == 0)
+        SleepMillis(1);
+    }
+  }
+
+private:
+  CDVDMessageQueue& m_queue;
+  int m_id;
+  std::vector<int64_t>& m_putTimes;
+};
+
+// Puts the packets of PRODUCERS threads and checks each producer's packets
+// come out in order. Returns the Put to Get latency of every packet.
+std::vector<int64_t> RunProducers(CDVDMessageQueue& queue)
+{
+  std::vector<std::vector<int64_t>> putTimes(PRODUCERS, std::vector<int64_t>(PACKETS_PER_PRODUCER));
+  std::vector<CProducer*> producers;
+  std::vector<thread*> threads;
+  for (int i = 0; i < PRODUCERS; i++)
+  {
+    producers.push_back(new CProducer(queue, i, putTimes[i]));
+    threads.push_back(new thread(*producers.back()));
+  }
+
+  std::vector<int64_t> latencies;
+  latencies.reserve(PRODUCERS * PACKETS_PER_PRODUCER);
+  std::vector<double> lastDts(PRODUCERS, -1);
+  while (latencies.size() < static_cast<size_t>(PRODUCERS * PACKETS_PER_PRODUCER))
+  {
+    CDVDMsg* msg;
+    EXPECT_EQ(MSGQ_OK, queue.Get(&msg, 5000));
+    if (!msg)
+      break;
+    int64_t now = CurrentHostCounter();
+
+    // every producer's packets come out in the order they were put
+    int id = GetStreamId(msg);
+    double dts = GetDts(msg);
+    EXPECT_EQ(lastDts[id] + 1, dts);
+    lastDts[id] = dts;
+
+    latencies.push_back(now - putTimes[id][static_cast<int>(dts)]);
+    msg->Release();
+  }
+
+  for (size_t i = 0; i < threads.size(); i++)
+  {
+    EXPECT_TRUE(threads[i]->timed_join(10000));
+    delete threads[i];
+    delete producers[i];
+  }
+
+  return latencies;
+}
+
+} // unnamed namespace
+
+TEST(TestDVDMessageQueue, Order)
+{
+  CDVDMessageQueue queue("test");
+  queue.Init();
+
+  queue.Put(CreatePacket(10, 0, 1));
+  queue.Put(CreatePacket(20, 0, 2));
+  queue.PutBack(CreatePacket(30, 0, 0));
+  EXPECT_EQ(60, queue.GetDataSize());
+
+  CDVDMsg* msg;
+  for (int i = 0; i < 3; i++)
+  {
+    ASSERT_EQ(MSGQ_OK, queue.Get(&msg, 0));
+    EXPECT_EQ(i, GetDts(msg));
+    msg->Release();
+  }
+  EXPECT_EQ(0, queue.GetDataSize());
+  EXPECT_EQ(MSGQ_TIMEOUT, queue.Get(&msg, 0));
+  EXPECT_EQ(nullptr, msg);
+
+  queue.End();
+}
+
+TEST(TestDVDMessageQueue, Priority)
+{
+  CDVDMessageQueue queue("test");
+  queue.Init();
+
+  queue.Put(CreatePacket(10, 0, 0));
+  queue.Put(new CDVDMsgInt(CDVDMsg::GENERAL_PAUSE, 1), 1);
+  queue.Put(new CDVDMsgInt(CDVDMsg::GENERAL_PAUSE, 2), 2);
+  queue.PutBack(new CDVDMsgInt(CDVDMsg::GENERAL_PAUSE, 3), 1);
+
+  CDVDMsg* msg;
+  int priority = 0;
+  const int expected[] = { 2, 3, 1 };
+  for (int value : expected)
+  {
+    priority = 0;
+    ASSERT_EQ(MSGQ_OK, queue.Get(&msg, 0, priority));
+    ASSERT_TRUE(msg->IsType(CDVDMsg::GENERAL_PAUSE));
+    EXPECT_EQ(value, static_cast<CDVDMsgInt*>(msg)->m_value);
+    msg->Release();
+  }
+
+  // only the priority lane is looked at when asking for a minimum priority
+  priority = 1;
+  EXPECT_EQ(MSGQ_TIMEOUT, queue.Get(&msg, 0, priority));
+
+  priority = 0;
+  ASSERT_EQ(MSGQ_OK, queue.Get(&msg, 0, priority));
+  EXPECT_TRUE(msg->IsType(CDVDMsg::DEMUXER_PACKET));
+  msg->Release();
+
+  queue.End();
+}
+
+TEST(TestDVDMessageQueue, FlushByType)
+{
+  CDVDMessageQueue queue("test");
+  queue.Init();
+
+  // more than fit the initial slots, so the ring has to grow and wrap
+  for (int i = 0; i < 1000; i++)
+  {
+    if (i % 3 == 0)
+      queue.Put(new CDVDMsg(CDVDMsg::GENERAL_RESYNC));
+    else
+      queue.Put(CreatePacket(1, 0, i));
+  }
+  EXPECT_EQ(334u, queue.GetPacketCount(CDVDMsg::GENERAL_RESYNC));
+  EXPECT_EQ(666u, queue.GetPacketCount(CDVDMsg::DEMUXER_PACKET));
+
+  queue.Flush(CDVDMsg::DEMUXER_PACKET);
+  EXPECT_EQ(0, queue.GetDataSize());
+  EXPECT_EQ(0u, queue.GetPacketCount(CDVDMsg::DEMUXER_PACKET));
+  EXPECT_EQ(334u, queue.GetPacketCount(CDVDMsg::GENERAL_RESYNC));
+
+  CDVDMsg* msg;
+  for (int i = 0; i < 334; i++)
+  {
+    ASSERT_EQ(MSGQ_OK, queue.Get(&msg, 0));
+    EXPECT_TRUE(msg->IsType(CDVDMsg::GENERAL_RESYNC));
+    msg->Release();
+  }
+  EXPECT_EQ(MSGQ_TIMEOUT, queue.Get(&msg, 0));
+
+  queue.End();
+}
+
+TEST(TestDVDMessageQueue, Abort)
+{
+  CDVDMessageQueue queue("test");
+  queue.Init();
+  queue.Abort();
+
+  CDVDMsg* msg;
+  EXPECT_EQ(MSGQ_ABORT, queue.Get(&msg, 1000));
+
+  queue.End();
+}
+
+TEST(TestDVDMessageQueue, MultipleProducers)
+{
+  CDVDMessageQueue queue("test");
+  queue.Init();
+
+  EXPECT_EQ(static_cast<size_t>(PRODUCERS * PACKETS_PER_PRODUCER), RunProducers(queue).size());
+  EXPECT_EQ(0, queue.GetDataSize());
+
+  queue.End();
+}
+
+// Put to Get latency, run with --gtest_also_run_disabled_tests
+TEST(TestDVDMessageQueue, DISABLED_Latency)
+{
+  CDVDMessageQueue queue("test");
+  queue.Init();
+
+  std::vector<int64_t> latencies = RunProducers(queue);
+  ASSERT_FALSE(latencies.empty());
+
+  std::sort(latencies.begin(), latencies.end());
+  double usPerTick = 1000000.0 / CurrentHostFrequency();
+  printf("Put to Get latency over %d messages: median %.1f us, 99%% %.1f us, max %.1f us\n",
+         static_cast<int>(latencies.size()), latencies[latencies.size() / 2] * usPerTick,
+         latencies[latencies.size() * 99 / 100] * usPerTick, latencies.back() * usPerTick);
+
+  queue.End();
+}
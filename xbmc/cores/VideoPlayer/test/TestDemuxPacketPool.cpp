@@ -0,0 +1,158 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "DVDDemuxers/DemuxPacketPool.h"
+#include "Interface/Addon/DemuxCrypto.h"
+#include "Interface/Addon/DemuxPacket.h"
+
+#include <memory>
+
+#include <gtest/gtest.h>
+
+class TestDemuxPacketPool : public testing::Test
+{
+protected:
+  TestDemuxPacketPool() : m_pool(CDemuxPacketPool::GetInstance())
+  {
+    // start without anything cached by earlier tests
+    m_pool.Trim();
+    m_start = m_pool.GetStats();
+  }
+
+  ~TestDemuxPacketPool() override
+  {
+    m_pool.Trim();
+  }
+
+  //! size of the data buffer a packet of the given size gets
+  size_t GetCapacity(size_t size)
+  {
+    size_t inUse = m_pool.GetStats().bytesInUse;
+    DemuxPacket* packet = m_pool.Allocate(size, 0);
+    size_t capacity = m_pool.GetStats().bytesInUse - inUse;
+    m_pool.Free(packet);
+    return capacity;
+  }
+
+  uint64_t GetHits()
+  {
+    return m_pool.GetStats().hits - m_start.hits;
+  }
+
+  CDemuxPacketPool& m_pool;
+  CDemuxPacketPool::Stats m_start;
+};
+
+TEST_F(TestDemuxPacketPool, SizeClasses)
+{
+  EXPECT_EQ(256u, GetCapacity(1));
+  EXPECT_EQ(256u, GetCapacity(256));
+  EXPECT_EQ(384u, GetCapacity(257));
+  EXPECT_EQ(384u, GetCapacity(384));
+  EXPECT_EQ(512u, GetCapacity(385));
+  EXPECT_EQ(768u, GetCapacity(600));
+  EXPECT_EQ(1536u, GetCapacity(1500));
+  EXPECT_EQ(4u * 1024 * 1024, GetCapacity(3 * 1024 * 1024 + 1));
+
+  // larger buffers are allocated as requested
+  EXPECT_EQ(5u * 1024 * 1024, GetCapacity(5 * 1024 * 1024));
+}
+
+TEST_F(TestDemuxPacketPool, BuffersAreReused)
+{
+  DemuxPacket* packet = m_pool.Allocate(300, 0);
+  ASSERT_TRUE(packet);
+  ASSERT_TRUE(packet->pData);
+  uint8_t* data = packet->pData;
+  m_pool.Free(packet);
+  EXPECT_EQ(384u, m_pool.GetStats().bytesCached);
+
+  // any size of the same class
+  packet = m_pool.Allocate(384, 0);
+  EXPECT_EQ(data, packet->pData);
+  EXPECT_EQ(1u, GetHits());
+  EXPECT_EQ(0u, m_pool.GetStats().bytesCached);
+
+  // but not of another one
+  DemuxPacket* other = m_pool.Allocate(385, 0);
+  EXPECT_EQ(1u, GetHits());
+
+  m_pool.Free(packet);
+  m_pool.Free(other);
+  EXPECT_EQ(384u + 512u, m_pool.GetStats().bytesCached);
+  EXPECT_EQ(m_start.bytesInUse, m_pool.GetStats().bytesInUse);
+  EXPECT_EQ(3u, m_pool.GetStats().allocations - m_start.allocations);
+}
+
+TEST_F(TestDemuxPacketPool, FreedPacketsAreReset)
+{
+  DemuxPacket* packet = m_pool.Allocate(1000, 0);
+  packet->iSize = 1000;
+  packet->iStreamId = 1;
+  packet->pts = 1.0;
+  m_pool.Free(packet);
+
+  packet = m_pool.Allocate(0, 0);
+  EXPECT_EQ(nullptr, packet->pData);
+  EXPECT_EQ(0, packet->iSize);
+  EXPECT_EQ(-1, packet->iStreamId);
+  EXPECT_EQ(DVD_NOPTS_VALUE, packet->pts);
+  EXPECT_FALSE(packet->cryptoInfo);
+  m_pool.Free(packet);
+}
+
+TEST_F(TestDemuxPacketPool, LargeBuffersAreNotCached)
+{
+  DemuxPacket* packet = m_pool.Allocate(5 * 1024 * 1024, 0);
+  ASSERT_TRUE(packet);
+  m_pool.Free(packet);
+  EXPECT_EQ(0u, m_pool.GetStats().bytesCached);
+
+  packet = m_pool.Allocate(5 * 1024 * 1024, 0);
+  EXPECT_EQ(0u, GetHits());
+  m_pool.Free(packet);
+}
+
+TEST_F(TestDemuxPacketPool, CryptoInfoIsRecycled)
+{
+  DemuxPacket* packet = m_pool.Allocate(0, 4);
+  ASSERT_TRUE(packet->cryptoInfo);
+  EXPECT_EQ(4u, packet->cryptoInfo->numSubSamples);
+  DemuxCryptoInfo* info = packet->cryptoInfo.get();
+  info->flags = 1;
+  m_pool.Free(packet);
+
+  // returned by the deleter, for the same number of subsamples only
+  packet = m_pool.Allocate(0, 2);
+  EXPECT_NE(info, packet->cryptoInfo.get());
+  EXPECT_EQ(2u, packet->cryptoInfo->numSubSamples);
+  m_pool.Free(packet);
+
+  packet = m_pool.Allocate(0, 4);
+  EXPECT_EQ(info, packet->cryptoInfo.get());
+  EXPECT_EQ(0u, packet->cryptoInfo->flags);
+  m_pool.Free(packet);
+}
+
+TEST_F(TestDemuxPacketPool, SharedCryptoInfoIsKept)
+{
+  DemuxPacket* packet = m_pool.Allocate(0, 4);
+  std::shared_ptr<DemuxCryptoInfo> info = packet->cryptoInfo;
+  m_pool.Free(packet);
+
+  // still referenced, e.g. by a decoder
+  packet = m_pool.Allocate(0, 4);
+  EXPECT_NE(info.get(), packet->cryptoInfo.get());
+  m_pool.Free(packet);
+
+  DemuxCryptoInfo* released = info.get();
+  info.reset();
+  packet = m_pool.Allocate(0, 4);
+  EXPECT_EQ(released, packet->cryptoInfo.get());
+  m_pool.Free(packet);
+}
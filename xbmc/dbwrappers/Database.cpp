@@ -19,6 +19,8 @@
 #include "DbUrl.h"
 #include "ServiceBroker.h"
 
+#include <algorithm>
+
 #if defined(HAS_MYSQL) || defined(HAS_MARIADB)
 #include "mysqldataset.h"
 #endif
@@ -598,12 +600,41 @@ void CDatabase::Close()
 
   if (NULL == m_pDB.get() ) return ;
   if (NULL != m_pDS.get()) m_pDS->close();
+  LogQueryStats();
   m_pDB->disconnect();
   m_pDB.reset();
   m_pDS.reset();
   m_pDS2.reset();
 }
 
+void CDatabase::LogQueryStats() const
+{
+  const QueryStats &stats = m_pDB->get_query_stats();
+  if (stats.empty() || !CLog::IsLogLevelLogged(LOGDEBUG))
+    return;
+
+  std::vector<QueryStats::const_iterator> slowest;
+  int64_t total = 0;
+  for (QueryStats::const_iterator it = stats.begin(); it != stats.end(); ++it)
+  {
+    slowest.push_back(it);
+    total += it->second.total_us;
+  }
+
+  CLog::Log(LOGDEBUG, LOGDATABASE, "%s - %s: %u statement cache hits, %u misses, %.1f ms spent in parameterized queries",
+            __FUNCTION__, GetBaseDBName(), m_pDB->get_statement_hits(), m_pDB->get_statement_misses(), total / 1000.0);
+
+  const size_t count = std::min<size_t>(slowest.size(), 5);
+  std::partial_sort(slowest.begin(), slowest.begin() + count, slowest.end(),
+                    [](QueryStats::const_iterator a, QueryStats::const_iterator b) { return a->second.total_us > b->second.total_us; });
+  for (size_t i = 0; i < count; i++)
+  {
+    const query_stat &stat = slowest[i]->second;
+    CLog::Log(LOGDEBUG, LOGDATABASE, "%s - %u calls, %.1f ms total, %.1f ms max: %s", __FUNCTION__,
+              stat.count, stat.total_us / 1000.0, stat.max_us / 1000.0, slowest[i]->first.c_str());
+  }
+}
+
 bool CDatabase::Compress(bool bForce /* =true */)
 {
   if (!m_sqlite)
@@ -101,9 +101,9 @@ public:
 
   bool Open(const DatabaseSettings &db);
 
-  void BeginTransaction();
+  virtual void BeginTransaction();
   virtual bool CommitTransaction();
-  void RollbackTransaction();
+  virtual void RollbackTransaction();
   bool InTransaction();
   void CopyDB(const std::string& latestDb);
   void DropAnalytics();
@@ -249,6 +249,10 @@ private:
   void InitSettings(DatabaseSettings &dbSettings);
   void UpdateVersionNumber();
 
+  /*! \brief Log the hit rate of the statement cache and the most expensive parameterized queries
+   */
+  void LogQueryStats() const;
+
   bool m_bMultiWrite; /*!< True if there are any queries in the queue, false otherwise */
   unsigned int m_openCount;
 
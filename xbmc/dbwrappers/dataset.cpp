@@ -66,6 +66,38 @@ std::string Database::prepare(const char *format, ...)
   return result;
 }
 
+void Database::add_query_stat(const std::string &sql, int64_t duration_us)
+{
+  // statistics are kept per sql, don't let queries with inlined values fill them up
+  static const size_t MAX_QUERY_STATS = 1000;
+
+  QueryStats::iterator it = query_stats.find(sql);
+  if (it == query_stats.end())
+  {
+    if (query_stats.size() >= MAX_QUERY_STATS)
+      return;
+    it = query_stats.insert(std::make_pair(sql, query_stat())).first;
+  }
+  it->second.count++;
+  it->second.total_us += duration_us;
+  it->second.max_us = std::max(it->second.max_us, duration_us);
+}
+
+//************* QueryTimer implementation ***************
+
+QueryTimer::QueryTimer(Database *db, const std::string &sql):
+  db(db),
+  sql(sql),
+  start(std::chrono::steady_clock::now())
+{
+}
+
+QueryTimer::~QueryTimer()
+{
+  if (db)
+    db->add_query_stat(sql, std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start).count());
+}
+
 //************* Dataset implementation ***************
 
 Dataset::Dataset():
@@ -186,6 +218,69 @@ void Dataset::parse_sql(std::string &sql) {
 }
 
 
+std::string Dataset::bind_params(const std::string &sql, const StmtParams &params) {
+  std::string result;
+  result.reserve(sql.size());
+  size_t param = 0;
+  char quote = 0;
+  for (char c : sql)
+  {
+    if (quote)
+    {
+      if (c == quote)
+        quote = 0;
+    }
+    else if (c == '\'' || c == '"' || c == '`')
+      quote = c;
+    else if (c == '?')
+    {
+      if (param >= params.size())
+        throw DbErrors("Missing parameter %u for query: %s", (unsigned int)param + 1, sql.c_str());
+
+      const field_value &value = params[param++];
+      if (value.get_isNull())
+        result += "NULL";
+      else
+      {
+        switch (value.get_fType())
+        {
+        case ft_Boolean:
+        case ft_Short:
+        case ft_UShort:
+        case ft_Int:
+        case ft_UInt:
+        case ft_Int64:
+          result += std::to_string(value.get_asInt64());
+          break;
+        case ft_Float:
+        case ft_Double:
+          result += db->prepare("%.17g", value.get_asDouble());
+          break;
+        default:
+          result += db->prepare("'%s'", value.get_asString().c_str());
+          break;
+        }
+      }
+      continue;
+    }
+    result += c;
+  }
+  if (param != params.size())
+    throw DbErrors("Too many parameters for query: %s", sql.c_str());
+  return result;
+}
+
+bool Dataset::query_prepared(const std::string &sql, const StmtParams &params) {
+  QueryTimer timer(db, sql);
+  return query(bind_params(sql, params));
+}
+
+int Dataset::exec_prepared(const std::string &sql, const StmtParams &params) {
+  QueryTimer timer(db, sql);
+  return exec(bind_params(sql, params));
+}
+
+
 void Dataset::close(void) {
   haveError  = false;
   frecno = 0;
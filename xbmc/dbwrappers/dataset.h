@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <chrono>
 #include <cstdio>
 #include <list>
 #include <map>
@@ -40,6 +41,17 @@ class Dataset;		// forward declaration of class Dataset
 #define DB_UNEXPECTED		7	// This shouldn't ever happen
 #define DB_UNEXPECTED_RESULT   -1       //For integer functions
 
+typedef std::vector<field_value> StmtParams;
+
+/* time spent in a parameterized query, see Dataset::query_prepared */
+struct query_stat
+{
+  unsigned int count = 0;
+  int64_t total_us = 0;
+  int64_t max_us = 0;
+};
+typedef std::map<std::string, query_stat> QueryStats;
+
 /******************* Class Database definition ********************
 
    represents  connection with database server;
@@ -149,6 +161,31 @@ public:
 
   virtual bool in_transaction() {return false;};
 
+/* statistics of parameterized queries */
+  void add_query_stat(const std::string &sql, int64_t duration_us);
+  const QueryStats &get_query_stats() const { return query_stats; }
+/* number of parameterized queries that used/compiled a cached statement */
+  uint64_t get_statement_hits() const { return statement_hits; }
+  uint64_t get_statement_misses() const { return statement_misses; }
+
+protected:
+  QueryStats query_stats;
+  uint64_t statement_hits = 0;
+  uint64_t statement_misses = 0;
+};
+
+
+
+/* measures a parameterized query and adds it to the statistics of the database */
+class QueryTimer {
+public:
+  QueryTimer(Database *db, const std::string &sql);
+  ~QueryTimer();
+
+private:
+  Database *db;
+  const std::string &sql;
+  std::chrono::steady_clock::time_point start;
 };
 
 
@@ -244,6 +281,9 @@ protected:
 /* Parse Sql - replacing fields with prefixes :OLD_ and :NEW_ with current values of OLD or NEW field. */
   void parse_sql(std::string &sql);
 
+/* Replace each '?' placeholder in sql with the escaped value of the next parameter */
+  std::string bind_params(const std::string &sql, const StmtParams &params);
+
 /* Returns old field value (for :OLD) */
   virtual const field_value f_old(const char *f);
 
@@ -292,6 +332,11 @@ public:
   virtual const void* getExecRes()=0;
 /* as open, but with our query exec Sql */
   virtual bool query(const std::string &sql) = 0;
+/* Parameterized versions of query and exec, each '?' in sql is bound to the next
+   value of params. Drivers may keep the compiled statement for the next call with
+   the same sql, the default implementation binds the values into the sql text. */
+  virtual bool query_prepared(const std::string &sql, const StmtParams &params);
+  virtual int exec_prepared(const std::string &sql, const StmtParams &params);
 /* Close SQL Query*/
   virtual void close();
 /* This function looks for field Field_name with value equal Field_value
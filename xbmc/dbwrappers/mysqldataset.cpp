@@ -10,6 +10,8 @@
 #include <string>
 #include <set>
 #include <algorithm>
+#include <type_traits>
+#include <vector>
 
 #include "utils/log.h"
 #include "network/WakeOnAccess.h"
@@ -38,6 +40,7 @@ MysqlDatabase::MysqlDatabase() {
 
   active = false;
   _in_transaction = false;     // for transaction
+  max_statements = 200;
 
   error = "Unknown database error";//S_NO_CONNECTION;
   host = "localhost";
@@ -245,6 +248,7 @@ int MysqlDatabase::connect(bool create_new) {
 void MysqlDatabase::disconnect(void) {
   if (conn != NULL)
   {
+    clear_statements();
     mysql_close(conn);
     conn = NULL;
   }
@@ -446,6 +450,92 @@ int MysqlDatabase::query_with_reconnect(const char* query) {
   return result;
 }
 
+MYSQL_STMT *MysqlDatabase::get_statement(const std::string &sql) {
+  if (!active) throw DbErrors("No Database Connection");
+
+  std::unordered_map<std::string, StatementList::iterator>::iterator it = statement_index.find(sql);
+  if (it != statement_index.end())
+  {
+    statement_hits++;
+    statements.splice(statements.begin(), statements, it->second);
+    return it->second->second;
+  }
+
+  statement_misses++;
+  MYSQL_STMT *stmt = mysql_stmt_init(conn);
+  if (stmt == NULL)
+    throw DbErrors("Can't allocate statement for query: %s", sql.c_str());
+
+  // the server is asked for the error, so the caller can reconnect if it's gone
+  if (mysql_stmt_prepare(stmt, sql.c_str(), sql.size()) != MYSQL_OK)
+  {
+    last_err = mysql_stmt_errno(stmt);
+    mysql_stmt_close(stmt);
+    return NULL;
+  }
+
+  statements.push_front(std::make_pair(sql, stmt));
+  statement_index[sql] = statements.begin();
+
+  // the new statement is at the front, so it's never evicted here
+  while (statements.size() > max_statements)
+  {
+    mysql_stmt_close(statements.back().second);
+    statement_index.erase(statements.back().first);
+    statements.pop_back();
+  }
+  return stmt;
+}
+
+MYSQL_STMT *MysqlDatabase::execute_statement(const std::string &sql, MYSQL_BIND *params, unsigned int count) {
+  int attempts = 5;
+  int result;
+
+  while (true)
+  {
+    MYSQL_STMT *stmt = get_statement(sql);
+    if (stmt == NULL)
+      result = last_err;
+    else
+    {
+      if (mysql_stmt_param_count(stmt) != count)
+        throw DbErrors("Expected %lu parameters for query: %s", (unsigned long)mysql_stmt_param_count(stmt), sql.c_str());
+
+      if ((count == 0 || mysql_stmt_bind_param(stmt, params) == 0) && mysql_stmt_execute(stmt) == MYSQL_OK)
+        return stmt;
+      result = mysql_stmt_errno(stmt);
+    }
+
+    if ((result != CR_SERVER_GONE_ERROR && result != CR_SERVER_LOST) || attempts-- <= 0)
+      break;
+
+    // reconnecting drops the prepared statements, they're prepared again on the new connection
+    CLog::Log(LOGINFO,"MYSQL server has gone. Will try %d more attempt(s) to reconnect.", attempts);
+    active = false;
+    connect(true);
+  }
+
+  setErr(result, sql.c_str());
+  throw DbErrors(getErrorMsg());
+}
+
+void MysqlDatabase::set_statement_cache_size(size_t size) {
+  max_statements = std::max<size_t>(size, 1);
+  while (statements.size() > max_statements)
+  {
+    mysql_stmt_close(statements.back().second);
+    statement_index.erase(statements.back().first);
+    statements.pop_back();
+  }
+}
+
+void MysqlDatabase::clear_statements() {
+  for (StatementList::iterator i = statements.begin(); i != statements.end(); ++i)
+    mysql_stmt_close(i->second);
+  statements.clear();
+  statement_index.clear();
+}
+
 long MysqlDatabase::nextid(const char* sname) {
   CLog::Log(LOGDEBUG,"MysqlDatabase::nextid for %s",sname);
   if (!active) return DB_UNEXPECTED_RESULT;
@@ -501,7 +591,9 @@ void MysqlDatabase::start_transaction() {
 void MysqlDatabase::commit_transaction() {
   if (active)
   {
-    mysql_commit(conn);
+    // a failed commit leaves the transaction open, the caller has to roll it back
+    if (mysql_commit(conn) != 0)
+      throw DbErrors("Can't commit transaction: '%s' (%d)", mysql_error(conn), mysql_errno(conn));
     mysql_autocommit(conn, true);
     CLog::Log(LOGDEBUG,"Mysql commit transaction");
     _in_transaction = false;
@@ -1482,6 +1574,139 @@ static size_t ci_find(const std::string& where, const std::string& what)
     return loc - where.begin();
 }
 
+// converts a column value returned as text by the server, value is NULL for SQL NULL
+static void convert_field(field_value &v, enum_field_types type, const char *value)
+{
+  switch (type)
+  {
+    case MYSQL_TYPE_LONGLONG:
+    case MYSQL_TYPE_DECIMAL:
+    case MYSQL_TYPE_NEWDECIMAL:
+    case MYSQL_TYPE_TINY:
+    case MYSQL_TYPE_SHORT:
+    case MYSQL_TYPE_INT24:
+    case MYSQL_TYPE_LONG:
+      if (value != NULL)
+      {
+        v.set_asInt(atoi(value));
+      }
+      else
+      {
+        v.set_asInt(0);
+      }
+      break;
+    case MYSQL_TYPE_FLOAT:
+    case MYSQL_TYPE_DOUBLE:
+      if (value != NULL)
+      {
+        v.set_asDouble(atof(value));
+      }
+      else
+      {
+        v.set_asDouble(0);
+      }
+      break;
+    case MYSQL_TYPE_STRING:
+    case MYSQL_TYPE_VAR_STRING:
+    case MYSQL_TYPE_VARCHAR:
+      if (value != NULL) v.set_asString(value);
+      break;
+    case MYSQL_TYPE_TINY_BLOB:
+    case MYSQL_TYPE_MEDIUM_BLOB:
+    case MYSQL_TYPE_LONG_BLOB:
+    case MYSQL_TYPE_BLOB:
+      if (value != NULL) v.set_asString(value);
+      break;
+    case MYSQL_TYPE_NULL:
+    default:
+      CLog::Log(LOGDEBUG,"MYSQL: Unknown field type: %u", type);
+      v.set_asString("");
+      v.set_isNull();
+      break;
+  }
+}
+
+// the values bound to the parameters of a prepared statement, kept alive until it's executed
+class StatementParams
+{
+public:
+  explicit StatementParams(const StmtParams &params)
+    : m_binds(params.size()), m_ints(params.size()), m_doubles(params.size()),
+      m_strings(params.size()), m_lengths(params.size())
+  {
+    for (size_t i = 0; i < params.size(); i++)
+    {
+      const field_value &value = params[i];
+      MYSQL_BIND &bind = m_binds[i];
+      if (value.get_isNull())
+      {
+        bind.buffer_type = MYSQL_TYPE_NULL;
+        continue;
+      }
+
+      switch (value.get_fType())
+      {
+      case ft_Boolean:
+      case ft_Short:
+      case ft_UShort:
+      case ft_Int:
+      case ft_UInt:
+      case ft_Int64:
+        m_ints[i] = value.get_asInt64();
+        bind.buffer_type = MYSQL_TYPE_LONGLONG;
+        bind.buffer = &m_ints[i];
+        break;
+      case ft_Float:
+      case ft_Double:
+        m_doubles[i] = value.get_asDouble();
+        bind.buffer_type = MYSQL_TYPE_DOUBLE;
+        bind.buffer = &m_doubles[i];
+        break;
+      default:
+        m_strings[i] = value.get_asString();
+        m_lengths[i] = m_strings[i].size();
+        bind.buffer_type = MYSQL_TYPE_STRING;
+        bind.buffer = const_cast<char*>(m_strings[i].c_str());
+        bind.buffer_length = m_lengths[i];
+        bind.length = &m_lengths[i];
+        break;
+      }
+    }
+  }
+
+  MYSQL_BIND *data() { return m_binds.empty() ? NULL : &m_binds[0]; }
+  unsigned int size() const { return m_binds.size(); }
+
+private:
+  std::vector<MYSQL_BIND> m_binds;
+  std::vector<long long> m_ints;
+  std::vector<double> m_doubles;
+  std::vector<std::string> m_strings;
+  std::vector<unsigned long> m_lengths;
+};
+
+// frees the result set of a cached statement once it's read, so the connection is ready for the next query
+class StatementResult
+{
+public:
+  explicit StatementResult(MYSQL_STMT *stmt) : m_stmt(stmt), m_meta(mysql_stmt_result_metadata(stmt)) {}
+  ~StatementResult()
+  {
+    if (m_meta != NULL)
+      mysql_free_result(m_meta);
+    mysql_stmt_free_result(m_stmt);
+  }
+
+  MYSQL_RES *meta() const { return m_meta; }
+
+private:
+  MYSQL_STMT *m_stmt;
+  MYSQL_RES *m_meta;
+};
+
+// is_null and error of MYSQL_BIND are my_bool in older clients and bool in MySQL 8
+typedef std::remove_pointer<decltype(MYSQL_BIND::is_null)>::type bind_bool;
+
 int MysqlDataset::exec(const std::string &sql) {
   if (!handle()) throw DbErrors("No Database Connection");
   std::string qry = sql;
@@ -1571,66 +1796,132 @@ bool MysqlDataset::query(const std::string &query) {
   { // have a row of data
     sql_record *res = new sql_record;
     res->resize(numColumns);
+    for (unsigned int i = 0; i < numColumns; i++)
+      convert_field(res->at(i), fields[i].type, row[i]);
+    result.records.push_back(res);
+  }
+  mysql_free_result(stmt);
+  active = true;
+  ds_state = dsSelect;
+  this->first();
+  return true;
+}
+
+bool MysqlDataset::query_prepared(const std::string &sql, const StmtParams &params) {
+  if (!handle()) throw DbErrors("No Database Connection");
+  QueryTimer timer(db, sql);
+
+  close();
+
+  std::string qry = sql;
+  size_t loc;
+
+  // mysql doesn't understand CAST(foo as integer) => change to CAST(foo as signed integer)
+  while ((loc = ci_find(qry, "as integer)")) != std::string::npos)
+    qry = qry.insert(loc + 3, "signed ");
+
+  StatementParams binds(params);
+  MYSQL_STMT *stmt = static_cast<MysqlDatabase*>(db)->execute_statement(qry, binds.data(), binds.size());
+  StatementResult res(stmt);
+  if (res.meta() == NULL)
+    throw DbErrors("Missing result set!");
+
+  if (mysql_stmt_store_result(stmt) != MYSQL_OK)
+  {
+    db->setErr(mysql_stmt_errno(stmt), qry.c_str());
+    throw DbErrors(db->getErrorMsg());
+  }
+
+  // column headers
+  const unsigned int numColumns = mysql_num_fields(res.meta());
+  MYSQL_FIELD *fields = mysql_fetch_fields(res.meta());
+  result.record_header.resize(numColumns);
+  for (unsigned int i = 0; i < numColumns; i++)
+    result.record_header[i].name = fields[i].name;
+
+  // every column is fetched as text and converted the same way as in query()
+  std::vector<MYSQL_BIND> columns(numColumns);
+  std::vector<std::vector<char> > buffers(numColumns, std::vector<char>(256));
+  std::vector<unsigned long> lengths(numColumns);
+  std::vector<bind_bool> nulls(numColumns);
+  for (unsigned int i = 0; i < numColumns; i++)
+  {
+    columns[i].buffer_type = MYSQL_TYPE_STRING;
+    columns[i].buffer = buffers[i].data();
+    columns[i].buffer_length = buffers[i].size();
+    columns[i].length = &lengths[i];
+    columns[i].is_null = &nulls[i];
+  }
+  if (numColumns > 0 && mysql_stmt_bind_result(stmt, columns.data()) != 0)
+  {
+    db->setErr(mysql_stmt_errno(stmt), qry.c_str());
+    throw DbErrors(db->getErrorMsg());
+  }
+
+  // returned rows
+  int rc;
+  while ((rc = mysql_stmt_fetch(stmt)) == MYSQL_OK || rc == MYSQL_DATA_TRUNCATED)
+  {
+    sql_record *row = new sql_record;
+    row->resize(numColumns);
+    result.records.push_back(row);
+
+    bool rebind = false;
     for (unsigned int i = 0; i < numColumns; i++)
     {
-      field_value &v = res->at(i);
-      switch (fields[i].type)
+      if (nulls[i])
       {
-        case MYSQL_TYPE_LONGLONG:
-        case MYSQL_TYPE_DECIMAL:
-        case MYSQL_TYPE_NEWDECIMAL:
-        case MYSQL_TYPE_TINY:
-        case MYSQL_TYPE_SHORT:
-        case MYSQL_TYPE_INT24:
-        case MYSQL_TYPE_LONG:
-          if (row[i] != NULL)
-          {
-            v.set_asInt(atoi(row[i]));
-          }
-          else
-          {
-            v.set_asInt(0);
-          }
-          break;
-        case MYSQL_TYPE_FLOAT:
-        case MYSQL_TYPE_DOUBLE:
-          if (row[i] != NULL)
-          {
-            v.set_asDouble(atof(row[i]));
-          }
-          else
-          {
-            v.set_asDouble(0);
-          }
-          break;
-        case MYSQL_TYPE_STRING:
-        case MYSQL_TYPE_VAR_STRING:
-        case MYSQL_TYPE_VARCHAR:
-          if (row[i] != NULL) v.set_asString((const char *)row[i] );
-          break;
-        case MYSQL_TYPE_TINY_BLOB:
-        case MYSQL_TYPE_MEDIUM_BLOB:
-        case MYSQL_TYPE_LONG_BLOB:
-        case MYSQL_TYPE_BLOB:
-          if (row[i] != NULL) v.set_asString((const char *)row[i]);
-          break;
-        case MYSQL_TYPE_NULL:
-        default:
-          CLog::Log(LOGDEBUG,"MYSQL: Unknown field type: %u", fields[i].type);
-          v.set_asString("");
-          v.set_isNull();
-          break;
+        convert_field(row->at(i), fields[i].type, NULL);
+        continue;
       }
+
+      if (lengths[i] > buffers[i].size())
+      {
+        // the value didn't fit, fetch it again into a buffer that's large enough
+        buffers[i].resize(lengths[i]);
+        columns[i].buffer = buffers[i].data();
+        columns[i].buffer_length = buffers[i].size();
+        if (mysql_stmt_fetch_column(stmt, &columns[i], i, 0) != 0)
+        {
+          db->setErr(mysql_stmt_errno(stmt), qry.c_str());
+          throw DbErrors(db->getErrorMsg());
+        }
+        rebind = true;
+      }
+      convert_field(row->at(i), fields[i].type, std::string(buffers[i].data(), lengths[i]).c_str());
+    }
+
+    if (rebind && mysql_stmt_bind_result(stmt, columns.data()) != 0)
+    {
+      db->setErr(mysql_stmt_errno(stmt), qry.c_str());
+      throw DbErrors(db->getErrorMsg());
     }
-    result.records.push_back(res);
   }
-  mysql_free_result(stmt);
+  if (rc != MYSQL_NO_DATA)
+  {
+    db->setErr(mysql_stmt_errno(stmt), qry.c_str());
+    throw DbErrors(db->getErrorMsg());
+  }
+
   active = true;
   ds_state = dsSelect;
   this->first();
   return true;
 }
 
+int MysqlDataset::exec_prepared(const std::string &sql, const StmtParams &params) {
+  if (!handle()) throw DbErrors("No Database Connection");
+  QueryTimer timer(db, sql);
+
+  exec_res.clear();
+
+  StatementParams binds(params);
+  MYSQL_STMT *stmt = static_cast<MysqlDatabase*>(db)->execute_statement(sql, binds.data(), binds.size());
+  // discards any rows, so the statement can be executed again
+  StatementResult res(stmt);
+  return MYSQL_OK;
+}
+
 void MysqlDataset::open(const std::string &sql) {
    set_select_sql(sql);
    open();
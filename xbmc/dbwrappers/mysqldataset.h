@@ -8,7 +8,9 @@
 
 #pragma once
 
+#include <list>
 #include <stdio.h>
+#include <unordered_map>
 #include "dataset.h"
 #ifdef HAS_MYSQL
 #include "mysql/mysql.h"
@@ -29,6 +31,13 @@ protected:
   bool _in_transaction;
   int last_err;
 
+/* server-side prepared statements of parameterized queries, most recently used first */
+  typedef std::list<std::pair<std::string, MYSQL_STMT*>> StatementList;
+  StatementList statements;
+  std::unordered_map<std::string, StatementList::iterator> statement_index;
+  size_t max_statements;
+
+  void clear_statements();
 
 public:
 /* default constructor */
@@ -78,6 +87,14 @@ public:
   int query_with_reconnect(const char* query);
   void configure_connection();
 
+/* returns the prepared statement for sql, preparing and caching it on the server if needed */
+  MYSQL_STMT *get_statement(const std::string &sql);
+/* binds params to the prepared statement for sql and executes it, reconnecting if the server is gone */
+  MYSQL_STMT *execute_statement(const std::string &sql, MYSQL_BIND *params, unsigned int count);
+/* sets the number of prepared statements kept for reuse */
+  void set_statement_cache_size(size_t size);
+  size_t get_cached_statements() const { return statements.size(); }
+
 private:
 
   typedef struct StrAccum StrAccum;
@@ -141,6 +158,9 @@ or insert() operations default = false) */
   const void* getExecRes() override;
 /* as open, but with our query exec Sql */
   bool query(const std::string &query) override;
+/* parameterized queries using the prepared statements of the database */
+  bool query_prepared(const std::string &sql, const StmtParams &params) override;
+  int exec_prepared(const std::string &sql, const StmtParams &params) override;
 /* func. closes a query */
   void close(void) override;
 /* Cancel changes, made in insert or edit states of dataset */
@@ -10,6 +10,7 @@
  *  See LICENSES/README.md for more information.
  */
 
+#include <algorithm>
 #include <iostream>
 #include <string>
 
@@ -66,12 +67,109 @@ static int busy_callback(void*, int busyCount)
   return 1;
 }
 
+// read all rows of a statement into a result set, returns the result of the last step
+static int read_rows(sqlite3_stmt *stmt, result_set &result)
+{
+  // column headers
+  const unsigned int numColumns = sqlite3_column_count(stmt);
+  result.record_header.resize(numColumns);
+  for (unsigned int i = 0; i < numColumns; i++)
+    result.record_header[i].name = sqlite3_column_name(stmt, i);
+
+  // returned rows
+  int rc;
+  while ((rc = sqlite3_step(stmt)) == SQLITE_ROW)
+  { // have a row of data
+    sql_record *res = new sql_record;
+    res->resize(numColumns);
+    for (unsigned int i = 0; i < numColumns; i++)
+    {
+      field_value &v = res->at(i);
+      switch (sqlite3_column_type(stmt, i))
+      {
+      case SQLITE_INTEGER:
+        v.set_asInt64(sqlite3_column_int64(stmt, i));
+        break;
+      case SQLITE_FLOAT:
+        v.set_asDouble(sqlite3_column_double(stmt, i));
+        break;
+      case SQLITE_TEXT:
+        v.set_asString((const char *)sqlite3_column_text(stmt, i));
+        break;
+      case SQLITE_BLOB:
+        v.set_asString((const char *)sqlite3_column_text(stmt, i));
+        break;
+      case SQLITE_NULL:
+      default:
+        v.set_asString("");
+        v.set_isNull();
+        break;
+      }
+    }
+    result.records.push_back(res);
+  }
+  return rc;
+}
+
+static int bind_param(sqlite3_stmt *stmt, int index, const field_value &value)
+{
+  if (value.get_isNull())
+    return sqlite3_bind_null(stmt, index);
+
+  switch (value.get_fType())
+  {
+  case ft_Boolean:
+  case ft_Short:
+  case ft_UShort:
+  case ft_Int:
+  case ft_UInt:
+  case ft_Int64:
+    return sqlite3_bind_int64(stmt, index, value.get_asInt64());
+  case ft_Float:
+  case ft_Double:
+    return sqlite3_bind_double(stmt, index, value.get_asDouble());
+  default:
+  {
+    const std::string str = value.get_asString();
+    return sqlite3_bind_text(stmt, index, str.c_str(), str.size(), SQLITE_TRANSIENT);
+  }
+  }
+}
+
+static void bind_statement(Database *db, sqlite3_stmt *stmt, const std::string &sql, const StmtParams &params)
+{
+  if (sqlite3_bind_parameter_count(stmt) != (int)params.size())
+    throw DbErrors("Expected %d parameters for query: %s", sqlite3_bind_parameter_count(stmt), sql.c_str());
+
+  for (size_t i = 0; i < params.size(); i++)
+  {
+    if (db->setErr(bind_param(stmt, i + 1, params[i]), sql.c_str()) != SQLITE_OK)
+      throw DbErrors(db->getErrorMsg());
+  }
+}
+
+// resets a cached statement once it's no longer used, so it doesn't keep the database locked
+class StatementReset
+{
+public:
+  explicit StatementReset(sqlite3_stmt *stmt) : m_stmt(stmt) {}
+  ~StatementReset()
+  {
+    sqlite3_reset(m_stmt);
+    sqlite3_clear_bindings(m_stmt);
+  }
+
+private:
+  sqlite3_stmt *m_stmt;
+};
+
 //************* SqliteDatabase implementation ***************
 
 SqliteDatabase::SqliteDatabase() {
 
   active = false;
   _in_transaction = false;    // for transaction
+  max_statements = 200;
 
   error = "Unknown database error";//S_NO_CONNECTION;
   host = "localhost";
@@ -251,10 +349,57 @@ bool SqliteDatabase::exists(void)
 
 void SqliteDatabase::disconnect(void) {
   if (active == false) return;
+  clear_statements();
   sqlite3_close(conn);
   active = false;
 }
 
+sqlite3_stmt *SqliteDatabase::get_statement(const std::string &sql) {
+  if (!active) throw DbErrors("No Database Connection");
+
+  std::unordered_map<std::string, StatementList::iterator>::iterator it = statement_index.find(sql);
+  if (it != statement_index.end())
+  {
+    statement_hits++;
+    statements.splice(statements.begin(), statements, it->second);
+    return it->second->second;
+  }
+
+  statement_misses++;
+  sqlite3_stmt *stmt = NULL;
+  if (setErr(sqlite3_prepare_v2(conn, sql.c_str(), -1, &stmt, NULL), sql.c_str()) != SQLITE_OK)
+    throw DbErrors(getErrorMsg());
+
+  statements.push_front(std::make_pair(sql, stmt));
+  statement_index[sql] = statements.begin();
+
+  // the new statement is at the front, so it's never evicted here
+  while (statements.size() > max_statements)
+  {
+    sqlite3_finalize(statements.back().second);
+    statement_index.erase(statements.back().first);
+    statements.pop_back();
+  }
+  return stmt;
+}
+
+void SqliteDatabase::set_statement_cache_size(size_t size) {
+  max_statements = std::max<size_t>(size, 1);
+  while (statements.size() > max_statements)
+  {
+    sqlite3_finalize(statements.back().second);
+    statement_index.erase(statements.back().first);
+    statements.pop_back();
+  }
+}
+
+void SqliteDatabase::clear_statements() {
+  for (StatementList::iterator i = statements.begin(); i != statements.end(); ++i)
+    sqlite3_finalize(i->second);
+  statements.clear();
+  statement_index.clear();
+}
+
 int SqliteDatabase::create() {
   return connect(true);
 }
@@ -393,7 +538,9 @@ void SqliteDatabase::start_transaction() {
 
 void SqliteDatabase::commit_transaction() {
   if (active) {
-    sqlite3_exec(conn,"commit",NULL,NULL,NULL);
+    // a failed commit leaves the transaction open, the caller has to roll it back
+    if (setErr(sqlite3_exec(conn,"commit",NULL,NULL,NULL),"commit") != SQLITE_OK)
+      throw DbErrors(getErrorMsg());
     _in_transaction = false;
   }
 }
@@ -678,43 +825,7 @@ bool SqliteDataset::query(const std::string &query) {
   if (db->setErr(sqlite3_prepare_v2(handle(),query.c_str(),-1,&stmt, NULL),query.c_str()) != SQLITE_OK)
     throw DbErrors(db->getErrorMsg());
 
-  // column headers
-  const unsigned int numColumns = sqlite3_column_count(stmt);
-  result.record_header.resize(numColumns);
-  for (unsigned int i = 0; i < numColumns; i++)
-    result.record_header[i].name = sqlite3_column_name(stmt, i);
-
-  // returned rows
-  while (sqlite3_step(stmt) == SQLITE_ROW)
-  { // have a row of data
-    sql_record *res = new sql_record;
-    res->resize(numColumns);
-    for (unsigned int i = 0; i < numColumns; i++)
-    {
-      field_value &v = res->at(i);
-      switch (sqlite3_column_type(stmt, i))
-      {
-      case SQLITE_INTEGER:
-        v.set_asInt64(sqlite3_column_int64(stmt, i));
-        break;
-      case SQLITE_FLOAT:
-        v.set_asDouble(sqlite3_column_double(stmt, i));
-        break;
-      case SQLITE_TEXT:
-        v.set_asString((const char *)sqlite3_column_text(stmt, i));
-        break;
-      case SQLITE_BLOB:
-        v.set_asString((const char *)sqlite3_column_text(stmt, i));
-        break;
-      case SQLITE_NULL:
-      default:
-        v.set_asString("");
-        v.set_isNull();
-        break;
-      }
-    }
-    result.records.push_back(res);
-  }
+  read_rows(stmt, result);
   if (db->setErr(sqlite3_finalize(stmt),query.c_str()) == SQLITE_OK)
   {
     active = true;
@@ -728,6 +839,50 @@ bool SqliteDataset::query(const std::string &query) {
   }
 }
 
+bool SqliteDataset::query_prepared(const std::string &sql, const StmtParams &params) {
+  if (!handle()) throw DbErrors("No Database Connection");
+  QueryTimer timer(db, sql);
+
+  close();
+
+  sqlite3_stmt *stmt = static_cast<SqliteDatabase*>(db)->get_statement(sql);
+  StatementReset reset(stmt);
+  bind_statement(db, stmt, sql, params);
+
+  int rc = read_rows(stmt, result);
+  if (rc != SQLITE_DONE)
+  {
+    db->setErr(rc, sql.c_str());
+    throw DbErrors(db->getErrorMsg());
+  }
+
+  active = true;
+  ds_state = dsSelect;
+  this->first();
+  return true;
+}
+
+int SqliteDataset::exec_prepared(const std::string &sql, const StmtParams &params) {
+  if (!handle()) throw DbErrors("No Database Connection");
+  QueryTimer timer(db, sql);
+
+  exec_res.clear();
+
+  sqlite3_stmt *stmt = static_cast<SqliteDatabase*>(db)->get_statement(sql);
+  StatementReset reset(stmt);
+  bind_statement(db, stmt, sql, params);
+
+  int rc;
+  while ((rc = sqlite3_step(stmt)) == SQLITE_ROW)
+    ;
+  if (rc != SQLITE_DONE)
+  {
+    db->setErr(rc, sql.c_str());
+    throw DbErrors(db->getErrorMsg());
+  }
+  return SQLITE_OK;
+}
+
 void SqliteDataset::open(const std::string &sql) {
   set_select_sql(sql);
   open();
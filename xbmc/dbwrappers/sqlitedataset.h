@@ -12,7 +12,9 @@
 
 #pragma once
 
+#include <list>
 #include <stdio.h>
+#include <unordered_map>
 #include "dataset.h"
 #include <sqlite3.h>
 
@@ -29,6 +31,14 @@ protected:
   bool _in_transaction;
   int last_err;
 
+/* compiled statements of parameterized queries, most recently used first */
+  typedef std::list<std::pair<std::string, sqlite3_stmt*>> StatementList;
+  StatementList statements;
+  std::unordered_map<std::string, StatementList::iterator> statement_index;
+  size_t max_statements;
+
+  void clear_statements();
+
 public:
 /* default constructor */
   SqliteDatabase();
@@ -80,6 +90,11 @@ public:
 
   bool in_transaction() override {return _in_transaction;};
 
+/* returns the compiled statement for sql, compiling and caching it if needed */
+  sqlite3_stmt *get_statement(const std::string &sql);
+/* sets the number of compiled statements kept for reuse */
+  void set_statement_cache_size(size_t size);
+  size_t get_cached_statements() const { return statements.size(); }
 };
 
 
@@ -132,6 +147,9 @@ or insert() operations default = false) */
   const void* getExecRes() override;
 /* as open, but with our query exec Sql */
   bool query(const std::string &query) override;
+/* parameterized queries using the statement cache of the database */
+  bool query_prepared(const std::string &sql, const StmtParams &params) override;
+  int exec_prepared(const std::string &sql, const StmtParams &params) override;
 /* func. closes a query */
   void close(void) override;
 /* Cancel changes, made in insert or edit states of dataset */
@@ -0,0 +1,102 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "dbwrappers/sqlitedataset.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+
+#include <memory>
+
+#include "gtest/gtest.h"
+
+using namespace dbiplus;
+
+namespace
+{
+const char* TEST_DATABASE = "sqlitedataset-test";
+}
+
+class TestSqliteDataset : public testing::Test
+{
+protected:
+  TestSqliteDataset()
+  {
+    m_db.setHostName(CSpecialProtocol::TranslatePath("special://temp/").c_str());
+    m_db.setDatabase(TEST_DATABASE);
+    m_db.connect(true);
+    m_ds.reset(m_db.CreateDataset());
+    m_ds->exec("CREATE TABLE item (id INTEGER PRIMARY KEY, name TEXT, value REAL)");
+  }
+
+  ~TestSqliteDataset() override
+  {
+    m_ds.reset();
+    m_db.disconnect();
+    XFILE::CFile::Delete(std::string("special://temp/") + TEST_DATABASE + ".db");
+  }
+
+  SqliteDatabase m_db;
+  std::unique_ptr<Dataset> m_ds;
+};
+
+TEST_F(TestSqliteDataset, Parameters)
+{
+  const std::string insert = "INSERT INTO item (id, name, value) VALUES (?, ?, ?)";
+  m_ds->exec_prepared(insert, { field_value(1), field_value("it's"), field_value(1.5) });
+  field_value null;
+  null.set_isNull();
+  m_ds->exec_prepared(insert, { field_value(2), null, null });
+
+  ASSERT_TRUE(m_ds->query_prepared("SELECT name, value FROM item WHERE id = ?", { field_value(1) }));
+  ASSERT_EQ(1, m_ds->num_rows());
+  EXPECT_EQ("it's", m_ds->fv(0).get_asString());
+  EXPECT_EQ(1.5, m_ds->fv(1).get_asDouble());
+
+  ASSERT_TRUE(m_ds->query_prepared("SELECT id FROM item WHERE name = ?", { field_value("it's") }));
+  ASSERT_EQ(1, m_ds->num_rows());
+  EXPECT_EQ(1, m_ds->fv(0).get_asInt());
+
+  ASSERT_TRUE(m_ds->query_prepared("SELECT name FROM item WHERE id = ?", { field_value(2) }));
+  ASSERT_EQ(1, m_ds->num_rows());
+  EXPECT_TRUE(m_ds->fv(0).get_isNull());
+  m_ds->close();
+
+  EXPECT_THROW(m_ds->query_prepared("SELECT name FROM item WHERE id = ?", {}), DbErrors);
+}
+
+TEST_F(TestSqliteDataset, StatementCache)
+{
+  const std::string select = "SELECT name FROM item WHERE id = ?";
+  for (int i = 0; i < 3; i++)
+    m_ds->query_prepared(select, { field_value(i) });
+  m_ds->close();
+
+  EXPECT_EQ(1U, m_db.get_statement_misses());
+  EXPECT_EQ(2U, m_db.get_statement_hits());
+  EXPECT_EQ(3U, m_db.get_query_stats().at(select).count);
+
+  // a cached statement doesn't keep the database locked
+  m_ds->exec("DROP TABLE item");
+  EXPECT_THROW(m_ds->query_prepared(select, { field_value(1) }), DbErrors);
+}
+
+TEST_F(TestSqliteDataset, StatementCacheEviction)
+{
+  m_db.set_statement_cache_size(2);
+  m_ds->query_prepared("SELECT id FROM item WHERE id = ?", { field_value(1) });
+  m_ds->query_prepared("SELECT name FROM item WHERE id = ?", { field_value(1) });
+  m_ds->query_prepared("SELECT value FROM item WHERE id = ?", { field_value(1) });
+  EXPECT_EQ(2U, m_db.get_cached_statements());
+
+  // least recently used was evicted
+  m_ds->query_prepared("SELECT value FROM item WHERE id = ?", { field_value(1) });
+  EXPECT_EQ(1U, m_db.get_statement_hits());
+  m_ds->query_prepared("SELECT id FROM item WHERE id = ?", { field_value(1) });
+  EXPECT_EQ(4U, m_db.get_statement_misses());
+  m_ds->close();
+}
@@ -46,6 +46,31 @@ void CCacheStrategy::ClearEndOfInput()
   m_bEndOfInput = false;
 }
 
+char* CCacheStrategy::GetWriteSpan(size_t iRequestSize, size_t& iSpanSize)
+{
+  iSpanSize = 0;
+  return nullptr;
+}
+
+void CCacheStrategy::CommitWrite(size_t iSize)
+{
+}
+
+const char* CCacheStrategy::GetReadSpan(size_t& iSpanSize)
+{
+  iSpanSize = 0;
+  return nullptr;
+}
+
+void CCacheStrategy::CommitRead(size_t iSize)
+{
+}
+
+int CCacheStrategy::FillFromStore(size_t iMaxSize)
+{
+  return 0;
+}
+
 CSimpleFileCache::CSimpleFileCache()
   : m_cacheFileRead(new CacheLocalFile())
   , m_cacheFileWrite(new CacheLocalFile())
@@ -309,6 +334,31 @@ int64_t CDoubleCache::WaitForData(unsigned int iMinAvail, unsigned int iMillis)
   return m_pCache->WaitForData(iMinAvail, iMillis);
 }
 
+char* CDoubleCache::GetWriteSpan(size_t iRequestSize, size_t& iSpanSize)
+{
+  return m_pCache->GetWriteSpan(iRequestSize, iSpanSize);
+}
+
+void CDoubleCache::CommitWrite(size_t iSize)
+{
+  m_pCache->CommitWrite(iSize);
+}
+
+const char* CDoubleCache::GetReadSpan(size_t& iSpanSize)
+{
+  return m_pCache->GetReadSpan(iSpanSize);
+}
+
+void CDoubleCache::CommitRead(size_t iSize)
+{
+  m_pCache->CommitRead(iSize);
+}
+
+int CDoubleCache::FillFromStore(size_t iMaxSize)
+{
+  return m_pCache->FillFromStore(iMaxSize);
+}
+
 int64_t CDoubleCache::Seek(int64_t iFilePosition)
 {
   /* Check whether position is NOT in our current cache but IS in our old cache.
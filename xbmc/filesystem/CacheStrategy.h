@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <stdint.h>
 #include <string>
 #include "threads/Event.h"
@@ -33,6 +34,44 @@ public:
   virtual int ReadFromCache(char *pBuffer, size_t iMaxSize) = 0;
   virtual int64_t WaitForData(unsigned int iMinAvail, unsigned int iMillis) = 0;
 
+  /*!
+   \brief Get a contiguous region of the cache that can be filled directly
+   \param iRequestSize maximum number of bytes the caller wants to write
+   \param iSpanSize [out] number of bytes writable at the returned address
+   \return pointer to writable cache memory, or nullptr if the strategy does not
+           support direct writes (use WriteToCache instead)
+   \sa CommitWrite
+   */
+  virtual char* GetWriteSpan(size_t iRequestSize, size_t& iSpanSize);
+
+  /*!
+   \brief Publish data written into the span returned by GetWriteSpan
+   \param iSize number of bytes actually written, must not exceed the span size
+   */
+  virtual void CommitWrite(size_t iSize);
+
+  /*!
+   \brief Get a contiguous region of cached data at the current read position
+   \param iSpanSize [out] number of bytes readable at the returned address
+   \return pointer to cached data, or nullptr if no data is available or the
+           strategy does not support direct reads (use ReadFromCache instead)
+   \sa CommitRead
+   */
+  virtual const char* GetReadSpan(size_t& iSpanSize);
+
+  /*!
+   \brief Consume data read from the span returned by GetReadSpan
+   \param iSize number of bytes consumed, must not exceed the span size
+   */
+  virtual void CommitRead(size_t iSize);
+
+  /*!
+   \brief Fill the cache at its write position from a local copy of the source
+   \param iMaxSize maximum number of bytes to add
+   \return number of bytes added, 0 if the strategy has no local copy of that range
+   */
+  virtual int FillFromStore(size_t iMaxSize);
+
   virtual int64_t Seek(int64_t iFilePosition) = 0;
 
   /*!
@@ -56,7 +95,7 @@ public:
 
   CEvent m_space;
 protected:
-  bool  m_bEndOfInput = false;
+  std::atomic<bool> m_bEndOfInput{false};
 };
 
 /**
@@ -109,6 +148,12 @@ public:
   int ReadFromCache(char *pBuffer, size_t iMaxSize) override;
   int64_t WaitForData(unsigned int iMinAvail, unsigned int iMillis) override;
 
+  char* GetWriteSpan(size_t iRequestSize, size_t& iSpanSize) override;
+  void CommitWrite(size_t iSize) override;
+  const char* GetReadSpan(size_t& iSpanSize) override;
+  void CommitRead(size_t iSize) override;
+  int FillFromStore(size_t iMaxSize) override;
+
   int64_t Seek(int64_t iFilePosition) override;
   bool Reset(int64_t iSourcePosition, bool clearAnyway=true) override;
   void EndOfInput() override;
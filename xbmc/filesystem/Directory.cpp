@@ -29,6 +29,24 @@ using namespace XFILE;
 
 #define TIME_TO_BUSY_DIALOG 500
 
+namespace
+{
+bool ShowHidden(const CDirectory::CHints &hints)
+{
+  //! @todo we shouldn't be checking the gui setting here, callers should use getHidden instead
+  return CServiceBroker::GetSettingsComponent()->GetSettings()->GetBool(CSettings::SETTING_FILELISTS_SHOWHIDDEN) ||
+         (hints.flags & DIR_FLAG_GET_HIDDEN);
+}
+
+// whether an item is left out of the listing, the mask must be set on directory
+bool IsFiltered(const IDirectory &directory, const CFileItem &item, bool showHidden)
+{
+  if (!item.m_bIsFolder && !directory.AllowAll() && !directory.IsAllowed(item.GetURL()))
+    return true;
+  return !showHidden && item.GetProperty("file:hidden").asBoolean();
+}
+}
+
 class CGetDirectory
 {
 private:
@@ -164,8 +182,15 @@ bool CDirectory::GetDirectory(const CURL& url, std::shared_ptr<IDirectory> pDire
       return false;
 
     // check our cache for this path
-    if (g_directoryCache.GetDirectory(realURL.Get(), items, (hints.flags & DIR_FLAG_READ_CACHE) == DIR_FLAG_READ_CACHE))
+    std::shared_ptr<const CFileItemList> cached =
+        g_directoryCache.GetDirectory(realURL.Get(), (hints.flags & DIR_FLAG_READ_CACHE) == DIR_FLAG_READ_CACHE);
+    if (cached)
+    {
+      // the snapshot is shared and immutable, the caller gets its own items
+      // to filter and modify. No cache lock is held while copying.
+      items.Copy(*cached);
       items.SetURL(url);
+    }
     else
     {
       // need to clear the cache (in case the directory fetch fails)
@@ -250,31 +275,15 @@ bool CDirectory::GetDirectory(const CURL& url, std::shared_ptr<IDirectory> pDire
         g_directoryCache.SetDirectory(realURL.Get(), items, pDirectory->GetCacheType(url));
     }
 
-    // now filter for allowed files
-    if (!pDirectory->AllowAll())
+    // now filter for allowed and hidden files
+    pDirectory->SetMask(hints.mask);
+    const bool showHidden = ShowHidden(hints);
+    for (int i = 0; i < items.Size(); ++i)
     {
-      pDirectory->SetMask(hints.mask);
-      for (int i = 0; i < items.Size(); ++i)
+      if (IsFiltered(*pDirectory, *items[i], showHidden))
       {
-        CFileItemPtr item = items[i];
-        if (!item->m_bIsFolder && !pDirectory->IsAllowed(item->GetURL()))
-        {
-          items.Remove(i);
-          i--; // don't confuse loop
-        }
-      }
-    }
-    // filter hidden files
-    //! @todo we shouldn't be checking the gui setting here, callers should use getHidden instead
-    if (!CServiceBroker::GetSettingsComponent()->GetSettings()->GetBool(CSettings::SETTING_FILELISTS_SHOWHIDDEN) && !(hints.flags & DIR_FLAG_GET_HIDDEN))
-    {
-      for (int i = 0; i < items.Size(); ++i)
-      {
-        if (items[i]->GetProperty("file:hidden").asBoolean())
-        {
-          items.Remove(i);
-          i--; // don't confuse loop
-        }
+        items.Remove(i);
+        i--; // don't confuse loop
       }
     }
 
@@ -306,6 +315,57 @@ bool CDirectory::GetDirectory(const CURL& url, std::shared_ptr<IDirectory> pDire
   return false;
 }
 
+std::shared_ptr<const CFileItemList> CDirectory::GetSharedDirectory(const std::string& strPath, const std::string &strMask, int flags)
+{
+  CHints hints;
+  hints.flags = flags;
+  hints.mask = strMask;
+  const CURL url(strPath);
+
+  try
+  {
+    // file directories and path substitution modify the items
+    CURL realURL = URIUtils::SubstitutePath(url);
+    if ((flags & DIR_FLAG_NO_FILE_DIRS) && !(flags & DIR_FLAG_BYPASS_CACHE) && realURL.Get() == url.Get())
+    {
+      std::shared_ptr<const CFileItemList> cached =
+          g_directoryCache.GetDirectory(realURL.Get(), (flags & DIR_FLAG_READ_CACHE) == DIR_FLAG_READ_CACHE);
+      std::unique_ptr<IDirectory> pDirectory(CDirectoryFactory::Create(realURL));
+      if (cached && pDirectory)
+      {
+        pDirectory->SetMask(strMask);
+        const bool showHidden = ShowHidden(hints);
+
+        int i = 0;
+        while (i < cached->Size() && !IsFiltered(*pDirectory, *cached->Get(i), showHidden))
+          i++;
+        if (i == cached->Size())
+          return cached;
+
+        // share the remaining items
+        std::shared_ptr<CFileItemList> filtered = std::make_shared<CFileItemList>();
+        filtered->Copy(*cached, false);
+        for (i = 0; i < cached->Size(); i++)
+        {
+          if (!IsFiltered(*pDirectory, *cached->Get(i), showHidden))
+            filtered->Add(cached->Get(i));
+        }
+        return filtered;
+      }
+    }
+  }
+  XBMCCOMMONS_HANDLE_UNCHECKED
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s - Unhandled exception", __FUNCTION__);
+  }
+
+  std::shared_ptr<CFileItemList> items = std::make_shared<CFileItemList>();
+  if (!GetDirectory(url, *items, hints))
+    return nullptr;
+  return items;
+}
+
 bool CDirectory::Create(const std::string& strPath)
 {
   const CURL pathToUrl(strPath);
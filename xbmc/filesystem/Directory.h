@@ -65,6 +65,17 @@ public:
                            , CFileItemList &items
                            , const CHints &hints);
 
+  /*! \brief Get a listing of a directory that is only read
+   A cached listing is shared with the directory cache instead of being copied,
+   leaving out the items filtered by mask or hidden. Without
+   DIR_FLAG_NO_FILE_DIRS, or for substituted paths, the listing is fetched as
+   by GetDirectory().
+   \return the listing, nullptr on failure. Neither the list nor its items may be modified.
+   */
+  static std::shared_ptr<const CFileItemList> GetSharedDirectory(const std::string& strPath,
+                                                                 const std::string &strMask,
+                                                                 int flags);
+
   static bool Create(const std::string& strPath);
   static bool Exists(const std::string& strPath, bool bUseCache = true);
   static bool Remove(const std::string& strPath);
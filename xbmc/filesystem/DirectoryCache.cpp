@@ -14,69 +14,82 @@
 #include "utils/URIUtils.h"
 #include "utils/StringUtils.h"
 #include "URL.h"
-#include "climits"
 
 #include <algorithm>
+#include <functional>
 
-// Maximum number of directories to keep in our cache
-#define MAX_CACHED_DIRS 50
+// Estimated memory of all cached directories we try to stay below
+#define MAX_CACHED_BYTES (32 * 1024 * 1024)
 
 using namespace XFILE;
 
-CDirectoryCache::CDir::CDir(DIR_CACHE_TYPE cacheType)
+CDirectoryCache::CDir::CDir(DIR_CACHE_TYPE cacheType, std::shared_ptr<CFileItemList> items)
+  : m_Items(std::move(items))
+  , m_cacheType(cacheType)
+  , m_size(0)
 {
-  m_cacheType = cacheType;
-  m_lastAccess = 0;
-  m_Items = new CFileItemList;
-  m_Items->SetIgnoreURLOptions(true);
-  m_Items->SetFastLookup(true);
 }
 
-CDirectoryCache::CDir::~CDir()
+CDirectoryCache::CDirectoryCache(void)
+  : m_bytes(0)
+  , m_maxBytes(MAX_CACHED_BYTES)
+  , m_cacheHits(0)
+  , m_cacheMisses(0)
+  , m_evictions(0)
 {
-  delete m_Items;
 }
 
-void CDirectoryCache::CDir::SetLastAccess(unsigned int &accessCounter)
+CDirectoryCache::~CDirectoryCache(void) = default;
+
+std::string CDirectoryCache::GetStoredPath(const std::string& strPath)
 {
-  m_lastAccess = accessCounter++;
+  // Get rid of any URL options, else the compare may be wrong
+  std::string storedPath = CURL(strPath).GetWithoutOptions();
+  URIUtils::RemoveSlashAtEnd(storedPath);
+  return storedPath;
 }
 
-CDirectoryCache::CDirectoryCache(void)
+size_t CDirectoryCache::EstimateSize(const std::string& strPath, const CFileItemList& items)
 {
-  m_accessCounter = 0;
-#ifdef _DEBUG
-  m_cacheHits = 0;
-  m_cacheMisses = 0;
-#endif
+  size_t size = sizeof(CFileItemList) + strPath.size();
+  for (int i = 0; i < items.Size(); i++)
+  {
+    const CFileItem& item = *items[i];
+    size += sizeof(CFileItem) + item.GetPath().size() + item.GetLabel().size();
+  }
+  return size;
 }
 
-CDirectoryCache::~CDirectoryCache(void) = default;
-
-bool CDirectoryCache::GetDirectory(const std::string& strPath, CFileItemList &items, bool retrieveAll)
+CDirectoryCache::CShard& CDirectoryCache::GetShard(const std::string& storedPath)
 {
-  CSingleLock lock (m_cs);
+  return m_shards[std::hash<std::string>()(storedPath) % NUM_SHARDS];
+}
 
-  // Get rid of any URL options, else the compare may be wrong
-  std::string storedPath = CURL(strPath).GetWithoutOptions();
-  URIUtils::RemoveSlashAtEnd(storedPath);
+std::shared_ptr<CFileItemList> CDirectoryCache::Find(const std::string& storedPath, bool retrieveAll, bool checkCacheType)
+{
+  CShard& shard = GetShard(storedPath);
+  CSingleLock lock(shard.m_cs);
 
-  ciCache i = m_cache.find(storedPath);
-  if (i != m_cache.end())
+  auto i = shard.m_cache.find(storedPath);
+  if (i != shard.m_cache.end())
   {
-    CDir* dir = i->second;
-    if (dir->m_cacheType == XFILE::DIR_CACHE_ALWAYS ||
-       (dir->m_cacheType == XFILE::DIR_CACHE_ONCE && retrieveAll))
+    CDir& dir = i->second->second;
+    if (!checkCacheType ||
+        dir.m_cacheType == XFILE::DIR_CACHE_ALWAYS ||
+       (dir.m_cacheType == XFILE::DIR_CACHE_ONCE && retrieveAll))
     {
-      items.Copy(*dir->m_Items);
-      dir->SetLastAccess(m_accessCounter);
-#ifdef _DEBUG
-      m_cacheHits+=items.Size();
-#endif
-      return true;
+      shard.m_lru.splice(shard.m_lru.begin(), shard.m_lru, i->second);
+      m_cacheHits++;
+      return dir.m_Items;
     }
   }
-  return false;
+  m_cacheMisses++;
+  return nullptr;
+}
+
+std::shared_ptr<const CFileItemList> CDirectoryCache::GetDirectory(const std::string& strPath, bool retrieveAll)
+{
+  return Find(GetStoredPath(strPath), retrieveAll, true);
 }
 
 void CDirectoryCache::SetDirectory(const std::string& strPath, const CFileItemList &items, DIR_CACHE_TYPE cacheType)
@@ -95,20 +108,31 @@ void CDirectoryCache::SetDirectory(const std::string& strPath, const CFileItemLi
   // IDEALLY, any further processing on the item would actually create a new item
   // instead of altering it, but we can't really enforce that in an easy way, so
   // this is the best solution for now.
-  CSingleLock lock (m_cs);
+  std::string storedPath = GetStoredPath(strPath);
 
-  // Get rid of any URL options, else the compare may be wrong
-  std::string storedPath = CURL(strPath).GetWithoutOptions();
-  URIUtils::RemoveSlashAtEnd(storedPath);
+  // copy outside of the lock, the listing can be large
+  std::shared_ptr<CFileItemList> copy = std::make_shared<CFileItemList>();
+  copy->SetIgnoreURLOptions(true);
+  copy->SetFastLookup(true);
+  copy->Copy(items);
 
-  ClearDirectory(storedPath);
+  CDir dir(cacheType, copy);
+  dir.m_size = EstimateSize(storedPath, items);
+
+  {
+    CShard& shard = GetShard(storedPath);
+    CSingleLock lock(shard.m_cs);
 
-  CheckIfFull();
+    auto i = shard.m_cache.find(storedPath);
+    if (i != shard.m_cache.end())
+      Delete(shard, i->second);
 
-  CDir* dir = new CDir(cacheType);
-  dir->m_Items->Copy(items);
-  dir->SetLastAccess(m_accessCounter);
-  m_cache.insert(std::pair<std::string, CDir*>(storedPath, dir));
+    shard.m_lru.emplace_front(storedPath, dir);
+    shard.m_cache[storedPath] = shard.m_lru.begin();
+    m_bytes += dir.m_size;
+  }
+
+  CheckIfFull(storedPath);
 }
 
 void CDirectoryCache::ClearFile(const std::string& strFile)
@@ -121,55 +145,98 @@ void CDirectoryCache::ClearFile(const std::string& strFile)
 
 void CDirectoryCache::ClearDirectory(const std::string& strPath)
 {
-  CSingleLock lock (m_cs);
+  std::string storedPath = GetStoredPath(strPath);
 
-  // Get rid of any URL options, else the compare may be wrong
-  std::string storedPath = CURL(strPath).GetWithoutOptions();
-  URIUtils::RemoveSlashAtEnd(storedPath);
+  CShard& shard = GetShard(storedPath);
+  CSingleLock lock(shard.m_cs);
 
-  iCache i = m_cache.find(storedPath);
-  if (i != m_cache.end())
-    Delete(i);
+  auto i = shard.m_cache.find(storedPath);
+  if (i != shard.m_cache.end())
+    Delete(shard, i->second);
 }
 
 void CDirectoryCache::ClearSubPaths(const std::string& strPath)
 {
-  CSingleLock lock (m_cs);
-
   // Get rid of any URL options, else the compare may be wrong
   std::string storedPath = CURL(strPath).GetWithoutOptions();
 
-  iCache i = m_cache.begin();
-  while (i != m_cache.end())
+  for (CShard& shard : m_shards)
   {
-    if (URIUtils::PathHasParent(i->first, storedPath))
-      Delete(i++);
-    else
-      i++;
+    CSingleLock lock(shard.m_cs);
+
+    auto i = shard.m_lru.begin();
+    while (i != shard.m_lru.end())
+    {
+      if (URIUtils::PathHasParent(i->first, storedPath))
+        Delete(shard, i++);
+      else
+        i++;
+    }
   }
 }
 
 void CDirectoryCache::AddFile(const std::string& strFile)
 {
-  CSingleLock lock (m_cs);
-
   // Get rid of any URL options, else the compare may be wrong
   std::string strPath = URIUtils::GetDirectory(CURL(strFile).GetWithoutOptions());
   URIUtils::RemoveSlashAtEnd(strPath);
 
-  ciCache i = m_cache.find(strPath);
-  if (i != m_cache.end())
+  CShard& shard = GetShard(strPath);
+  CFileItemPtr item(new CFileItem(strFile, false));
+  const size_t added = sizeof(CFileItem) + strFile.size();
+
+  for (;;)
   {
-    CDir *dir = i->second;
-    CFileItemPtr item(new CFileItem(strFile, false));
-    dir->m_Items->Add(item);
-    dir->SetLastAccess(m_accessCounter);
+    std::shared_ptr<const CFileItemList> snapshot;
+    {
+      CSingleLock lock(shard.m_cs);
+
+      auto i = shard.m_cache.find(strPath);
+      if (i == shard.m_cache.end())
+        return;
+
+      // readers only get hold of the listing through the lock, if the cache
+      // holds the only reference it can be modified in place
+      CDir& dir = i->second->second;
+      if (dir.m_Items.use_count() == 1)
+      {
+        dir.m_Items->Add(item);
+        dir.m_size += added;
+        m_bytes += added;
+        shard.m_lru.splice(shard.m_lru.begin(), shard.m_lru, i->second);
+        return;
+      }
+      snapshot = dir.m_Items;
+    }
+
+    // snapshots in use by readers are never modified, replace it with a list
+    // sharing the same items. Built outside of the lock, the listing can be large.
+    std::shared_ptr<CFileItemList> items = std::make_shared<CFileItemList>();
+    items->SetIgnoreURLOptions(true);
+    items->SetFastLookup(true);
+    items->Copy(*snapshot, false);
+    items->Append(*snapshot);
+    items->Add(item);
+
+    CSingleLock lock(shard.m_cs);
+    auto i = shard.m_cache.find(strPath);
+    if (i == shard.m_cache.end())
+      return;
+
+    CDir& dir = i->second->second;
+    if (dir.m_Items != snapshot)
+      continue; // replaced in the meantime, start over
+
+    dir.m_Items = items;
+    dir.m_size += added;
+    m_bytes += added;
+    shard.m_lru.splice(shard.m_lru.begin(), shard.m_lru, i->second);
+    return;
   }
 }
 
 bool CDirectoryCache::FileExists(const std::string& strFile, bool& bInCache)
 {
-  CSingleLock lock (m_cs);
   bInCache = false;
 
   // Get rid of any URL options, else the compare may be wrong
@@ -178,101 +245,95 @@ bool CDirectoryCache::FileExists(const std::string& strFile, bool& bInCache)
   std::string storedPath = URIUtils::GetDirectory(strPath);
   URIUtils::RemoveSlashAtEnd(storedPath);
 
-  ciCache i = m_cache.find(storedPath);
-  if (i != m_cache.end())
+  std::shared_ptr<CFileItemList> items = Find(storedPath, false, false);
+  if (items)
   {
     bInCache = true;
-    CDir *dir = i->second;
-    dir->SetLastAccess(m_accessCounter);
-#ifdef _DEBUG
-    m_cacheHits++;
-#endif
-    return (URIUtils::PathEquals(strPath, storedPath) || dir->m_Items->Contains(strFile));
+    return (URIUtils::PathEquals(strPath, storedPath) || items->Contains(strFile));
   }
-#ifdef _DEBUG
-  m_cacheMisses++;
-#endif
   return false;
 }
 
 void CDirectoryCache::Clear()
 {
   // this routine clears everything
-  CSingleLock lock (m_cs);
+  for (CShard& shard : m_shards)
+  {
+    CSingleLock lock(shard.m_cs);
 
-  iCache i = m_cache.begin();
-  while (i != m_cache.end() )
-    Delete(i++);
+    auto i = shard.m_lru.begin();
+    while (i != shard.m_lru.end())
+      Delete(shard, i++);
+  }
 }
 
-void CDirectoryCache::InitCache(std::set<std::string>& dirs)
+bool CDirectoryCache::EvictOne(CShard& shard, const std::string& keep)
 {
-  std::set<std::string>::iterator it;
-  for (it = dirs.begin(); it != dirs.end(); ++it)
+  CSingleLock lock(shard.m_cs);
+
+  // oldest first. ensure dirs that are always cached aren't cleared
+  for (auto i = shard.m_lru.rbegin(); i != shard.m_lru.rend(); ++i)
   {
-    const std::string& strDir = *it;
-    CFileItemList items;
-    CDirectory::GetDirectory(strDir, items, "", DIR_FLAG_NO_FILE_DIRS);
-    items.Clear();
+    if (i->second.m_cacheType != DIR_CACHE_ALWAYS && i->first != keep)
+    {
+      Delete(shard, std::next(i).base());
+      m_evictions++;
+      return true;
+    }
   }
+  return false;
 }
 
-void CDirectoryCache::ClearCache(std::set<std::string>& dirs)
+void CDirectoryCache::CheckIfFull(const std::string& keep)
 {
-  iCache i = m_cache.begin();
-  while (i != m_cache.end())
+  // evict from the shard that just grew first, then from the others. Shards
+  // are locked one at a time, so eviction is only LRU within a shard.
+  const unsigned int first = &GetShard(keep) - m_shards;
+  unsigned int shard = first;
+  while (m_bytes > m_maxBytes)
   {
-    if (dirs.find(i->first) != dirs.end())
-      Delete(i++);
-    else
-      i++;
+    if (!EvictOne(m_shards[shard], keep))
+    {
+      shard = (shard + 1) % NUM_SHARDS;
+      if (shard == first)
+        break;
+    }
   }
 }
 
-void CDirectoryCache::CheckIfFull()
+void CDirectoryCache::Delete(CShard& shard, LruList::iterator it)
+{
+  m_bytes -= it->second.m_size;
+  shard.m_cache.erase(it->first);
+  shard.m_lru.erase(it);
+}
+
+CDirectoryCache::CStats CDirectoryCache::GetStats() const
 {
-  CSingleLock lock (m_cs);
+  CStats stats;
+  stats.hits = m_cacheHits;
+  stats.misses = m_cacheMisses;
+  stats.evictions = m_evictions;
+  stats.maxBytes = m_maxBytes;
 
-  // find the last accessed folder, and remove if the number of cached folders is too many
-  iCache lastAccessed = m_cache.end();
-  unsigned int numCached = 0;
-  for (iCache i = m_cache.begin(); i != m_cache.end(); i++)
+  for (const CShard& shard : m_shards)
   {
-    // ensure dirs that are always cached aren't cleared
-    if (i->second->m_cacheType != DIR_CACHE_ALWAYS)
+    CSingleLock lock(shard.m_cs);
+    for (const auto& it : shard.m_lru)
     {
-      if (lastAccessed == m_cache.end() || i->second->GetLastAccess() < lastAccessed->second->GetLastAccess())
-        lastAccessed = i;
-      numCached++;
+      stats.items += it.second.m_Items->Size();
+      stats.bytes += it.second.m_size;
+      stats.directories++;
     }
   }
-  if (lastAccessed != m_cache.end() && numCached >= MAX_CACHED_DIRS)
-    Delete(lastAccessed);
+  return stats;
 }
 
-void CDirectoryCache::Delete(iCache it)
-{
-  CDir* dir = it->second;
-  delete dir;
-  m_cache.erase(it);
-}
-
-#ifdef _DEBUG
 void CDirectoryCache::PrintStats() const
 {
-  CSingleLock lock (m_cs);
-  CLog::Log(LOGDEBUG, "%s - total of %u cache hits, and %u cache misses", __FUNCTION__, m_cacheHits, m_cacheMisses);
-  // run through and find the oldest and the number of items cached
-  unsigned int oldest = UINT_MAX;
-  unsigned int numItems = 0;
-  unsigned int numDirs = 0;
-  for (ciCache i = m_cache.begin(); i != m_cache.end(); i++)
-  {
-    CDir *dir = i->second;
-    oldest = std::min(oldest, dir->GetLastAccess());
-    numItems += dir->m_Items->Size();
-    numDirs++;
-  }
-  CLog::Log(LOGDEBUG, "%s - %u folders cached, with %u items total.  Oldest is %u, current is %u", __FUNCTION__, numDirs, numItems, oldest, m_accessCounter);
+  CStats stats = GetStats();
+  CLog::Log(LOGDEBUG, "%s - total of %" PRIu64" cache hits, %" PRIu64" cache misses and %" PRIu64" evictions",
+            __FUNCTION__, stats.hits, stats.misses, stats.evictions);
+  CLog::Log(LOGDEBUG, "%s - %u folders cached, with %u items total, using about %zu of %zu bytes",
+            __FUNCTION__, stats.directories, stats.items, stats.bytes, stats.maxBytes);
 }
-#endif
@@ -11,35 +11,69 @@
 #include "IDirectory.h"
 #include "threads/CriticalSection.h"
 
-#include <map>
-#include <set>
+#include <atomic>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
 
 class CFileItem;
+class CFileItemList;
 
 namespace XFILE
 {
+  /*!
+   \brief In-memory cache of directory listings
+
+   The cache is split into shards, each with its own lock and LRU list, so
+   lookups of unrelated paths don't contend. Listings are stored as snapshots
+   that are shared with callers instead of being copied under the lock, and
+   are only modified in place while no caller holds them. Entries are evicted
+   least recently used first once the estimated memory use of all listings
+   exceeds the budget.
+   */
   class CDirectoryCache
   {
     class CDir
     {
     public:
-      explicit CDir(DIR_CACHE_TYPE cacheType);
-      virtual ~CDir();
-
-      void SetLastAccess(unsigned int &accessCounter);
-      unsigned int GetLastAccess() const { return m_lastAccess; };
+      CDir(DIR_CACHE_TYPE cacheType, std::shared_ptr<CFileItemList> items);
 
-      CFileItemList* m_Items;
+      std::shared_ptr<CFileItemList> m_Items; ///< only modified while no reader holds it, see AddFile
       DIR_CACHE_TYPE m_cacheType;
-    private:
-      CDir(const CDir&) = delete;
-      CDir& operator=(const CDir&) = delete;
-      unsigned int m_lastAccess;
+      size_t m_size; ///< estimated memory use of the listing
     };
+
+    typedef std::list<std::pair<std::string, CDir>> LruList;
+
+    struct CShard
+    {
+      mutable CCriticalSection m_cs;
+      LruList m_lru; ///< most recently used first
+      std::unordered_map<std::string, LruList::iterator> m_cache;
+    };
+
   public:
+    struct CStats
+    {
+      uint64_t hits = 0;
+      uint64_t misses = 0;
+      uint64_t evictions = 0;
+      unsigned int directories = 0;
+      unsigned int items = 0;
+      size_t bytes = 0;
+      size_t maxBytes = 0;
+    };
+
     CDirectoryCache(void);
     virtual ~CDirectoryCache(void);
-    bool GetDirectory(const std::string& strPath, CFileItemList &items, bool retrieveAll = false);
+    /*!
+     \brief Get the cached listing of a directory without copying it
+     \return shared snapshot of the listing, or nullptr if not cached. The items
+             must not be modified.
+     */
+    std::shared_ptr<const CFileItemList> GetDirectory(const std::string& strPath, bool retrieveAll = false);
+
     void SetDirectory(const std::string& strPath, const CFileItemList &items, DIR_CACHE_TYPE cacheType);
     void ClearDirectory(const std::string& strPath);
     void ClearFile(const std::string& strFile);
@@ -47,27 +81,29 @@ namespace XFILE
     void Clear();
     void AddFile(const std::string& strFile);
     bool FileExists(const std::string& strPath, bool& bInCache);
-#ifdef _DEBUG
+
+    CStats GetStats() const;
     void PrintStats() const;
-#endif
+
   protected:
-    void InitCache(std::set<std::string>& dirs);
-    void ClearCache(std::set<std::string>& dirs);
-    void CheckIfFull();
+    static std::string GetStoredPath(const std::string& strPath);
+    static size_t EstimateSize(const std::string& strPath, const CFileItemList& items);
 
-    std::map<std::string, CDir*> m_cache;
-    typedef std::map<std::string, CDir*>::iterator iCache;
-    typedef std::map<std::string, CDir*>::const_iterator ciCache;
-    void Delete(iCache i);
+    CShard& GetShard(const std::string& storedPath);
+    std::shared_ptr<CFileItemList> Find(const std::string& storedPath, bool retrieveAll, bool checkCacheType);
+    void Delete(CShard& shard, LruList::iterator it);
+    bool EvictOne(CShard& shard, const std::string& keep);
+    void CheckIfFull(const std::string& keep);
 
-    mutable CCriticalSection m_cs;
+    static const unsigned int NUM_SHARDS = 16;
+    CShard m_shards[NUM_SHARDS];
 
-    unsigned int m_accessCounter;
+    std::atomic<size_t> m_bytes;
+    size_t m_maxBytes;
 
-#ifdef _DEBUG
-    unsigned int m_cacheHits;
-    unsigned int m_cacheMisses;
-#endif
+    std::atomic<uint64_t> m_cacheHits;
+    std::atomic<uint64_t> m_cacheMisses;
+    std::atomic<uint64_t> m_evictions;
   };
 }
 extern XFILE::CDirectoryCache g_directoryCache;
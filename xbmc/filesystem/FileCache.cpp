@@ -14,8 +14,11 @@
 #include "ServiceBroker.h"
 
 #include "CircularCache.h"
+#include "LockFreeCircularCache.h"
+#include "PersistentCache.h"
 #include "threads/SingleLock.h"
 #include "utils/log.h"
+#include "utils/URIUtils.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/SettingsComponent.h"
 
@@ -203,7 +206,10 @@ bool CFileCache::Open(const CURL& url)
         front /= 2;
         back /= 2;
       }
-      m_pCache = new CCircularCache(front, back);
+      if (CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_cacheLockFree)
+        m_pCache = new CLockFreeCircularCache(front, back);
+      else
+        m_pCache = new CCircularCache(front, back);
       m_forwardCacheSize = front;
     }
 
@@ -212,6 +218,18 @@ bool CFileCache::Open(const CURL& url)
       // If READ_MULTI_STREAM flag is set: Double buffering is required
       m_pCache = new CDoubleCache(m_pCache);
     }
+
+    const auto advancedSettings = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings();
+    struct __stat64 st;
+    if (advancedSettings->m_cachePersistentSize > 0 && m_fileSize > 0 &&
+        m_source.Stat(&st) == 0 && st.st_mtime != 0)
+    {
+      // Keep what we read on disk, so reopening this file can skip the source
+      CPersistentCacheStore::GetInstance().Configure(
+        URIUtils::AddFileToFolder(advancedSettings->m_cachePath, "filecache"),
+        static_cast<uint64_t>(advancedSettings->m_cachePersistentSize) * 1024 * 1024);
+      m_pCache = new CPersistentCache(m_pCache, url.GetWithoutUserDetails(), m_fileSize, st.st_mtime);
+    }
   }
 
   // open cache strategy
@@ -256,6 +274,7 @@ void CFileCache::Process()
   CWriteRate limiter;
   CWriteRate average;
   bool cacheReachEOF = false;
+  bool sourceOutOfSync = false; // source position lags behind data served from the cache store
 
   while (!m_bStop)
   {
@@ -278,6 +297,8 @@ void CFileCache::Process()
           m_seekPossible = m_source.IoControl(IOCTRL_SEEK_POSSIBLE, NULL);
           sourceSeekFailed = true;
         }
+        else
+          sourceOutOfSync = false;
       }
       if (!sourceSeekFailed)
       {
@@ -329,9 +350,37 @@ void CFileCache::Process()
       continue;
     }
 
-    ssize_t iRead = 0;
+    // use a local copy of this range if the strategy keeps one
+    ssize_t iStored = 0;
     if (!cacheReachEOF)
-      iRead = m_source.Read(buffer.get(), maxWrite);
+      iStored = m_pCache->FillFromStore(maxWrite);
+
+    if (iStored > 0)
+      sourceOutOfSync = true;
+    else if (sourceOutOfSync && !cacheReachEOF)
+    {
+      if (m_source.Seek(m_writePos, SEEK_SET) != m_writePos)
+      {
+        CLog::Log(LOGERROR, "CFileCache::Process - Error seeking source to %" PRId64" after reading from cache store", m_writePos);
+        break; // while (!m_bStop)
+      }
+      sourceOutOfSync = false;
+    }
+
+    // fill the cache memory directly if the strategy allows it
+    size_t spanSize = 0;
+    char* span = nullptr;
+    if (!cacheReachEOF && iStored == 0)
+      span = m_pCache->GetWriteSpan(maxWrite, spanSize);
+
+    ssize_t iRead = iStored;
+    if (!cacheReachEOF && iStored == 0)
+    {
+      if (span)
+        iRead = m_source.Read(span, spanSize);
+      else
+        iRead = m_source.Read(buffer.get(), maxWrite);
+    }
     if (iRead == 0)
     {
       // Check for actual EOF and retry as long as we still have data in our cache
@@ -382,6 +431,14 @@ void CFileCache::Process()
     }
 
     int iTotalWrite = 0;
+    if (iStored > 0)
+      iTotalWrite = iRead; // already added by FillFromStore
+    else if (span)
+    {
+      m_pCache->CommitWrite(iRead);
+      iTotalWrite = iRead;
+    }
+
     while (!m_bStop && (iTotalWrite < iRead))
     {
       int iWrite = 0;
@@ -0,0 +1,285 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "LockFreeCircularCache.h"
+#include "threads/SystemClock.h"
+
+#include <algorithm>
+#include <string.h>
+
+using namespace XFILE;
+
+CLockFreeCircularCache::CLockFreeCircularCache(size_t front, size_t back)
+ : CCacheStrategy()
+ , m_beg(0)
+ , m_end(0)
+ , m_cur(0)
+ , m_buf(nullptr)
+ , m_size(front + back)
+ , m_size_back(back)
+#ifdef TARGET_WINDOWS
+ , m_handle(INVALID_HANDLE_VALUE)
+#endif
+{
+}
+
+CLockFreeCircularCache::~CLockFreeCircularCache()
+{
+  Close();
+}
+
+int CLockFreeCircularCache::Open()
+{
+#ifdef TARGET_WINDOWS
+  m_handle = CreateFileMapping(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, 0, m_size, NULL);
+  if(m_handle == NULL)
+    return CACHE_RC_ERROR;
+  m_buf = (uint8_t*)MapViewOfFile(m_handle, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+#else
+  m_buf = new uint8_t[m_size];
+#endif
+  if (m_buf == nullptr)
+    return CACHE_RC_ERROR;
+  m_beg = 0;
+  m_end = 0;
+  m_cur = 0;
+  return CACHE_RC_OK;
+}
+
+void CLockFreeCircularCache::Close()
+{
+#ifdef TARGET_WINDOWS
+  UnmapViewOfFile(m_buf);
+  CloseHandle(m_handle);
+  m_handle = INVALID_HANDLE_VALUE;
+#else
+  delete[] m_buf;
+#endif
+  m_buf = nullptr;
+}
+
+size_t CLockFreeCircularCache::GetWritableSize(int64_t cur) const
+{
+  const int64_t beg = m_beg.load(std::memory_order_relaxed);
+  const int64_t end = m_end.load(std::memory_order_relaxed);
+
+  size_t back  = (size_t)(cur - beg); // Backbuffer size
+  size_t front = (size_t)(end - cur); // Frontbuffer size
+  return m_size - std::min(back, m_size_back) - front;
+}
+
+size_t CLockFreeCircularCache::GetMaxWriteSize(const size_t& iRequestSize)
+{
+  return std::min(iRequestSize, GetWritableSize(m_cur.load()));
+}
+
+/**
+ * Returns the region at m_end % m_size that may be overwritten, limited to the
+ * wrap point of the buffer. Same space rules as CCircularCache::WriteToCache.
+ *
+ * Before handing out the span, m_beg is advanced past the history that is about
+ * to be overwritten. Together with the check in Seek() this guarantees the
+ * consumer never moves its read position into memory the producer is filling,
+ * without either side taking a lock.
+ */
+char* CLockFreeCircularCache::GetWriteSpan(size_t iRequestSize, size_t& iSpanSize)
+{
+  iSpanSize = 0;
+  if (m_buf == nullptr)
+    return nullptr;
+
+  const int64_t beg = m_beg.load(std::memory_order_relaxed);
+  const int64_t end = m_end.load(std::memory_order_relaxed);
+  const size_t pos  = end % m_size;
+
+  size_t len;
+  int64_t cur = m_cur.load();
+  for (;;)
+  {
+    len = std::min(std::min(iRequestSize, GetWritableSize(cur)), m_size - pos);
+
+    // reserve the history we are going to overwrite
+    m_beg.store(std::max(beg, end + (int64_t)len - (int64_t)m_size));
+
+    // the consumer may have seeked backwards in the meantime, in that case
+    // recalculate the space against its new position
+    const int64_t now = m_cur.load();
+    if (now >= cur)
+      break;
+    cur = now;
+  }
+
+  if (len == 0)
+    return nullptr;
+
+  iSpanSize = len;
+  return reinterpret_cast<char*>(m_buf + pos);
+}
+
+void CLockFreeCircularCache::CommitWrite(size_t iSize)
+{
+  if (iSize == 0)
+    return;
+
+  m_end.store(m_end.load(std::memory_order_relaxed) + iSize, std::memory_order_release);
+  m_written.Set();
+}
+
+int CLockFreeCircularCache::WriteToCache(const char *buf, size_t len)
+{
+  size_t avail;
+  char* span = GetWriteSpan(len, avail);
+  if (span == nullptr)
+    return 0;
+
+  memcpy(span, buf, avail);
+  CommitWrite(avail);
+
+  return avail;
+}
+
+const char* CLockFreeCircularCache::GetReadSpan(size_t& iSpanSize)
+{
+  iSpanSize = 0;
+  if (m_buf == nullptr)
+    return nullptr;
+
+  const int64_t cur = m_cur.load(std::memory_order_relaxed);
+  const int64_t end = m_end.load(std::memory_order_acquire);
+
+  size_t pos   = cur % m_size;
+  size_t front = (size_t)(end - cur);
+  size_t avail = std::min(m_size - pos, front);
+  if (avail == 0)
+    return nullptr;
+
+  iSpanSize = avail;
+  return reinterpret_cast<const char*>(m_buf + pos);
+}
+
+void CLockFreeCircularCache::CommitRead(size_t iSize)
+{
+  if (iSize == 0)
+    return;
+
+  m_cur.store(m_cur.load(std::memory_order_relaxed) + iSize);
+  m_space.Set();
+}
+
+int CLockFreeCircularCache::ReadFromCache(char *buf, size_t len)
+{
+  size_t avail;
+  const char* span = GetReadSpan(avail);
+  if (span == nullptr)
+  {
+    if (!IsEndOfInput())
+      return CACHE_RC_WOULD_BLOCK;
+
+    // the producer may have written its last data right before flagging eof
+    span = GetReadSpan(avail);
+    if (span == nullptr)
+      return 0;
+  }
+
+  if (len > avail)
+    len = avail;
+
+  if (len == 0)
+    return 0;
+
+  memcpy(buf, span, len);
+  CommitRead(len);
+
+  return len;
+}
+
+int64_t CLockFreeCircularCache::WaitForData(unsigned int minimum, unsigned int millis)
+{
+  // without waiting this is safe from the producer as well: m_end is loaded
+  // before m_cur, and the consumer never moves m_cur past m_end
+  int64_t avail = m_end.load(std::memory_order_acquire) - m_cur.load();
+
+  if (millis == 0 || IsEndOfInput())
+    return avail;
+
+  if (minimum > m_size - m_size_back)
+    minimum = m_size - m_size_back;
+
+  XbmcThreads::EndTime endtime(millis);
+  while (!IsEndOfInput() && avail < minimum && !endtime.IsTimePast())
+  {
+    m_written.WaitMSec(50); // may miss the deadline. shouldn't be a problem.
+    avail = m_end.load(std::memory_order_acquire) - m_cur.load();
+  }
+
+  return avail;
+}
+
+int64_t CLockFreeCircularCache::Seek(int64_t pos)
+{
+  // if seek is a bit over what we have, try to wait a few seconds for the data to be available.
+  // we try to avoid a (heavy) seek on the source
+  const int64_t end = m_end.load(std::memory_order_acquire);
+  if (pos >= end && pos < end + 100000)
+  {
+    // moving forward never conflicts with the producer
+    m_cur.store(end);
+    WaitForData((size_t)(pos - end), 5000);
+  }
+
+  if (pos < m_beg.load() || pos > m_end.load(std::memory_order_acquire))
+    return CACHE_RC_ERROR;
+
+  // publish the new position first, then verify the producer did not reserve it
+  // for overwriting in the meantime (see GetWriteSpan)
+  const int64_t cur = m_cur.load(std::memory_order_relaxed);
+  m_cur.store(pos);
+  if (pos < m_beg.load())
+  {
+    m_cur.store(cur);
+    return CACHE_RC_ERROR;
+  }
+
+  return pos;
+}
+
+bool CLockFreeCircularCache::Reset(int64_t pos, bool clearAnyway)
+{
+  if (!clearAnyway && IsCachedPosition(pos))
+  {
+    m_cur.store(pos);
+    return false;
+  }
+  m_end.store(pos);
+  m_beg.store(pos);
+  m_cur.store(pos);
+
+  return true;
+}
+
+int64_t CLockFreeCircularCache::CachedDataEndPosIfSeekTo(int64_t iFilePosition)
+{
+  if (IsCachedPosition(iFilePosition))
+    return m_end.load();
+  return iFilePosition;
+}
+
+int64_t CLockFreeCircularCache::CachedDataEndPos()
+{
+  return m_end.load();
+}
+
+bool CLockFreeCircularCache::IsCachedPosition(int64_t iFilePosition)
+{
+  return iFilePosition >= m_beg.load() && iFilePosition <= m_end.load();
+}
+
+CCacheStrategy *CLockFreeCircularCache::CreateNew()
+{
+  return new CLockFreeCircularCache(m_size - m_size_back, m_size_back);
+}
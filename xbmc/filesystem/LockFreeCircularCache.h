@@ -0,0 +1,80 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "CacheStrategy.h"
+#include "threads/Event.h"
+
+#include <atomic>
+
+namespace XFILE {
+
+/*!
+ \brief Single-producer/single-consumer ring buffer cache without a data lock
+
+ Behaves like CCircularCache, but the fill thread (producer) and the reading
+ thread (consumer) only synchronise through atomic positions, and both sides can
+ access the ring directly through GetWriteSpan/GetReadSpan to avoid intermediate
+ copies.
+
+ Threading contract (as used by CFileCache):
+  - GetMaxWriteSize, WriteToCache, GetWriteSpan, CommitWrite, EndOfInput and
+    CachedDataEndPosIfSeekTo are only called from the producer thread.
+  - ReadFromCache, GetReadSpan, CommitRead and Seek are only called from the
+    consumer thread.
+  - WaitForData only waits when called from the consumer thread. With iMillis 0
+    it just reads both positions, the producer uses that to poll the amount of
+    data ahead of the reader.
+  - Reset is called from the producer thread while the consumer is blocked
+    waiting for the seek to complete.
+ */
+class CLockFreeCircularCache : public CCacheStrategy
+{
+public:
+  CLockFreeCircularCache(size_t front, size_t back);
+  ~CLockFreeCircularCache() override;
+
+  int Open() override;
+  void Close() override;
+
+  size_t GetMaxWriteSize(const size_t& iRequestSize) override;
+  int WriteToCache(const char *buf, size_t len) override;
+  int ReadFromCache(char *buf, size_t len) override;
+  int64_t WaitForData(unsigned int minimum, unsigned int iMillis) override;
+
+  char* GetWriteSpan(size_t iRequestSize, size_t& iSpanSize) override;
+  void CommitWrite(size_t iSize) override;
+  const char* GetReadSpan(size_t& iSpanSize) override;
+  void CommitRead(size_t iSize) override;
+
+  int64_t Seek(int64_t pos) override;
+  bool Reset(int64_t pos, bool clearAnyway=true) override;
+
+  int64_t CachedDataEndPosIfSeekTo(int64_t iFilePosition) override;
+  int64_t CachedDataEndPos() override;
+  bool IsCachedPosition(int64_t iFilePosition) override;
+
+  CCacheStrategy *CreateNew() override;
+
+protected:
+  size_t GetWritableSize(int64_t cur) const;
+
+  std::atomic<int64_t> m_beg;  /**< index in file (not buffer) of beginning of valid data, owned by producer */
+  std::atomic<int64_t> m_end;  /**< index in file (not buffer) of end of valid data, owned by producer */
+  std::atomic<int64_t> m_cur;  /**< current reading index in file, owned by consumer */
+  uint8_t *m_buf;              /**< buffer holding data */
+  size_t m_size;               /**< size of data buffer used (m_buf) */
+  size_t m_size_back;          /**< guaranteed size of back buffer */
+  CEvent m_written;
+#ifdef TARGET_WINDOWS
+  HANDLE m_handle;
+#endif
+};
+
+} // namespace XFILE
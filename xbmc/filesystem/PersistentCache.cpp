@@ -0,0 +1,727 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "PersistentCache.h"
+#include "Directory.h"
+#include "File.h"
+#include "FileItem.h"
+#include "IFile.h"
+#include "SpecialProtocol.h"
+#include "URL.h"
+#include "threads/SingleLock.h"
+#include "utils/Digest.h"
+#include "utils/JobManager.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+#include "utils/log.h"
+#if defined(TARGET_POSIX)
+#include "platform/posix/filesystem/PosixFile.h"
+#define CacheLocalFile CPosixFile
+#elif defined(TARGET_WINDOWS)
+#include "platform/win32/filesystem/Win32File.h"
+#define CacheLocalFile CWin32File
+#endif // TARGET_WINDOWS
+
+#include <algorithm>
+#include <string.h>
+
+using namespace XFILE;
+using KODI::UTILITY::CDigest;
+
+namespace
+{
+const uint32_t BLOCKMAP_VERSION = 1;
+
+bool WriteAll(IFile& file, const void* buffer, size_t size)
+{
+  return file.Write(buffer, size) == static_cast<ssize_t>(size);
+}
+
+bool ReadAll(IFile& file, void* buffer, size_t size)
+{
+  return file.Read(buffer, size) == static_cast<ssize_t>(size);
+}
+
+//! the final block of a file is usually shorter than BLOCK_SIZE
+uint64_t CountCachedBytes(const std::vector<bool>& blocks, int64_t size)
+{
+  const int64_t blockSize = CPersistentCacheEntry::BLOCK_SIZE;
+  uint64_t bytes = 0;
+  for (size_t block = 0; block < blocks.size(); block++)
+  {
+    const int64_t start = static_cast<int64_t>(block) * blockSize;
+    if (blocks[block])
+      bytes += std::min(start + blockSize, size) - start;
+  }
+  return bytes;
+}
+}
+
+CPersistentCacheEntry::CPersistentCacheEntry(const std::string& path, const std::string& key, int64_t size)
+  : m_path(path)
+  , m_key(key)
+  , m_size(size)
+  , m_blocks((size + BLOCK_SIZE - 1) / BLOCK_SIZE, false)
+  , m_file(new CacheLocalFile())
+{
+}
+
+CPersistentCacheEntry::~CPersistentCacheEntry()
+{
+  Close();
+  delete m_file;
+}
+
+bool CPersistentCacheEntry::Open()
+{
+  CSingleLock lock(m_section);
+
+  std::string key;
+  int64_t size;
+  std::vector<bool> blocks;
+  if (ReadBlockMap(m_path + ".idx", key, size, blocks) && key == m_key && size == m_size &&
+      blocks.size() == m_blocks.size())
+  {
+    m_blocks = std::move(blocks);
+    m_cachedBytes = CountCachedBytes(m_blocks, m_size);
+  }
+  else
+  {
+    // stale or foreign data, start from scratch
+    std::fill(m_blocks.begin(), m_blocks.end(), false);
+    m_cachedBytes = 0;
+    CFile::Delete(m_path);
+  }
+
+  if (!m_file->OpenForWrite(CURL(m_path), false))
+  {
+    CLog::LogF(LOGERROR, "failed to open \"%s\"", m_path.c_str());
+    return false;
+  }
+
+  // mark the entry as used now, even if nothing new is read
+  m_dirty = true;
+  return true;
+}
+
+void CPersistentCacheEntry::Close()
+{
+  CSingleLock lock(m_section);
+
+  if (m_dirty)
+    SaveBlockMap();
+  m_file->Close();
+}
+
+size_t CPersistentCacheEntry::GetCachedSize(int64_t pos, size_t maxSize)
+{
+  CSingleLock lock(m_section);
+
+  if (pos < 0 || pos >= m_size)
+    return 0;
+
+  int64_t end = pos;
+  size_t block = pos / BLOCK_SIZE;
+  while (block < m_blocks.size() && m_blocks[block] && end - pos < static_cast<int64_t>(maxSize))
+  {
+    block++;
+    end = std::min(static_cast<int64_t>(block * BLOCK_SIZE), m_size);
+  }
+
+  return static_cast<size_t>(std::min(end - pos, static_cast<int64_t>(maxSize)));
+}
+
+ssize_t CPersistentCacheEntry::Read(int64_t pos, char* buffer, size_t size)
+{
+  CSingleLock lock(m_section);
+
+  if (m_file->Seek(pos, SEEK_SET) != pos)
+    return -1;
+
+  return m_file->Read(buffer, size);
+}
+
+bool CPersistentCacheEntry::Write(int64_t pos, const char* buffer, size_t size, int64_t runStart)
+{
+  CSingleLock lock(m_section);
+
+  if (pos < 0 || pos + static_cast<int64_t>(size) > m_size)
+    return false;
+
+  if (m_file->Seek(pos, SEEK_SET) != pos || !WriteAll(*m_file, buffer, size))
+    return false;
+
+  // blocks completely covered by the current run are now valid
+  const int64_t runEnd = pos + size;
+  size_t first = (runStart + BLOCK_SIZE - 1) / BLOCK_SIZE;
+  for (size_t block = std::max(first, static_cast<size_t>(pos / BLOCK_SIZE)); block < m_blocks.size(); block++)
+  {
+    const int64_t blockEnd = std::min(static_cast<int64_t>((block + 1) * BLOCK_SIZE), m_size);
+    if (blockEnd > runEnd)
+      break;
+    if (!m_blocks[block])
+    {
+      m_blocks[block] = true;
+      m_cachedBytes += blockEnd - static_cast<int64_t>(block * BLOCK_SIZE);
+      m_dirty = true;
+    }
+  }
+
+  return true;
+}
+
+uint64_t CPersistentCacheEntry::GetCachedBytes()
+{
+  CSingleLock lock(m_section);
+  return m_cachedBytes;
+}
+
+bool CPersistentCacheEntry::SaveBlockMap()
+{
+  std::vector<uint8_t> bits((m_blocks.size() + 7) / 8, 0);
+  for (size_t i = 0; i < m_blocks.size(); i++)
+  {
+    if (m_blocks[i])
+      bits[i / 8] |= 1 << (i % 8);
+  }
+
+  CacheLocalFile file;
+  const uint32_t blockSize = BLOCK_SIZE;
+  const uint32_t keySize = m_key.size();
+  const uint32_t bitsSize = bits.size();
+  if (!file.OpenForWrite(CURL(m_path + ".idx"), true) ||
+      !WriteAll(file, &BLOCKMAP_VERSION, sizeof(BLOCKMAP_VERSION)) ||
+      !WriteAll(file, &m_size, sizeof(m_size)) ||
+      !WriteAll(file, &blockSize, sizeof(blockSize)) ||
+      !WriteAll(file, &keySize, sizeof(keySize)) ||
+      !WriteAll(file, m_key.data(), keySize) ||
+      !WriteAll(file, &bitsSize, sizeof(bitsSize)) ||
+      !WriteAll(file, bits.data(), bitsSize))
+  {
+    CLog::LogF(LOGERROR, "failed to write block map for \"%s\"", m_path.c_str());
+    return false;
+  }
+
+  m_dirty = false;
+  return true;
+}
+
+bool CPersistentCacheEntry::ReadBlockMap(const std::string& mapPath, std::string& key, int64_t& size, std::vector<bool>& blocks)
+{
+  CacheLocalFile file;
+  if (!file.Open(CURL(mapPath)))
+    return false;
+
+  uint32_t version, blockSize, keySize, bitsSize;
+  if (!ReadAll(file, &version, sizeof(version)) || version != BLOCKMAP_VERSION ||
+      !ReadAll(file, &size, sizeof(size)) || size <= 0 ||
+      !ReadAll(file, &blockSize, sizeof(blockSize)) || blockSize != BLOCK_SIZE ||
+      !ReadAll(file, &keySize, sizeof(keySize)) || keySize > 64 * 1024)
+    return false;
+
+  key.resize(keySize);
+  if (!ReadAll(file, &key[0], keySize) ||
+      !ReadAll(file, &bitsSize, sizeof(bitsSize)))
+    return false;
+
+  const size_t blockCount = (size + BLOCK_SIZE - 1) / BLOCK_SIZE;
+  if (bitsSize != (blockCount + 7) / 8)
+    return false;
+
+  std::vector<uint8_t> bits(bitsSize);
+  if (!ReadAll(file, bits.data(), bitsSize))
+    return false;
+
+  blocks.resize(blockCount);
+  for (size_t i = 0; i < blockCount; i++)
+    blocks[i] = (bits[i / 8] & (1 << (i % 8))) != 0;
+
+  return true;
+}
+
+CPersistentCacheStore& CPersistentCacheStore::GetInstance()
+{
+  static CPersistentCacheStore store;
+  return store;
+}
+
+void CPersistentCacheStore::Configure(const std::string& folder, uint64_t maxSize)
+{
+  CSingleLock lock(m_section);
+
+  m_maxSize = maxSize;
+  if (folder != m_folder)
+  {
+    m_entries.clear();
+    m_lru.clear();
+    m_folder = folder;
+    if (!m_folder.empty())
+      Load();
+  }
+  Evict();
+}
+
+void CPersistentCacheStore::Load()
+{
+  if (!CDirectory::Exists(m_folder) && !CDirectory::Create(m_folder))
+  {
+    CLog::LogF(LOGERROR, "unable to create \"%s\"", m_folder.c_str());
+    return;
+  }
+
+  CFileItemList items;
+  CDirectory::GetDirectory(m_folder, items, ".idx", DIR_FLAG_NO_FILE_DIRS | DIR_FLAG_BYPASS_CACHE);
+
+  std::vector<std::pair<time_t, std::string>> found;
+  for (const auto& item : items)
+  {
+    std::string key;
+    int64_t size;
+    std::vector<bool> blocks;
+    if (!CPersistentCacheEntry::ReadBlockMap(CSpecialProtocol::TranslatePath(item->GetPath()), key, size, blocks))
+    {
+      CFile::Delete(item->GetPath());
+      continue;
+    }
+
+    std::string hash = URIUtils::GetFileName(item->GetPath());
+    URIUtils::RemoveExtension(hash);
+
+    EntryInfo& info = m_entries[hash];
+    info.bytes = CountCachedBytes(blocks, size);
+
+    time_t lastUsed = 0;
+    item->m_dateTime.GetAsTime(lastUsed);
+    found.emplace_back(lastUsed, hash);
+  }
+
+  std::sort(found.begin(), found.end(), std::greater<std::pair<time_t, std::string>>());
+  for (const auto& it : found)
+    m_entries[it.second].lru = m_lru.insert(m_lru.end(), it.second);
+
+  CLog::Log(LOGDEBUG, "CPersistentCacheStore::Load - %u entries, %" PRIu64" bytes in \"%s\"",
+            static_cast<unsigned int>(m_entries.size()), GetCachedBytes(), m_folder.c_str());
+}
+
+std::string CPersistentCacheStore::GetDataPath(const std::string& hash) const
+{
+  return CSpecialProtocol::TranslatePath(URIUtils::AddFileToFolder(m_folder, hash));
+}
+
+std::shared_ptr<CPersistentCacheEntry> CPersistentCacheStore::Acquire(const std::string& url, int64_t size, int64_t mtime)
+{
+  CSingleLock lock(m_section);
+
+  if (m_folder.empty() || m_maxSize == 0 || size <= 0)
+    return nullptr;
+
+  const std::string key = StringUtils::Format("%s|%" PRId64"|%" PRId64, url.c_str(), size, mtime);
+  const std::string hash = CDigest::Calculate(CDigest::Type::MD5, key);
+
+  auto it = m_entries.find(hash);
+  if (it == m_entries.end())
+  {
+    it = m_entries.insert(std::make_pair(hash, EntryInfo())).first;
+    it->second.lru = m_lru.insert(m_lru.begin(), hash);
+  }
+  else
+    m_lru.splice(m_lru.begin(), m_lru, it->second.lru);
+
+  EntryInfo& info = it->second;
+  if (!info.entry)
+  {
+    auto entry = std::make_shared<CPersistentCacheEntry>(GetDataPath(hash), key, size);
+    if (!entry->Open())
+    {
+      Remove(hash);
+      return nullptr;
+    }
+    info.entry = entry;
+  }
+
+  info.users++;
+  return info.entry;
+}
+
+void CPersistentCacheStore::Release(const std::shared_ptr<CPersistentCacheEntry>& entry)
+{
+  CSingleLock lock(m_section);
+
+  for (auto& it : m_entries)
+  {
+    EntryInfo& info = it.second;
+    if (info.entry != entry)
+      continue;
+
+    info.bytes = entry->GetCachedBytes();
+    if (--info.users == 0)
+    {
+      info.entry->Close();
+      info.entry.reset();
+    }
+    break;
+  }
+
+  Evict();
+}
+
+bool CPersistentCacheStore::MakeRoom(uint64_t size)
+{
+  CSingleLock lock(m_section);
+
+  if (size > m_maxSize)
+    return false;
+
+  const uint64_t maxSize = m_maxSize;
+  m_maxSize -= size;
+  Evict();
+  m_maxSize = maxSize;
+
+  return GetCachedBytes() + size <= m_maxSize;
+}
+
+void CPersistentCacheStore::Evict()
+{
+  uint64_t total = GetCachedBytes();
+
+  auto it = m_lru.end();
+  while (total > m_maxSize && it != m_lru.begin())
+  {
+    --it;
+    EntryInfo& info = m_entries[*it];
+    if (info.users > 0)
+      continue;
+
+    total -= std::min(total, info.bytes);
+    std::string hash = *it;
+    it = m_lru.erase(it);
+    m_entries.erase(hash);
+
+    const std::string path = GetDataPath(hash);
+    CFile::Delete(path);
+    CFile::Delete(path + ".idx");
+  }
+}
+
+void CPersistentCacheStore::Remove(const std::string& hash)
+{
+  auto it = m_entries.find(hash);
+  if (it == m_entries.end())
+    return;
+
+  m_lru.erase(it->second.lru);
+  m_entries.erase(it);
+}
+
+uint64_t CPersistentCacheStore::GetCachedBytes()
+{
+  CSingleLock lock(m_section);
+
+  uint64_t total = 0;
+  for (const auto& it : m_entries)
+    total += it.second.entry ? it.second.entry->GetCachedBytes() : it.second.bytes;
+  return total;
+}
+
+void CPersistentCacheStore::Clear()
+{
+  CSingleLock lock(m_section);
+
+  const uint64_t maxSize = m_maxSize;
+  m_maxSize = 0;
+  Evict();
+  m_maxSize = maxSize;
+}
+
+const size_t CPersistentCache::MAX_PENDING_BYTES;
+
+class CPersistentCache::CWriteJob : public CJob
+{
+public:
+  explicit CWriteJob(CPersistentCache* cache) : m_cache(cache) {}
+
+  ~CWriteJob() override
+  {
+    // cancelled before it ran, e.g. on shutdown
+    if (!m_done)
+      m_cache->WritePending(false);
+  }
+
+  bool DoWork() override
+  {
+    m_cache->WritePending(true);
+    m_done = true;
+    return true;
+  }
+
+  const char* GetType() const override { return "persistentcachewrite"; }
+  AFFINITY GetAffinity() const override { return AFFINITY_IO; }
+
+private:
+  CPersistentCache* m_cache;
+  bool m_done = false;
+};
+
+CPersistentCache::CPersistentCache(CCacheStrategy *impl, const std::string& url, int64_t size, int64_t mtime)
+  : m_pCache(impl)
+  , m_url(url)
+  , m_size(size)
+  , m_mtime(mtime)
+{
+}
+
+CPersistentCache::~CPersistentCache()
+{
+  Close();
+  delete m_pCache;
+}
+
+int CPersistentCache::Open()
+{
+  int ret = m_pCache->Open();
+  if (ret != CACHE_RC_OK)
+    return ret;
+
+  m_entry = CPersistentCacheStore::GetInstance().Acquire(m_url, m_size, m_mtime);
+  m_runStart = -1;
+  m_runEnd = -1;
+  m_stopStoring = false;
+  m_isOpen = true;
+  return CACHE_RC_OK;
+}
+
+void CPersistentCache::Close()
+{
+  // called again by the destructor after an explicit Close()
+  if (!m_isOpen)
+    return;
+  m_isOpen = false;
+
+  m_pCache->Close();
+
+  // the write job uses the entry
+  m_writesDone.Wait();
+
+  if (m_entry)
+  {
+    CPersistentCacheStore::GetInstance().Release(m_entry);
+    m_entry.reset();
+  }
+}
+
+void CPersistentCache::Store(int64_t pos, const char* pBuffer, size_t iSize)
+{
+  if (!m_entry || iSize == 0 || m_stopStoring)
+    return;
+
+  if (pos != m_runEnd)
+    m_runStart = pos;
+  m_runEnd = pos + iSize;
+
+  CSingleLock lock(m_writeSection);
+  if (m_pendingBytes + iSize > MAX_PENDING_BYTES)
+  {
+    // storage is slower than the source, leave a gap rather than blocking
+    // the fill thread. The next data starts a new run.
+    m_runEnd = -1;
+    return;
+  }
+
+  m_pending.push_back(PendingWrite());
+  PendingWrite& pending = m_pending.back();
+  pending.pos = pos;
+  pending.runStart = m_runStart;
+  pending.data.assign(pBuffer, pBuffer + iSize);
+  m_pendingBytes += iSize;
+
+  if (!m_writing)
+  {
+    m_writing = true;
+    m_writesDone.Reset();
+    CJobManager::GetInstance().AddJob(new CWriteJob(this), nullptr);
+  }
+}
+
+void CPersistentCache::WritePending(bool write)
+{
+  CSingleLock lock(m_writeSection);
+  while (!m_pending.empty())
+  {
+    PendingWrite pending = std::move(m_pending.front());
+    m_pending.pop_front();
+    if (write)
+    {
+      CSingleExit exit(m_writeSection);
+      Write(pending);
+    }
+    m_pendingBytes -= pending.data.size();
+  }
+
+  m_writing = false;
+  m_writesDone.Set();
+}
+
+void CPersistentCache::Write(const PendingWrite& pending)
+{
+  if (m_stopStoring)
+    return;
+
+  if (!CPersistentCacheStore::GetInstance().MakeRoom(pending.data.size()))
+  {
+    CLog::LogF(LOGDEBUG, "budget used up, no longer storing \"%s\"", CURL::GetRedacted(m_url).c_str());
+    m_stopStoring = true;
+    return;
+  }
+
+  if (!m_entry->Write(pending.pos, pending.data.data(), pending.data.size(), pending.runStart))
+  {
+    // storage is broken (disk full?), stop using it for this file
+    CLog::LogF(LOGWARNING, "failed to store data, disabling persistent cache");
+    m_stopStoring = true;
+  }
+}
+
+size_t CPersistentCache::GetMaxWriteSize(const size_t& iRequestSize)
+{
+  return m_pCache->GetMaxWriteSize(iRequestSize);
+}
+
+int CPersistentCache::WriteToCache(const char *pBuffer, size_t iSize)
+{
+  const int64_t pos = m_pCache->CachedDataEndPos();
+  int ret = m_pCache->WriteToCache(pBuffer, iSize);
+  if (ret > 0)
+    Store(pos, pBuffer, ret);
+  return ret;
+}
+
+int CPersistentCache::ReadFromCache(char *pBuffer, size_t iMaxSize)
+{
+  return m_pCache->ReadFromCache(pBuffer, iMaxSize);
+}
+
+int64_t CPersistentCache::WaitForData(unsigned int iMinAvail, unsigned int iMillis)
+{
+  return m_pCache->WaitForData(iMinAvail, iMillis);
+}
+
+char* CPersistentCache::GetWriteSpan(size_t iRequestSize, size_t& iSpanSize)
+{
+  m_span = m_pCache->GetWriteSpan(iRequestSize, iSpanSize);
+  return m_span;
+}
+
+void CPersistentCache::CommitWrite(size_t iSize)
+{
+  const int64_t pos = m_pCache->CachedDataEndPos();
+  m_pCache->CommitWrite(iSize);
+  if (m_span)
+    Store(pos, m_span, iSize);
+  m_span = nullptr;
+}
+
+const char* CPersistentCache::GetReadSpan(size_t& iSpanSize)
+{
+  return m_pCache->GetReadSpan(iSpanSize);
+}
+
+void CPersistentCache::CommitRead(size_t iSize)
+{
+  m_pCache->CommitRead(iSize);
+}
+
+int CPersistentCache::FillFromStore(size_t iMaxSize)
+{
+  if (!m_entry)
+    return 0;
+
+  const int64_t pos = m_pCache->CachedDataEndPos();
+  size_t avail = m_entry->GetCachedSize(pos, iMaxSize);
+  if (avail == 0)
+    return 0;
+
+  ssize_t read;
+  size_t spanSize;
+  char* span = m_pCache->GetWriteSpan(avail, spanSize);
+  if (span)
+  {
+    read = m_entry->Read(pos, span, spanSize);
+    if (read <= 0)
+      return 0;
+    m_pCache->CommitWrite(read);
+  }
+  else
+  {
+    m_buffer.resize(avail);
+    read = m_entry->Read(pos, m_buffer.data(), avail);
+    if (read <= 0)
+      return 0;
+
+    ssize_t written = 0;
+    while (written < read)
+    {
+      int ret = m_pCache->WriteToCache(m_buffer.data() + written, read - written);
+      if (ret <= 0)
+        break;
+      written += ret;
+    }
+    read = written;
+  }
+
+  // data from the store continues the current run like data from the source
+  if (pos != m_runEnd)
+    m_runStart = pos;
+  m_runEnd = pos + read;
+
+  return read;
+}
+
+int64_t CPersistentCache::Seek(int64_t iFilePosition)
+{
+  return m_pCache->Seek(iFilePosition);
+}
+
+bool CPersistentCache::Reset(int64_t iSourcePosition, bool clearAnyway)
+{
+  return m_pCache->Reset(iSourcePosition, clearAnyway);
+}
+
+void CPersistentCache::EndOfInput()
+{
+  m_pCache->EndOfInput();
+}
+
+bool CPersistentCache::IsEndOfInput()
+{
+  return m_pCache->IsEndOfInput();
+}
+
+void CPersistentCache::ClearEndOfInput()
+{
+  m_pCache->ClearEndOfInput();
+}
+
+int64_t CPersistentCache::CachedDataEndPosIfSeekTo(int64_t iFilePosition)
+{
+  return m_pCache->CachedDataEndPosIfSeekTo(iFilePosition);
+}
+
+int64_t CPersistentCache::CachedDataEndPos()
+{
+  return m_pCache->CachedDataEndPos();
+}
+
+bool CPersistentCache::IsCachedPosition(int64_t iFilePosition)
+{
+  return m_pCache->IsCachedPosition(iFilePosition);
+}
+
+CCacheStrategy *CPersistentCache::CreateNew()
+{
+  return new CPersistentCache(m_pCache->CreateNew(), m_url, m_size, m_mtime);
+}
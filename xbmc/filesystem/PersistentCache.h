@@ -0,0 +1,213 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "CacheStrategy.h"
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+
+#include <atomic>
+#include <deque>
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace XFILE {
+
+/*!
+ \brief Locally stored copy of (parts of) a single source file
+
+ Data is kept in a sparse file at its original offset and tracked in blocks of
+ BLOCK_SIZE bytes. A block only becomes readable once it was written completely.
+ The block map is stored next to the data when the entry is closed.
+ */
+class CPersistentCacheEntry
+{
+public:
+  static const size_t BLOCK_SIZE = 256 * 1024;
+
+  CPersistentCacheEntry(const std::string& path, const std::string& key, int64_t size);
+  ~CPersistentCacheEntry();
+
+  bool Open();
+  void Close();
+
+  /*!
+   \brief Number of contiguous bytes available from position onwards, at most maxSize
+   */
+  size_t GetCachedSize(int64_t pos, size_t maxSize);
+
+  ssize_t Read(int64_t pos, char* buffer, size_t size);
+
+  /*!
+   \brief Store data read from the source
+   \param pos source position of buffer
+   \param runStart start of the contiguous range written up to pos. Blocks fully
+          inside [runStart, pos + size) become readable.
+   */
+  bool Write(int64_t pos, const char* buffer, size_t size, int64_t runStart);
+
+  uint64_t GetCachedBytes();
+
+  /*!
+   \brief Read the size of the cached data from a stored block map without opening the entry
+   \return false if the map is missing or does not match key/size
+   */
+  static bool ReadBlockMap(const std::string& mapPath, std::string& key, int64_t& size, std::vector<bool>& blocks);
+
+private:
+  bool SaveBlockMap();
+
+  std::string m_path;  ///< data file, the block map is stored at m_path + ".idx"
+  std::string m_key;
+  int64_t m_size;
+  std::vector<bool> m_blocks;
+  uint64_t m_cachedBytes = 0;
+  bool m_dirty = false;
+  IFile* m_file;
+  CCriticalSection m_section;
+};
+
+/*!
+ \brief Budgeted, LRU ordered collection of CPersistentCacheEntry objects
+
+ Entries are keyed by source url, size and modification time so a changed
+ source never returns stale data. Whole entries are evicted, least recently
+ used first, once the total amount of cached data exceeds the budget. Entries
+ in use by an open file are never evicted, instead they stop growing once the
+ budget is used up (see MakeRoom()).
+ */
+class CPersistentCacheStore
+{
+public:
+  static CPersistentCacheStore& GetInstance();
+
+  /*!
+   \brief Set the storage folder and byte budget, loads existing entries on first use
+   */
+  void Configure(const std::string& folder, uint64_t maxSize);
+
+  std::shared_ptr<CPersistentCacheEntry> Acquire(const std::string& url, int64_t size, int64_t mtime);
+  void Release(const std::shared_ptr<CPersistentCacheEntry>& entry);
+
+  /*!
+   \brief Evict unused entries until another size bytes fit into the budget
+   \return false if the entries in use already take up the budget
+   */
+  bool MakeRoom(uint64_t size);
+
+  uint64_t GetCachedBytes();
+  void Clear();
+
+private:
+  CPersistentCacheStore() = default;
+
+  struct EntryInfo
+  {
+    std::shared_ptr<CPersistentCacheEntry> entry;
+    std::list<std::string>::iterator lru;
+    uint64_t bytes = 0;
+    int users = 0;
+  };
+
+  void Load();
+  void Evict();
+  void Remove(const std::string& hash);
+  std::string GetDataPath(const std::string& hash) const;
+
+  std::string m_folder;
+  uint64_t m_maxSize = 0;
+  std::map<std::string, EntryInfo> m_entries;
+  std::list<std::string> m_lru; ///< hashes, most recently used first
+  CCriticalSection m_section;
+};
+
+/*!
+ \brief Cache strategy that keeps a persistent copy of everything read
+
+ Wraps another strategy. Data written to the cache is also stored in a
+ CPersistentCacheEntry, and FillFromStore() feeds previously stored ranges
+ back into the wrapped cache so they do not need to be read from the source.
+
+ The fill thread only queues the data, it is written to local storage by a
+ job. If storage can't keep up, data is dropped instead of stalling the fill
+ thread. Once the budget of the store is used up, nothing more is stored.
+ */
+class CPersistentCache : public CCacheStrategy
+{
+public:
+  CPersistentCache(CCacheStrategy *impl, const std::string& url, int64_t size, int64_t mtime);
+  ~CPersistentCache() override;
+
+  int Open() override;
+  void Close() override;
+
+  size_t GetMaxWriteSize(const size_t& iRequestSize) override;
+  int WriteToCache(const char *pBuffer, size_t iSize) override;
+  int ReadFromCache(char *pBuffer, size_t iMaxSize) override;
+  int64_t WaitForData(unsigned int iMinAvail, unsigned int iMillis) override;
+
+  char* GetWriteSpan(size_t iRequestSize, size_t& iSpanSize) override;
+  void CommitWrite(size_t iSize) override;
+  const char* GetReadSpan(size_t& iSpanSize) override;
+  void CommitRead(size_t iSize) override;
+  int FillFromStore(size_t iMaxSize) override;
+
+  int64_t Seek(int64_t iFilePosition) override;
+  bool Reset(int64_t iSourcePosition, bool clearAnyway=true) override;
+  void EndOfInput() override;
+  bool IsEndOfInput() override;
+  void ClearEndOfInput() override;
+
+  int64_t CachedDataEndPosIfSeekTo(int64_t iFilePosition) override;
+  int64_t CachedDataEndPos() override;
+  bool IsCachedPosition(int64_t iFilePosition) override;
+
+  CCacheStrategy *CreateNew() override;
+
+protected:
+  //! maximum amount of data waiting to be written to the entry
+  static const size_t MAX_PENDING_BYTES = 16 * 1024 * 1024;
+
+  struct PendingWrite
+  {
+    int64_t pos;
+    int64_t runStart;
+    std::vector<char> data;
+  };
+
+  void Store(int64_t pos, const char* pBuffer, size_t iSize);
+  void WritePending(bool write);
+  void Write(const PendingWrite& pending);
+
+  CCacheStrategy *m_pCache;
+  std::shared_ptr<CPersistentCacheEntry> m_entry;
+  std::string m_url;
+  int64_t m_size;
+  int64_t m_mtime;
+  int64_t m_runStart = -1;
+  int64_t m_runEnd = -1;
+  bool m_isOpen = false;
+  char* m_span = nullptr;
+  std::vector<char> m_buffer;
+
+  CCriticalSection m_writeSection;
+  std::deque<PendingWrite> m_pending;
+  size_t m_pendingBytes = 0;
+  bool m_writing = false;
+  CEvent m_writesDone{true, true};
+  std::atomic<bool> m_stopStoring{false};
+
+private:
+  class CWriteJob;
+};
+
+}
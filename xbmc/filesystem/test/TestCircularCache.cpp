@@ -0,0 +1,245 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "filesystem/CircularCache.h"
+#include "filesystem/LockFreeCircularCache.h"
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace XFILE;
+
+namespace
+{
+const size_t FRONT_SIZE = 256 * 1024;
+const size_t BACK_SIZE = 64 * 1024;
+
+// prime period, so the pattern never lines up with chunk or buffer sizes
+const int PATTERN_PERIOD = 251;
+
+uint8_t PatternAt(int64_t pos)
+{
+  return static_cast<uint8_t>(pos % PATTERN_PERIOD);
+}
+
+std::vector<char> MakePattern(int64_t start, size_t size)
+{
+  std::vector<char> data(size);
+  for (size_t i = 0; i < size; i++)
+    data[i] = PatternAt(start + i);
+  return data;
+}
+
+template<typename T>
+CCacheStrategy* CreateCache()
+{
+  return new T(FRONT_SIZE, BACK_SIZE);
+}
+
+/*!
+ \brief Push size bytes through the cache from a producer thread and read
+        them back on the calling thread
+ \param verify check every byte read, otherwise only the first of each read
+ \return throughput in MB/s
+ */
+double Transfer(CCacheStrategy& cache, size_t size, size_t chunkWrite, size_t chunkRead, bool verify)
+{
+  std::atomic<bool> forwardValid(true);
+  std::thread producer([&cache, size, chunkWrite, &forwardValid]()
+  {
+    std::vector<char> pattern = MakePattern(0, chunkWrite + PATTERN_PERIOD);
+    int64_t pos = 0;
+    while (pos < static_cast<int64_t>(size))
+    {
+      size_t len = cache.GetMaxWriteSize(std::min(chunkWrite, size - pos));
+      if (len == 0)
+      {
+        cache.m_space.WaitMSec(5);
+        continue;
+      }
+      const char* buffer = pattern.data() + pos % PATTERN_PERIOD;
+      size_t written = 0;
+      while (written < len)
+      {
+        int ret = cache.WriteToCache(buffer + written, len - written);
+        if (ret <= 0)
+          cache.m_space.WaitMSec(5);
+        else
+          written += ret;
+      }
+      pos += len;
+
+      // CFileCache polls the forward buffer level from the fill thread
+      const int64_t forward = cache.WaitForData(0, 0);
+      if (forward < 0 || forward > pos)
+        forwardValid = false;
+    }
+    cache.EndOfInput();
+  });
+
+  std::vector<char> buffer(chunkRead);
+  int64_t pos = 0;
+  bool valid = true;
+  auto start = std::chrono::steady_clock::now();
+  for (;;)
+  {
+    int ret = cache.ReadFromCache(buffer.data(), chunkRead);
+    if (ret == 0)
+      break;
+    if (ret == CACHE_RC_WOULD_BLOCK)
+    {
+      cache.WaitForData(1, 1000);
+      continue;
+    }
+    for (int i = 0; i < (verify ? ret : 1) && valid; i++)
+      valid = (static_cast<uint8_t>(buffer[i]) == PatternAt(pos + i));
+    pos += ret;
+  }
+  auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  producer.join();
+
+  EXPECT_TRUE(valid);
+  EXPECT_TRUE(forwardValid);
+  EXPECT_EQ(static_cast<int64_t>(size), pos);
+  return elapsed > 0 ? size / elapsed / (1024 * 1024) : 0;
+}
+}
+
+template<typename T>
+class TestCircularCache : public testing::Test
+{
+protected:
+  TestCircularCache() : cache(CreateCache<T>())
+  {
+    cache->Open();
+  }
+
+  std::unique_ptr<CCacheStrategy> cache;
+};
+
+typedef testing::Types<CCircularCache, CLockFreeCircularCache> CacheTypes;
+TYPED_TEST_CASE(TestCircularCache, CacheTypes);
+
+TYPED_TEST(TestCircularCache, WriteRead)
+{
+  std::vector<char> data = MakePattern(0, 1000);
+  char buf[1000];
+
+  EXPECT_EQ(CACHE_RC_WOULD_BLOCK, this->cache->ReadFromCache(buf, sizeof(buf)));
+  EXPECT_EQ(1000, this->cache->WriteToCache(data.data(), data.size()));
+  EXPECT_EQ(1000, this->cache->WaitForData(0, 0));
+  EXPECT_EQ(600, this->cache->ReadFromCache(buf, 600));
+  EXPECT_EQ(400, this->cache->ReadFromCache(buf + 600, 600));
+  EXPECT_EQ(0, memcmp(data.data(), buf, sizeof(buf)));
+
+  this->cache->EndOfInput();
+  EXPECT_EQ(0, this->cache->ReadFromCache(buf, sizeof(buf)));
+}
+
+TYPED_TEST(TestCircularCache, FillsFrontBuffer)
+{
+  std::vector<char> data = MakePattern(0, FRONT_SIZE + BACK_SIZE);
+  size_t written = 0;
+  int ret;
+  while ((ret = this->cache->WriteToCache(data.data() + written, data.size() - written)) > 0)
+    written += ret;
+
+  // nothing consumed yet, so the whole buffer can be used as front buffer
+  EXPECT_EQ(FRONT_SIZE + BACK_SIZE, written);
+  EXPECT_EQ(0U, this->cache->GetMaxWriteSize(1));
+}
+
+TYPED_TEST(TestCircularCache, SeekInBackBuffer)
+{
+  std::vector<char> data = MakePattern(0, 4096);
+  char buf[4096];
+  ASSERT_EQ(4096, this->cache->WriteToCache(data.data(), data.size()));
+  ASSERT_EQ(4096, this->cache->ReadFromCache(buf, sizeof(buf)));
+
+  EXPECT_EQ(1024, this->cache->Seek(1024));
+  EXPECT_EQ(100, this->cache->ReadFromCache(buf, 100));
+  EXPECT_EQ(0, memcmp(data.data() + 1024, buf, 100));
+  EXPECT_TRUE(this->cache->IsCachedPosition(0));
+  EXPECT_FALSE(this->cache->IsCachedPosition(4097));
+  EXPECT_EQ(4096, this->cache->CachedDataEndPosIfSeekTo(0));
+
+  EXPECT_FALSE(this->cache->Reset(2048, false));
+  EXPECT_TRUE(this->cache->Reset(10000));
+  EXPECT_EQ(10000, this->cache->CachedDataEndPos());
+}
+
+TYPED_TEST(TestCircularCache, WrapAround)
+{
+  // odd sizes so reads and writes straddle the wrap point
+  Transfer(*this->cache, 3 * (FRONT_SIZE + BACK_SIZE) + 17, 7000, 3000, true);
+}
+
+TEST(TestLockFreeCircularCache, Spans)
+{
+  CLockFreeCircularCache cache(FRONT_SIZE, BACK_SIZE);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  size_t size;
+  EXPECT_EQ(nullptr, cache.GetReadSpan(size));
+  EXPECT_EQ(0U, size);
+
+  char* write = cache.GetWriteSpan(100, size);
+  ASSERT_NE(nullptr, write);
+  EXPECT_EQ(100U, size);
+  std::vector<char> data = MakePattern(0, 100);
+  memcpy(write, data.data(), 60);
+  cache.CommitWrite(60);
+
+  const char* read = cache.GetReadSpan(size);
+  ASSERT_NE(nullptr, read);
+  EXPECT_EQ(60U, size);
+  EXPECT_EQ(0, memcmp(data.data(), read, 60));
+  cache.CommitRead(20);
+  EXPECT_EQ(40, cache.WaitForData(0, 0));
+
+  // spans never cross the wrap point
+  EXPECT_TRUE(cache.Reset(FRONT_SIZE + BACK_SIZE - 10));
+  write = cache.GetWriteSpan(100, size);
+  ASSERT_NE(nullptr, write);
+  EXPECT_EQ(10U, size);
+}
+
+TEST(TestLockFreeCircularCache, DefaultStrategyHasNoSpans)
+{
+  CCircularCache cache(FRONT_SIZE, BACK_SIZE);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+
+  size_t size;
+  EXPECT_EQ(nullptr, cache.GetWriteSpan(100, size));
+  EXPECT_EQ(0U, size);
+}
+
+// Transfer rate of both caches, run with --gtest_also_run_disabled_tests
+TEST(TestLockFreeCircularCache, DISABLED_Throughput)
+{
+  const size_t size = 256 * 1024 * 1024;
+  const size_t chunkWrite = 128 * 1024;
+  const size_t chunkRead = 32 * 1024;
+
+  CCircularCache locked(4 * 1024 * 1024, 1024 * 1024);
+  ASSERT_EQ(CACHE_RC_OK, locked.Open());
+  double rateLocked = Transfer(locked, size, chunkWrite, chunkRead, false);
+
+  CLockFreeCircularCache lockFree(4 * 1024 * 1024, 1024 * 1024);
+  ASSERT_EQ(CACHE_RC_OK, lockFree.Open());
+  double rateLockFree = Transfer(lockFree, size, chunkWrite, chunkRead, false);
+
+  std::cout << "CCircularCache:         " << rateLocked << " MB/s" << std::endl;
+  std::cout << "CLockFreeCircularCache: " << rateLockFree << " MB/s" << std::endl;
+}
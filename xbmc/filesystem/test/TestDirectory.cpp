@@ -7,6 +7,7 @@
  */
 
 #include "filesystem/Directory.h"
+#include "filesystem/DirectoryCache.h"
 #include "filesystem/IDirectory.h"
 #include "filesystem/SpecialProtocol.h"
 #include "FileItem.h"
@@ -54,3 +55,27 @@ TEST(TestDirectory, CreateRecursive)
   EXPECT_TRUE(XFILE::CDirectory::Create(path2));
   EXPECT_TRUE(XFILE::CDirectory::RemoveRecursive(path1));
 }
+
+TEST(TestDirectory, GetSharedDirectory)
+{
+  const std::string path = URIUtils::AddFileToFolder(CSpecialProtocol::TranslatePath("special://temp/"), "TestDirectoryShared/");
+  CFileItemList items;
+  items.SetPath(path);
+  items.Add(CFileItemPtr(new CFileItem(path + "movie.mkv", false)));
+  items.Add(CFileItemPtr(new CFileItem(path + "poster.jpg", false)));
+  g_directoryCache.SetDirectory(path, items, XFILE::DIR_CACHE_ALWAYS);
+
+  // nothing filtered, the cached listing itself is returned
+  auto all = XFILE::CDirectory::GetSharedDirectory(path, "", XFILE::DIR_FLAG_NO_FILE_DIRS);
+  ASSERT_TRUE(all != nullptr);
+  EXPECT_EQ(2, all->Size());
+  EXPECT_EQ(g_directoryCache.GetDirectory(path).get(), all.get());
+
+  // filtered listings share the items
+  auto images = XFILE::CDirectory::GetSharedDirectory(path, ".jpg", XFILE::DIR_FLAG_NO_FILE_DIRS);
+  ASSERT_TRUE(images != nullptr);
+  ASSERT_EQ(1, images->Size());
+  EXPECT_EQ(all->Get(1).get(), images->Get(0).get());
+
+  g_directoryCache.ClearDirectory(path);
+}
@@ -0,0 +1,172 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "FileItem.h"
+#include "filesystem/DirectoryCache.h"
+#include "utils/StringUtils.h"
+
+#include "gtest/gtest.h"
+
+using namespace XFILE;
+
+namespace
+{
+class CTestDirectoryCache : public CDirectoryCache
+{
+public:
+  void SetMaxBytes(size_t maxBytes) { m_maxBytes = maxBytes; }
+};
+
+void FillDirectory(CFileItemList& items, const std::string& path, int count)
+{
+  items.SetPath(path);
+  for (int i = 0; i < count; i++)
+    items.Add(CFileItemPtr(new CFileItem(StringUtils::Format("%sfile%d.mkv", path.c_str(), i), false)));
+}
+}
+
+TEST(TestDirectoryCache, GetSetDirectory)
+{
+  CTestDirectoryCache cache;
+  CFileItemList items;
+  FillDirectory(items, "smb://server/share/movies/", 10);
+  cache.SetDirectory("smb://server/share/movies/", items, DIR_CACHE_ALWAYS);
+
+  auto snapshot = cache.GetDirectory("smb://server/share/movies");
+  ASSERT_TRUE(snapshot != nullptr);
+  EXPECT_EQ(10, snapshot->Size());
+
+  // the snapshot is a copy of the listing that was set
+  items.Clear();
+  snapshot = cache.GetDirectory("smb://server/share/movies/");
+  ASSERT_TRUE(snapshot != nullptr);
+  EXPECT_EQ(10, snapshot->Size());
+
+  EXPECT_TRUE(cache.GetDirectory("smb://server/share/other/") == nullptr);
+
+  CDirectoryCache::CStats stats = cache.GetStats();
+  EXPECT_EQ(2U, stats.hits);
+  EXPECT_EQ(1U, stats.misses);
+  EXPECT_EQ(1U, stats.directories);
+  EXPECT_EQ(10U, stats.items);
+}
+
+TEST(TestDirectoryCache, CacheOnce)
+{
+  CTestDirectoryCache cache;
+  CFileItemList items;
+  FillDirectory(items, "smb://server/share/", 3);
+  cache.SetDirectory("smb://server/share/", items, DIR_CACHE_ONCE);
+
+  EXPECT_TRUE(cache.GetDirectory("smb://server/share/") == nullptr);
+  EXPECT_TRUE(cache.GetDirectory("smb://server/share/", true) != nullptr);
+
+  bool inCache;
+  EXPECT_TRUE(cache.FileExists("smb://server/share/file1.mkv", inCache));
+  EXPECT_TRUE(inCache);
+  EXPECT_FALSE(cache.FileExists("smb://server/share/missing.mkv", inCache));
+  EXPECT_TRUE(inCache);
+  EXPECT_FALSE(cache.FileExists("smb://server/other/file1.mkv", inCache));
+  EXPECT_FALSE(inCache);
+}
+
+TEST(TestDirectoryCache, AddFileKeepsSnapshots)
+{
+  CTestDirectoryCache cache;
+  CFileItemList items;
+  FillDirectory(items, "/media/", 2);
+  cache.SetDirectory("/media/", items, DIR_CACHE_ALWAYS);
+
+  auto before = cache.GetDirectory("/media/");
+  cache.AddFile("/media/new.mkv");
+  auto after = cache.GetDirectory("/media/");
+
+  ASSERT_TRUE(before && after);
+  EXPECT_EQ(2, before->Size());
+  EXPECT_EQ(3, after->Size());
+
+  bool inCache;
+  EXPECT_TRUE(cache.FileExists("/media/new.mkv", inCache));
+}
+
+TEST(TestDirectoryCache, AddFileInPlace)
+{
+  CTestDirectoryCache cache;
+  CFileItemList items;
+  FillDirectory(items, "/media/", 2);
+  cache.SetDirectory("/media/", items, DIR_CACHE_ALWAYS);
+
+  // no reader holds the listing, so files are added to it without copying
+  const CFileItemList* listing = cache.GetDirectory("/media/").get();
+  cache.AddFile("/media/new1.mkv");
+  cache.AddFile("/media/new2.mkv");
+
+  auto after = cache.GetDirectory("/media/");
+  ASSERT_TRUE(after != nullptr);
+  EXPECT_EQ(listing, after.get());
+  EXPECT_EQ(4, after->Size());
+
+  // items are shared with the replaced snapshot
+  cache.AddFile("/media/new3.mkv");
+  auto replaced = cache.GetDirectory("/media/");
+  ASSERT_TRUE(replaced != nullptr);
+  EXPECT_NE(after.get(), replaced.get());
+  EXPECT_EQ(after->Get(0).get(), replaced->Get(0).get());
+  EXPECT_EQ(5, replaced->Size());
+}
+
+TEST(TestDirectoryCache, Clear)
+{
+  CTestDirectoryCache cache;
+  for (const char* path : { "/media/a/", "/media/a/b/", "/media/c/" })
+  {
+    CFileItemList items;
+    FillDirectory(items, path, 1);
+    cache.SetDirectory(path, items, DIR_CACHE_ALWAYS);
+  }
+
+  cache.ClearSubPaths("/media/a/");
+  EXPECT_FALSE(cache.GetDirectory("/media/a/"));
+  EXPECT_FALSE(cache.GetDirectory("/media/a/b/"));
+  EXPECT_TRUE(cache.GetDirectory("/media/c/") != nullptr);
+
+  cache.ClearFile("/media/c/file0.mkv");
+  EXPECT_FALSE(cache.GetDirectory("/media/c/"));
+
+  CFileItemList items;
+  FillDirectory(items, "/media/d/", 1);
+  cache.SetDirectory("/media/d/", items, DIR_CACHE_ALWAYS);
+  cache.Clear();
+  EXPECT_EQ(0U, cache.GetStats().directories);
+  EXPECT_EQ(0U, cache.GetStats().bytes);
+}
+
+TEST(TestDirectoryCache, EvictsLeastRecentlyUsed)
+{
+  CTestDirectoryCache cache;
+  CFileItemList items;
+  FillDirectory(items, "/media/0/", 100);
+  cache.SetDirectory("/media/0/", items, DIR_CACHE_ONCE);
+  const size_t dirSize = cache.GetStats().bytes;
+
+  // room for about three listings
+  cache.SetMaxBytes(dirSize * 3 + dirSize / 2);
+  for (int i = 1; i < 10; i++)
+  {
+    CFileItemList more;
+    std::string path = StringUtils::Format("/media/%d/", i);
+    FillDirectory(more, path, 100);
+    cache.SetDirectory(path, more, DIR_CACHE_ONCE);
+  }
+
+  CDirectoryCache::CStats stats = cache.GetStats();
+  EXPECT_LE(stats.bytes, stats.maxBytes);
+  EXPECT_GE(stats.evictions, 6U);
+  EXPECT_TRUE(cache.GetDirectory("/media/9/", true) != nullptr);
+  EXPECT_FALSE(cache.GetDirectory("/media/0/", true));
+}
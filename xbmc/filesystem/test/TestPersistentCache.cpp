@@ -0,0 +1,179 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "filesystem/CircularCache.h"
+#include "filesystem/Directory.h"
+#include "filesystem/PersistentCache.h"
+#include "filesystem/SpecialProtocol.h"
+
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace XFILE;
+
+namespace
+{
+const std::string TEST_FOLDER = "special://temp/persistentcache-test/";
+const size_t BLOCK = CPersistentCacheEntry::BLOCK_SIZE;
+
+std::vector<char> MakeData(size_t size)
+{
+  std::vector<char> data(size);
+  for (size_t i = 0; i < size; i++)
+    data[i] = static_cast<char>(i % 253);
+  return data;
+}
+
+// push data through the cache in chunks of at most chunkSize, consuming it as we go
+void WriteAll(CCacheStrategy& cache, const std::vector<char>& data, size_t chunkSize = std::numeric_limits<size_t>::max())
+{
+  std::vector<char> sink(BLOCK);
+  size_t written = 0;
+  while (written < data.size())
+  {
+    int ret = cache.WriteToCache(data.data() + written, std::min(data.size() - written, chunkSize));
+    ASSERT_GE(ret, 0);
+    written += ret;
+    while (cache.ReadFromCache(sink.data(), sink.size()) > 0)
+      ;
+  }
+}
+}
+
+class TestPersistentCache : public testing::Test
+{
+protected:
+  TestPersistentCache()
+  {
+    CDirectory::RemoveRecursive(TEST_FOLDER);
+    CPersistentCacheStore::GetInstance().Configure(TEST_FOLDER, 100 * BLOCK);
+  }
+
+  ~TestPersistentCache() override
+  {
+    CPersistentCacheStore::GetInstance().Clear();
+    CPersistentCacheStore::GetInstance().Configure("", 0);
+    CDirectory::RemoveRecursive(TEST_FOLDER);
+  }
+};
+
+TEST_F(TestPersistentCache, EntryBlocks)
+{
+  const std::string path = CSpecialProtocol::TranslatePath(TEST_FOLDER + "entry");
+  const std::vector<char> data = MakeData(3 * BLOCK + 100);
+  {
+    CPersistentCacheEntry entry(path, "key", data.size());
+    ASSERT_TRUE(entry.Open());
+
+    // half a block is not usable yet
+    EXPECT_TRUE(entry.Write(0, data.data(), BLOCK / 2, 0));
+    EXPECT_EQ(0U, entry.GetCachedSize(0, data.size()));
+    EXPECT_TRUE(entry.Write(BLOCK / 2, data.data() + BLOCK / 2, BLOCK, 0));
+    EXPECT_EQ(BLOCK, entry.GetCachedSize(0, data.size()));
+    EXPECT_EQ(10U, entry.GetCachedSize(BLOCK - 10, data.size()));
+
+    // a run starting inside a block only completes the following blocks
+    EXPECT_TRUE(entry.Write(2 * BLOCK + 1, data.data() + 2 * BLOCK + 1, BLOCK + 99, 2 * BLOCK + 1));
+    EXPECT_EQ(0U, entry.GetCachedSize(2 * BLOCK, data.size()));
+    EXPECT_EQ(100U, entry.GetCachedSize(3 * BLOCK, data.size()));
+    // the final block only holds the end of the file
+    EXPECT_EQ(BLOCK + 100, entry.GetCachedBytes());
+    entry.Close();
+  }
+
+  CPersistentCacheEntry reopened(path, "key", data.size());
+  ASSERT_TRUE(reopened.Open());
+  EXPECT_EQ(BLOCK, reopened.GetCachedSize(0, data.size()));
+  EXPECT_EQ(BLOCK + 100, reopened.GetCachedBytes());
+
+  std::vector<char> buf(BLOCK);
+  EXPECT_EQ(static_cast<ssize_t>(BLOCK), reopened.Read(0, buf.data(), BLOCK));
+  EXPECT_EQ(0, memcmp(data.data(), buf.data(), BLOCK));
+  reopened.Close();
+
+  // a different key never sees old data
+  CPersistentCacheEntry other(path, "other", data.size());
+  ASSERT_TRUE(other.Open());
+  EXPECT_EQ(0U, other.GetCachedSize(0, data.size()));
+}
+
+TEST_F(TestPersistentCache, FillFromStore)
+{
+  const std::vector<char> data = MakeData(2 * BLOCK + 1000);
+  {
+    CPersistentCache cache(new CCircularCache(4 * BLOCK, BLOCK), "test://file", data.size(), 1);
+    ASSERT_EQ(CACHE_RC_OK, cache.Open());
+    EXPECT_EQ(0, cache.FillFromStore(BLOCK));
+    WriteAll(cache, data);
+    cache.Close();
+  }
+
+  CPersistentCache cache(new CCircularCache(4 * BLOCK, BLOCK), "test://file", data.size(), 1);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+  EXPECT_TRUE(cache.Reset(BLOCK));
+  EXPECT_EQ(static_cast<int>(BLOCK + 1000), cache.FillFromStore(4 * BLOCK));
+
+  std::vector<char> buf(BLOCK);
+  EXPECT_EQ(static_cast<int>(BLOCK), cache.ReadFromCache(buf.data(), buf.size()));
+  EXPECT_EQ(0, memcmp(data.data() + BLOCK, buf.data(), BLOCK));
+  cache.Close();
+
+  // modified source
+  CPersistentCache changed(new CCircularCache(4 * BLOCK, BLOCK), "test://file", data.size(), 2);
+  ASSERT_EQ(CACHE_RC_OK, changed.Open());
+  EXPECT_EQ(0, changed.FillFromStore(4 * BLOCK));
+}
+
+TEST_F(TestPersistentCache, Eviction)
+{
+  CPersistentCacheStore& store = CPersistentCacheStore::GetInstance();
+  store.Configure(TEST_FOLDER, 3 * BLOCK);
+
+  const std::vector<char> data = MakeData(2 * BLOCK);
+  for (const char* url : { "test://first", "test://second" })
+  {
+    CPersistentCache cache(new CCircularCache(4 * BLOCK, BLOCK), url, data.size(), 1);
+    ASSERT_EQ(CACHE_RC_OK, cache.Open());
+    WriteAll(cache, data);
+    cache.Close();
+  }
+
+  EXPECT_EQ(2 * BLOCK, store.GetCachedBytes());
+
+  CPersistentCache second(new CCircularCache(4 * BLOCK, BLOCK), "test://second", data.size(), 1);
+  ASSERT_EQ(CACHE_RC_OK, second.Open());
+  EXPECT_EQ(static_cast<int>(BLOCK), second.FillFromStore(BLOCK));
+}
+
+TEST_F(TestPersistentCache, BudgetOfOpenEntry)
+{
+  CPersistentCacheStore& store = CPersistentCacheStore::GetInstance();
+  store.Configure(TEST_FOLDER, 2 * BLOCK);
+
+  // the entry in use can't be evicted, it stops growing instead
+  const std::vector<char> data = MakeData(4 * BLOCK);
+  CPersistentCache cache(new CCircularCache(4 * BLOCK, BLOCK), "test://large", data.size(), 1);
+  ASSERT_EQ(CACHE_RC_OK, cache.Open());
+  WriteAll(cache, data, BLOCK / 2);
+  cache.Close();
+  EXPECT_EQ(2 * BLOCK, store.GetCachedBytes());
+
+  // older entries make room for the one in use
+  CPersistentCache other(new CCircularCache(4 * BLOCK, BLOCK), "test://other", data.size(), 1);
+  ASSERT_EQ(CACHE_RC_OK, other.Open());
+  WriteAll(other, data, BLOCK / 2);
+  other.Close();
+  EXPECT_EQ(2 * BLOCK, store.GetCachedBytes());
+
+  CPersistentCache large(new CCircularCache(4 * BLOCK, BLOCK), "test://large", data.size(), 1);
+  ASSERT_EQ(CACHE_RC_OK, large.Open());
+  EXPECT_EQ(0, large.FillFromStore(BLOCK));
+}
@@ -7,6 +7,7 @@
  */
 
 #include "GUIBaseContainer.h"
+#include "GUIComponent.h"
 #include "GUIListItemLayout.h"
 #include "GUIMessage.h"
 #include "ServiceBroker.h"
@@ -24,6 +25,10 @@
 #include "settings/Settings.h"
 #include "settings/SettingsComponent.h"
 #include "guilib/guiinfo/GUIInfoLabels.h"
+#include "GUILargeTextureManager.h"
+
+#include <algorithm>
+#include <cmath>
 
 #define HOLD_TIME_START 100
 #define HOLD_TIME_END   3000
@@ -52,6 +57,13 @@ CGUIBaseContainer::CGUIBaseContainer(int parentID, int controlID, float posX, fl
   m_autoScrollDelayTime = 0;
   m_autoScrollIsReversed = false;
   m_lastRenderTime = 0;
+  m_scrollVelocity = 0.0f;
+  m_lastScrollValue = 0.0f;
+  m_lastScrollTime = 0;
+  m_prefetchStart = 0;
+  m_prefetchEnd = 0;
+  m_scrollFrames = 0;
+  m_placeholderFrames = 0;
 }
 
 CGUIBaseContainer::CGUIBaseContainer(const CGUIBaseContainer &) = default;
@@ -111,6 +123,10 @@ void CGUIBaseContainer::Process(unsigned int currentTime, CDirtyRegionList &dirt
   pos += drawOffset;
   end += cacheAfter * m_layout->Size(m_orientation);
 
+  float visibleStart = (m_orientation == VERTICAL) ? m_posY : m_posX;
+  float visibleEnd = (m_orientation == VERTICAL) ? m_posY + m_height : m_posX + m_width;
+  bool placeholderShown = false;
+
   int current = offset - cacheBefore;
   while (pos < end && m_items.size())
   {
@@ -118,6 +134,7 @@ void CGUIBaseContainer::Process(unsigned int currentTime, CDirtyRegionList &dirt
     if (itemNo >= (int)m_items.size())
       break;
     bool focused = (current == GetOffset() + GetCursor());
+    float size = focused ? m_focusedLayout->Size(m_orientation) : m_layout->Size(m_orientation);
     if (itemNo >= 0)
     {
       CGUIListItemPtr item = m_items[itemNo];
@@ -126,12 +143,18 @@ void CGUIBaseContainer::Process(unsigned int currentTime, CDirtyRegionList &dirt
         ProcessItem(origin.x, pos, item, focused, currentTime, dirtyregions);
       else
         ProcessItem(pos, origin.y, item, focused, currentTime, dirtyregions);
+
+      if (!placeholderShown && pos < visibleEnd && pos + size > visibleStart)
+        placeholderShown = IsItemLoading(item, focused);
     }
     // increment our position
-    pos += focused ? m_focusedLayout->Size(m_orientation) : m_layout->Size(m_orientation);
+    pos += size;
     current++;
   }
 
+  UpdateScrollStats(placeholderShown);
+  UpdatePrefetch(offset, currentTime);
+
   // when we are scrolling up, offset will become lower (integer division, see offset calc)
   // to have same behaviour when scrolling down, we need to set page control to offset+1
   UpdatePageControl(offset + (m_scroller.IsScrollingDown() ? 1 : 0));
@@ -855,6 +878,7 @@ void CGUIBaseContainer::AllocResources()
 void CGUIBaseContainer::FreeResources(bool immediately)
 {
   CGUIControl::FreeResources(immediately);
+  CancelPrefetch();
   if (m_listProvider)
   {
     if (immediately)
@@ -1138,6 +1162,124 @@ void CGUIBaseContainer::Reset()
   m_items.clear();
   m_lastItem.reset();
   ResetAutoScrolling();
+  CancelPrefetch();
+}
+
+void CGUIBaseContainer::UpdatePrefetch(int offset, unsigned int currentTime)
+{
+  static const float min_prefetch_velocity = 2.0f; // rows per second
+  static const float prefetch_lookahead = 1.5f; // seconds of scrolling to prefetch for
+  static const int max_prefetch_pages = 4;
+
+  float size = m_layout->Size(m_orientation);
+  float value = m_scroller.GetValue();
+  if (m_lastScrollTime && currentTime > m_lastScrollTime && size > 0)
+  {
+    float velocity = (value - m_lastScrollValue) / size * 1000.0f / (currentTime - m_lastScrollTime);
+    m_scrollVelocity = 0.5f * (m_scrollVelocity + velocity);
+  }
+  m_lastScrollValue = value;
+  m_lastScrollTime = currentTime;
+
+  // once the scroll settles the visible items load their own images, drop
+  // the queued prefetches and let the loaded ones expire
+  if (!m_scroller.IsScrolling() && std::fabs(m_scrollVelocity) < min_prefetch_velocity)
+  {
+    if (!m_prefetchImages.empty())
+      CancelPrefetch();
+    return;
+  }
+
+  // keep the current window while scrolling slowly
+  if (std::fabs(m_scrollVelocity) >= min_prefetch_velocity && m_itemsPerPage > 0)
+  {
+    int pages = static_cast<int>(std::ceil(std::fabs(m_scrollVelocity) * prefetch_lookahead / m_itemsPerPage));
+    pages = std::min(pages, max_prefetch_pages);
+
+    int cacheBefore, cacheAfter;
+    GetCacheOffsets(cacheBefore, cacheAfter);
+    int start, end;
+    if (m_scrollVelocity > 0)
+    {
+      start = offset + m_itemsPerPage + 1 + cacheAfter;
+      end = start + pages * m_itemsPerPage;
+    }
+    else
+    {
+      end = offset - cacheBefore;
+      start = end - pages * m_itemsPerPage;
+    }
+
+    if (start != m_prefetchStart || end != m_prefetchEnd)
+    {
+      m_prefetchStart = start;
+      m_prefetchEnd = end;
+
+      // same range handling as FreeMemory, the window may wrap around
+      std::vector<int> itemNos;
+      int numItems = static_cast<int>(m_items.size());
+      int first = std::max(0, std::min(CorrectOffset(start, 0), numItems));
+      int last = std::max(0, std::min(CorrectOffset(end, 0), numItems));
+      if (first <= last)
+      {
+        for (int i = first; i < last; ++i)
+          itemNos.push_back(i);
+      }
+      else
+      {
+        for (int i = first; i < numItems; ++i)
+          itemNos.push_back(i);
+        for (int i = 0; i < last; ++i)
+          itemNos.push_back(i);
+      }
+      // the rows closest to the visible ones are needed first
+      if (m_scrollVelocity < 0)
+        std::reverse(itemNos.begin(), itemNos.end());
+
+      m_prefetchImages.clear();
+      for (int itemNo : itemNos)
+        m_layout->GetItemImages(m_items[itemNo].get(), m_prefetchImages);
+    }
+  }
+
+  if (!m_prefetchImages.empty())
+    CServiceBroker::GetGUI()->GetLargeTextureManager().PrefetchImages(this, m_prefetchImages);
+}
+
+void CGUIBaseContainer::CancelPrefetch()
+{
+  if (!m_prefetchImages.empty())
+    CServiceBroker::GetGUI()->GetLargeTextureManager().CancelPrefetch(this);
+  m_prefetchImages.clear();
+  m_prefetchStart = m_prefetchEnd = 0;
+  m_scrollVelocity = 0.0f;
+  m_lastScrollTime = 0;
+}
+
+void CGUIBaseContainer::UpdateScrollStats(bool placeholderShown)
+{
+  if (m_scroller.IsScrolling())
+  {
+    m_scrollFrames++;
+    if (placeholderShown)
+      m_placeholderFrames++;
+  }
+  else if (m_scrollFrames)
+  {
+    CLog::Log(LOGDEBUG, "CGUIBaseContainer: container %i showed loading images in %u of %u frames while scrolling",
+              GetID(), m_placeholderFrames, m_scrollFrames);
+    m_scrollFrames = 0;
+    m_placeholderFrames = 0;
+  }
+}
+
+bool CGUIBaseContainer::IsItemLoading(const CGUIListItemPtr &item, bool focused) const
+{
+  if (!m_scroller.IsScrolling())
+    return false;
+
+  const CGUIListItemLayout *layout = focused ? item->GetFocusedLayout() : item->GetLayout();
+  return layout && layout->IsLoading();
 }
 
 void CGUIBaseContainer::LoadLayout(TiXmlElement *layout)
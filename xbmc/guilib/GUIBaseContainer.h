@@ -13,6 +13,7 @@
 \brief
 */
 
+#include <string>
 #include <utility>
 #include <vector>
 #include <list>
@@ -156,6 +157,22 @@ protected:
   void SetContainerMoving(int direction);
   void UpdateScrollOffset(unsigned int currentTime);
 
+  /*! \brief Prefetch the images of the items the container is scrolling towards
+   The number of pages ahead of the visible ones that are prefetched depends on the scroll speed.
+   The prefetch is cancelled once the container stops scrolling.
+   \param offset the first visible row
+   \param currentTime the current frame time
+   \sa CGUILargeTextureManager::PrefetchImages
+   */
+  void UpdatePrefetch(int offset, unsigned int currentTime);
+  void CancelPrefetch();
+
+  /*! \brief Count the frames showing items whose images are still loading during a scroll
+   \param placeholderShown whether a visible item is still loading an image in this frame
+   */
+  void UpdateScrollStats(bool placeholderShown);
+  bool IsItemLoading(const CGUIListItemPtr &item, bool focused) const;
+
   CScroller m_scroller;
 
   IListProvider *m_listProvider;
@@ -226,6 +243,18 @@ private:
   std::string m_match;
   float m_scrollItemsPerFrame;
 
+  // image prefetching
+  float m_scrollVelocity; ///< smoothed scroll speed in rows per second, negative when scrolling up
+  float m_lastScrollValue;
+  unsigned int m_lastScrollTime;
+  int m_prefetchStart; ///< first row of the prefetch window
+  int m_prefetchEnd; ///< row after the last row of the prefetch window
+  std::vector<std::string> m_prefetchImages;
+
+  // placeholder telemetry of the current scroll
+  unsigned int m_scrollFrames;
+  unsigned int m_placeholderFrames;
+
   static const int letter_match_timeout = 1000;
 };
 
@@ -44,13 +44,20 @@ void CGUIComponent::Init()
   m_pWindowManager->AddMsgTarget(m_stereoscopicsManager.get());
 
   CServiceBroker::RegisterGUI(this);
+  m_initialized = true;
 }
 
 void CGUIComponent::Deinit()
 {
   CServiceBroker::UnregisterGUI();
 
+  // the managers may also be used standalone (e.g. by headless tools) without
+  // ever being initialized, so only tear down what Init() set up
+  if (!m_initialized)
+    return;
+
   m_pWindowManager->DeInitialize();
+  m_initialized = false;
 }
 
 CGUIWindowManager& CGUIComponent::GetWindowManager()
@@ -16,6 +16,7 @@
 #include "GUIWindowManager.h"
 #include "GUIControlProfiler.h"
 #include "GUITexture.h"
+#include "OcclusionTracker.h"
 #include "input/mouse/MouseStat.h"
 #include "input/InputManager.h"
 #include "input/Key.h"
@@ -47,6 +48,7 @@ CGUIControl::CGUIControl()
   m_controlDirtyState = DIRTY_STATE_CONTROL;
   m_stereo = 0.0f;
   m_controlStats = nullptr;
+  m_occluded = false;
 }
 
 CGUIControl::CGUIControl(int parentID, int controlID, float posX, float posY, float width, float height)
@@ -75,6 +77,7 @@ CGUIControl::CGUIControl(int parentID, int controlID, float posX, float posY, fl
   m_controlDirtyState = DIRTY_STATE_CONTROL;
   m_stereo = 0.0f;
   m_controlStats = nullptr;
+  m_occluded = false;
 }
 
 CGUIControl::CGUIControl(const CGUIControl &) = default;
@@ -118,6 +121,7 @@ void CGUIControl::DynamicResourceAlloc(bool bOnOff)
 void CGUIControl::DoProcess(unsigned int currentTime, CDirtyRegionList &dirtyregions)
 {
   CRect dirtyRegion = m_renderRegion;
+  bool moved = false;
 
   bool changed = (m_controlDirtyState & DIRTY_STATE_CONTROL) != 0 || (m_bInvalidated && IsVisible());
   m_controlDirtyState = 0;
@@ -138,6 +142,7 @@ void CGUIControl::DoProcess(unsigned int currentTime, CDirtyRegionList &dirtyreg
     {
       dirtyRegion.Union(m_renderRegion);
       changed = true;
+      moved = true;
     }
 
     if (m_hasCamera)
@@ -149,7 +154,9 @@ void CGUIControl::DoProcess(unsigned int currentTime, CDirtyRegionList &dirtyreg
 
   changed |= (m_controlDirtyState & DIRTY_STATE_CONTROL) != 0;
 
-  if (changed)
+  // changes behind opaque controls can't be seen while we stay in place. Should the
+  // occluding controls change or go away, they mark their own regions dirty.
+  if (changed && (!m_occluded || moved))
   {
     dirtyregions.emplace_back(dirtyRegion);
   }
@@ -168,7 +175,7 @@ void CGUIControl::Process(unsigned int currentTime, CDirtyRegionList &dirtyregio
 // 3. reset the animation transform
 void CGUIControl::DoRender()
 {
-  if (IsVisible())
+  if (IsVisible() && !m_occluded)
   {
     bool hasStereo = m_stereo != 0.0
                   && CServiceBroker::GetWinSystem()->GetGfxContext().GetStereoMode() != RENDER_STEREO_MODE_MONO
@@ -200,6 +207,23 @@ void CGUIControl::DoRender()
   }
 }
 
+void CGUIControl::UpdateOcclusion(COcclusionTracker &occlusion)
+{
+  m_occluded = false;
+  if (!IsVisible())
+    return;
+
+  if (occlusion.IsOccluded(m_renderRegion))
+  {
+    m_occluded = true;
+    return;
+  }
+
+  CRect opaqueRegion = GetOpaqueRegion();
+  if (!opaqueRegion.IsEmpty())
+    occlusion.AddOccluder(opaqueRegion);
+}
+
 bool CGUIControl::OnAction(const CAction &action)
 {
   if (HasFocus())
@@ -27,6 +27,7 @@ class CAction;
 class CMouseEvent;
 class CGUIMessage;
 class CGUIAction;
+class COcclusionTracker;
 
 enum ORIENTATION { HORIZONTAL = 0, VERTICAL };
 
@@ -185,6 +186,18 @@ public:
    */
   virtual CRect CalcRenderRegion() const;
 
+  /*! \brief Update whether this control is hidden behind opaque controls rendered after it
+   Called after processing, in reverse render order. Hidden controls aren't rendered and
+   don't mark themselves dirty as long as they stay in place.
+   \param occlusion the opaque regions of the controls visited so far
+   */
+  virtual void UpdateOcclusion(COcclusionTracker &occlusion);
+  bool IsOccluded() const { return m_occluded; };
+  /*! \brief return the region in screen coordinates this control fully covers with opaque pixels
+   Called during occlusion updates, empty if the control is (partially) transparent
+   */
+  virtual CRect GetOpaqueRegion() const { return CRect(); };
+
   /*! \brief Set actions to perform on navigation
    \param actions ActionMap of actions
    \sa SetNavigationAction
@@ -370,5 +383,6 @@ protected:
 
   unsigned int  m_controlDirtyState;
   CRect m_renderRegion;         // In screen coordinates
+  bool m_occluded;              // hidden behind opaque controls, see UpdateOcclusion()
 };
 
@@ -117,6 +117,31 @@ void CGUIControlGroup::Render()
   CServiceBroker::GetWinSystem()->GetGfxContext().RestoreOrigin();
 }
 
+void CGUIControlGroup::UpdateOcclusion(COcclusionTracker &occlusion)
+{
+  CGUIControl::UpdateOcclusion(occlusion);
+  if (!IsVisible())
+    return;
+
+  // visit the children in reverse render order, see Render()
+  CGUIControl *focusedControl = NULL;
+  if (m_renderFocusedLast)
+  {
+    for (auto *control : m_children)
+    {
+      if (control->HasFocus())
+        focusedControl = control;
+    }
+  }
+  if (focusedControl)
+    focusedControl->UpdateOcclusion(occlusion);
+  for (auto it = m_children.rbegin(); it != m_children.rend(); ++it)
+  {
+    if (*it != focusedControl)
+      (*it)->UpdateOcclusion(occlusion);
+  }
+}
+
 void CGUIControlGroup::RenderEx()
 {
   for (auto *control : m_children)
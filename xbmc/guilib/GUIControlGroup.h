@@ -33,6 +33,7 @@ public:
   void Process(unsigned int currentTime, CDirtyRegionList &dirtyregions) override;
   void Render() override;
   void RenderEx() override;
+  void UpdateOcclusion(COcclusionTracker &occlusion) override;
   bool OnAction(const CAction &action) override;
   bool OnMessage(CGUIMessage& message) override;
   virtual bool SendControlMessage(CGUIMessage& message);
@@ -128,6 +128,12 @@ void CGUIControlGroupList::Render()
   CGUIControl::Render();
 }
 
+void CGUIControlGroupList::UpdateOcclusion(COcclusionTracker &occlusion)
+{
+  // the children are clipped to the list, treat it as a single control
+  CGUIControl::UpdateOcclusion(occlusion);
+}
+
 bool CGUIControlGroupList::OnMessage(CGUIMessage& message)
 {
   switch (message.GetMessage() )
@@ -33,6 +33,7 @@ public:
 
   void Process(unsigned int currentTime, CDirtyRegionList &dirtyregions) override;
   void Render() override;
+  void UpdateOcclusion(COcclusionTracker &occlusion) override;
   bool OnMessage(CGUIMessage& message) override;
 
   EVENT_RESULT SendMouseEvent(const CPoint &point, const CMouseEvent &event) override;
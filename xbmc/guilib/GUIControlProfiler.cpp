@@ -7,6 +7,9 @@
  */
 
 #include "GUIControlProfiler.h"
+#include "GUIComponent.h"
+#include "GUIInfoManager.h"
+#include "ServiceBroker.h"
 #include "utils/XBMCTinyXML.h"
 #include "utils/TimeUtils.h"
 #include "utils/StringUtils.h"
@@ -240,6 +243,12 @@ void CGUIControlProfiler::Start(void)
   m_bIsRunning = true;
   m_pLastItem = NULL;
   m_ItemHead.Reset(this);
+
+  const INFO::InfoChangeTracker& tracker = CServiceBroker::GetGUI()->GetInfoManager().GetChangeTracker();
+  m_infoEvaluations = tracker.GetEvaluations();
+  m_infoCacheHits = tracker.GetCacheHits();
+  m_renderedArea = 0;
+  m_renderedFrames = 0;
 }
 
 void CGUIControlProfiler::BeginVisibility(CGUIControl *pControl)
@@ -266,6 +275,12 @@ void CGUIControlProfiler::EndRender(CGUIControl *pControl)
   item->EndRender();
 }
 
+void CGUIControlProfiler::AddRenderedArea(float area)
+{
+  m_renderedArea += area;
+  m_renderedFrames++;
+}
+
 CGUIControlProfilerItem *CGUIControlProfiler::FindOrAddControl(CGUIControl *pControl)
 {
   if (m_pLastItem)
@@ -328,6 +343,27 @@ bool CGUIControlProfiler::SaveResults(void)
   root->SetAttribute("timeunit", "ms");
   doc.LinkEndChild(root);
 
+  // how many infobool lookups had to be evaluated vs. were served from cache
+  const INFO::InfoChangeTracker& tracker = CServiceBroker::GetGUI()->GetInfoManager().GetChangeTracker();
+  unsigned int evaluations = tracker.GetEvaluations() - m_infoEvaluations;
+  unsigned int cacheHits = tracker.GetCacheHits() - m_infoCacheHits;
+  TiXmlElement *infoBools = new TiXmlElement("infobools");
+  str = StringUtils::Format("%u", evaluations);
+  infoBools->SetAttribute("evaluated", str.c_str());
+  str = StringUtils::Format("%u", cacheHits);
+  infoBools->SetAttribute("cached", str.c_str());
+  str = StringUtils::Format("%.1f", m_iFrameCount ? static_cast<double>(evaluations) / m_iFrameCount : 0.0);
+  infoBools->SetAttribute("evaluatedperframe", str.c_str());
+  root->LinkEndChild(infoBools);
+
+  // how much of the screen was actually drawn, after dirty regions and occlusion
+  TiXmlElement *rendered = new TiXmlElement("rendered");
+  str = StringUtils::Format("%u", m_renderedFrames);
+  rendered->SetAttribute("frames", str.c_str());
+  str = StringUtils::Format("%.0f", m_renderedFrames ? m_renderedArea / m_renderedFrames : 0.0);
+  rendered->SetAttribute("pixelsperframe", str.c_str());
+  root->LinkEndChild(rendered);
+
   m_ItemHead.SaveToXML(root);
   return doc.SaveFile(m_strOutputFile);
 }
@@ -0,0 +1,261 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "GUIFontAtlas.h"
+
+#include <algorithm>
+#include <limits>
+#include <string.h>
+
+const unsigned int CGUIFontAtlas::PAGE_HEIGHT;
+const unsigned int CGUIFontAtlas::NO_PAGE;
+
+CGUIFontAtlas::CGUIFontAtlas(unsigned int width, unsigned int maxHeight)
+  : m_width(width),
+    m_maxHeight(maxHeight / PAGE_HEIGHT * PAGE_HEIGHT)
+{
+}
+
+int CGUIFontAtlas::AllocateLine(IPageOwner* owner, unsigned int height, unsigned int frameTime)
+{
+  if (height == 0)
+    return -1;
+
+  // room for another line on a block of the owner
+  for (unsigned int i = 0; i < m_pages.size(); i += m_pages[i].count)
+  {
+    Page& page = m_pages[i];
+    if (page.owner == owner && page.lineHeight == height && page.usedRows + height <= page.count * PAGE_HEIGHT)
+    {
+      int y = i * PAGE_HEIGHT + page.usedRows;
+      page.usedRows += height;
+      page.lastUsed = frameTime;
+      return y;
+    }
+  }
+
+  const unsigned int pages = (height + PAGE_HEIGHT - 1) / PAGE_HEIGHT;
+  int block = FindFreeBlock(pages);
+  if (block < 0 && Grow(pages, owner))
+    block = FindFreeBlock(pages);
+  if (block < 0)
+    block = Evict(pages, owner, frameTime);
+  if (block < 0)
+    return -1;
+
+  Assign(block, pages, owner, height, height, frameTime);
+  return block * PAGE_HEIGHT;
+}
+
+int CGUIFontAtlas::AllocateBlock(IPageOwner* owner, unsigned int pages, unsigned int lineHeight, unsigned int usedRows, unsigned int frameTime)
+{
+  if (pages == 0 || lineHeight == 0 || usedRows > pages * PAGE_HEIGHT)
+    return -1;
+
+  int block = FindFreeBlock(pages);
+  if (block < 0 && Grow(pages, owner))
+    block = FindFreeBlock(pages);
+  if (block < 0)
+    return -1;
+
+  Assign(block, pages, owner, lineHeight, usedRows, frameTime);
+  return block * PAGE_HEIGHT;
+}
+
+void CGUIFontAtlas::ReleasePages(IPageOwner* owner)
+{
+  for (unsigned int i = 0; i < m_pages.size();)
+  {
+    unsigned int next = i + m_pages[i].count;
+    if (m_pages[i].owner == owner)
+      Free(i);
+    i = next;
+  }
+}
+
+unsigned int CGUIFontAtlas::GetPage(unsigned int y) const
+{
+  if (y >= m_height)
+    return NO_PAGE;
+  return m_pages[y / PAGE_HEIGHT].first;
+}
+
+void CGUIFontAtlas::Touch(unsigned int page, unsigned int frameTime)
+{
+  if (page < m_pages.size())
+    m_pages[m_pages[page].first].lastUsed = frameTime;
+}
+
+std::vector<unsigned int> CGUIFontAtlas::GetBlocks(const IPageOwner* owner) const
+{
+  std::vector<unsigned int> blocks;
+  for (unsigned int i = 0; i < m_pages.size(); i += m_pages[i].count)
+  {
+    if (m_pages[i].owner == owner)
+      blocks.push_back(i);
+  }
+  return blocks;
+}
+
+void CGUIFontAtlas::CopyToTexture(const unsigned char* pixels, unsigned int pitch, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2)
+{
+  x2 = std::min(x2, m_width);
+  y2 = std::min(y2, m_height);
+  if (x1 >= x2 || y1 >= y2)
+    return;
+
+  unsigned char* target = m_pixels.data() + y1 * m_width + x1;
+  for (unsigned int y = y1; y < y2; y++)
+  {
+    memcpy(target, pixels, x2 - x1);
+    pixels += pitch;
+    target += m_width;
+  }
+
+  UpdateTexture(x1, y1, x2, y2);
+}
+
+int CGUIFontAtlas::FindFreeBlock(unsigned int pages) const
+{
+  unsigned int run = 0;
+  for (unsigned int i = 0; i < m_pages.size(); i++)
+  {
+    run = m_pages[i].owner ? 0 : run + 1;
+    if (run == pages)
+      return i + 1 - pages;
+  }
+  return -1;
+}
+
+bool CGUIFontAtlas::Grow(unsigned int pages, const IPageOwner* owner)
+{
+  // resizing changes the texture coordinates of vertices waiting to be drawn
+  for (unsigned int i = 0; i < m_pages.size(); i += m_pages[i].count)
+  {
+    if (m_pages[i].owner && m_pages[i].owner != owner && m_pages[i].owner->IsDrawing())
+      return false;
+  }
+
+  // free pages at the end can be part of the new block
+  unsigned int usedPages = m_pages.size();
+  while (usedPages > 0 && !m_pages[usedPages - 1].owner)
+    usedPages--;
+  const unsigned int neededHeight = (usedPages + pages) * PAGE_HEIGHT;
+
+  unsigned int newHeight = m_height ? m_height * 2 : PAGE_HEIGHT;
+  while (newHeight < neededHeight)
+    newHeight *= 2;
+  if (newHeight > m_maxHeight)
+    newHeight = m_maxHeight;
+  if (newHeight < neededHeight || newHeight <= m_height)
+    return false;
+
+  const unsigned int oldHeight = m_height;
+  m_height = newHeight;
+  m_pixels.resize(m_width * m_height, 0);
+  if (!ResizeTexture(oldHeight))
+  {
+    m_height = oldHeight;
+    m_pixels.resize(m_width * m_height);
+    return false;
+  }
+
+  for (unsigned int i = m_pages.size(); i < m_height / PAGE_HEIGHT; i++)
+  {
+    Page page;
+    page.first = i;
+    page.count = 1;
+    m_pages.push_back(page);
+  }
+
+  std::vector<IPageOwner*> owners;
+  for (unsigned int i = 0; i < m_pages.size(); i += m_pages[i].count)
+  {
+    if (m_pages[i].owner && std::find(owners.begin(), owners.end(), m_pages[i].owner) == owners.end())
+      owners.push_back(m_pages[i].owner);
+  }
+  for (auto owner : owners)
+    owner->OnAtlasResized();
+
+  return true;
+}
+
+int CGUIFontAtlas::Evict(unsigned int pages, const IPageOwner* owner, unsigned int frameTime)
+{
+  // pick the run of pages whose most recently used block is the oldest, every
+  // block overlapping the run is taken back
+  int best = -1;
+  unsigned int bestAge = 0;
+  for (unsigned int start = 0; start + pages <= m_pages.size(); start++)
+  {
+    bool usable = true;
+    unsigned int age = std::numeric_limits<unsigned int>::max();
+    for (unsigned int i = m_pages[start].first; i < start + pages && usable; i += m_pages[i].count)
+    {
+      const Page& page = m_pages[i];
+      if (!page.owner)
+        continue;
+      if (page.lastUsed == frameTime || (page.owner != owner && page.owner->IsDrawing()))
+        usable = false;
+      else
+        age = std::min(age, frameTime - page.lastUsed);
+    }
+    if (usable && (best < 0 || age > bestAge))
+    {
+      best = start;
+      bestAge = age;
+    }
+  }
+  if (best < 0)
+    return -1;
+
+  for (unsigned int i = m_pages[best].first; i < best + pages;)
+  {
+    unsigned int next = i + m_pages[i].count;
+    if (m_pages[i].owner)
+    {
+      m_pages[i].owner->OnPageEvicted(i);
+      Free(i);
+    }
+    i = next;
+  }
+  return best;
+}
+
+void CGUIFontAtlas::Assign(unsigned int page, unsigned int pages, IPageOwner* owner, unsigned int lineHeight, unsigned int usedRows, unsigned int frameTime)
+{
+  for (unsigned int i = page; i < page + pages; i++)
+  {
+    m_pages[i].owner = owner;
+    m_pages[i].first = page;
+    m_pages[i].count = 0;
+  }
+
+  Page& first = m_pages[page];
+  first.count = pages;
+  first.lineHeight = lineHeight;
+  first.usedRows = usedRows;
+  first.lastUsed = frameTime;
+}
+
+void CGUIFontAtlas::Free(unsigned int page)
+{
+  const unsigned int pages = m_pages[page].count;
+  for (unsigned int i = page; i < page + pages; i++)
+  {
+    m_pages[i] = Page();
+    m_pages[i].first = i;
+    m_pages[i].count = 1;
+  }
+
+  // clear the pixels, new glyphs won't necessarily cover the old ones
+  const unsigned int y1 = page * PAGE_HEIGHT;
+  const unsigned int y2 = (page + pages) * PAGE_HEIGHT;
+  memset(m_pixels.data() + y1 * m_width, 0, (y2 - y1) * m_width);
+  UpdateTexture(0, y1, m_width, y2);
+}
@@ -0,0 +1,154 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include <vector>
+
+/*!
+ \ingroup textures
+ \brief Glyph texture shared by the fonts loaded from one font file
+
+ The texture is split into pages of PAGE_HEIGHT rows. A font is handed whole
+ pages (a block of several pages if its lines are taller than a page) and fills
+ them with lines of its glyphs, so all sizes of a font draw from one texture.
+
+ The texture grows by doubling its height. Once it has reached the maximum
+ height, the least recently used page is taken back from its font and handed
+ out again. Pages drawn from in the current frame are never taken back.
+
+ The pixels are kept in system memory as well, the backends upload changed
+ rows to their hardware texture.
+ */
+class CGUIFontAtlas
+{
+public:
+  /*!
+   \brief A font drawing from the atlas
+   */
+  class IPageOwner
+  {
+  public:
+    virtual ~IPageOwner() = default;
+
+    /*!
+     \brief The block starting at page was taken back, the glyphs on it must no longer be used
+     */
+    virtual void OnPageEvicted(unsigned int page) = 0;
+
+    /*!
+     \brief The height of the texture changed, texture coordinates must be recalculated
+     */
+    virtual void OnAtlasResized() = 0;
+
+    /*!
+     \brief Whether vertices referring to the texture are waiting to be drawn
+     */
+    virtual bool IsDrawing() const = 0;
+  };
+
+  static const unsigned int PAGE_HEIGHT = 256;
+  static const unsigned int NO_PAGE = static_cast<unsigned int>(-1);
+
+  CGUIFontAtlas(unsigned int width, unsigned int maxHeight);
+  virtual ~CGUIFontAtlas() = default;
+
+  /*!
+   \brief Get a line of glyphs for a font
+   Uses the free rows of a block of the font with the same line height, then
+   a free block, then grows the texture, and finally takes back the least
+   recently used block that isn't drawn from in frameTime.
+   \param owner the font the line is for
+   \param height height of the line in rows
+   \param frameTime the current frame time
+   \return the top row of the line, -1 if there is no room
+   */
+  int AllocateLine(IPageOwner* owner, unsigned int height, unsigned int frameTime);
+
+  /*!
+   \brief Get a block of free pages, e.g. to restore glyphs rasterized earlier
+   Grows the texture if needed, but never takes back pages of other fonts.
+   \param owner the font the block is for
+   \param pages number of pages of the block
+   \param lineHeight height of the lines in the block
+   \param usedRows number of rows of the block already filled with lines
+   \param frameTime the current frame time
+   \return the top row of the block, -1 if there is no room
+   */
+  int AllocateBlock(IPageOwner* owner, unsigned int pages, unsigned int lineHeight, unsigned int usedRows, unsigned int frameTime);
+
+  /*!
+   \brief Give back all pages of a font
+   */
+  void ReleasePages(IPageOwner* owner);
+
+  /*!
+   \brief Get the first page of the block holding a row
+   */
+  unsigned int GetPage(unsigned int y) const;
+
+  /*!
+   \brief Remember that the block starting at page is drawn from at frameTime
+   */
+  void Touch(unsigned int page, unsigned int frameTime);
+
+  /*!
+   \brief Get the first pages of the blocks of a font
+   */
+  std::vector<unsigned int> GetBlocks(const IPageOwner* owner) const;
+  unsigned int GetBlockPages(unsigned int page) const { return m_pages[page].count; }
+  unsigned int GetBlockLineHeight(unsigned int page) const { return m_pages[page].lineHeight; }
+  unsigned int GetBlockUsedRows(unsigned int page) const { return m_pages[page].usedRows; }
+
+  /*!
+   \brief Copy pixels into the texture
+   \param pixels the pixels to copy, 8 bit alpha
+   \param pitch bytes per row of pixels
+   */
+  void CopyToTexture(const unsigned char* pixels, unsigned int pitch, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2);
+
+  const unsigned char* GetPixels() const { return m_pixels.data(); }
+  unsigned int GetWidth() const { return m_width; }
+  unsigned int GetHeight() const { return m_height; }
+
+protected:
+  /*!
+   \brief Resize the hardware texture to GetHeight() rows, keeping its contents
+   \param oldHeight the height before resizing, 0 if there is no texture yet
+   */
+  virtual bool ResizeTexture(unsigned int oldHeight) = 0;
+
+  /*!
+   \brief Upload the given rectangle of GetPixels() to the hardware texture
+   */
+  virtual void UpdateTexture(unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2) = 0;
+
+private:
+  struct Page
+  {
+    IPageOwner* owner = nullptr;
+    unsigned int first = 0;      // first page of the block the page belongs to
+    // only valid on the first page of a block
+    unsigned int count = 0;
+    unsigned int lineHeight = 0;
+    unsigned int usedRows = 0;
+    unsigned int lastUsed = 0;
+  };
+
+  int FindFreeBlock(unsigned int pages) const;
+  bool Grow(unsigned int pages, const IPageOwner* owner);
+  int Evict(unsigned int pages, const IPageOwner* owner, unsigned int frameTime);
+  void Assign(unsigned int page, unsigned int pages, IPageOwner* owner, unsigned int lineHeight, unsigned int usedRows, unsigned int frameTime);
+  void Free(unsigned int page);
+
+  unsigned int m_width;
+  unsigned int m_height = 0;
+  unsigned int m_maxHeight;
+  std::vector<Page> m_pages;
+  std::vector<unsigned char> m_pixels;
+};
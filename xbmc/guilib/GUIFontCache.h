@@ -93,12 +93,15 @@ struct CGUIFontCacheHash
 {
   size_t operator()(const CGUIFontCacheKey<Position> &key) const
   {
-    /* Not much effort has gone into choosing this hash function */
-    size_t hash = 0, i;
-    for (i = 0; i < 3 && i < key.m_text.size(); ++i)
-      hash += key.m_text[i];
-    if (key.m_colors.size())
-      hash += key.m_colors[0];
+    /* Hash the whole text, labels sharing a prefix (e.g. list items) would
+     * otherwise all end up in the same bucket */
+    size_t hash = 2166136261u;
+    for (size_t i = 0; i < key.m_text.size(); ++i)
+      hash = (hash ^ key.m_text[i]) * 16777619u;
+    for (size_t i = 0; i < key.m_colors.size(); ++i)
+      hash = (hash ^ key.m_colors[i]) * 16777619u;
+    hash = (hash ^ key.m_alignment) * 16777619u;
+    hash = (hash ^ static_cast<size_t>(key.m_scrolling)) * 16777619u;
     hash += static_cast<size_t>(MatrixHashContribution(key)); // horrible
     return hash;
   }
@@ -9,21 +9,32 @@
 #include "GUIFont.h"
 #include "GUIFontTTF.h"
 #include "GUIFontManager.h"
-#include "Texture.h"
 #include "windowing/GraphicContext.h"
 #include "ServiceBroker.h"
+#include "Util.h"
 #include "filesystem/SpecialProtocol.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/SettingsComponent.h"
+#include "utils/Archive.h"
+#include "utils/Crc32.h"
 #include "utils/MathUtils.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
 #include "utils/log.h"
 #include "rendering/RenderSystem.h"
 #include "windowing/WinSystem.h"
 #include "URL.h"
 #include "filesystem/File.h"
+#include "threads/SingleLock.h"
 #include "threads/SystemClock.h"
+#include "utils/TimeUtils.h"
 
+#include <algorithm>
+#include <map>
 #include <math.h>
 #include <memory>
 #include <queue>
+#include <stdexcept>
 
 // stuff for freetype
 #include <ft2build.h>
@@ -45,10 +56,45 @@
 #endif
 #endif
 
-#define CHARS_PER_TEXTURE_LINE 20 // number of characters to cache per texture line
 #define CHAR_CHUNK    64      // 64 chars allocated at a time (1024 bytes)
 #define GLYPH_STRENGTH_BOLD 24
 #define GLYPH_STRENGTH_LIGHT -48
+#define MAX_ATLAS_WIDTH 2048  // room for about 20 characters per line of the largest fonts
+
+namespace
+{
+
+const unsigned int GLYPH_CACHE_MAGIC = 0x4b464743; // "KFGC"
+//! bump whenever the format or the way glyphs are rasterized changes
+const unsigned int GLYPH_CACHE_VERSION = 1;
+
+const std::string GLYPH_CACHE_FOLDER = "special://temp/fontcache/";
+
+//! atlases by font file, all sizes of a font draw from the same texture
+CCriticalSection atlasSection;
+std::map<std::string, std::weak_ptr<CGUIFontAtlas>> atlases;
+
+bool GetFileInfo(const std::string& path, long long& mtime, long long& size)
+{
+  struct __stat64 st;
+  if (XFILE::CFile::Stat(path, &st) != 0)
+    return false;
+  mtime = static_cast<long long>(st.st_mtime);
+  size = static_cast<long long>(st.st_size);
+  return true;
+}
+
+//! CArchive zero-fills reads past the end of the file, so counts are checked against what fits into it
+unsigned int ReadCount(CArchive& ar, int64_t fileSize, int64_t entrySize)
+{
+  unsigned int count;
+  ar >> count;
+  if (static_cast<int64_t>(count) * entrySize > fileSize)
+    throw std::out_of_range("count exceeds file size");
+  return count;
+}
+
+} // unnamed namespace
 
 
 class CFreeTypeLibrary
@@ -151,7 +197,6 @@ XBMC_GLOBAL_REF(CFreeTypeLibrary, g_freeTypeLibrary); // our freetype library
 
 CGUIFontTTFBase::CGUIFontTTFBase(const std::string& strFileName) : m_staticCache(*this), m_dynamicCache(*this)
 {
-  m_texture = NULL;
   m_char = NULL;
   m_maxChars = 0;
   m_nestedBeginCount = 0;
@@ -167,11 +212,10 @@ CGUIFontTTFBase::CGUIFontTTFBase(const std::string& strFileName) : m_staticCache
   m_cellBaseLine = m_cellHeight = 0;
   m_numChars = 0;
   m_posX = m_posY = 0;
-  m_textureHeight = m_textureWidth = 0;
+  m_useGlyphCache = m_glyphCacheChanged = false;
   m_textureScaleX = m_textureScaleY = 0.0;
   m_ellipsesWidth = m_height = 0.0f;
   m_color = 0;
-  m_nTexture = 0;
 
   m_renderSystem = CServiceBroker::GetRenderSystem();
 }
@@ -197,26 +241,31 @@ void CGUIFontTTFBase::RemoveReference()
 
 void CGUIFontTTFBase::ClearCharacterCache()
 {
-  delete(m_texture);
-
-  DeleteHardwareTexture();
+  if (m_atlas)
+    m_atlas->ReleasePages(this);
 
-  m_texture = NULL;
   delete[] m_char;
   m_char = new Character[CHAR_CHUNK];
   memset(m_charquick, 0, sizeof(m_charquick));
   m_numChars = 0;
   m_maxChars = CHAR_CHUNK;
-  // set the posX and posY so that our texture will be created on first character write.
-  m_posX = m_textureWidth;
-  m_posY = -(int)GetTextureLineHeight();
-  m_textureHeight = 0;
+  // set the posX and posY so that a line will be allocated on first character write.
+  m_posX = m_atlas ? m_atlas->GetWidth() : 0;
+  m_posY = -1;
+
+  // cached vertices refer to the dropped characters
+  m_staticCache.Flush();
+  m_dynamicCache.Flush();
 }
 
 void CGUIFontTTFBase::Clear()
 {
-  delete(m_texture);
-  m_texture = NULL;
+  if (m_atlas)
+  {
+    SaveGlyphCache();
+    m_atlas->ReleasePages(this);
+    m_atlas.reset();
+  }
   delete[] m_char;
   memset(m_charquick, 0, sizeof(m_charquick));
   m_char = NULL;
@@ -224,6 +273,7 @@ void CGUIFontTTFBase::Clear()
   m_numChars = 0;
   m_posX = 0;
   m_posY = 0;
+  m_glyphCacheChanged = false;
   m_nestedBeginCount = 0;
 
   if (m_face)
@@ -298,8 +348,8 @@ bool CGUIFontTTFBase::Load(const std::string& strFilename, float height, float a
 
   m_height = height;
 
-  delete(m_texture);
-  m_texture = NULL;
+  if (m_atlas)
+    m_atlas->ReleasePages(this);
   delete[] m_char;
   m_char = NULL;
 
@@ -308,18 +358,16 @@ bool CGUIFontTTFBase::Load(const std::string& strFilename, float height, float a
 
   m_strFilename = strFilename;
 
-  m_textureHeight = 0;
-  m_textureWidth = ((m_cellHeight * CHARS_PER_TEXTURE_LINE) & ~63) + 64;
-
-  m_textureWidth = CBaseTexture::PadPow2(m_textureWidth);
+  m_atlas = GetAtlas(strFilename);
+  m_textureScaleX = 1.0f / m_atlas->GetWidth();
+  if (m_atlas->GetHeight())
+    m_textureScaleY = 1.0f / m_atlas->GetHeight();
 
-  if (m_textureWidth > m_renderSystem->GetMaxTextureSize())
-    m_textureWidth = m_renderSystem->GetMaxTextureSize();
-  m_textureScaleX = 1.0f / m_textureWidth;
+  // set the posX and posY so that a line will be allocated on first character write.
+  m_posX = m_atlas->GetWidth();
+  m_posY = -1;
 
-  // set the posX and posY so that our texture will be created on first character write.
-  m_posX = m_textureWidth;
-  m_posY = -(int)GetTextureLineHeight();
+  LoadGlyphCache();
 
   // cache the ellipses width
   Character *ellipse = GetCharacter(L'.');
@@ -330,7 +378,7 @@ bool CGUIFontTTFBase::Load(const std::string& strFilename, float height, float a
 
 void CGUIFontTTFBase::Begin()
 {
-  if (m_nestedBeginCount == 0 && m_texture != NULL && FirstBegin())
+  if (m_nestedBeginCount == 0 && m_atlas && m_atlas->GetHeight() && FirstBegin())
   {
     m_vertexTrans.clear();
     m_vertex.clear();
@@ -608,12 +656,14 @@ CGUIFontTTFBase::Character* CGUIFontTTFBase::GetCharacter(character_t chr)
   if (letter == L'\r')
     return NULL;
 
+  Character *found = NULL;
+
   // quick access to ascii chars
   if (letter < 255)
   {
     character_t ch = (style << 8) | letter;
-    if (ch < LOOKUPTABLE_SIZE && m_charquick[ch])
-      return m_charquick[ch];
+    if (ch < LOOKUPTABLE_SIZE)
+      found = m_charquick[ch];
   }
 
   // letters are stored based on style and letter
@@ -621,7 +671,7 @@ CGUIFontTTFBase::Character* CGUIFontTTFBase::GetCharacter(character_t chr)
 
   int low = 0;
   int high = m_numChars - 1;
-  while (low <= high)
+  while (!found && low <= high)
   {
     int mid = (low + high) >> 1;
     if (ch > m_char[mid].letterAndStyle)
@@ -629,39 +679,28 @@ CGUIFontTTFBase::Character* CGUIFontTTFBase::GetCharacter(character_t chr)
     else if (ch < m_char[mid].letterAndStyle)
       high = mid - 1;
     else
-      return &m_char[mid];
+      found = &m_char[mid];
   }
-  // if we get to here, then low is where we should insert the new character
-
-  // increase the size of the buffer if we need it
-  if (m_numChars >= m_maxChars)
-  { // need to increase the size of the buffer
-    Character *newTable = new Character[m_maxChars + CHAR_CHUNK];
-    if (m_char)
-    {
-      memcpy(newTable, m_char, low * sizeof(Character));
-      memcpy(newTable + low + 1, m_char + low, (m_numChars - low) * sizeof(Character));
-      delete[] m_char;
-    }
-    m_char = newTable;
-    m_maxChars += CHAR_CHUNK;
 
+  if (found)
+  {
+    // remember the page is in use, so it isn't reused while the text is drawn
+    if (found->page != CGUIFontAtlas::NO_PAGE)
+      m_atlas->Touch(found->page, CTimeUtils::GetFrameTime());
+    return found;
   }
-  else
-  { // just move the data along as necessary
-    memmove(m_char + low + 1, m_char + low, (m_numChars - low) * sizeof(Character));
-  }
+
   // render the character to our texture
   // must End() as we can't render text to our texture during a Begin(), End() block
+  Character newChar;
   unsigned int nestedBeginCount = m_nestedBeginCount;
   m_nestedBeginCount = 1;
   if (nestedBeginCount) End();
-  if (!CacheCharacter(letter, style, m_char + low))
+  if (!CacheCharacter(letter, style, &newChar))
   { // unable to cache character - try clearing them all out and starting over
     CLog::Log(LOGDEBUG, "%s: Unable to cache character.  Clearing character cache of %i characters", __FUNCTION__, m_numChars);
     ClearCharacterCache();
-    low = 0;
-    if (!CacheCharacter(letter, style, m_char + low))
+    if (!CacheCharacter(letter, style, &newChar))
     {
       CLog::Log(LOGERROR, "%s: Unable to cache character (out of memory?)", __FUNCTION__);
       if (nestedBeginCount) Begin();
@@ -672,7 +711,46 @@ CGUIFontTTFBase::Character* CGUIFontTTFBase::GetCharacter(character_t chr)
   if (nestedBeginCount) Begin();
   m_nestedBeginCount = nestedBeginCount;
 
-  // fixup quick access
+  // find where to insert the new character, caching may have dropped others
+  low = 0;
+  high = m_numChars - 1;
+  while (low <= high)
+  {
+    int mid = (low + high) >> 1;
+    if (ch > m_char[mid].letterAndStyle)
+      low = mid + 1;
+    else
+      high = mid - 1;
+  }
+
+  // increase the size of the buffer if we need it
+  if (m_numChars >= m_maxChars)
+  { // need to increase the size of the buffer
+    Character *newTable = new Character[m_maxChars + CHAR_CHUNK];
+    if (m_char)
+    {
+      memcpy(newTable, m_char, low * sizeof(Character));
+      memcpy(newTable + low + 1, m_char + low, (m_numChars - low) * sizeof(Character));
+      delete[] m_char;
+    }
+    m_char = newTable;
+    m_maxChars += CHAR_CHUNK;
+
+  }
+  else
+  { // just move the data along as necessary
+    memmove(m_char + low + 1, m_char + low, (m_numChars - low) * sizeof(Character));
+  }
+  m_char[low] = newChar;
+  m_numChars++;
+
+  UpdateQuickLookup();
+
+  return m_char + low;
+}
+
+void CGUIFontTTFBase::UpdateQuickLookup()
+{
   memset(m_charquick, 0, sizeof(m_charquick));
   for(int i=0;i<m_numChars;i++)
   {
@@ -682,8 +760,316 @@ CGUIFontTTFBase::Character* CGUIFontTTFBase::GetCharacter(character_t chr)
       m_charquick[ch] = m_char+i;
     }
   }
+}
+
+bool CGUIFontTTFBase::NextTextureLine()
+{
+  int posY = m_atlas->AllocateLine(this, GetTextureLineHeight(), CTimeUtils::GetFrameTime());
+  if (posY < 0)
+  {
+    CLog::Log(LOGDEBUG, "%s: No room left in the glyph atlas of %s", __FUNCTION__, m_strFileName.c_str());
+    return false;
+  }
 
-  return m_char + low;
+  m_posX = 0;
+  m_posY = posY;
+  m_textureScaleY = 1.0f / m_atlas->GetHeight();
+  return true;
+}
+
+void CGUIFontTTFBase::OnPageEvicted(unsigned int page)
+{
+  // drop the characters on that page
+  int numChars = 0;
+  for (int i = 0; i < m_numChars; i++)
+  {
+    if (m_char[i].page != page)
+      m_char[numChars++] = m_char[i];
+  }
+  CLog::Log(LOGDEBUG, "%s: Glyph atlas page %u of %s is reused, dropping %i characters", __FUNCTION__, page, m_strFileName.c_str(), m_numChars - numChars);
+  m_numChars = numChars;
+  UpdateQuickLookup();
+
+  // cached vertices may refer to the dropped characters
+  m_staticCache.Flush();
+  m_dynamicCache.Flush();
+
+  if (m_posY >= 0 && m_atlas->GetPage(m_posY) == page)
+  {
+    m_posX = m_atlas->GetWidth();
+    m_posY = -1;
+  }
+}
+
+void CGUIFontTTFBase::OnAtlasResized()
+{
+  m_textureScaleY = 1.0f / m_atlas->GetHeight();
+
+  // cached vertices hold texture coordinates for the old height
+  m_staticCache.Flush();
+  m_dynamicCache.Flush();
+}
+
+bool CGUIFontTTFBase::IsDrawing() const
+{
+  return m_nestedBeginCount > 0;
+}
+
+std::shared_ptr<CGUIFontAtlas> CGUIFontTTFBase::GetAtlas(const std::string& fontPath)
+{
+  CSingleLock lock(atlasSection);
+
+  std::shared_ptr<CGUIFontAtlas> atlas = atlases[fontPath].lock();
+  if (!atlas)
+  {
+    unsigned int maxTextureSize = m_renderSystem->GetMaxTextureSize();
+    atlas.reset(CreateAtlas(std::min<unsigned int>(maxTextureSize, MAX_ATLAS_WIDTH), maxTextureSize));
+    atlases[fontPath] = atlas;
+
+    // forget the atlases of fonts that are no longer loaded
+    for (auto it = atlases.begin(); it != atlases.end();)
+    {
+      if (it->second.expired())
+        it = atlases.erase(it);
+      else
+        ++it;
+    }
+  }
+  return atlas;
+}
+
+std::string CGUIFontTTFBase::GetGlyphCachePath() const
+{
+  return URIUtils::AddFileToFolder(GLYPH_CACHE_FOLDER, StringUtils::Format("%08x.bin", Crc32::ComputeFromLowerCase(m_strFileName)));
+}
+
+void CGUIFontTTFBase::LoadGlyphCache()
+{
+  m_useGlyphCache = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_guiFontCache;
+  if (!m_useGlyphCache)
+    return;
+
+  const std::string path = GetGlyphCachePath();
+
+  XFILE::CFile file;
+  if (!file.Open(path))
+    return;
+
+  std::vector<Character> chars;
+  bool loaded = false;
+  try
+  {
+    CArchive ar(&file, CArchive::load);
+    loaded = ReadGlyphCache(ar, file.GetLength(), chars);
+    ar.Close();
+  }
+  catch (const std::out_of_range&)
+  {
+    CLog::Log(LOGERROR, "%s: corrupt glyph cache %s for %s", __FUNCTION__, path.c_str(), m_strFileName.c_str());
+    loaded = false;
+  }
+  file.Close();
+
+  if (!loaded)
+  {
+    // give back the pages restored before the error
+    m_atlas->ReleasePages(this);
+    return;
+  }
+
+  std::sort(chars.begin(), chars.end(), [](const Character& a, const Character& b) {
+    return a.letterAndStyle < b.letterAndStyle;
+  });
+  m_maxChars = (chars.size() / CHAR_CHUNK + 1) * CHAR_CHUNK;
+  m_char = new Character[m_maxChars];
+  std::copy(chars.begin(), chars.end(), m_char);
+  m_numChars = static_cast<int>(chars.size());
+  UpdateQuickLookup();
+
+  CLog::Log(LOGDEBUG, "%s: restored %i characters of %s", __FUNCTION__, m_numChars, m_strFileName.c_str());
+}
+
+bool CGUIFontTTFBase::ReadGlyphCache(CArchive& ar, int64_t fileSize, std::vector<Character>& chars)
+{
+  unsigned int magic, version;
+  ar >> magic;
+  ar >> version;
+  if (magic != GLYPH_CACHE_MAGIC || version != GLYPH_CACHE_VERSION)
+    return false;
+
+  // the glyphs are only valid for the same font file, size and rasterizer
+  std::string name, fontPath;
+  long long mtime, size, currentMtime, currentSize;
+  int major, minor, patch;
+  unsigned int cellHeight, cellBaseLine, width, pageHeight;
+  ar >> name;
+  ar >> fontPath;
+  ar >> mtime;
+  ar >> size;
+  ar >> major;
+  ar >> minor;
+  ar >> patch;
+  ar >> cellHeight;
+  ar >> cellBaseLine;
+  ar >> width;
+  ar >> pageHeight;
+  if (name != m_strFileName || fontPath != m_strFilename ||
+      !GetFileInfo(m_strFilename, currentMtime, currentSize) || mtime != currentMtime || size != currentSize ||
+      major != FREETYPE_MAJOR || minor != FREETYPE_MINOR || patch != FREETYPE_PATCH ||
+      cellHeight != m_cellHeight || cellBaseLine != m_cellBaseLine ||
+      width != m_atlas->GetWidth() || pageHeight != CGUIFontAtlas::PAGE_HEIGHT)
+  {
+    CLog::Log(LOGDEBUG, "%s: glyph cache of %s is outdated", __FUNCTION__, m_strFileName.c_str());
+    return false;
+  }
+
+  auto readCharacters = [&ar, fileSize, &chars](int top, unsigned int page) {
+    const unsigned int count = ReadCount(ar, fileSize, sizeof(character_t) + 2 * sizeof(short) + 5 * sizeof(float));
+    for (unsigned int i = 0; i < count; i++)
+    {
+      Character ch;
+      ar >> ch.letterAndStyle;
+      ar >> ch.offsetX;
+      ar >> ch.offsetY;
+      ar >> ch.left;
+      ar >> ch.top;
+      ar >> ch.right;
+      ar >> ch.bottom;
+      ar >> ch.advance;
+      if (top < 0)
+        continue; // the block couldn't be restored, the character is rasterized again when needed
+      ch.top += top;
+      ch.bottom += top;
+      ch.page = page;
+      chars.push_back(ch);
+    }
+  };
+
+  // blocks are restored while there is room, they never take pages from other fonts
+  const unsigned int frameTime = CTimeUtils::GetFrameTime();
+  // pages, line height, used rows and the length of the pixels
+  const unsigned int blockCount = ReadCount(ar, fileSize, 4 * sizeof(unsigned int));
+  for (unsigned int block = 0; block < blockCount; block++)
+  {
+    unsigned int pages, lineHeight, usedRows;
+    std::string pixels;
+    ar >> pages;
+    ar >> lineHeight;
+    ar >> usedRows;
+    ar >> pixels;
+    if (pixels.size() != static_cast<size_t>(usedRows) * width)
+      throw std::out_of_range("invalid block");
+
+    int top = m_atlas->AllocateBlock(this, pages, lineHeight, usedRows, frameTime);
+    if (top >= 0)
+      m_atlas->CopyToTexture(reinterpret_cast<const unsigned char*>(pixels.data()), width, 0, top, width, top + usedRows);
+    readCharacters(top, top >= 0 ? m_atlas->GetPage(top) : CGUIFontAtlas::NO_PAGE);
+  }
+
+  // characters without pixels
+  readCharacters(0, CGUIFontAtlas::NO_PAGE);
+
+  ar >> magic;
+  if (magic != GLYPH_CACHE_MAGIC)
+    throw std::out_of_range("truncated");
+
+  return true;
+}
+
+void CGUIFontTTFBase::SaveGlyphCache()
+{
+  if (!m_useGlyphCache || !m_glyphCacheChanged)
+    return;
+
+  long long mtime, size;
+  if (!GetFileInfo(m_strFilename, mtime, size))
+    return;
+
+  const std::string path = GetGlyphCachePath();
+  if (!CUtil::CreateDirectoryEx(URIUtils::GetDirectory(path)))
+    return;
+
+  // renamed over the old cache once complete, a partial cache is never left behind
+  const std::string tempPath = path + ".tmp";
+  XFILE::CFile file;
+  if (!file.OpenForWrite(tempPath, true))
+  {
+    CLog::Log(LOGWARNING, "%s: unable to write %s", __FUNCTION__, tempPath.c_str());
+    return;
+  }
+
+  const unsigned int width = m_atlas->GetWidth();
+
+  CArchive ar(&file, CArchive::store);
+  ar << GLYPH_CACHE_MAGIC;
+  ar << GLYPH_CACHE_VERSION;
+  ar << m_strFileName;
+  ar << m_strFilename;
+  ar << mtime;
+  ar << size;
+  ar << static_cast<int>(FREETYPE_MAJOR);
+  ar << static_cast<int>(FREETYPE_MINOR);
+  ar << static_cast<int>(FREETYPE_PATCH);
+  ar << m_cellHeight;
+  ar << m_cellBaseLine;
+  ar << width;
+  ar << CGUIFontAtlas::PAGE_HEIGHT;
+
+  // texture coordinates are stored relative to the top of their block
+  auto writeCharacters = [this, &ar](int top, unsigned int page) {
+    unsigned int count = 0;
+    for (int i = 0; i < m_numChars; i++)
+    {
+      if (m_char[i].page == page)
+        count++;
+    }
+    ar << count;
+    for (int i = 0; i < m_numChars; i++)
+    {
+      const Character& ch = m_char[i];
+      if (ch.page != page)
+        continue;
+      ar << ch.letterAndStyle;
+      ar << ch.offsetX;
+      ar << ch.offsetY;
+      ar << ch.left;
+      ar << ch.top - top;
+      ar << ch.right;
+      ar << ch.bottom - top;
+      ar << ch.advance;
+    }
+  };
+
+  const std::vector<unsigned int> blocks = m_atlas->GetBlocks(this);
+  ar << static_cast<unsigned int>(blocks.size());
+  for (unsigned int page : blocks)
+  {
+    const unsigned int top = page * CGUIFontAtlas::PAGE_HEIGHT;
+    const unsigned int usedRows = m_atlas->GetBlockUsedRows(page);
+    ar << m_atlas->GetBlockPages(page);
+    ar << m_atlas->GetBlockLineHeight(page);
+    ar << usedRows;
+    ar << std::string(reinterpret_cast<const char*>(m_atlas->GetPixels() + top * width), usedRows * width);
+    writeCharacters(top, page);
+  }
+
+  // characters without pixels
+  writeCharacters(0, CGUIFontAtlas::NO_PAGE);
+
+  ar << GLYPH_CACHE_MAGIC;
+  ar.Close();
+  file.Close();
+
+  // not every platform replaces an existing file on rename
+  if (!XFILE::CFile::Rename(tempPath, path) &&
+      (!XFILE::CFile::Delete(path) || !XFILE::CFile::Rename(tempPath, path)))
+  {
+    CLog::Log(LOGWARNING, "%s: unable to replace %s", __FUNCTION__, path.c_str());
+    XFILE::CFile::Delete(tempPath);
+    return;
+  }
+
+  m_glyphCacheChanged = false;
 }
 
 bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *ch)
@@ -730,42 +1116,15 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
 
     // check we have enough room for the character.
     // cast-fest is here to avoid warnings due to freeetype version differences (signedness of width).
-    if (static_cast<int>(m_posX + bitGlyph->left + bitmap.width) > static_cast<int>(m_textureWidth))
-    { // no space - gotta drop to the next line (which means creating a new texture and copying it across)
-      m_posX = 0;
-      m_posY += GetTextureLineHeight();
-      if (bitGlyph->left < 0)
-        m_posX += -bitGlyph->left;
-
-      if(m_posY + GetTextureLineHeight() >= m_textureHeight)
+    if (m_posY < 0 || static_cast<int>(m_posX + bitGlyph->left + bitmap.width) > static_cast<int>(m_atlas->GetWidth()))
+    { // no space - gotta drop to the next line (which may mean growing the atlas or reusing a page)
+      if (!NextTextureLine())
       {
-        // create the new larger texture
-        unsigned int newHeight = m_posY + GetTextureLineHeight();
-        // check for max height
-        if (newHeight > m_renderSystem->GetMaxTextureSize())
-        {
-          CLog::Log(LOGDEBUG, "%s: New cache texture is too large (%u > %u pixels long)", __FUNCTION__, newHeight, m_renderSystem->GetMaxTextureSize());
-          FT_Done_Glyph(glyph);
-          return false;
-        }
-
-        CBaseTexture* newTexture = NULL;
-        newTexture = ReallocTexture(newHeight);
-        if(newTexture == NULL)
-        {
-          FT_Done_Glyph(glyph);
-          CLog::Log(LOGDEBUG, "%s: Failed to allocate new texture of height %u", __FUNCTION__, newHeight);
-          return false;
-        }
-        m_texture = newTexture;
+        FT_Done_Glyph(glyph);
+        return false;
       }
-    }
-
-    if(m_texture == NULL)
-    {
-      FT_Done_Glyph(glyph);
-      CLog::Log(LOGDEBUG, "%s: no texture to cache character to", __FUNCTION__);
-      return false;
+      if (bitGlyph->left < 0)
+        m_posX += -bitGlyph->left;
     }
   }
   // set the character in our table
@@ -777,20 +1136,37 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
   ch->right = ch->left + bitmap.width;
   ch->bottom = ch->top + bitmap.rows;
   ch->advance = (float)MathUtils::round_int( (float)m_face->glyph->advance.x / 64 );
+  ch->page = isEmptyGlyph ? CGUIFontAtlas::NO_PAGE : m_atlas->GetPage(m_posY);
 
   // we need only render if we actually have some pixels
   if (!isEmptyGlyph)
   {
-    // ensure our rect will stay inside the texture (it *should* but we need to be certain)
-    unsigned int x1 = std::max(m_posX + ch->offsetX, 0);
-    unsigned int y1 = std::max(m_posY + ch->offsetY, 0);
-    unsigned int x2 = std::min(x1 + bitmap.width, m_textureWidth);
-    unsigned int y2 = std::min(y1 + bitmap.rows, m_textureHeight);
-    CopyCharToTexture(bitGlyph, x1, y1, x2, y2);
-
     m_posX += spacing_between_characters_in_texture + (unsigned short)std::max(ch->right - ch->left + ch->offsetX, ch->advance);
+
+    // ensure our rect will stay inside the line (it *should* but we need to be certain),
+    // rows outside of it would overwrite the glyphs of other lines or fonts
+    int lineTop = m_posY;
+    int lineBottom = m_posY + GetTextureLineHeight() - spacing_between_characters_in_texture;
+    int skipRows = std::max(lineTop - static_cast<int>(ch->top), 0);
+    ch->top += skipRows;
+    ch->offsetY += skipRows;
+    ch->bottom = std::min(ch->bottom, static_cast<float>(lineBottom));
+    if (ch->bottom > ch->top)
+    {
+      unsigned int x1 = std::max(static_cast<int>(ch->left), 0);
+      unsigned int y1 = static_cast<unsigned int>(ch->top);
+      unsigned int x2 = std::min(x1 + bitmap.width, m_atlas->GetWidth());
+      unsigned int y2 = static_cast<unsigned int>(ch->bottom);
+      m_atlas->CopyToTexture(bitmap.buffer + skipRows * bitmap.pitch, bitmap.pitch, x1, y1, x2, y2);
+    }
+    else
+    {
+      ch->left = ch->top = ch->right = ch->bottom = 0;
+      ch->page = CGUIFontAtlas::NO_PAGE;
+    }
+    m_atlas->Touch(m_atlas->GetPage(m_posY), CTimeUtils::GetFrameTime());
   }
-  m_numChars++;
+  m_glyphCacheChanged = true;
 
   // free the glyph
   FT_Done_Glyph(glyph);
@@ -8,10 +8,12 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 #include <stdint.h>
 #include <vector>
 
+#include "GUIFontAtlas.h"
 #include "utils/auto_buffer.h"
 #include "utils/Color.h"
 #include "utils/Geometry.h"
@@ -26,7 +28,7 @@ using namespace DirectX::PackedVector;
 
 constexpr size_t LOOKUPTABLE_SIZE = 256 * 8;
 
-class CBaseTexture;
+class CArchive;
 class CRenderSystemBase;
 
 struct FT_FaceRec_;
@@ -64,7 +66,7 @@ struct SVertex
 #include "GUIFontCache.h"
 
 
-class CGUIFontTTFBase
+class CGUIFontTTFBase : public CGUIFontAtlas::IPageOwner
 {
   friend class CGUIFont;
 
@@ -92,6 +94,7 @@ protected:
     float left, top, right, bottom;
     float advance;
     character_t letterAndStyle;
+    unsigned int page;  // atlas block the character is on, CGUIFontAtlas::NO_PAGE if it has no pixels
   };
   void AddReference();
   void RemoveReference();
@@ -114,21 +117,40 @@ protected:
   bool CacheCharacter(wchar_t letter, uint32_t style, Character *ch);
   void RenderCharacter(float posX, float posY, const Character *ch, UTILS::Color color, bool roundX, std::vector<SVertex> &vertices);
   void ClearCharacterCache();
+  void UpdateQuickLookup();
 
-  virtual CBaseTexture* ReallocTexture(unsigned int& newHeight) = 0;
-  virtual bool CopyCharToTexture(FT_BitmapGlyph bitGlyph, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2) = 0;
-  virtual void DeleteHardwareTexture() = 0;
+  /*! \brief Move to the start of a new line in the atlas
+   \return false if the atlas has no room for another line
+   */
+  bool NextTextureLine();
+
+  // CGUIFontAtlas::IPageOwner
+  void OnPageEvicted(unsigned int page) override;
+  void OnAtlasResized() override;
+  bool IsDrawing() const override;
+
+  /*! \brief Get the atlas shared by all fonts loaded from fontPath
+   */
+  std::shared_ptr<CGUIFontAtlas> GetAtlas(const std::string& fontPath);
+  virtual CGUIFontAtlas* CreateAtlas(unsigned int width, unsigned int maxHeight) const = 0;
+
+  /*! \brief Restore the glyphs rasterized by an earlier run, see advancedsettings <gui><fontcache>
+   */
+  void LoadGlyphCache();
+  void SaveGlyphCache();
+  bool ReadGlyphCache(CArchive& ar, int64_t fileSize, std::vector<Character>& chars);
+  std::string GetGlyphCachePath() const;
 
   // modifying glyphs
   void SetGlyphStrength(FT_GlyphSlot slot, int glyphStrength);
   static void ObliqueGlyph(FT_GlyphSlot slot);
 
-  CBaseTexture* m_texture;        // texture that holds our rendered characters (8bit alpha only)
+  std::shared_ptr<CGUIFontAtlas> m_atlas; // texture that holds our rendered characters (8bit alpha only)
 
-  unsigned int m_textureWidth;       // width of our texture
-  unsigned int m_textureHeight;      // height of our texture
-  int m_posX;                        // current position in the texture
-  int m_posY;
+  int m_posX;                        // current position in the atlas
+  int m_posY;                        // top of the current line, -1 if there is none
+  bool m_useGlyphCache;              // restore and store the rasterized characters on disk
+  bool m_glyphCacheChanged;          // characters were rasterized since the glyph cache was read
 
   /*! \brief the height of each line in the texture.
    Accounts for spacing between lines to avoid characters overlapping.
@@ -157,8 +179,6 @@ protected:
   float m_originX;
   float m_originY;
 
-  unsigned int m_nTexture;
-
   struct CTranslatedVertices
   {
     float translateX;
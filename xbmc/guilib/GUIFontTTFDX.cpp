@@ -9,27 +9,60 @@
 #include "GUIFontTTFDX.h"
 #include "GUIFontManager.h"
 #include "GUIShaderDX.h"
-#include "Texture.h"
 #include "rendering/dx/DeviceResources.h"
 #include "rendering/dx/RenderContext.h"
 #include "utils/log.h"
 
-// stuff for freetype
-#include <ft2build.h>
-
 using namespace Microsoft::WRL;
 
-#ifdef TARGET_WINDOWS_STORE
-#define generic GenericFromFreeTypeLibrary
-#endif
+CGUIFontAtlasDX::CGUIFontAtlasDX(unsigned int width, unsigned int maxHeight)
+: CGUIFontAtlas(width, maxHeight)
+{
+}
+
+CGUIFontAtlasDX::~CGUIFontAtlasDX()
+{
+  delete m_texture;
+}
+
+bool CGUIFontAtlasDX::ResizeTexture(unsigned int oldHeight)
+{
+  CD3DTexture* newTexture = new CD3DTexture();
+  if (!newTexture->Create(GetWidth(), GetHeight(), 1, D3D11_USAGE_DEFAULT, DXGI_FORMAT_R8_UNORM))
+  {
+    CLog::LogF(LOGERROR, "Failed to create the font texture.");
+    delete newTexture;
+    return false;
+  }
+
+  // There might be data to copy from the previous texture
+  if (m_texture && oldHeight)
+  {
+    CD3D11_BOX rect(0, 0, 0, GetWidth(), oldHeight, 1);
+    ComPtr<ID3D11DeviceContext> pContext = DX::DeviceResources::Get()->GetImmediateContext();
+    pContext->CopySubresourceRegion(newTexture->Get(), 0, 0, 0, 0, m_texture->Get(), 0, &rect);
+  }
+  delete m_texture;
+  m_texture = newTexture;
+
+  // the new rows are empty
+  UpdateTexture(0, oldHeight, GetWidth(), GetHeight());
+  return true;
+}
 
-#include FT_FREETYPE_H
-#include FT_GLYPH_H
+void CGUIFontAtlasDX::UpdateTexture(unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2)
+{
+  ComPtr<ID3D11DeviceContext> pContext = DX::DeviceResources::Get()->GetImmediateContext();
+  if (m_texture && m_texture->Get() && pContext)
+  {
+    CD3D11_BOX dstBox(x1, y1, 0, x2, y2, 1);
+    pContext->UpdateSubresource(m_texture->Get(), 0, &dstBox, GetPixels() + y1 * GetWidth() + x1, GetWidth(), 0);
+  }
+}
 
 CGUIFontTTFDX::CGUIFontTTFDX(const std::string& strFileName)
 : CGUIFontTTFBase(strFileName)
 {
-  m_speedupTexture = nullptr;
   m_vertexBuffer   = nullptr;
   m_vertexWidth    = 0;
   m_buffers.clear();
@@ -40,11 +73,6 @@ CGUIFontTTFDX::~CGUIFontTTFDX(void)
 {
   DX::Windowing()->Unregister(this);
 
-  if (m_speedupTexture)
-  {
-    delete m_speedupTexture;
-    m_speedupTexture = nullptr;
-  }
   m_vertexBuffer = nullptr;
   m_staticIndexBuffer = nullptr;
   if (!m_buffers.empty())
@@ -89,7 +117,7 @@ void CGUIFontTTFDX::LastEnd()
 
   CGUIShaderDX* pGUIShader = DX::Windowing()->GetGUIShader();
   // Set font texture as shader resource
-  pGUIShader->SetShaderViews(1, m_speedupTexture->GetAddressOfSRV());
+  pGUIShader->SetShaderViews(1, static_cast<CGUIFontAtlasDX*>(m_atlas.get())->GetAddressOfSRV());
   // Enable alpha blend
   DX::Windowing()->SetAlphaBlendEnable(true);
   // Set our static index buffer
@@ -215,71 +243,9 @@ void CGUIFontTTFDX::ClearReference(CGUIFontTTFDX* font, CD3DBuffer* pBuffer)
     font->m_buffers.erase(it);
 }
 
-CBaseTexture* CGUIFontTTFDX::ReallocTexture(unsigned int& newHeight)
-{
-  assert(newHeight != 0);
-  assert(m_textureWidth != 0);
-  if(m_textureHeight == 0)
-  {
-    delete m_texture;
-    m_texture = nullptr;
-    delete m_speedupTexture;
-    m_speedupTexture = nullptr;
-  }
-  m_staticCache.Flush();
-  m_dynamicCache.Flush();
-
-  CDXTexture* pNewTexture = new CDXTexture(m_textureWidth, newHeight, XB_FMT_A8);
-  CD3DTexture* newSpeedupTexture = new CD3DTexture();
-  if (!newSpeedupTexture->Create(m_textureWidth, newHeight, 1, D3D11_USAGE_DEFAULT, DXGI_FORMAT_R8_UNORM))
-  {
-    delete newSpeedupTexture;
-    delete pNewTexture;
-    return nullptr;
-  }
-
-  // There might be data to copy from the previous texture
-  if (newSpeedupTexture && m_speedupTexture)
-  {
-    CD3D11_BOX rect(0, 0, 0, m_textureWidth, m_textureHeight, 1);
-    ComPtr<ID3D11DeviceContext> pContext = DX::DeviceResources::Get()->GetImmediateContext();
-    pContext->CopySubresourceRegion(newSpeedupTexture->Get(), 0, 0, 0, 0, m_speedupTexture->Get(), 0, &rect);
-  }
-
-  if (m_texture)
-  {
-    delete m_texture;
-    m_texture = nullptr;
-  }
-  if (m_speedupTexture)
-  {
-    delete m_speedupTexture;
-    m_speedupTexture = nullptr;
-  }
-  m_textureHeight = newHeight;
-  m_textureScaleY = 1.0f / m_textureHeight;
-  m_speedupTexture = newSpeedupTexture;
-
-  return pNewTexture;
-}
-
-bool CGUIFontTTFDX::CopyCharToTexture(FT_BitmapGlyph bitGlyph, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2)
-{
-  FT_Bitmap bitmap = bitGlyph->bitmap;
-
-  ComPtr<ID3D11DeviceContext> pContext = DX::DeviceResources::Get()->GetImmediateContext();
-  if (m_speedupTexture && m_speedupTexture->Get() && pContext && bitmap.buffer)
-  {
-    CD3D11_BOX dstBox(x1, y1, 0, x2, y2, 1);
-    pContext->UpdateSubresource(m_speedupTexture->Get(), 0, &dstBox, bitmap.buffer, bitmap.pitch, 0);
-    return true;
-  }
-
-  return false;
-}
-
-void CGUIFontTTFDX::DeleteHardwareTexture()
+CGUIFontAtlas* CGUIFontTTFDX::CreateAtlas(unsigned int width, unsigned int maxHeight) const
 {
+  return new CGUIFontAtlasDX(width, maxHeight);
 }
 
 bool CGUIFontTTFDX::UpdateDynamicVertexBuffer(const SVertex* pSysMem, unsigned int vertex_count)
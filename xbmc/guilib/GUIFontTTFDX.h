@@ -21,6 +21,22 @@
 
 #define ELEMENT_ARRAY_MAX_CHAR_INDEX (2000)
 
+class CGUIFontAtlasDX : public CGUIFontAtlas
+{
+public:
+  CGUIFontAtlasDX(unsigned int width, unsigned int maxHeight);
+  ~CGUIFontAtlasDX() override;
+
+  ID3D11ShaderResourceView** GetAddressOfSRV() const { return m_texture->GetAddressOfSRV(); }
+
+protected:
+  bool ResizeTexture(unsigned int oldHeight) override;
+  void UpdateTexture(unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2) override;
+
+private:
+  CD3DTexture* m_texture = nullptr;
+};
+
 /*!
  \ingroup textures
  \brief
@@ -43,9 +59,7 @@ public:
   static void DestroyStaticIndexBuffer(void);
 
 protected:
-  CBaseTexture* ReallocTexture(unsigned int& newHeight) override;
-  bool CopyCharToTexture(FT_BitmapGlyph bitGlyph, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2) override;
-  void DeleteHardwareTexture() override;
+  CGUIFontAtlas* CreateAtlas(unsigned int width, unsigned int maxHeight) const override;
 
 private:
   bool UpdateDynamicVertexBuffer(const SVertex* pSysMem, unsigned int count);
@@ -53,7 +67,6 @@ private:
   static void ClearReference(CGUIFontTTFDX* font, CD3DBuffer* pBuffer);
 
   unsigned m_vertexWidth;
-  CD3DTexture* m_speedupTexture;  // extra texture to speed up reallocations
   Microsoft::WRL::ComPtr<ID3D11Buffer> m_vertexBuffer;
   std::list<CD3DBuffer*> m_buffers;
 
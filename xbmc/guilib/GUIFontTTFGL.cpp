@@ -9,7 +9,6 @@
 #include "GUIFont.h"
 #include "GUIFontTTFGL.h"
 #include "GUIFontManager.h"
-#include "Texture.h"
 #include "TextureManager.h"
 #include "windowing/GraphicContext.h"
 #include "ServiceBroker.h"
@@ -23,33 +22,21 @@
 #endif
 #include "rendering/MatrixGL.h"
 
-// stuff for freetype
-#include <ft2build.h>
-#include FT_FREETYPE_H
-#include FT_GLYPH_H
-#include FT_OUTLINE_H
-
 #define ELEMENT_ARRAY_MAX_CHAR_INDEX (1000)
 #define BUFFER_OFFSET(i) ((char *)NULL + (i))
 
-CGUIFontTTFGL::CGUIFontTTFGL(const std::string& strFileName)
-: CGUIFontTTFBase(strFileName)
+CGUIFontAtlasGL::CGUIFontAtlasGL(unsigned int width, unsigned int maxHeight)
+: CGUIFontAtlas(width, maxHeight)
 {
-  m_updateY1 = 0;
-  m_updateY2 = 0;
-  m_textureStatus = TEXTURE_VOID;
 }
 
-CGUIFontTTFGL::~CGUIFontTTFGL(void)
+CGUIFontAtlasGL::~CGUIFontAtlasGL()
 {
-  // It's important that all the CGUIFontCacheEntry objects are
-  // destructed before the CGUIFontTTFGL goes out of scope, because
-  // our virtual methods won't be accessible after this point
-  m_dynamicCache.Flush();
-  DeleteHardwareTexture();
+  if (m_textureStatus != TEXTURE_VOID && glIsTexture(m_texture))
+    CServiceBroker::GetGUI()->GetTextureManager().ReleaseHwTexture(m_texture);
 }
 
-bool CGUIFontTTFGL::FirstBegin()
+void CGUIFontAtlasGL::Bind()
 {
 #if defined(HAS_GL)
   GLenum pixformat = GL_RED;
@@ -68,25 +55,25 @@ bool CGUIFontTTFGL::FirstBegin()
 
   if (m_textureStatus == TEXTURE_REALLOCATED)
   {
-    if (glIsTexture(m_nTexture))
-      CServiceBroker::GetGUI()->GetTextureManager().ReleaseHwTexture(m_nTexture);
+    if (glIsTexture(m_texture))
+      CServiceBroker::GetGUI()->GetTextureManager().ReleaseHwTexture(m_texture);
     m_textureStatus = TEXTURE_VOID;
   }
 
   if (m_textureStatus == TEXTURE_VOID)
   {
     // Have OpenGL generate a texture object handle for us
-    glGenTextures(1, (GLuint*) &m_nTexture);
+    glGenTextures(1, &m_texture);
 
     // Bind the texture object
-    glBindTexture(GL_TEXTURE_2D, m_nTexture);
+    glBindTexture(GL_TEXTURE_2D, m_texture);
 
     // Set the texture's stretching properties
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
     // Set the texture image -- THIS WORKS, so the pixels must be wrong.
-    glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, m_texture->GetWidth(), m_texture->GetHeight(), 0,
+    glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, GetWidth(), GetHeight(), 0,
         pixformat, GL_UNSIGNED_BYTE, 0);
 
     VerifyGLState();
@@ -95,19 +82,77 @@ bool CGUIFontTTFGL::FirstBegin()
 
   if (m_textureStatus == TEXTURE_UPDATED)
   {
-    glBindTexture(GL_TEXTURE_2D, m_nTexture);
-    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, m_updateY1, m_texture->GetWidth(), m_updateY2 - m_updateY1, pixformat, GL_UNSIGNED_BYTE,
-        m_texture->GetPixels() + m_updateY1 * m_texture->GetPitch());
+    glBindTexture(GL_TEXTURE_2D, m_texture);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, m_updateY1, GetWidth(), m_updateY2 - m_updateY1, pixformat, GL_UNSIGNED_BYTE,
+        GetPixels() + m_updateY1 * GetWidth());
 
     m_updateY1 = m_updateY2 = 0;
     m_textureStatus = TEXTURE_READY;
   }
 
+  glActiveTexture(GL_TEXTURE0);
+  glBindTexture(GL_TEXTURE_2D, m_texture);
+}
+
+bool CGUIFontAtlasGL::ResizeTexture(unsigned int oldHeight)
+{
+  // the texture is recreated on the next Bind(), with all of its rows
+  m_updateY1 = 0;
+  m_updateY2 = GetHeight();
+  m_textureStatus = TEXTURE_REALLOCATED;
+  return true;
+}
+
+void CGUIFontAtlasGL::UpdateTexture(unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2)
+{
+  switch (m_textureStatus)
+  {
+  case TEXTURE_UPDATED:
+    {
+      m_updateY1 = std::min(m_updateY1, y1);
+      m_updateY2 = std::max(m_updateY2, y2);
+    }
+    break;
+
+  case TEXTURE_READY:
+    {
+      m_updateY1 = y1;
+      m_updateY2 = y2;
+      m_textureStatus = TEXTURE_UPDATED;
+    }
+    break;
+
+  case TEXTURE_REALLOCATED:
+    {
+      m_updateY2 = std::max(m_updateY2, y2);
+    }
+    break;
+
+  case TEXTURE_VOID:
+  default:
+    break;
+  }
+}
+
+CGUIFontTTFGL::CGUIFontTTFGL(const std::string& strFileName)
+: CGUIFontTTFBase(strFileName)
+{
+}
+
+CGUIFontTTFGL::~CGUIFontTTFGL(void)
+{
+  // It's important that all the CGUIFontCacheEntry objects are
+  // destructed before the CGUIFontTTFGL goes out of scope, because
+  // our virtual methods won't be accessible after this point
+  m_dynamicCache.Flush();
+}
+
+bool CGUIFontTTFGL::FirstBegin()
+{
   // Turn Blending On
   glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE_MINUS_DST_ALPHA, GL_ONE);
   glEnable(GL_BLEND);
-  glActiveTexture(GL_TEXTURE0);
-  glBindTexture(GL_TEXTURE_2D, m_nTexture);
+  static_cast<CGUIFontAtlasGL*>(m_atlas.get())->Bind();
   return true;
 }
 
@@ -305,104 +350,9 @@ void CGUIFontTTFGL::DestroyVertexBuffer(CVertexBuffer &buffer) const
   }
 }
 
-CBaseTexture* CGUIFontTTFGL::ReallocTexture(unsigned int& newHeight)
-{
-  newHeight = CBaseTexture::PadPow2(newHeight);
-
-  CBaseTexture* newTexture = new CTexture(m_textureWidth, newHeight, XB_FMT_A8);
-
-  if (!newTexture || newTexture->GetPixels() == NULL)
-  {
-    CLog::Log(LOGERROR, "GUIFontTTFGL::CacheCharacter: Error creating new cache texture for size %f", m_height);
-    delete newTexture;
-    return NULL;
-  }
-  m_textureHeight = newTexture->GetHeight();
-  m_textureScaleY = 1.0f / m_textureHeight;
-  m_textureWidth = newTexture->GetWidth();
-  m_textureScaleX = 1.0f / m_textureWidth;
-  if (m_textureHeight < newHeight)
-    CLog::Log(LOGWARNING, "%s: allocated new texture with height of %d, requested %d", __FUNCTION__, m_textureHeight, newHeight);
-  m_staticCache.Flush();
-  m_dynamicCache.Flush();
-
-  memset(newTexture->GetPixels(), 0, m_textureHeight * newTexture->GetPitch());
-  if (m_texture)
-  {
-    m_updateY1 = 0;
-    m_updateY2 = m_texture->GetHeight();
-
-    unsigned char* src = m_texture->GetPixels();
-    unsigned char* dst = newTexture->GetPixels();
-    for (unsigned int y = 0; y < m_texture->GetHeight(); y++)
-    {
-      memcpy(dst, src, m_texture->GetPitch());
-      src += m_texture->GetPitch();
-      dst += newTexture->GetPitch();
-    }
-    delete m_texture;
-  }
-
-  m_textureStatus = TEXTURE_REALLOCATED;
-
-  return newTexture;
-}
-
-bool CGUIFontTTFGL::CopyCharToTexture(FT_BitmapGlyph bitGlyph, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2)
-{
-  FT_Bitmap bitmap = bitGlyph->bitmap;
-
-  unsigned char* source = bitmap.buffer;
-  unsigned char* target = m_texture->GetPixels() + y1 * m_texture->GetPitch() + x1;
-
-  for (unsigned int y = y1; y < y2; y++)
-  {
-    memcpy(target, source, x2-x1);
-    source += bitmap.width;
-    target += m_texture->GetPitch();
-  }
-
-  switch (m_textureStatus)
-  {
-  case TEXTURE_UPDATED:
-    {
-      m_updateY1 = std::min(m_updateY1, y1);
-      m_updateY2 = std::max(m_updateY2, y2);
-    }
-    break;
-
-  case TEXTURE_READY:
-    {
-      m_updateY1 = y1;
-      m_updateY2 = y2;
-      m_textureStatus = TEXTURE_UPDATED;
-    }
-    break;
-
-  case TEXTURE_REALLOCATED:
-    {
-      m_updateY2 = std::max(m_updateY2, y2);
-    }
-    break;
-
-  case TEXTURE_VOID:
-  default:
-    break;
-  }
-
-  return true;
-}
-
-void CGUIFontTTFGL::DeleteHardwareTexture()
+CGUIFontAtlas* CGUIFontTTFGL::CreateAtlas(unsigned int width, unsigned int maxHeight) const
 {
-  if (m_textureStatus != TEXTURE_VOID)
-  {
-    if (glIsTexture(m_nTexture))
-      CServiceBroker::GetGUI()->GetTextureManager().ReleaseHwTexture(m_nTexture);
-
-    m_textureStatus = TEXTURE_VOID;
-    m_updateY1 = m_updateY2 = 0;
-  }
+  return new CGUIFontAtlasGL(width, maxHeight);
 }
 
 void CGUIFontTTFGL::CreateStaticVertexBuffers(void)
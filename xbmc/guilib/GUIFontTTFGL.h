@@ -14,6 +14,36 @@
 #include "GUIFontTTF.h"
 #include "system_gl.h"
 
+class CGUIFontAtlasGL : public CGUIFontAtlas
+{
+public:
+  CGUIFontAtlasGL(unsigned int width, unsigned int maxHeight);
+  ~CGUIFontAtlasGL() override;
+
+  /*! \brief Upload the changed rows and bind the texture
+   */
+  void Bind();
+
+protected:
+  bool ResizeTexture(unsigned int oldHeight) override;
+  void UpdateTexture(unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2) override;
+
+private:
+  GLuint m_texture = 0;
+  unsigned int m_updateY1 = 0;
+  unsigned int m_updateY2 = 0;
+
+  enum TextureStatus
+  {
+    TEXTURE_VOID = 0,
+    TEXTURE_READY,
+    TEXTURE_REALLOCATED,
+    TEXTURE_UPDATED,
+  };
+
+  TextureStatus m_textureStatus = TEXTURE_VOID;
+};
+
 class CGUIFontTTFGL : public CGUIFontTTFBase
 {
 public:
@@ -29,26 +59,11 @@ public:
   static void DestroyStaticVertexBuffers(void);
 
 protected:
-  CBaseTexture* ReallocTexture(unsigned int& newHeight) override;
-  bool CopyCharToTexture(FT_BitmapGlyph bitGlyph, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2) override;
-  void DeleteHardwareTexture() override;
+  CGUIFontAtlas* CreateAtlas(unsigned int width, unsigned int maxHeight) const override;
 
   static GLuint m_elementArrayHandle;
 
 private:
-  unsigned int m_updateY1;
-  unsigned int m_updateY2;
-
-  enum TextureStatus
-  {
-    TEXTURE_VOID = 0,
-    TEXTURE_READY,
-    TEXTURE_REALLOCATED,
-    TEXTURE_UPDATED,
-  };
-
-  TextureStatus m_textureStatus;
-
   static bool m_staticVertexBufferCreated;
 };
 
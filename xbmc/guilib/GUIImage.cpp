@@ -7,7 +7,10 @@
  */
 
 #include "GUIImage.h"
+#include "GUIComponent.h"
 #include "GUIMessage.h"
+#include "ServiceBroker.h"
+#include "TextureManager.h"
 #include "utils/log.h"
 
 #include <cassert>
@@ -156,6 +159,20 @@ void CGUIImage::Process(unsigned int currentTime, CDirtyRegionList &dirtyregions
     MarkDirtyRegion();
 
   CGUIControl::Process(currentTime, dirtyregions);
+
+  // the screen region we cover, only if the transform keeps the texture an opaque rectangle
+  m_opaqueRegion = CRect();
+  const TransformMatrix &transform = m_cachedTransform;
+  if (m_texture.IsOpaque() && transform.alpha >= 1.0f &&
+      transform.m[0][1] == 0.0f && transform.m[1][0] == 0.0f &&
+      transform.m[2][0] == 0.0f && transform.m[2][1] == 0.0f)
+  {
+    CRect rect(m_texture.GetRenderRect());
+    rect.Intersect(CRect(m_texture.GetXPosition(), m_texture.GetYPosition(),
+                         m_texture.GetXPosition() + m_texture.GetWidth(),
+                         m_texture.GetYPosition() + m_texture.GetHeight()));
+    m_opaqueRegion = CServiceBroker::GetWinSystem()->GetGfxContext().GenerateAABB(rect);
+  }
 }
 
 void CGUIImage::Render()
@@ -296,6 +313,18 @@ const std::string &CGUIImage::GetFileName() const
   return m_texture.GetFileName();
 }
 
+std::string CGUIImage::GetItemImage(const CGUIListItem *item) const
+{
+  if (m_info.IsConstant())
+    return "";
+
+  // same as CGUITextureBase::AllocResources
+  std::string image = m_info.GetItemLabel(item, true);
+  if (image.empty() || (!m_texture.IsLazyLoaded() && CServiceBroker::GetGUI()->GetTextureManager().CanLoad(image)))
+    return "";
+  return image;
+}
+
 void CGUIImage::SetAspectRatio(const CAspectRatio &aspect)
 {
   m_texture.SetAspectRatio(aspect);
@@ -81,10 +81,20 @@ public:
   void SetCrossFade(unsigned int time);
 
   const std::string& GetFileName() const;
+
+  /*! \brief Get the image this control would show for an item, if it's loaded in the background
+   \param item the list item
+   \return the image path, or empty if the image doesn't depend on the item or isn't lazily loaded
+   */
+  std::string GetItemImage(const CGUIListItem *item) const;
+
+  /*! \brief Whether the image is still being loaded in the background */
+  bool IsLoading() const { return m_texture.IsLoading(); };
   float GetTextureWidth() const;
   float GetTextureHeight() const;
 
   CRect CalcRenderRegion() const override;
+  CRect GetOpaqueRegion() const override { return m_opaqueRegion; };
 
 #ifdef _DEBUG
   void DumpTextureUse() override;
@@ -110,5 +120,6 @@ protected:
   unsigned int m_crossFadeTime;
   unsigned int m_currentFadeTime;
   unsigned int m_lastRenderTime;
+  CRect m_opaqueRegion;          ///< region in screen coordinates fully covered by the texture
 };
 
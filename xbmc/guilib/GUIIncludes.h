@@ -61,6 +61,14 @@ public:
    */
   const INFO::CSkinVariableString* CreateSkinVariable(const std::string& name, int context);
 
+  /*!
+   \brief Get the files the include components were loaded from so far. Includes
+   referenced by \code{file} attributes are loaded on demand while resolving.
+
+   \return the loaded files
+   */
+  const std::vector<std::string>& GetFiles() const { return m_files; }
+
 private:
   enum ResolveParamsResult
   {
@@ -7,6 +7,7 @@
  */
 
 #include "GUIListGroup.h"
+#include "GUIImage.h"
 #include "GUIListLabel.h"
 #include "utils/log.h"
 
@@ -79,6 +80,41 @@ void CGUIListGroup::UpdateVisibility(const CGUIListItem *item)
   m_item = item;
 }
 
+void CGUIListGroup::GetItemImages(const CGUIListItem *item, std::vector<std::string> &images) const
+{
+  for (ciControls it = m_children.begin(); it != m_children.end(); ++it)
+  {
+    if ((*it)->GetControlType() == CGUIControl::GUICONTROL_IMAGE)
+    {
+      std::string image = static_cast<const CGUIImage*>(*it)->GetItemImage(item);
+      if (!image.empty())
+        images.push_back(image);
+    }
+    else if ((*it)->GetControlType() == CGUIControl::GUICONTROL_LISTGROUP)
+      static_cast<const CGUIListGroup*>(*it)->GetItemImages(item, images);
+  }
+}
+
+bool CGUIListGroup::IsLoading() const
+{
+  for (ciControls it = m_children.begin(); it != m_children.end(); ++it)
+  {
+    if (!(*it)->IsVisible())
+      continue;
+    if ((*it)->GetControlType() == CGUIControl::GUICONTROL_IMAGE)
+    {
+      if (static_cast<const CGUIImage*>(*it)->IsLoading())
+        return true;
+    }
+    else if ((*it)->GetControlType() == CGUIControl::GUICONTROL_LISTGROUP)
+    {
+      if (static_cast<const CGUIListGroup*>(*it)->IsLoading())
+        return true;
+    }
+  }
+  return false;
+}
+
 void CGUIListGroup::UpdateInfo(const CGUIListItem *item)
 {
   for (iControls it = m_children.begin(); it != m_children.end(); it++)
@@ -15,6 +15,9 @@
 
 #include "GUIControlGroup.h"
 
+#include <string>
+#include <vector>
+
 /*!
  \ingroup controls
  \brief a group of controls within a list/panel container
@@ -44,6 +47,15 @@ public:
   void SetState(bool selected, bool focused);
   void SelectItemFromPoint(const CPoint &point);
 
+  /*! \brief Get the images that are loaded in the background when showing an item
+   \param item the list item
+   \param images [out] the images are appended to this list
+   */
+  void GetItemImages(const CGUIListItem *item, std::vector<std::string> &images) const;
+
+  /*! \brief Whether any of the images is still being loaded in the background */
+  bool IsLoading() const;
+
 protected:
   const CGUIListItem *m_item;
 };
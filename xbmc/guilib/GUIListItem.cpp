@@ -13,12 +13,11 @@
 #include "GUIListItemLayout.h"
 #include "utils/Archive.h"
 #include "utils/CharsetConverter.h"
-#include "utils/StringUtils.h"
 #include "utils/Variant.h"
 
-bool CGUIListItem::icompare::operator()(const std::string &s1, const std::string &s2) const
+namespace
 {
-  return StringUtils::CompareNoCase(s1, s2) < 0;
+const CGUIListItem::ArtMap emptyArt;
 }
 
 CGUIListItem::CGUIListItem(const CGUIListItem& item)
@@ -93,31 +92,48 @@ const std::wstring& CGUIListItem::GetSortLabel() const
   return m_sortLabel;
 }
 
+CGUIListItem::ArtMap &CGUIListItem::GetWritableArt(std::shared_ptr<ArtMap> &art)
+{
+  if (!art)
+    art = std::make_shared<ArtMap>();
+  else if (art.use_count() > 1)
+    art = std::make_shared<ArtMap>(*art);
+  return *art;
+}
+
 void CGUIListItem::SetArt(const std::string &type, const std::string &url)
 {
-  ArtMap::iterator i = m_art.find(type);
-  if (i == m_art.end() || i->second != url)
+  const ArtMap &art = GetArt();
+  ArtMap::const_iterator i = art.find(type);
+  if (i == art.end() || i->second != url)
   {
-    m_art[type] = url;
+    GetWritableArt(m_art)[type] = url;
     SetInvalid();
   }
 }
 
 void CGUIListItem::SetArt(const ArtMap &art)
 {
-  m_art = art;
+  if (m_art && m_art.use_count() == 1)
+    *m_art = art;
+  else
+    m_art = std::make_shared<ArtMap>(art);
   SetInvalid();
 }
 
 void CGUIListItem::SetArtFallback(const std::string &from, const std::string &to)
 {
-  m_artFallbacks[from] = to;
+  GetWritableArt(m_artFallbacks)[from] = to;
 }
 
 void CGUIListItem::ClearArt()
 {
-  m_art.clear();
-  m_artFallbacks.clear();
+  // keep references handed out by GetArt() valid if the map isn't shared
+  if (m_art && m_art.use_count() == 1)
+    m_art->clear();
+  else
+    m_art.reset();
+  m_artFallbacks.reset();
 }
 
 void CGUIListItem::AppendArt(const ArtMap &art, const std::string &prefix)
@@ -128,22 +144,28 @@ void CGUIListItem::AppendArt(const ArtMap &art, const std::string &prefix)
 
 std::string CGUIListItem::GetArt(const std::string &type) const
 {
-  ArtMap::const_iterator i = m_art.find(type);
-  if (i != m_art.end())
+  if (!m_art)
+    return "";
+
+  ArtMap::const_iterator i = m_art->find(type);
+  if (i != m_art->end())
     return i->second;
-  i = m_artFallbacks.find(type);
-  if (i != m_artFallbacks.end())
+  if (m_artFallbacks)
   {
-    ArtMap::const_iterator j = m_art.find(i->second);
-    if (j != m_art.end())
-      return j->second;
+    i = m_artFallbacks->find(type);
+    if (i != m_artFallbacks->end())
+    {
+      ArtMap::const_iterator j = m_art->find(i->second);
+      if (j != m_art->end())
+        return j->second;
+    }
   }
   return "";
 }
 
 const CGUIListItem::ArtMap &CGUIListItem::GetArt() const
 {
-  return m_art;
+  return m_art ? *m_art : emptyArt;
 }
 
 bool CGUIListItem::HasArt(const std::string &type) const
@@ -225,7 +247,7 @@ CGUIListItem& CGUIListItem::operator =(const CGUIListItem& item)
   m_strIcon = item.m_strIcon;
   m_overlayIcon = item.m_overlayIcon;
   m_bIsFolder = item.m_bIsFolder;
-  m_mapProperties = item.m_mapProperties;
+  m_properties = item.m_properties;
   m_art = item.m_art;
   m_artFallbacks = item.m_artFallbacks;
   SetInvalid();
@@ -243,20 +265,22 @@ void CGUIListItem::Archive(CArchive &ar)
     ar << m_strIcon;
     ar << m_bSelected;
     ar << m_overlayIcon;
-    ar << (int)m_mapProperties.size();
-    for (PropertyMap::const_iterator it = m_mapProperties.begin(); it != m_mapProperties.end(); ++it)
+    ar << (int)m_properties.size();
+    for (CGUIListItemProperties::const_iterator it = m_properties.begin(); it != m_properties.end(); ++it)
     {
-      ar << it->first;
+      ar << it->first->spelling;
       ar << it->second;
     }
-    ar << (int)m_art.size();
-    for (ArtMap::const_iterator i = m_art.begin(); i != m_art.end(); ++i)
+    const ArtMap &art = GetArt();
+    ar << (int)art.size();
+    for (ArtMap::const_iterator i = art.begin(); i != art.end(); ++i)
     {
       ar << i->first;
       ar << i->second;
     }
-    ar << (int)m_artFallbacks.size();
-    for (ArtMap::const_iterator i = m_artFallbacks.begin(); i != m_artFallbacks.end(); ++i)
+    const ArtMap &artFallbacks = m_artFallbacks ? *m_artFallbacks : emptyArt;
+    ar << (int)artFallbacks.size();
+    for (ArtMap::const_iterator i = artFallbacks.begin(); i != artFallbacks.end(); ++i)
     {
       ar << i->first;
       ar << i->second;
@@ -291,7 +315,7 @@ void CGUIListItem::Archive(CArchive &ar)
       std::string key, value;
       ar >> key;
       ar >> value;
-      m_art.insert(make_pair(key, value));
+      GetWritableArt(m_art).insert(make_pair(key, value));
     }
     ar >> mapSize;
     for (int i = 0; i < mapSize; i++)
@@ -299,7 +323,7 @@ void CGUIListItem::Archive(CArchive &ar)
       std::string key, value;
       ar >> key;
       ar >> value;
-      m_artFallbacks.insert(make_pair(key, value));
+      GetWritableArt(m_artFallbacks).insert(make_pair(key, value));
     }
     SetInvalid();
   }
@@ -313,11 +337,12 @@ void CGUIListItem::Serialize(CVariant &value)
   value["strIcon"] = m_strIcon;
   value["selected"] = m_bSelected;
 
-  for (PropertyMap::const_iterator it = m_mapProperties.begin(); it != m_mapProperties.end(); ++it)
+  for (CGUIListItemProperties::const_iterator it = m_properties.begin(); it != m_properties.end(); ++it)
   {
-    value["properties"][it->first] = it->second;
+    value["properties"][it->first->spelling] = it->second;
   }
-  for (ArtMap::const_iterator it = m_art.begin(); it != m_art.end(); ++it)
+  const ArtMap &art = GetArt();
+  for (ArtMap::const_iterator it = art.begin(); it != art.end(); ++it)
     value["art"][it->first] = it->second;
 }
 
@@ -371,56 +396,34 @@ void CGUIListItem::SetInvalid()
 
 void CGUIListItem::SetProperty(const std::string &strKey, const CVariant &value)
 {
-  PropertyMap::iterator iter = m_mapProperties.find(strKey);
-  if (iter == m_mapProperties.end())
-  {
-    m_mapProperties.insert(make_pair(strKey, value));
+  if (m_properties.Set(strKey, value))
     SetInvalid();
-  }
-  else if (iter->second != value)
-  {
-    iter->second = value;
-    SetInvalid();
-  }
 }
 
-const CVariant &CGUIListItem::GetProperty(const std::string &strKey) const
+CVariant CGUIListItem::GetProperty(const std::string &strKey) const
 {
-  PropertyMap::const_iterator iter = m_mapProperties.find(strKey);
-  static CVariant nullVariant = CVariant(CVariant::VariantTypeNull);
-
-  if (iter == m_mapProperties.end())
-    return nullVariant;
+  const CVariant *value = m_properties.Get(strKey);
+  if (!value)
+    return CVariant(CVariant::VariantTypeNull);
 
-  return iter->second;
+  return *value;
 }
 
 bool CGUIListItem::HasProperty(const std::string &strKey) const
 {
-  PropertyMap::const_iterator iter = m_mapProperties.find(strKey);
-  if (iter == m_mapProperties.end())
-    return false;
-
-  return true;
+  return m_properties.Get(strKey) != nullptr;
 }
 
 void CGUIListItem::ClearProperty(const std::string &strKey)
 {
-  PropertyMap::iterator iter = m_mapProperties.find(strKey);
-  if (iter != m_mapProperties.end())
-  {
-    m_mapProperties.erase(iter);
+  if (m_properties.Erase(strKey))
     SetInvalid();
-  }
 }
 
 void CGUIListItem::ClearProperties()
 {
-  if (!m_mapProperties.empty())
-  {
-    m_mapProperties.clear();
+  if (m_properties.Clear())
     SetInvalid();
-  }
 }
 
 void CGUIListItem::IncrementProperty(const std::string &strKey, int nVal)
@@ -439,6 +442,6 @@ void CGUIListItem::IncrementProperty(const std::string &strKey, double dVal)
 
 void CGUIListItem::AppendProperties(const CGUIListItem &item)
 {
-  for (PropertyMap::const_iterator i = item.m_mapProperties.begin(); i != item.m_mapProperties.end(); ++i)
-    SetProperty(i->first, i->second);
+  for (CGUIListItemProperties::const_iterator i = item.m_properties.begin(); i != item.m_properties.end(); ++i)
+    SetProperty(i->first->spelling, i->second);
 }
@@ -13,6 +13,8 @@
 \brief
 */
 
+#include "GUIListItemProperties.h"
+
 #include <map>
 #include <string>
 #include <memory>
@@ -159,10 +161,16 @@ public:
   void Serialize(CVariant& value);
 
   bool       HasProperty(const std::string &strKey) const;
-  bool       HasProperties() const { return !m_mapProperties.empty(); };
+  bool       HasProperties() const { return !m_properties.empty(); };
   void       ClearProperty(const std::string &strKey);
 
-  const CVariant &GetProperty(const std::string &strKey) const;
+  /*! \brief Get the value of a property
+   Properties are shared copy-on-write between copies of an item, so the value is
+   returned by copy rather than as a reference into storage a later SetProperty()
+   may reallocate.
+   \return the value, or a null variant if the property is not set
+   */
+  CVariant GetProperty(const std::string &strKey) const;
 
 protected:
   std::string m_strLabel2;     // text of column2
@@ -173,18 +181,17 @@ protected:
   CGUIListItemLayoutPtr m_focusedLayout;
   bool m_bSelected;     // item is selected or not
 
-  struct icompare
-  {
-    bool operator()(const std::string &s1, const std::string &s2) const;
-  };
-
-  typedef std::map<std::string, CVariant, icompare> PropertyMap;
-  PropertyMap m_mapProperties;
+  CGUIListItemProperties m_properties;
 private:
   std::wstring m_sortLabel;    // text for sorting. Need to be UTF16 for proper sorting
   std::string m_strLabel;      // text of column1
 
-  ArtMap m_art;
-  ArtMap m_artFallbacks;
+  /*! \brief Get an art map for modification, copying it first if it's shared with other items
+   */
+  static ArtMap &GetWritableArt(std::shared_ptr<ArtMap> &art);
+
+  // shared between copies of the item until modified
+  std::shared_ptr<ArtMap> m_art;
+  std::shared_ptr<ArtMap> m_artFallbacks;
 };
 
@@ -74,6 +74,15 @@ void CGUIListItemLayout::Process(CGUIListItem *item, int parentID, unsigned int
   m_group.DoProcess(currentTime, dirtyregions);
 }
 
+void CGUIListItemLayout::GetItemImages(CGUIListItem *item, std::vector<std::string> &images) const
+{
+  // same as in Process
+  CFileItem *fileItem = item->IsFileItem() ? static_cast<CFileItem*>(item) : new CFileItem(*item);
+  m_group.GetItemImages(fileItem, images);
+  if (!item->IsFileItem())
+    delete fileItem;
+}
+
 void CGUIListItemLayout::Render(CGUIListItem *item, int parentID)
 {
   m_group.DoRender();
@@ -33,6 +33,14 @@ public:
   void FreeResources(bool immediately = false);
   void SetParentControl(CGUIControl *control) { m_group.SetParentControl(control); };
 
+  /*! \brief Get the images that are loaded in the background when showing an item with this layout
+   \sa CGUIListGroup::GetItemImages
+   */
+  void GetItemImages(CGUIListItem *item, std::vector<std::string> &images) const;
+
+  /*! \brief Whether any image of the layout is still being loaded in the background */
+  bool IsLoading() const { return m_group.IsLoading(); };
+
 //#ifdef GUILIB_PYTHON_COMPATIBILITY
   void CreateListControlLayouts(float width, float height, bool focused, const CLabelInfo &labelInfo, const CLabelInfo &labelInfo2, const CTextureInfo &texture, const CTextureInfo &textureFocus, float texHeight, float iconWidth, float iconHeight, const std::string &nofocusCondition, const std::string &focusCondition);
 //#endif
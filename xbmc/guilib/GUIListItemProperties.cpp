@@ -0,0 +1,187 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "GUIListItemProperties.h"
+
+#include "threads/SharedSection.h"
+#include "utils/StringUtils.h"
+#include "utils/Variant.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace
+{
+
+typedef std::weak_ptr<const CGUIListItemProperties::Name> WeakName;
+
+struct Names
+{
+  std::unordered_map<std::string, WeakName> spellings;
+  size_t sweepSize = 256; //!< drop released names once there are this many spellings
+};
+
+Names& GetNames()
+{
+  static Names names;
+  return names;
+}
+
+CSharedSection& GetNamesSection()
+{
+  static CSharedSection section;
+  return section;
+}
+
+void EraseReleased(std::unordered_map<std::string, WeakName>& map)
+{
+  for (auto it = map.begin(); it != map.end();)
+  {
+    if (it->second.expired())
+      it = map.erase(it);
+    else
+      ++it;
+  }
+}
+
+const CGUIListItemProperties::Entries& GetEmptyEntries()
+{
+  static const CGUIListItemProperties::Entries empty;
+  return empty;
+}
+
+} // unnamed namespace
+
+CGUIListItemProperties::NamePtr CGUIListItemProperties::Intern(const std::string &name)
+{
+  Names& names = GetNames();
+  {
+    CSharedLock lock(GetNamesSection());
+    auto it = names.spellings.find(name);
+    if (it != names.spellings.end())
+    {
+      NamePtr interned = it->second.lock();
+      if (interned)
+        return interned;
+    }
+  }
+
+  CExclusiveLock lock(GetNamesSection());
+
+  // names of items that are gone would otherwise accumulate
+  if (names.spellings.size() >= names.sweepSize)
+  {
+    EraseReleased(names.spellings);
+    names.sweepSize = std::max<size_t>(256, 2 * names.spellings.size());
+  }
+
+  WeakName& spelling = names.spellings[name];
+  NamePtr interned = spelling.lock();
+  if (interned)
+    return interned;
+
+  std::shared_ptr<Name> newName = std::make_shared<Name>();
+  newName->spelling = name;
+  spelling = newName;
+  return newName;
+}
+
+CGUIListItemProperties::NamePtr CGUIListItemProperties::Find(const std::string &name)
+{
+  CSharedLock lock(GetNamesSection());
+  const Names& names = GetNames();
+  auto it = names.spellings.find(name);
+  return it != names.spellings.end() ? it->second.lock() : nullptr;
+}
+
+CGUIListItemProperties::const_iterator CGUIListItemProperties::begin() const
+{
+  return m_entries ? m_entries->begin() : GetEmptyEntries().begin();
+}
+
+CGUIListItemProperties::const_iterator CGUIListItemProperties::end() const
+{
+  return m_entries ? m_entries->end() : GetEmptyEntries().end();
+}
+
+const CVariant* CGUIListItemProperties::Get(const std::string &name) const
+{
+  if (!m_entries)
+    return nullptr;
+
+  for (const auto& entry : *m_entries)
+  {
+    if (StringUtils::EqualsNoCase(entry.first->spelling, name))
+      return &entry.second;
+  }
+  return nullptr;
+}
+
+bool CGUIListItemProperties::Set(const std::string &name, const CVariant &value)
+{
+  const CVariant* current = Get(name);
+  if (current)
+  {
+    if (*current == value)
+      return false;
+
+    // an existing property keeps the spelling it was first set with
+    for (auto& entry : GetWritable())
+    {
+      if (StringUtils::EqualsNoCase(entry.first->spelling, name))
+      {
+        entry.second = value;
+        break;
+      }
+    }
+    return true;
+  }
+
+  GetWritable().push_back(Entry(Intern(name), value));
+  return true;
+}
+
+bool CGUIListItemProperties::Erase(const std::string &name)
+{
+  if (!Get(name))
+    return false;
+
+  Entries& entries = GetWritable();
+  for (Entries::iterator it = entries.begin(); it != entries.end(); ++it)
+  {
+    if (StringUtils::EqualsNoCase(it->first->spelling, name))
+    {
+      entries.erase(it);
+      break;
+    }
+  }
+  return true;
+}
+
+bool CGUIListItemProperties::Clear()
+{
+  if (empty())
+    return false;
+
+  m_entries.reset();
+  return true;
+}
+
+CGUIListItemProperties::Entries& CGUIListItemProperties::GetWritable()
+{
+  // copy on write: detach from other items sharing the properties
+  if (!m_entries)
+  {
+    m_entries = std::make_shared<Entries>();
+    // most items only have a handful of properties
+    m_entries->reserve(4);
+  }
+  else if (m_entries.use_count() > 1)
+    m_entries = std::make_shared<Entries>(*m_entries);
+  return *m_entries;
+}
@@ -0,0 +1,87 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "utils/Variant.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+/*!
+ \ingroup controls
+ \brief Compact, copy-on-write storage of list item properties
+
+ Property names are interned, so items share one string per name instead of
+ each holding its own copy. Names are compared case-insensitively and each item
+ keeps the spelling its property was first set with. The properties of an item
+ are kept in a small flat vector that is shared between copies of the item until
+ one of them is modified, which makes copying large item lists cheap. Since a
+ modification may reallocate or replace the vector, pointers returned by Get()
+ are only valid until the properties are next modified.
+
+ Looking up a property only scans the entries of the item and takes no lock;
+ the interning registry is only locked when a new property is added. Interned
+ names are released once no item uses them anymore.
+ */
+class CGUIListItemProperties
+{
+public:
+  struct Name
+  {
+    std::string spelling;
+  };
+  typedef std::shared_ptr<const Name> NamePtr;
+  typedef std::pair<NamePtr, CVariant> Entry;
+  typedef std::vector<Entry> Entries;
+  typedef Entries::const_iterator const_iterator;
+
+  /*! \brief Get the interned name for a property name, adding it if needed
+   \param name the property name
+   \return the interned name, with the spelling of name
+   */
+  static NamePtr Intern(const std::string &name);
+
+  /*! \brief Get the interned name of a spelling
+   \param name the property name, case-sensitive
+   \return the interned name, or nullptr if no item has a property of this spelling
+   */
+  static NamePtr Find(const std::string &name);
+
+  bool empty() const { return !m_entries || m_entries->empty(); }
+  size_t size() const { return m_entries ? m_entries->size() : 0; }
+  const_iterator begin() const;
+  const_iterator end() const;
+
+  /*! \brief Get the value of a property
+   \return the value or nullptr if not set, valid until the properties are modified
+   */
+  const CVariant* Get(const std::string &name) const;
+
+  /*! \brief Set the value of a property
+   \return true if the value changed
+   */
+  bool Set(const std::string &name, const CVariant &value);
+
+  /*! \brief Remove a property
+   \return true if the property was set
+   */
+  bool Erase(const std::string &name);
+
+  /*! \brief Remove all properties
+   \return true if any property was set
+   */
+  bool Clear();
+
+private:
+  Entries& GetWritable();
+
+  std::shared_ptr<Entries> m_entries;
+};
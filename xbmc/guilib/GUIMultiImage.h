@@ -63,6 +63,7 @@ protected:
     explicit CMultiImageJob(const std::string &path);
     bool DoWork() override;
     const char *GetType() const override { return "multiimage"; };
+    AFFINITY GetAffinity() const override { return AFFINITY_IO; };
 
     std::vector<std::string> m_files;
     std::string              m_path;
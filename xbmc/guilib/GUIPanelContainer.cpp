@@ -51,6 +51,10 @@ void CGUIPanelContainer::Process(unsigned int currentTime, CDirtyRegionList &dir
   pos += (offset - cacheBefore) * m_layout->Size(m_orientation) - m_scroller.GetValue();
   end += cacheAfter * m_layout->Size(m_orientation);
 
+  float visibleStart = (m_orientation == VERTICAL) ? m_posY : m_posX;
+  float visibleEnd = (m_orientation == VERTICAL) ? m_posY + m_height : m_posX + m_width;
+  bool placeholderShown = false;
+
   int current = (offset - cacheBefore) * m_itemsPerRow;
   int col = 0;
   while (pos < end && m_items.size())
@@ -66,6 +70,9 @@ void CGUIPanelContainer::Process(unsigned int currentTime, CDirtyRegionList &dir
         ProcessItem(origin.x + col * m_layout->Size(HORIZONTAL), pos, item, focused, currentTime, dirtyregions);
       else
         ProcessItem(pos, origin.y + col * m_layout->Size(VERTICAL), item, focused, currentTime, dirtyregions);
+
+      if (!placeholderShown && pos < visibleEnd && pos + m_layout->Size(m_orientation) > visibleStart)
+        placeholderShown = IsItemLoading(item, focused);
     }
     // increment our position
     if (col < m_itemsPerRow - 1)
@@ -78,6 +85,9 @@ void CGUIPanelContainer::Process(unsigned int currentTime, CDirtyRegionList &dir
     current++;
   }
 
+  UpdateScrollStats(placeholderShown);
+  UpdatePrefetch(offset, currentTime);
+
   // when we are scrolling up, offset will become lower (integer division, see offset calc)
   // to have same behaviour when scrolling down, we need to set page control to offset+1
   UpdatePageControl(offset + (m_scroller.IsScrollingDown() ? 1 : 0));
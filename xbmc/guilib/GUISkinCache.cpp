@@ -0,0 +1,385 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "GUISkinCache.h"
+#include "GUIComponent.h"
+#include "GUIInfoManager.h"
+#include "ServiceBroker.h"
+#include "Util.h"
+#include "addons/Skin.h"
+#include "filesystem/File.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/SettingsComponent.h"
+#include "utils/Archive.h"
+#include "utils/Crc32.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+#include "utils/XBMCTinyXML.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+
+const unsigned int CACHE_MAGIC = 0x434b534b; // "KSKC"
+//! bump whenever the format or the way CGUIIncludes resolves changes
+const unsigned int CACHE_VERSION = 1;
+
+const std::string CACHE_FOLDER = "special://temp/skincache/";
+
+enum NodeToken
+{
+  TOKEN_ELEMENT = 0,
+  TOKEN_TEXT,
+  TOKEN_CDATA
+};
+
+/*!
+ \brief Reads the number of entries that follow in the archive
+ CArchive zero-fills reads past the end of the file instead of failing, so a
+ corrupt count would go on reading empty entries. Each entry takes at least
+ entrySize bytes, so no valid count exceeds what fits into the file.
+ */
+unsigned int ReadCount(CArchive& ar, int64_t fileSize, int64_t entrySize)
+{
+  unsigned int count;
+  ar >> count;
+  if (static_cast<int64_t>(count) * entrySize > fileSize)
+    throw std::out_of_range("count exceeds file size");
+  return count;
+}
+
+bool GetFileInfo(const std::string& path, long long& mtime, long long& size)
+{
+  struct __stat64 st;
+  if (XFILE::CFile::Stat(path, &st) != 0)
+    return false;
+  mtime = static_cast<long long>(st.st_mtime);
+  size = static_cast<long long>(st.st_size);
+  return true;
+}
+
+/*!
+ \brief Flattens an XML tree into a token stream of indices into a table of
+ unique strings. Element names, attribute names and most values repeat a lot in
+ prepared skin XML, so each of them is only stored once.
+ */
+class CTreeWriter
+{
+public:
+  void Write(const TiXmlElement& element)
+  {
+    m_tokens.push_back(TOKEN_ELEMENT);
+    m_tokens.push_back(Intern(element.ValueStr()));
+
+    size_t attributeCount = m_tokens.size();
+    m_tokens.push_back(0);
+    for (const TiXmlAttribute* attribute = element.FirstAttribute(); attribute; attribute = attribute->Next())
+    {
+      m_tokens.push_back(Intern(attribute->Name()));
+      m_tokens.push_back(Intern(attribute->ValueStr()));
+      m_tokens[attributeCount]++;
+    }
+
+    size_t childCount = m_tokens.size();
+    m_tokens.push_back(0);
+    for (const TiXmlNode* child = element.FirstChild(); child; child = child->NextSibling())
+    {
+      if (const TiXmlElement* childElement = child->ToElement())
+        Write(*childElement);
+      else if (const TiXmlText* text = child->ToText())
+      {
+        m_tokens.push_back(text->CDATA() ? TOKEN_CDATA : TOKEN_TEXT);
+        m_tokens.push_back(Intern(text->ValueStr()));
+      }
+      else
+        continue; // comments etc. are of no use to the window
+
+      m_tokens[childCount]++;
+    }
+  }
+
+  const std::vector<std::string>& GetStrings() const { return m_strings; }
+  const std::vector<int>& GetTokens() const { return m_tokens; }
+
+private:
+  int Intern(const std::string& str)
+  {
+    auto it = m_index.find(str);
+    if (it != m_index.end())
+      return it->second;
+
+    int index = static_cast<int>(m_strings.size());
+    m_strings.push_back(str);
+    m_index.insert(std::make_pair(str, index));
+    return index;
+  }
+
+  std::vector<std::string> m_strings;
+  std::unordered_map<std::string, int> m_index;
+  std::vector<int> m_tokens;
+};
+
+//! rebuilds the tree written by CTreeWriter, throws std::out_of_range on corrupt data
+class CTreeReader
+{
+public:
+  CTreeReader(const std::vector<std::string>& strings, const std::vector<int>& tokens)
+    : m_strings(strings), m_tokens(tokens)
+  {
+  }
+
+  std::unique_ptr<TiXmlElement> Read()
+  {
+    if (Next() != TOKEN_ELEMENT)
+      throw std::out_of_range("root is not an element");
+
+    std::unique_ptr<TiXmlElement> root(new TiXmlElement(String()));
+    ReadElement(*root);
+    if (m_pos != m_tokens.size())
+      throw std::out_of_range("trailing data");
+    return root;
+  }
+
+private:
+  void ReadElement(TiXmlElement& element)
+  {
+    for (int attributes = Next(); attributes > 0; attributes--)
+    {
+      const std::string& name = String();
+      element.SetAttribute(name, String());
+    }
+
+    for (int children = Next(); children > 0; children--)
+    {
+      int token = Next();
+      if (token == TOKEN_ELEMENT)
+      {
+        TiXmlElement* child = new TiXmlElement(String());
+        element.LinkEndChild(child);
+        ReadElement(*child);
+      }
+      else if (token == TOKEN_TEXT || token == TOKEN_CDATA)
+      {
+        TiXmlText* text = new TiXmlText(String());
+        text->SetCDATA(token == TOKEN_CDATA);
+        element.LinkEndChild(text);
+      }
+      else
+        throw std::out_of_range("invalid node");
+    }
+  }
+
+  int Next() { return m_tokens.at(m_pos++); }
+  const std::string& String() { return m_strings.at(static_cast<size_t>(Next())); }
+
+  const std::vector<std::string>& m_strings;
+  const std::vector<int>& m_tokens;
+  size_t m_pos = 0;
+};
+
+} // unnamed namespace
+
+bool CGUISkinCache::IsEnabled()
+{
+  return g_SkinInfo && !g_SkinInfo->IsDebugging() &&
+         CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_guiSkinCache;
+}
+
+std::string CGUISkinCache::GetCachePath(const std::string& windowFile)
+{
+  std::string folder = URIUtils::AddFileToFolder(CACHE_FOLDER, g_SkinInfo->ID());
+  return URIUtils::AddFileToFolder(folder, StringUtils::Format("%08x.bin", Crc32::ComputeFromLowerCase(windowFile)));
+}
+
+std::unique_ptr<TiXmlElement> CGUISkinCache::Load(const std::string& windowFile, std::map<INFO::InfoPtr, bool>& includeConditions)
+{
+  const std::string path = GetCachePath(windowFile);
+
+  XFILE::CFile file;
+  if (!file.Open(path))
+    return nullptr;
+
+  std::unique_ptr<TiXmlElement> root;
+  try
+  {
+    CArchive ar(&file, CArchive::load);
+    root = Read(ar, file.GetLength(), windowFile, includeConditions);
+    ar.Close();
+  }
+  catch (const std::out_of_range&)
+  {
+    CLog::Log(LOGERROR, "CGUISkinCache: corrupt cache file %s for %s", path.c_str(), windowFile.c_str());
+    root.reset();
+  }
+  file.Close();
+
+  if (root)
+    CLog::Log(LOGDEBUG, "CGUISkinCache: using cached %s", windowFile.c_str());
+  else
+    includeConditions.clear();
+
+  return root;
+}
+
+std::unique_ptr<TiXmlElement> CGUISkinCache::Read(CArchive& ar, int64_t fileSize, const std::string& windowFile, std::map<INFO::InfoPtr, bool>& includeConditions)
+{
+  unsigned int magic, version;
+  ar >> magic;
+  ar >> version;
+  if (magic != CACHE_MAGIC || version != CACHE_VERSION)
+    return nullptr;
+
+  std::string skinId, skinVersion, file;
+  ar >> skinId;
+  ar >> skinVersion;
+  ar >> file;
+  if (skinId != g_SkinInfo->ID() || skinVersion != g_SkinInfo->Version().asString() || file != windowFile)
+    return nullptr;
+
+  // the window file and every include file it was resolved against must be unchanged
+  std::vector<std::string> files;
+  // path length, mtime and size
+  unsigned int fileCount = ReadCount(ar, fileSize, 4 + 8 + 8);
+  for (unsigned int i = 0; i < fileCount; i++)
+  {
+    std::string dependency;
+    long long mtime, size, currentMtime, currentSize;
+    ar >> dependency;
+    ar >> mtime;
+    ar >> size;
+    if (!GetFileInfo(dependency, currentMtime, currentSize) || mtime != currentMtime || size != currentSize)
+    {
+      CLog::Log(LOGDEBUG, "CGUISkinCache: %s changed, not using cached %s", dependency.c_str(), windowFile.c_str());
+      return nullptr;
+    }
+    files.push_back(dependency);
+  }
+
+  // include files loaded since would have been visible while resolving
+  for (const auto& includeFile : g_SkinInfo->GetIncludeFiles())
+  {
+    if (std::find(files.begin(), files.end(), includeFile) == files.end())
+      return nullptr;
+  }
+
+  // the resolved tree is only valid for the same values of the <include> conditions
+  // expression length and value
+  unsigned int conditionCount = ReadCount(ar, fileSize, 4 + 1);
+  includeConditions.clear();
+  for (unsigned int i = 0; i < conditionCount; i++)
+  {
+    std::string expression;
+    bool value;
+    ar >> expression;
+    ar >> value;
+    INFO::InfoPtr condition = CServiceBroker::GetGUI()->GetInfoManager().Register(expression);
+    if (!condition || condition->Get() != value)
+      return nullptr;
+    includeConditions.insert(std::make_pair(condition, value));
+  }
+
+  return ReadTree(ar, fileSize);
+}
+
+void CGUISkinCache::WriteTree(CArchive& ar, const TiXmlElement& element)
+{
+  CTreeWriter writer;
+  writer.Write(element);
+
+  ar << writer.GetStrings();
+  ar << writer.GetTokens();
+  ar << CACHE_MAGIC;
+}
+
+std::unique_ptr<TiXmlElement> CGUISkinCache::ReadTree(CArchive& ar, int64_t fileSize)
+{
+  // read element by element rather than through CArchive's vector operators to bound the counts
+  std::vector<std::string> strings(ReadCount(ar, fileSize, 4));
+  for (auto& str : strings)
+    ar >> str;
+
+  std::vector<int> tokens(ReadCount(ar, fileSize, 4));
+  for (auto& token : tokens)
+    ar >> token;
+
+  unsigned int end;
+  ar >> end;
+  if (end != CACHE_MAGIC)
+    throw std::out_of_range("truncated");
+
+  return CTreeReader(strings, tokens).Read();
+}
+
+void CGUISkinCache::Store(const std::string& windowFile, const TiXmlElement& prepared, const std::map<INFO::InfoPtr, bool>& includeConditions)
+{
+  std::vector<std::string> files(1, windowFile);
+  const std::vector<std::string>& includeFiles = g_SkinInfo->GetIncludeFiles();
+  files.insert(files.end(), includeFiles.begin(), includeFiles.end());
+
+  std::vector<std::pair<long long, long long>> fileInfos;
+  for (const auto& dependency : files)
+  {
+    long long mtime, size;
+    if (!GetFileInfo(dependency, mtime, size))
+      return;
+    fileInfos.push_back(std::make_pair(mtime, size));
+  }
+
+  const std::string path = GetCachePath(windowFile);
+  if (!CUtil::CreateDirectoryEx(URIUtils::GetDirectory(path)))
+    return;
+
+  // written next to the entry and renamed over it, so a crash or a full disk
+  // never leaves a partial entry behind
+  const std::string tempPath = path + ".tmp";
+  XFILE::CFile file;
+  if (!file.OpenForWrite(tempPath, true))
+  {
+    CLog::Log(LOGWARNING, "CGUISkinCache: unable to write %s", tempPath.c_str());
+    return;
+  }
+
+  CArchive ar(&file, CArchive::store);
+  ar << CACHE_MAGIC;
+  ar << CACHE_VERSION;
+  ar << g_SkinInfo->ID();
+  ar << g_SkinInfo->Version().asString();
+  ar << windowFile;
+
+  ar << static_cast<unsigned int>(files.size());
+  for (size_t i = 0; i < files.size(); i++)
+  {
+    ar << files[i];
+    ar << fileInfos[i].first;
+    ar << fileInfos[i].second;
+  }
+
+  ar << static_cast<unsigned int>(includeConditions.size());
+  for (const auto& condition : includeConditions)
+  {
+    ar << condition.first->GetExpression();
+    ar << condition.second;
+  }
+
+  WriteTree(ar, prepared);
+  ar.Close();
+  file.Close();
+
+  // not every platform replaces an existing file on rename
+  if (!XFILE::CFile::Rename(tempPath, path) &&
+      (!XFILE::CFile::Delete(path) || !XFILE::CFile::Rename(tempPath, path)))
+  {
+    CLog::Log(LOGWARNING, "CGUISkinCache: unable to replace %s", path.c_str());
+    XFILE::CFile::Delete(tempPath);
+  }
+}
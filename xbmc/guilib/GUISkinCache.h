@@ -0,0 +1,76 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "interfaces/info/InfoBool.h"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+
+class CArchive;
+class TiXmlElement;
+
+/*!
+ \brief On-disk cache of prepared window XML
+
+ Preparing a window (parsing its XML and resolving includes, constants and
+ expressions through CGUIIncludes) is done on every skin load. The cache stores
+ the prepared tree in a compact binary form with all strings interned, so the
+ next load can skip both steps.
+
+ An entry is only used if the skin ID and version, the modification times and
+ sizes of the window file and of all include files it was resolved against,
+ and the values of its <include> conditions are unchanged.
+ */
+class CGUISkinCache
+{
+public:
+  /*!
+   \brief Whether the cache is enabled for the current skin
+   */
+  static bool IsEnabled();
+
+  /*!
+   \brief Load the prepared XML of a window
+   \param windowFile path of the window XML file
+   \param includeConditions [out] the include conditions the XML was prepared with
+   \return the prepared XML, or nullptr if there is no valid cache entry
+   */
+  static std::unique_ptr<TiXmlElement> Load(const std::string& windowFile, std::map<INFO::InfoPtr, bool>& includeConditions);
+
+  /*!
+   \brief Store the prepared XML of a window
+   \param windowFile path of the window XML file
+   \param prepared the XML as returned by CGUIWindow::Prepare()
+   \param includeConditions the include conditions the XML was prepared with
+   */
+  static void Store(const std::string& windowFile, const TiXmlElement& prepared, const std::map<INFO::InfoPtr, bool>& includeConditions);
+
+  /*!
+   \brief Write an XML tree in the binary form of the cache
+   \param ar archive to write to
+   \param element root of the tree
+   */
+  static void WriteTree(CArchive& ar, const TiXmlElement& element);
+
+  /*!
+   \brief Read an XML tree written by WriteTree()
+   \param ar archive to read from
+   \param fileSize size of the underlying file, bounds the number of entries read
+   \return the root of the tree
+   \throws std::out_of_range if the data is truncated or corrupt
+   */
+  static std::unique_ptr<TiXmlElement> ReadTree(CArchive& ar, int64_t fileSize);
+
+private:
+  static std::string GetCachePath(const std::string& windowFile);
+  static std::unique_ptr<TiXmlElement> Read(CArchive& ar, int64_t fileSize, const std::string& windowFile, std::map<INFO::InfoPtr, bool>& includeConditions);
+};
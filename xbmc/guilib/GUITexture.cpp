@@ -8,6 +8,7 @@
 
 #include "GUITexture.h"
 #include "windowing/GraphicContext.h"
+#include "Texture.h"
 #include "TextureManager.h"
 #include "GUILargeTextureManager.h"
 #include "utils/MathUtils.h"
@@ -545,6 +546,24 @@ bool CGUITextureBase::ReadyToRender() const
   return m_texture.size() > 0;
 }
 
+bool CGUITextureBase::IsOpaque() const
+{
+  if (!m_visible || !ReadyToRender() || m_alpha != 0xFF || m_diffuse.size())
+    return false;
+
+  // same as in Render()
+  UTILS::Color color = (m_info.diffuseColor) ? (UTILS::Color)m_info.diffuseColor : m_diffuseColor;
+  if ((color & 0xff000000) != 0xff000000)
+    return false;
+
+  for (const auto texture : m_texture.m_textures)
+  {
+    if (!texture || texture->HasAlpha())
+      return false;
+  }
+  return true;
+}
+
 void CGUITextureBase::OrientateTexture(CRect &rect, float width, float height, int orientation)
 {
   switch (orientation & 3)
@@ -105,6 +105,12 @@ public:
   bool IsAllocated() const { return m_isAllocated != NO; };
   bool FailedToAlloc() const { return m_isAllocated == NORMAL_FAILED || m_isAllocated == LARGE_FAILED; };
   bool ReadyToRender() const;
+  /*! \brief Whether the texture is waiting for the large texture manager to load it */
+  bool IsLoading() const { return m_isAllocated == LARGE && !m_texture.size(); };
+  /*! \brief Whether rendering fully covers the render rect (clipped to the frame) with opaque pixels
+   Doesn't take the alpha of the current transform into account.
+   */
+  bool IsOpaque() const;
 protected:
   bool CalculateSize();
   void LoadDiffuseImage();
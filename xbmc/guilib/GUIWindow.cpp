@@ -13,6 +13,7 @@
 #include "GUIControlFactory.h"
 #include "GUIControlGroup.h"
 #include "GUIControlProfiler.h"
+#include "GUISkinCache.h"
 
 #include "addons/Skin.h"
 #include "GUIInfoManager.h"
@@ -125,9 +126,20 @@ bool CGUIWindow::Load(const std::string& strFileName, bool bContainsPath)
 
 bool CGUIWindow::LoadXML(const std::string &strPath, const std::string &strLowerPath)
 {
+  bool storeInCache = false;
+
   // load window xml if we don't have it stored yet
   if (!m_windowXMLRootElement)
   {
+    // skip parsing and preparing if the skin cache holds a valid prepared tree
+    if (CGUISkinCache::IsEnabled())
+    {
+      std::unique_ptr<TiXmlElement> cached = CGUISkinCache::Load(strPath, m_xmlIncludeConditions);
+      if (cached)
+        return Load(cached.get());
+      storeInCache = true;
+    }
+
     CXBMCTinyXML xmlDoc;
     std::string strPathLower = strPath;
     StringUtils::ToLower(strPathLower);
@@ -151,7 +163,11 @@ bool CGUIWindow::LoadXML(const std::string &strPath, const std::string &strLower
   else
     CLog::Log(LOGDEBUG, "Using already stored xml root node for %s", strPath.c_str());
 
-  return Load(Prepare(m_windowXMLRootElement).get());
+  std::unique_ptr<TiXmlElement> prepared = Prepare(m_windowXMLRootElement);
+  if (prepared && storeInCache)
+    CGUISkinCache::Store(strPath, *prepared, m_xmlIncludeConditions);
+
+  return Load(prepared.get());
 }
 
 std::unique_ptr<TiXmlElement> CGUIWindow::Prepare(TiXmlElement *pRootElement)
@@ -357,6 +373,14 @@ void CGUIWindow::DoRender()
   if (CGUIControlProfiler::IsRunning()) CGUIControlProfiler::Instance().EndFrame();
 }
 
+void CGUIWindow::UpdateOcclusion(COcclusionTracker &occlusion)
+{
+  // nothing is rendered until we're allocated, see DoRender()
+  if (m_bAllocated)
+    CGUIControlGroup::UpdateOcclusion(occlusion);
+  m_occluded = false;
+}
+
 void CGUIWindow::AfterRender()
 {
   // Check to see if we should close at this point
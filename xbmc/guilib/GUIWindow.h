@@ -78,6 +78,12 @@ public:
    */
   void DoRender() override;
 
+  /*! \brief Update the occlusion of the controls of the window
+   The window itself is never hidden, as it may render more than its controls.
+   \sa CGUIControl::UpdateOcclusion
+   */
+  void UpdateOcclusion(COcclusionTracker &occlusion) override;
+
   /*! \brief Do any post render activities.
     Check if window closing animation is finished and finalize window closing.
    */
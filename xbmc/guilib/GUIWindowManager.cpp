@@ -20,6 +20,7 @@
 #include "settings/SettingsComponent.h"
 #include "addons/Skin.h"
 #include "GUITexture.h"
+#include "GUIControlProfiler.h"
 #include "utils/Variant.h"
 #include "input/Key.h"
 #include "utils/log.h"
@@ -1104,6 +1105,26 @@ void CGUIWindowManager::Process(unsigned int currentTime)
 
   for (CDirtyRegionList::iterator itr = m_dirtyregions.begin(); itr != m_dirtyregions.end(); ++itr)
     m_tracker.MarkDirtyRegion(*itr);
+
+  UpdateOcclusion();
+}
+
+void CGUIWindowManager::UpdateOcclusion()
+{
+  // stereo rendering shifts controls by different amounts, don't hide any
+  RENDER_STEREO_MODE stereoMode = CServiceBroker::GetWinSystem()->GetGfxContext().GetStereoMode();
+  m_occlusion.Reset(stereoMode == RENDER_STEREO_MODE_OFF || stereoMode == RENDER_STEREO_MODE_MONO);
+
+  // visit the windows topmost first
+  CGUIWindow* pWindow = GetWindow(GetActiveWindow());
+  std::vector<CGUIWindow*> renderList = GetRenderList();
+  for (auto it = renderList.rbegin(); it != renderList.rend(); ++it)
+  {
+    if ((*it)->IsDialogRunning())
+      (*it)->UpdateOcclusion(m_occlusion);
+  }
+  if (pWindow)
+    pWindow->UpdateOcclusion(m_occlusion);
 }
 
 void CGUIWindowManager::MarkDirty()
@@ -1126,6 +1147,14 @@ void CGUIWindowManager::MarkDirty(const CRect& rect)
       window->MarkDirtyRegion();
 }
 
+std::vector<CGUIWindow*> CGUIWindowManager::GetRenderList() const
+{
+  // we render the dialogs based on their render order.
+  auto renderList = m_activeDialogs;
+  stable_sort(renderList.begin(), renderList.end(), RenderOrderSortFunction);
+  return renderList;
+}
+
 void CGUIWindowManager::RenderPass() const
 {
   CGUIWindow* pWindow = GetWindow(GetActiveWindow());
@@ -1135,11 +1164,7 @@ void CGUIWindowManager::RenderPass() const
     pWindow->DoRender();
   }
 
-  // we render the dialogs based on their render order.
-  auto renderList = m_activeDialogs;
-  stable_sort(renderList.begin(), renderList.end(), RenderOrderSortFunction);
-
-  for (const auto& window : renderList)
+  for (const auto& window : GetRenderList())
   {
     if (window->IsDialogRunning())
       window->DoRender();
@@ -1172,11 +1197,13 @@ bool CGUIWindowManager::Render()
   CDirtyRegionList dirtyRegions = m_tracker.GetDirtyRegions();
 
   bool hasRendered = false;
+  float renderedArea = 0;
   // If we visualize the regions we will always render the entire viewport
   if (CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_guiVisualizeDirtyRegions || CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_guiAlgorithmDirtyRegions == DIRTYREGION_SOLVER_FILL_VIEWPORT_ALWAYS)
   {
     RenderPass();
     hasRendered = true;
+    renderedArea = CServiceBroker::GetWinSystem()->GetGfxContext().GetViewWindow().Area();
   }
   else if (CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_guiAlgorithmDirtyRegions == DIRTYREGION_SOLVER_FILL_VIEWPORT_ON_CHANGE)
   {
@@ -1184,6 +1211,7 @@ bool CGUIWindowManager::Render()
     {
       RenderPass();
       hasRendered = true;
+      renderedArea = CServiceBroker::GetWinSystem()->GetGfxContext().GetViewWindow().Area();
     }
   }
   else
@@ -1196,10 +1224,14 @@ bool CGUIWindowManager::Render()
       CServiceBroker::GetWinSystem()->GetGfxContext().SetScissors(*i);
       RenderPass();
       hasRendered = true;
+      renderedArea += i->Area();
     }
     CServiceBroker::GetWinSystem()->GetGfxContext().ResetScissors();
   }
 
+  if (CGUIControlProfiler::IsRunning())
+    CGUIControlProfiler::Instance().AddRenderedArea(renderedArea);
+
   if (CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_guiVisualizeDirtyRegions)
   {
     CServiceBroker::GetWinSystem()->GetGfxContext().SetRenderingResolution(CServiceBroker::GetWinSystem()->GetGfxContext().GetResInfo(), false);
@@ -14,6 +14,7 @@
 #include <vector>
 
 #include "DirtyRegionTracker.h"
+#include "OcclusionTracker.h"
 #include "guilib/WindowIDs.h"
 #include "GUIWindow.h"
 #include "IMsgTargetCallback.h"
@@ -216,6 +217,8 @@ public:
 #endif
 private:
   void RenderPass() const;
+  std::vector<CGUIWindow*> GetRenderList() const;
+  void UpdateOcclusion();
 
   void LoadNotOnDemandWindows();
   void UnloadNotOnDemandWindows();
@@ -267,4 +270,5 @@ private:
 
   CDirtyRegionList m_dirtyregions;
   CDirtyRegionTracker m_tracker;
+  COcclusionTracker m_occlusion;
 };
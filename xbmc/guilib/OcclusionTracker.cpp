@@ -0,0 +1,51 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "OcclusionTracker.h"
+
+#include <math.h>
+
+void COcclusionTracker::Reset(bool enabled)
+{
+  m_occluders.clear();
+  m_enabled = enabled;
+}
+
+void COcclusionTracker::AddOccluder(const CRect &region)
+{
+  if (!m_enabled)
+    return;
+
+  // only whole pixels are covered, edges may be blended with what's below
+  CRect rect(ceilf(region.x1), ceilf(region.y1), floorf(region.x2), floorf(region.y2));
+  if (rect.x2 <= rect.x1 || rect.y2 <= rect.y1)
+    return;
+
+  // skip regions within an existing occluder, the list stays short
+  for (const auto &occluder : m_occluders)
+  {
+    if (occluder.x1 <= rect.x1 && occluder.y1 <= rect.y1 &&
+        occluder.x2 >= rect.x2 && occluder.y2 >= rect.y2)
+      return;
+  }
+  m_occluders.push_back(rect);
+}
+
+bool COcclusionTracker::IsOccluded(const CRect &region) const
+{
+  if (region.IsEmpty())
+    return false;
+
+  for (const auto &occluder : m_occluders)
+  {
+    if (occluder.x1 <= region.x1 && occluder.y1 <= region.y1 &&
+        occluder.x2 >= region.x2 && occluder.y2 >= region.y2)
+      return true;
+  }
+  return false;
+}
@@ -0,0 +1,48 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "utils/Geometry.h"
+
+#include <vector>
+
+/*!
+ \ingroup controls
+ \brief Tracks the screen regions covered by opaque controls during a frame
+
+ After processing, the controls of all rendered windows are visited in reverse
+ render order (see CGUIControl::UpdateOcclusion). A control whose render region
+ lies completely within the opaque region of a control visited before it is
+ hidden, so it doesn't need to be rendered.
+ */
+class COcclusionTracker
+{
+public:
+  /*!
+   \brief Forget all occluders, called before visiting the controls of a frame
+   \param enabled whether controls may be hidden at all this frame
+   */
+  void Reset(bool enabled);
+
+  /*!
+   \brief Add the opaque region of a visited control
+   \param region the region in screen coordinates, must be fully covered by opaque pixels
+   */
+  void AddOccluder(const CRect &region);
+
+  /*!
+   \brief Whether a region is hidden behind the occluders added so far
+   \param region the render region in screen coordinates
+   */
+  bool IsOccluded(const CRect &region) const;
+
+private:
+  std::vector<CRect> m_occluders;
+  bool m_enabled = false;
+};
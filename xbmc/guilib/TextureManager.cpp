@@ -13,6 +13,8 @@
 #include "addons/Skin.h"
 #include "filesystem/Directory.h"
 #include "filesystem/File.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/SettingsComponent.h"
 #include "windowing/GraphicContext.h"
 #include "Texture.h"
 #include "threads/SingleLock.h"
@@ -251,17 +253,14 @@ bool CGUITextureManager::HasTexture(const std::string &textureName, std::string
     return false;
 
   // Check our loaded and bundled textures - we store in bundles using \\.
-  std::string bundledName = CTextureBundle::Normalize(textureName);
-  for (int i = 0; i < (int)m_vecTextures.size(); ++i)
+  if (m_textures.find(textureName) != m_textures.end())
   {
-    CTextureMap *pMap = m_vecTextures[i];
-    if (pMap->GetName() == textureName)
-    {
-      if (size) *size = 1;
-      return true;
-    }
+    if (size) *size = 1;
+    return true;
   }
 
+  std::string bundledName = CTextureBundle::Normalize(textureName);
+
   for (int i = 0; i < 2; i++)
   {
     if (m_TexBundle[i].HasFile(bundledName))
@@ -293,28 +292,24 @@ const CTextureArray& CGUITextureManager::Load(const std::string& strTextureName,
 
   if (size) // we found the texture
   {
-    for (int i = 0; i < (int)m_vecTextures.size(); ++i)
+    TextureMap::iterator it = m_textures.find(strTextureName);
+    if (it != m_textures.end())
     {
-      CTextureMap *pMap = m_vecTextures[i];
-      if (pMap->GetName() == strTextureName)
-      {
-        //CLog::Log(LOGDEBUG, "Total memusage %u", GetMemoryUsage());
-        return pMap->GetTexture();
-      }
+      m_hits++;
+      return it->second->GetTexture();
     }
     // Whoops, not there.
     return emptyTexture;
   }
 
-  for (ilistUnused i = m_unusedTextures.begin(); i != m_unusedTextures.end(); ++i)
+  auto unused = m_unusedIndex.find(strTextureName);
+  if (unused != m_unusedIndex.end())
   {
-    CTextureMap* pMap = i->first;
-    if (pMap->GetName() == strTextureName && i->second > 0)
-    {
-      m_vecTextures.push_back(pMap);
-      m_unusedTextures.erase(i);
-      return pMap->GetTexture();
-    }
+    CTextureMap* pMap = unused->second->first;
+    EraseUnused(unused->second);
+    m_textures[strTextureName] = pMap;
+    m_hits++;
+    return pMap->GetTexture();
   }
 
   if (checkBundleOnly && bundle == -1)
@@ -359,7 +354,7 @@ const CTextureArray& CGUITextureManager::Load(const std::string& strTextureName,
     delete[] pTextures;
     delete[] Delay;
 
-    m_vecTextures.push_back(pMap);
+    AddTexture(pMap);
     return pMap->GetTexture();
   }
   else if (StringUtils::EndsWithNoCase(strPath, ".gif") ||
@@ -416,7 +411,7 @@ const CTextureArray& CGUITextureManager::Load(const std::string& strTextureName,
 
     file.Close();
 
-    m_vecTextures.push_back(pMap);
+    AddTexture(pMap);
     return pMap->GetTexture();
   }
 
@@ -443,7 +438,7 @@ const CTextureArray& CGUITextureManager::Load(const std::string& strTextureName,
 
   CTextureMap* pMap = new CTextureMap(strTextureName, width, height, 0);
   pMap->Add(pTexture, 100);
-  m_vecTextures.push_back(pMap);
+  AddTexture(pMap);
 
 #ifdef _DEBUG_TEXTURES
   int64_t end, freq;
@@ -462,37 +457,65 @@ void CGUITextureManager::ReleaseTexture(const std::string& strTextureName, bool
 {
   CSingleLock lock(CServiceBroker::GetWinSystem()->GetGfxContext());
 
-  ivecTextures i;
-  i = m_vecTextures.begin();
-  while (i != m_vecTextures.end())
+  TextureMap::iterator i = m_textures.find(strTextureName);
+  if (i != m_textures.end())
   {
-    CTextureMap* pMap = *i;
-    if (pMap->GetName() == strTextureName)
+    CTextureMap* pMap = i->second;
+    if (pMap->Release())
     {
-      if (pMap->Release())
-      {
-        //CLog::Log(LOGINFO, "  cleanup:%s", strTextureName.c_str());
-        // add to our textures to free
-        m_unusedTextures.push_back(std::make_pair(pMap, immediately ? 0 : XbmcThreads::SystemClockMillis()));
-        i = m_vecTextures.erase(i);
-      }
-      return;
+      //CLog::Log(LOGINFO, "  cleanup:%s", strTextureName.c_str());
+      // add to our textures to free, only those not released immediately may be reused
+      unsigned int releaseTime = immediately ? 0 : XbmcThreads::SystemClockMillis();
+      m_unusedTextures.push_back(std::make_pair(pMap, releaseTime));
+      if (releaseTime > 0)
+        m_unusedIndex[strTextureName] = std::prev(m_unusedTextures.end());
+      m_textures.erase(i);
     }
-    ++i;
+    return;
   }
   CLog::Log(LOGWARNING, "%s: Unable to release texture %s", __FUNCTION__, strTextureName.c_str());
 }
 
+void CGUITextureManager::AddTexture(CTextureMap* pMap)
+{
+  m_textures[pMap->GetName()] = pMap;
+  m_bytes += pMap->GetMemoryUsage();
+  m_loads++;
+}
+
+void CGUITextureManager::DeleteTexture(CTextureMap* pMap)
+{
+  m_bytes -= pMap->GetMemoryUsage();
+  delete pMap;
+}
+
+CGUITextureManager::ilistUnused CGUITextureManager::EraseUnused(ilistUnused it)
+{
+  auto index = m_unusedIndex.find(it->first->GetName());
+  if (index != m_unusedIndex.end() && index->second == it)
+    m_unusedIndex.erase(index);
+  return m_unusedTextures.erase(it);
+}
+
 void CGUITextureManager::FreeUnusedTextures(unsigned int timeDelay)
+{
+  uint64_t maxBytes = static_cast<uint64_t>(CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_guiTextureCacheSize) * 1024 * 1024;
+  FreeUnusedTextures(timeDelay, maxBytes);
+}
+
+void CGUITextureManager::FreeUnusedTextures(unsigned int timeDelay, uint64_t maxBytes)
 {
   unsigned int currFrameTime = XbmcThreads::SystemClockMillis();
   CSingleLock lock(CServiceBroker::GetWinSystem()->GetGfxContext());
   for (ilistUnused i = m_unusedTextures.begin(); i != m_unusedTextures.end();)
   {
-    if (currFrameTime - i->second >= timeDelay)
+    // textures released immediately are always freed, the others once they
+    // exceed the cache size
+    if (currFrameTime - i->second >= timeDelay && (i->second == 0 || m_bytes > maxBytes))
     {
-      delete i->first;
-      i = m_unusedTextures.erase(i);
+      DeleteTexture(i->first);
+      i = EraseUnused(i);
+      m_evictions++;
     }
     else
       ++i;
@@ -524,47 +547,48 @@ void CGUITextureManager::Cleanup()
 {
   CSingleLock lock(CServiceBroker::GetWinSystem()->GetGfxContext());
 
-  ivecTextures i;
-  i = m_vecTextures.begin();
-  while (i != m_vecTextures.end())
+  for (const auto& it : m_textures)
   {
-    CTextureMap* pMap = *i;
+    CTextureMap* pMap = it.second;
     CLog::Log(LOGWARNING, "%s: Having to cleanup texture %s", __FUNCTION__, pMap->GetName().c_str());
-    delete pMap;
-    i = m_vecTextures.erase(i);
+    DeleteTexture(pMap);
   }
+  m_textures.clear();
 
   m_TexBundle[0] = CTextureBundle(true);
   m_TexBundle[1] = CTextureBundle();
-  FreeUnusedTextures();
+  FreeUnusedTextures(0, 0);
 }
 
 void CGUITextureManager::Dump() const
 {
-  CLog::Log(LOGDEBUG, "{0}: total texturemaps size: {1}", __FUNCTION__, m_vecTextures.size());
+  CLog::Log(LOGDEBUG, "{0}: total texturemaps size: {1}", __FUNCTION__, m_textures.size());
 
-  for (int i = 0; i < (int)m_vecTextures.size(); ++i)
+  for (const auto& it : m_textures)
   {
-    const CTextureMap* pMap = m_vecTextures[i];
+    const CTextureMap* pMap = it.second;
     if (!pMap->IsEmpty())
       pMap->Dump();
   }
+
+  CStats stats = GetStats();
+  CLog::Log(LOGDEBUG, "{0}: {1} hits, {2} loads, {3} evictions, {4} unused texturemaps, {5} bytes", __FUNCTION__,
+    stats.hits, stats.loads, stats.evictions, stats.unusedTextures, stats.bytes);
 }
 
 void CGUITextureManager::Flush()
 {
   CSingleLock lock(CServiceBroker::GetWinSystem()->GetGfxContext());
 
-  ivecTextures i;
-  i = m_vecTextures.begin();
-  while (i != m_vecTextures.end())
+  TextureMap::iterator i = m_textures.begin();
+  while (i != m_textures.end())
   {
-    CTextureMap* pMap = *i;
+    CTextureMap* pMap = i->second;
     pMap->Flush();
     if (pMap->IsEmpty() )
     {
-      delete pMap;
-      i = m_vecTextures.erase(i);
+      DeleteTexture(pMap);
+      i = m_textures.erase(i);
     }
     else
     {
@@ -576,13 +600,25 @@ void CGUITextureManager::Flush()
 unsigned int CGUITextureManager::GetMemoryUsage() const
 {
   unsigned int memUsage = 0;
-  for (int i = 0; i < (int)m_vecTextures.size(); ++i)
+  for (const auto& it : m_textures)
   {
-    memUsage += m_vecTextures[i]->GetMemoryUsage();
+    memUsage += it.second->GetMemoryUsage();
   }
   return memUsage;
 }
 
+CGUITextureManager::CStats CGUITextureManager::GetStats() const
+{
+  CStats stats;
+  stats.hits = m_hits;
+  stats.loads = m_loads;
+  stats.evictions = m_evictions;
+  stats.textures = m_textures.size();
+  stats.unusedTextures = m_unusedTextures.size();
+  stats.bytes = m_bytes;
+  return stats;
+}
+
 void CGUITextureManager::SetTexturePath(const std::string &texturePath)
 {
   CSingleLock lock(m_section);
@@ -9,6 +9,8 @@
 #pragma once
 
 #include <list>
+#include <string>
+#include <unordered_map>
 #include <vector>
 #include <utility>
 
@@ -90,6 +92,16 @@ protected:
 class CGUITextureManager
 {
 public:
+  struct CStats
+  {
+    uint64_t hits = 0;      ///< requests served by an already loaded texture
+    uint64_t loads = 0;     ///< textures loaded from file or bundle
+    uint64_t evictions = 0; ///< released textures that got freed
+    unsigned int textures = 0;       ///< textures in use
+    unsigned int unusedTextures = 0; ///< released textures kept for reuse
+    uint64_t bytes = 0;     ///< memory used by all loaded textures
+  };
+
   CGUITextureManager(void);
   virtual ~CGUITextureManager(void);
 
@@ -108,18 +120,39 @@ public:
   void SetTexturePath(const std::string &texturePath);    ///< Set a single path as the path to check when loading media (clear then add)
   void RemoveTexturePath(const std::string &texturePath); ///< Remove a path from the paths to check when loading media
 
-  void FreeUnusedTextures(unsigned int timeDelay = 0); ///< Free textures (called from app thread only)
+  /*!
+   \brief Free released textures (called from app thread only)
+   Textures released longer than timeDelay ago are kept as long as all loaded
+   textures fit into the texture cache size from advanced settings. Least
+   recently released textures are freed first.
+   */
+  void FreeUnusedTextures(unsigned int timeDelay = 0);
   void ReleaseHwTexture(unsigned int texture);
+
+  CStats GetStats() const;
 protected:
-  std::vector<CTextureMap*> m_vecTextures;
-  std::list<std::pair<CTextureMap*, unsigned int> > m_unusedTextures;
+  typedef std::unordered_map<std::string, CTextureMap*> TextureMap;
+  typedef std::list<std::pair<CTextureMap*, unsigned int> > UnusedList;
+  typedef UnusedList::iterator ilistUnused;
+
+  void FreeUnusedTextures(unsigned int timeDelay, uint64_t maxBytes);
+  void AddTexture(CTextureMap* pMap);
+  void DeleteTexture(CTextureMap* pMap);
+  ilistUnused EraseUnused(ilistUnused it);
+
+  TextureMap m_textures; ///< textures in use, by name
+  UnusedList m_unusedTextures; ///< released textures with release time, least recently released first
+  std::unordered_map<std::string, ilistUnused> m_unusedIndex; ///< released textures which may be reused, by name
   std::vector<unsigned int> m_unusedHwTextures;
-  typedef std::vector<CTextureMap*>::iterator ivecTextures;
-  typedef std::list<std::pair<CTextureMap*, unsigned int> >::iterator ilistUnused;
   // we have 2 texture bundles (one for the base textures, one for the theme)
   CTextureBundle m_TexBundle[2];
 
   std::vector<std::string> m_texturePaths;
   CCriticalSection m_section;
+
+  uint64_t m_bytes = 0;
+  uint64_t m_hits = 0;
+  uint64_t m_loads = 0;
+  uint64_t m_evictions = 0;
 };
 
@@ -58,6 +58,7 @@ void CLibraryGUIInfo::SetLibraryBool(int condition, bool value)
     default:
       break;
   }
+  ++m_version;
 }
 
 void CLibraryGUIInfo::ResetLibraryBools()
@@ -70,6 +71,7 @@ void CLibraryGUIInfo::ResetLibraryBools()
   m_libraryHasSingles = -1;
   m_libraryHasCompilations = -1;
   m_libraryRoleCounts.clear();
+  ++m_version;
 }
 
 bool CLibraryGUIInfo::InitCurrentItem(CFileItem *item)
@@ -10,6 +10,7 @@
 
 #include "guilib/guiinfo/GUIInfoProvider.h"
 
+#include <atomic>
 #include <string>
 #include <utility>
 #include <vector>
@@ -39,7 +40,14 @@ public:
   void SetLibraryBool(int condition, bool value);
   void ResetLibraryBools();
 
+  /*!
+   \brief Get a counter that changes whenever the library bools are set or reset
+   */
+  unsigned int GetVersion() const { return m_version; }
+
 private:
+  std::atomic<unsigned int> m_version{0};
+
   mutable int m_libraryHasMusic;
   mutable int m_libraryHasMovies;
   mutable int m_libraryHasTVShows;
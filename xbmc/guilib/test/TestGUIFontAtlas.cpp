@@ -0,0 +1,222 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "guilib/GUIFontAtlas.h"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace
+{
+
+const unsigned int PAGE = CGUIFontAtlas::PAGE_HEIGHT;
+
+class CTestAtlas : public CGUIFontAtlas
+{
+public:
+  CTestAtlas(unsigned int width, unsigned int maxHeight) : CGUIFontAtlas(width, maxHeight) {}
+
+  unsigned int resizes = 0;
+  unsigned int updates = 0;
+
+protected:
+  bool ResizeTexture(unsigned int oldHeight) override
+  {
+    resizes++;
+    return true;
+  }
+
+  void UpdateTexture(unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2) override
+  {
+    updates++;
+  }
+};
+
+class CTestOwner : public CGUIFontAtlas::IPageOwner
+{
+public:
+  void OnPageEvicted(unsigned int page) override { evicted.push_back(page); }
+  void OnAtlasResized() override { resized++; }
+  bool IsDrawing() const override { return drawing; }
+
+  std::vector<unsigned int> evicted;
+  unsigned int resized = 0;
+  bool drawing = false;
+};
+
+} // unnamed namespace
+
+TEST(TestGUIFontAtlas, LinesShareABlock)
+{
+  CTestAtlas atlas(64, 4 * PAGE);
+  CTestOwner font;
+
+  EXPECT_EQ(0, atlas.AllocateLine(&font, 100, 1));
+  EXPECT_EQ(100, atlas.AllocateLine(&font, 100, 1));
+  // the third line doesn't fit in the first page
+  EXPECT_EQ(static_cast<int>(PAGE), atlas.AllocateLine(&font, 100, 1));
+  EXPECT_EQ(2 * PAGE, atlas.GetHeight());
+  EXPECT_EQ(0u, atlas.GetPage(150));
+  EXPECT_EQ(1u, atlas.GetPage(PAGE + 10));
+}
+
+TEST(TestGUIFontAtlas, FontsGetSeparatePages)
+{
+  CTestAtlas atlas(64, 4 * PAGE);
+  CTestOwner small, large;
+
+  EXPECT_EQ(0, atlas.AllocateLine(&small, 20, 1));
+  EXPECT_EQ(static_cast<int>(PAGE), atlas.AllocateLine(&large, 40, 1));
+  EXPECT_EQ(20, atlas.AllocateLine(&small, 20, 1));
+
+  std::vector<unsigned int> blocks = atlas.GetBlocks(&large);
+  ASSERT_EQ(1u, blocks.size());
+  EXPECT_EQ(1u, blocks[0]);
+  EXPECT_EQ(40u, atlas.GetBlockUsedRows(1));
+  EXPECT_EQ(40u, atlas.GetBlockLineHeight(1));
+}
+
+TEST(TestGUIFontAtlas, GrowsByDoubling)
+{
+  CTestAtlas atlas(64, 8 * PAGE);
+  CTestOwner first, second, third;
+
+  EXPECT_EQ(0, atlas.AllocateLine(&first, 20, 1));
+  EXPECT_EQ(PAGE, atlas.GetHeight());
+  EXPECT_EQ(1u, atlas.resizes);
+
+  EXPECT_EQ(static_cast<int>(PAGE), atlas.AllocateLine(&second, 20, 1));
+  EXPECT_EQ(2 * PAGE, atlas.GetHeight());
+  EXPECT_EQ(2u, atlas.resizes);
+  // every font already on the texture has to recalculate its texture coordinates
+  EXPECT_EQ(1u, first.resized);
+  EXPECT_EQ(0u, second.resized);
+
+  EXPECT_EQ(static_cast<int>(2 * PAGE), atlas.AllocateLine(&third, 20, 1));
+  EXPECT_EQ(4 * PAGE, atlas.GetHeight());
+}
+
+TEST(TestGUIFontAtlas, EvictsLeastRecentlyUsed)
+{
+  CTestAtlas atlas(64, 2 * PAGE);
+  CTestOwner first, second, third;
+
+  EXPECT_EQ(0, atlas.AllocateLine(&first, 20, 1));
+  EXPECT_EQ(static_cast<int>(PAGE), atlas.AllocateLine(&second, 20, 2));
+  atlas.Touch(0, 3);
+
+  // the page of second was drawn from longest ago
+  EXPECT_EQ(static_cast<int>(PAGE), atlas.AllocateLine(&third, 20, 4));
+  EXPECT_TRUE(first.evicted.empty());
+  ASSERT_EQ(1u, second.evicted.size());
+  EXPECT_EQ(1u, second.evicted[0]);
+  EXPECT_TRUE(atlas.GetBlocks(&second).empty());
+}
+
+TEST(TestGUIFontAtlas, KeepsPagesInUse)
+{
+  CTestAtlas atlas(64, 2 * PAGE);
+  CTestOwner first, second, third;
+
+  EXPECT_EQ(0, atlas.AllocateLine(&first, 20, 1));
+  EXPECT_EQ(static_cast<int>(PAGE), atlas.AllocateLine(&second, 20, 1));
+
+  // pages drawn from in this frame may be referenced by text being laid out
+  atlas.Touch(0, 5);
+  atlas.Touch(1, 5);
+  EXPECT_EQ(-1, atlas.AllocateLine(&third, 20, 5));
+
+  // vertices of a font between Begin() and End() refer to its pages
+  second.drawing = true;
+  EXPECT_EQ(0, atlas.AllocateLine(&third, 20, 6));
+  EXPECT_EQ(1u, first.evicted.size());
+  EXPECT_TRUE(second.evicted.empty());
+}
+
+TEST(TestGUIFontAtlas, DoesntGrowWhileOthersDraw)
+{
+  CTestAtlas atlas(64, 4 * PAGE);
+  CTestOwner first, second;
+
+  EXPECT_EQ(0, atlas.AllocateLine(&first, 20, 1));
+  first.drawing = true;
+  EXPECT_EQ(-1, atlas.AllocateLine(&second, 20, 1));
+  EXPECT_EQ(PAGE, atlas.GetHeight());
+
+  first.drawing = false;
+  EXPECT_EQ(static_cast<int>(PAGE), atlas.AllocateLine(&second, 20, 1));
+}
+
+TEST(TestGUIFontAtlas, TallLinesSpanPages)
+{
+  CTestAtlas atlas(64, 4 * PAGE);
+  CTestOwner small, huge;
+
+  EXPECT_EQ(0, atlas.AllocateLine(&small, 20, 1));
+  EXPECT_EQ(static_cast<int>(PAGE), atlas.AllocateLine(&huge, PAGE + 10, 1));
+  EXPECT_EQ(4 * PAGE, atlas.GetHeight());
+  EXPECT_EQ(2u, atlas.GetBlockPages(1));
+  EXPECT_EQ(1u, atlas.GetPage(2 * PAGE + 5));
+
+  // the whole block is taken back
+  atlas.Touch(0, 2);
+  EXPECT_EQ(static_cast<int>(3 * PAGE), atlas.AllocateLine(&small, PAGE, 2));
+  EXPECT_EQ(static_cast<int>(PAGE), atlas.AllocateLine(&small, PAGE + 10, 3));
+  ASSERT_EQ(1u, huge.evicted.size());
+  EXPECT_EQ(1u, huge.evicted[0]);
+}
+
+TEST(TestGUIFontAtlas, ReleasePages)
+{
+  CTestAtlas atlas(64, 2 * PAGE);
+  CTestOwner first, second;
+
+  EXPECT_EQ(0, atlas.AllocateLine(&first, 20, 1));
+  EXPECT_EQ(static_cast<int>(PAGE), atlas.AllocateLine(&second, 20, 1));
+  atlas.ReleasePages(&first);
+  EXPECT_TRUE(atlas.GetBlocks(&first).empty());
+
+  // the free page is used before anything is evicted
+  EXPECT_EQ(0, atlas.AllocateLine(&second, 200, 1));
+  EXPECT_TRUE(second.evicted.empty());
+}
+
+TEST(TestGUIFontAtlas, AllocateBlockNeverEvicts)
+{
+  CTestAtlas atlas(64, 2 * PAGE);
+  CTestOwner first, second, third;
+
+  EXPECT_EQ(0, atlas.AllocateBlock(&first, 1, 20, 60, 1));
+  EXPECT_EQ(60u, atlas.GetBlockUsedRows(0));
+  // restored blocks are filled further by new lines
+  EXPECT_EQ(60, atlas.AllocateLine(&first, 20, 1));
+
+  EXPECT_EQ(static_cast<int>(PAGE), atlas.AllocateBlock(&second, 1, 20, 20, 1));
+  EXPECT_EQ(-1, atlas.AllocateBlock(&third, 1, 20, 20, 5));
+  EXPECT_TRUE(first.evicted.empty());
+  EXPECT_TRUE(second.evicted.empty());
+}
+
+TEST(TestGUIFontAtlas, CopyToTexture)
+{
+  CTestAtlas atlas(8, PAGE);
+  CTestOwner font;
+
+  EXPECT_EQ(0, atlas.AllocateLine(&font, 4, 1));
+  const unsigned char glyph[] = { 1, 2, 3,
+                                  4, 5, 6 };
+  atlas.CopyToTexture(glyph, 3, 2, 1, 5, 3);
+  EXPECT_EQ(1, atlas.GetPixels()[1 * 8 + 2]);
+  EXPECT_EQ(6, atlas.GetPixels()[2 * 8 + 4]);
+  EXPECT_EQ(0, atlas.GetPixels()[2 * 8 + 5]);
+
+  // freed pages are cleared for the next font
+  atlas.ReleasePages(&font);
+  EXPECT_EQ(0, atlas.GetPixels()[1 * 8 + 2]);
+}
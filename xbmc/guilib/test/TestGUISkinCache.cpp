@@ -0,0 +1,133 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "guilib/GUISkinCache.h"
+#include "utils/Archive.h"
+#include "utils/XBMCTinyXML.h"
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace
+{
+const std::string TEST_XML =
+  "<window id=\"1\">"
+    "<controls>"
+      "<control type=\"label\"><label>Some text</label><visible>true</visible></control>"
+      "<control type=\"label\"><label><![CDATA[<raw>]]></label></control>"
+    "</controls>"
+  "</window>";
+
+std::string Print(const TiXmlElement& element)
+{
+  TiXmlPrinter printer;
+  element.Accept(&printer);
+  return printer.Str();
+}
+}
+
+class TestGUISkinCache : public testing::Test
+{
+protected:
+  TestGUISkinCache() : m_path(CSpecialProtocol::TranslatePath("special://temp/TestGUISkinCache.bin"))
+  {
+  }
+
+  ~TestGUISkinCache() override
+  {
+    XFILE::CFile::Delete(m_path);
+  }
+
+  void Write(const TiXmlElement& element)
+  {
+    XFILE::CFile file;
+    ASSERT_TRUE(file.OpenForWrite(m_path, true));
+    CArchive ar(&file, CArchive::store);
+    CGUISkinCache::WriteTree(ar, element);
+    ar.Close();
+  }
+
+  void WriteBytes(const std::vector<uint8_t>& data)
+  {
+    XFILE::CFile file;
+    ASSERT_TRUE(file.OpenForWrite(m_path, true));
+    file.Write(data.data(), data.size());
+  }
+
+  std::vector<uint8_t> ReadBytes()
+  {
+    XFILE::CFile file;
+    XFILE::auto_buffer buffer;
+    file.LoadFile(m_path, buffer);
+    return std::vector<uint8_t>(buffer.get(), buffer.get() + buffer.size());
+  }
+
+  std::unique_ptr<TiXmlElement> Read()
+  {
+    XFILE::CFile file;
+    if (!file.Open(m_path))
+      return nullptr;
+    CArchive ar(&file, CArchive::load);
+    return CGUISkinCache::ReadTree(ar, file.GetLength());
+  }
+
+  std::string m_path;
+};
+
+TEST_F(TestGUISkinCache, RoundTrip)
+{
+  CXBMCTinyXML doc;
+  ASSERT_TRUE(doc.Parse(TEST_XML));
+  Write(*doc.RootElement());
+
+  std::unique_ptr<TiXmlElement> root = Read();
+  ASSERT_TRUE(root);
+  EXPECT_EQ(Print(*doc.RootElement()), Print(*root));
+  EXPECT_TRUE(root->FirstChildElement("controls")->LastChild()->FirstChildElement("label")->FirstChild()->ToText()->CDATA());
+}
+
+TEST_F(TestGUISkinCache, Truncated)
+{
+  CXBMCTinyXML doc;
+  ASSERT_TRUE(doc.Parse(TEST_XML));
+  Write(*doc.RootElement());
+
+  std::vector<uint8_t> data = ReadBytes();
+  ASSERT_GT(data.size(), 8u);
+  for (size_t size : { data.size() - 1, data.size() / 2, size_t(4), size_t(0) })
+  {
+    WriteBytes(std::vector<uint8_t>(data.begin(), data.begin() + size));
+    EXPECT_THROW(Read(), std::out_of_range) << "size " << size;
+  }
+}
+
+TEST_F(TestGUISkinCache, CorruptCounts)
+{
+  CXBMCTinyXML doc;
+  ASSERT_TRUE(doc.Parse(TEST_XML));
+  Write(*doc.RootElement());
+
+  std::vector<uint8_t> data = ReadBytes();
+
+  // a string count far beyond what the file can hold
+  std::vector<uint8_t> corrupt(data);
+  corrupt[0] = corrupt[1] = corrupt[2] = corrupt[3] = 0xff;
+  WriteBytes(corrupt);
+  EXPECT_THROW(Read(), std::out_of_range);
+
+  // the first string claims to reach past the end of the file
+  corrupt = data;
+  corrupt[4] = corrupt[5] = 0xff;
+  WriteBytes(corrupt);
+  EXPECT_THROW(Read(), std::out_of_range);
+}
@@ -0,0 +1,101 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "guilib/OcclusionTracker.h"
+
+#include "gtest/gtest.h"
+
+TEST(TestOcclusionTracker, Containment)
+{
+  COcclusionTracker tracker;
+  tracker.Reset(true);
+  tracker.AddOccluder(CRect(0, 0, 100, 100));
+
+  EXPECT_TRUE(tracker.IsOccluded(CRect(10, 10, 90, 90)));
+  EXPECT_TRUE(tracker.IsOccluded(CRect(0, 0, 100, 100)));
+  // partially covered regions still have to be rendered
+  EXPECT_FALSE(tracker.IsOccluded(CRect(50, 50, 150, 90)));
+  EXPECT_FALSE(tracker.IsOccluded(CRect(-1, 10, 90, 90)));
+  EXPECT_FALSE(tracker.IsOccluded(CRect(200, 200, 300, 300)));
+}
+
+TEST(TestOcclusionTracker, RegionsAreNotMerged)
+{
+  COcclusionTracker tracker;
+  tracker.Reset(true);
+  tracker.AddOccluder(CRect(0, 0, 100, 100));
+  tracker.AddOccluder(CRect(100, 0, 200, 100));
+
+  EXPECT_TRUE(tracker.IsOccluded(CRect(110, 10, 190, 90)));
+  // covered by two occluders, but by neither on its own
+  EXPECT_FALSE(tracker.IsOccluded(CRect(50, 10, 150, 90)));
+}
+
+TEST(TestOcclusionTracker, FractionalEdges)
+{
+  COcclusionTracker tracker;
+  tracker.Reset(true);
+  // only covers the whole pixels 11..99 x 21..79
+  tracker.AddOccluder(CRect(10.5f, 20.2f, 99.7f, 79.9f));
+
+  EXPECT_TRUE(tracker.IsOccluded(CRect(11, 21, 99, 79)));
+  EXPECT_TRUE(tracker.IsOccluded(CRect(11.5f, 21.5f, 98.5f, 78.5f)));
+  EXPECT_FALSE(tracker.IsOccluded(CRect(10.5f, 21, 99, 79)));
+  EXPECT_FALSE(tracker.IsOccluded(CRect(11, 20.5f, 99, 79)));
+  EXPECT_FALSE(tracker.IsOccluded(CRect(11, 21, 99.5f, 79)));
+  EXPECT_FALSE(tracker.IsOccluded(CRect(11, 21, 99, 79.5f)));
+}
+
+TEST(TestOcclusionTracker, PartialPixels)
+{
+  COcclusionTracker tracker;
+  tracker.Reset(true);
+  // narrower than a whole pixel, covers nothing
+  tracker.AddOccluder(CRect(10.2f, 0, 10.8f, 100));
+  tracker.AddOccluder(CRect(0, 50.1f, 100, 50.9f));
+
+  EXPECT_FALSE(tracker.IsOccluded(CRect(10.3f, 10, 10.7f, 90)));
+  EXPECT_FALSE(tracker.IsOccluded(CRect(10, 50.3f, 90, 50.7f)));
+}
+
+TEST(TestOcclusionTracker, EmptyRegion)
+{
+  COcclusionTracker tracker;
+  tracker.Reset(true);
+  tracker.AddOccluder(CRect(0, 0, 100, 100));
+  tracker.AddOccluder(CRect(200, 200, 200, 300));
+
+  // nothing is rendered for empty regions, so they are never hidden either
+  EXPECT_FALSE(tracker.IsOccluded(CRect()));
+  EXPECT_FALSE(tracker.IsOccluded(CRect(10, 10, 10, 90)));
+  EXPECT_FALSE(tracker.IsOccluded(CRect(200, 250, 200, 260)));
+}
+
+TEST(TestOcclusionTracker, Disabled)
+{
+  COcclusionTracker tracker;
+  EXPECT_FALSE(tracker.IsOccluded(CRect(10, 10, 90, 90)));
+
+  tracker.Reset(false);
+  tracker.AddOccluder(CRect(0, 0, 100, 100));
+  EXPECT_FALSE(tracker.IsOccluded(CRect(10, 10, 90, 90)));
+}
+
+TEST(TestOcclusionTracker, ResetForgetsOccluders)
+{
+  COcclusionTracker tracker;
+  tracker.Reset(true);
+  tracker.AddOccluder(CRect(0, 0, 100, 100));
+  EXPECT_TRUE(tracker.IsOccluded(CRect(10, 10, 90, 90)));
+
+  tracker.Reset(false);
+  EXPECT_FALSE(tracker.IsOccluded(CRect(10, 10, 90, 90)));
+
+  tracker.Reset(true);
+  EXPECT_FALSE(tracker.IsOccluded(CRect(10, 10, 90, 90)));
+}
@@ -0,0 +1,185 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "ServiceBroker.h"
+#include "guilib/Texture.h"
+#include "guilib/TextureManager.h"
+#include "windowing/WinSystem.h"
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace
+{
+
+const unsigned int TEXTURE_SIZE = 16;
+
+//! texture with pixels only, never uploaded
+class CTestTexture : public CBaseTexture
+{
+public:
+  CTestTexture() : CBaseTexture(TEXTURE_SIZE, TEXTURE_SIZE) {}
+
+  void CreateTextureObject() override {}
+  void DestroyTextureObject() override {}
+  void LoadToGPU() override {}
+  void BindToUnit(unsigned int unit) override {}
+};
+
+//! provides the graphics context the texture manager locks
+class CTestWinSystem : public CWinSystemBase
+{
+public:
+  bool CreateNewWindow(const std::string& name, bool fullScreen, RESOLUTION_INFO& res) override { return false; }
+  bool ResizeWindow(int newWidth, int newHeight, int newLeft, int newTop) override { return false; }
+  bool SetFullScreen(bool fullScreen, RESOLUTION_INFO& res, bool blankOtherDisplays) override { return false; }
+  void Register(IDispResource* resource) override {}
+  void Unregister(IDispResource* resource) override {}
+};
+
+class CTestTextureManager : public CGUITextureManager
+{
+public:
+  using CGUITextureManager::FreeUnusedTextures;
+
+  //! adds a texture as if it was loaded from file, with one reference
+  const CTextureArray& Add(const std::string& name)
+  {
+    CTextureMap* map = new CTextureMap(name, TEXTURE_SIZE, TEXTURE_SIZE, 0);
+    map->Add(new CTestTexture, 100);
+    AddTexture(map);
+    return map->GetTexture();
+  }
+
+  bool IsLoaded(const std::string& name) const { return m_textures.find(name) != m_textures.end(); }
+  bool IsReusable(const std::string& name) const { return m_unusedIndex.find(name) != m_unusedIndex.end(); }
+};
+
+//! memory a texture added by CTestTextureManager::Add() accounts for
+uint64_t TextureBytes()
+{
+  CTextureMap map("size", TEXTURE_SIZE, TEXTURE_SIZE, 0);
+  map.Add(new CTestTexture, 100);
+  return map.GetMemoryUsage();
+}
+
+} // unnamed namespace
+
+class TestTextureManager : public testing::Test
+{
+protected:
+  TestTextureManager()
+  {
+    CServiceBroker::RegisterWinSystem(&m_winSystem);
+  }
+
+  ~TestTextureManager() override
+  {
+    CServiceBroker::UnregisterWinSystem();
+  }
+
+  CTestWinSystem m_winSystem;
+};
+
+TEST_F(TestTextureManager, LoadedTexturesAreShared)
+{
+  CTestTextureManager manager;
+  const CTextureArray& texture = manager.Add("/textures/a.png");
+
+  EXPECT_TRUE(manager.HasTexture("/textures/a.png"));
+  EXPECT_EQ(&texture, &manager.Load("/textures/a.png"));
+
+  CGUITextureManager::CStats stats = manager.GetStats();
+  EXPECT_EQ(1u, stats.hits);
+  EXPECT_EQ(1u, stats.loads);
+  EXPECT_EQ(1u, stats.textures);
+  EXPECT_EQ(TextureBytes(), stats.bytes);
+
+  // still referenced once
+  manager.ReleaseTexture("/textures/a.png");
+  EXPECT_TRUE(manager.IsLoaded("/textures/a.png"));
+  manager.ReleaseTexture("/textures/a.png");
+  EXPECT_FALSE(manager.IsLoaded("/textures/a.png"));
+  EXPECT_EQ(1u, manager.GetStats().unusedTextures);
+}
+
+TEST_F(TestTextureManager, ReleasedTexturesAreReused)
+{
+  CTestTextureManager manager;
+  const CTextureArray& texture = manager.Add("/textures/a.png");
+  manager.ReleaseTexture("/textures/a.png");
+  EXPECT_TRUE(manager.IsReusable("/textures/a.png"));
+
+  EXPECT_EQ(&texture, &manager.Load("/textures/a.png"));
+  EXPECT_TRUE(manager.IsLoaded("/textures/a.png"));
+  EXPECT_FALSE(manager.IsReusable("/textures/a.png"));
+
+  CGUITextureManager::CStats stats = manager.GetStats();
+  EXPECT_EQ(1u, stats.hits);
+  EXPECT_EQ(1u, stats.loads);
+  EXPECT_EQ(0u, stats.unusedTextures);
+}
+
+TEST_F(TestTextureManager, ImmediatelyReleasedTexturesAreFreed)
+{
+  CTestTextureManager manager;
+  manager.Add("/textures/a.png");
+  manager.Add("/textures/b.png");
+  manager.ReleaseTexture("/textures/a.png", true);
+  manager.ReleaseTexture("/textures/b.png");
+  EXPECT_FALSE(manager.IsReusable("/textures/a.png"));
+
+  // freed even though everything fits into the budget
+  manager.FreeUnusedTextures(0, 2 * TextureBytes());
+  CGUITextureManager::CStats stats = manager.GetStats();
+  EXPECT_EQ(1u, stats.evictions);
+  EXPECT_EQ(1u, stats.unusedTextures);
+  EXPECT_EQ(TextureBytes(), stats.bytes);
+  EXPECT_TRUE(manager.IsReusable("/textures/b.png"));
+}
+
+TEST_F(TestTextureManager, LeastRecentlyReleasedAreFreedFirst)
+{
+  CTestTextureManager manager;
+  for (const char* name : { "/textures/a.png", "/textures/b.png", "/textures/c.png", "/textures/d.png" })
+    manager.Add(name);
+  manager.ReleaseTexture("/textures/a.png");
+  manager.ReleaseTexture("/textures/c.png");
+  manager.ReleaseTexture("/textures/b.png");
+
+  // only as many as needed to get within the budget
+  manager.FreeUnusedTextures(0, 2 * TextureBytes());
+  CGUITextureManager::CStats stats = manager.GetStats();
+  EXPECT_EQ(2u, stats.evictions);
+  EXPECT_EQ(2 * TextureBytes(), stats.bytes);
+  EXPECT_FALSE(manager.IsReusable("/textures/a.png"));
+  EXPECT_FALSE(manager.IsReusable("/textures/c.png"));
+  EXPECT_TRUE(manager.IsReusable("/textures/b.png"));
+  EXPECT_TRUE(manager.IsLoaded("/textures/d.png"));
+
+  // textures in use are never freed
+  manager.FreeUnusedTextures(0, 0);
+  stats = manager.GetStats();
+  EXPECT_EQ(3u, stats.evictions);
+  EXPECT_EQ(0u, stats.unusedTextures);
+  EXPECT_EQ(TextureBytes(), stats.bytes);
+  EXPECT_TRUE(manager.IsLoaded("/textures/d.png"));
+}
+
+TEST_F(TestTextureManager, RecentlyReleasedAreKept)
+{
+  CTestTextureManager manager;
+  manager.Add("/textures/a.png");
+  manager.ReleaseTexture("/textures/a.png");
+
+  // within the delay textures are kept regardless of the budget
+  manager.FreeUnusedTextures(60000, 0);
+  EXPECT_EQ(0u, manager.GetStats().evictions);
+  EXPECT_TRUE(manager.IsReusable("/textures/a.png"));
+}
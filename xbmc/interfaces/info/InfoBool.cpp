@@ -11,13 +11,33 @@
 
 namespace INFO
 {
-  InfoBool::InfoBool(const std::string &expression, int context, unsigned int &refreshCounter)
+  InfoChangeTracker::InfoChangeTracker()
+    : m_epoch(1),
+      m_evaluations(0),
+      m_cacheHits(0)
+  {
+    for (unsigned int i = 0; i < SOURCE_COUNT; i++)
+      m_changed[i] = m_epoch;
+  }
+
+  void InfoChangeTracker::Changed(unsigned int dependencies)
+  {
+    ++m_epoch;
+    for (unsigned int i = 0; i < SOURCE_COUNT; i++)
+    {
+      if (dependencies & (1 << i))
+        m_changed[i] = m_epoch;
+    }
+  }
+
+  InfoBool::InfoBool(const std::string &expression, int context, InfoChangeTracker &tracker)
     : m_value(false),
       m_context(context),
       m_listItemDependent(false),
       m_expression(expression),
-      m_refreshCounter(0),
-      m_parentRefreshCounter(refreshCounter)
+      m_dependencies(DEPENDS_ALL),
+      m_epoch(0),
+      m_tracker(tracker)
   {
     StringUtils::ToLower(m_expression);
   }
@@ -15,6 +15,67 @@ class CGUIListItem;
 
 namespace INFO
 {
+/*!
+ \ingroup info
+ \brief State sources an info bool can depend on
+ */
+enum InfoDependency
+{
+  DEPENDS_NONE     = 0,
+  DEPENDS_PLAYER   = 1 << 0, ///< player state, playback time and the playing item
+  DEPENDS_LIBRARY  = 1 << 1, ///< library content
+  DEPENDS_LISTITEM = 1 << 2, ///< focused list items and containers
+  DEPENDS_SYSTEM   = 1 << 3, ///< everything else (windows, skin, system state, ...)
+  DEPENDS_ALL      = DEPENDS_PLAYER | DEPENDS_LIBRARY | DEPENDS_LISTITEM | DEPENDS_SYSTEM
+};
+
+/*!
+ \ingroup info
+ \brief Tracks when each state source last changed
+
+ Every change bumps a global epoch and records it for the changed sources. An
+ info bool remembers the epoch it was last evaluated at and only needs to be
+ evaluated again if one of the sources it depends on changed since.
+ */
+class InfoChangeTracker
+{
+public:
+  InfoChangeTracker();
+
+  /*! \brief Mark the given sources as changed
+   \param dependencies InfoDependency flags of the changed sources
+   */
+  void Changed(unsigned int dependencies);
+
+  /*! \brief Check whether any of the given sources changed after the given epoch
+   */
+  bool HasChanged(unsigned int dependencies, unsigned int epoch) const
+  {
+    for (unsigned int i = 0; i < SOURCE_COUNT; i++)
+    {
+      if ((dependencies & (1 << i)) && m_changed[i] > epoch)
+        return true;
+    }
+    return false;
+  }
+
+  unsigned int GetEpoch() const { return m_epoch; }
+
+  /*! \brief Number of times info bools were evaluated/served from cache, for profiling
+   */
+  unsigned int GetEvaluations() const { return m_evaluations; }
+  unsigned int GetCacheHits() const { return m_cacheHits; }
+
+private:
+  friend class InfoBool;
+
+  static const unsigned int SOURCE_COUNT = 4;
+  unsigned int m_epoch;
+  unsigned int m_changed[SOURCE_COUNT];
+  unsigned int m_evaluations;
+  unsigned int m_cacheHits;
+};
+
 /*!
  \ingroup info
  \brief Base class, wrapping boolean conditions and expressions
@@ -22,7 +83,7 @@ namespace INFO
 class InfoBool
 {
 public:
-  InfoBool(const std::string &expression, int context, unsigned int &refreshCounter);
+  InfoBool(const std::string &expression, int context, InfoChangeTracker &tracker);
   virtual ~InfoBool() = default;
 
   virtual void Initialize() {};
@@ -34,12 +95,20 @@ public:
   inline bool Get(const CGUIListItem *item = NULL)
   {
     if (item && m_listItemDependent)
+    {
       Update(item);
-    else if (m_refreshCounter != m_parentRefreshCounter || m_refreshCounter == 0)
+      m_tracker.m_evaluations++;
+    }
+    else if (m_epoch == 0 || m_tracker.HasChanged(m_dependencies, m_epoch))
     {
+      // take the epoch first so changes made during the update aren't missed
+      unsigned int epoch = m_tracker.GetEpoch();
       Update(NULL);
-      m_refreshCounter = m_parentRefreshCounter;
+      m_epoch = epoch;
+      m_tracker.m_evaluations++;
     }
+    else
+      m_tracker.m_cacheHits++;
     return m_value;
   }
 
@@ -66,16 +135,22 @@ public:
 
   const std::string &GetExpression() const { return m_expression; }
   bool ListItemDependent() const { return m_listItemDependent; }
+
+  /*! \brief The state sources this info bool depends on, set by Initialize()
+   \return InfoDependency flags
+   */
+  unsigned int GetDependencies() const { return m_dependencies; }
 protected:
 
   bool m_value;                ///< current value
   int m_context;               ///< contextual information to go with the condition
   bool m_listItemDependent;    ///< do not cache if a listitem pointer is given
   std::string  m_expression;   ///< original expression
+  unsigned int m_dependencies; ///< InfoDependency flags, re-evaluate only if one of these changed
 
 private:
-  unsigned int m_refreshCounter;
-  unsigned int &m_parentRefreshCounter;
+  unsigned int m_epoch;        ///< tracker epoch of the last evaluation, 0 if never evaluated
+  InfoChangeTracker &m_tracker;
 };
 
 typedef std::shared_ptr<InfoBool> InfoPtr;
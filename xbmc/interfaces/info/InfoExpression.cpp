@@ -19,7 +19,9 @@ using namespace INFO;
 
 void InfoSingle::Initialize()
 {
-  m_condition = CServiceBroker::GetGUI()->GetInfoManager().TranslateSingleString(m_expression, m_listItemDependent);
+  CGUIInfoManager& infoMgr = CServiceBroker::GetGUI()->GetInfoManager();
+  m_condition = infoMgr.TranslateSingleString(m_expression, m_listItemDependent);
+  m_dependencies = infoMgr.GetDependencies(m_condition);
 }
 
 void InfoSingle::Update(const CGUIListItem *item)
@@ -34,6 +36,7 @@ void InfoExpression::Initialize()
     CLog::Log(LOGERROR, "Error parsing boolean expression %s", m_expression.c_str());
     m_expression_tree = std::make_shared<InfoLeaf>(CServiceBroker::GetGUI()->GetInfoManager().Register("false", 0), false);
   }
+  m_dependencies = m_expression_tree->GetDependencies();
 }
 
 void InfoExpression::Update(const CGUIListItem *item)
@@ -84,6 +87,14 @@ void InfoExpression::InfoAssociativeGroup::Merge(std::shared_ptr<InfoAssociative
   m_children.splice(m_children.end(), other->m_children);
 }
 
+unsigned int InfoExpression::InfoAssociativeGroup::GetDependencies() const
+{
+  unsigned int dependencies = DEPENDS_NONE;
+  for (const auto& child : m_children)
+    dependencies |= child->GetDependencies();
+  return dependencies;
+}
+
 bool InfoExpression::InfoAssociativeGroup::Evaluate(const CGUIListItem *item)
 {
   /* Handle either AND or OR by using the relation
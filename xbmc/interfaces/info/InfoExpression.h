@@ -22,8 +22,8 @@ namespace INFO
 class InfoSingle : public InfoBool
 {
 public:
-  InfoSingle(const std::string &expression, int context, unsigned int &refreshCounter)
-    : InfoBool(expression, context, refreshCounter) {};
+  InfoSingle(const std::string &expression, int context, InfoChangeTracker &tracker)
+    : InfoBool(expression, context, tracker) {};
   void Initialize() override;
 
   void Update(const CGUIListItem *item) override;
@@ -36,8 +36,8 @@ private:
 class InfoExpression : public InfoBool
 {
 public:
-  InfoExpression(const std::string &expression, int context, unsigned int &refreshCounter)
-    : InfoBool(expression, context, refreshCounter) {};
+  InfoExpression(const std::string &expression, int context, InfoChangeTracker &tracker)
+    : InfoBool(expression, context, tracker) {};
   ~InfoExpression() override = default;
 
   void Initialize() override;
@@ -68,6 +68,7 @@ private:
     virtual ~InfoSubexpression(void) = default; // so we can destruct derived classes using a pointer to their base class
     virtual bool Evaluate(const CGUIListItem *item) = 0;
     virtual node_type_t Type() const=0;
+    virtual unsigned int GetDependencies() const = 0;
   };
 
   typedef std::shared_ptr<InfoSubexpression> InfoSubexpressionPtr;
@@ -79,6 +80,7 @@ private:
     InfoLeaf(InfoPtr info, bool invert) : m_info(info), m_invert(invert) {};
     bool Evaluate(const CGUIListItem *item) override;
     node_type_t Type() const override { return NODE_LEAF; };
+    unsigned int GetDependencies() const override { return m_info ? m_info->GetDependencies() : DEPENDS_ALL; }
   private:
     InfoPtr m_info;
     bool m_invert;
@@ -93,6 +95,7 @@ private:
     void Merge(std::shared_ptr<InfoAssociativeGroup> other);
     bool Evaluate(const CGUIListItem *item) override;
     node_type_t Type() const override { return m_type; };
+    unsigned int GetDependencies() const override;
   private:
     node_type_t m_type;
     std::list<InfoSubexpressionPtr> m_children;
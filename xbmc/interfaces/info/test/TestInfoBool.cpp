@@ -0,0 +1,135 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "guilib/GUIListItem.h"
+#include "interfaces/info/InfoBool.h"
+
+#include "gtest/gtest.h"
+
+using namespace INFO;
+
+namespace
+{
+class CountingBool : public InfoBool
+{
+public:
+  CountingBool(unsigned int dependencies, InfoChangeTracker& tracker, bool listItemDependent = false)
+    : InfoBool("counting", 0, tracker)
+  {
+    m_dependencies = dependencies;
+    m_listItemDependent = listItemDependent;
+  }
+
+  void Update(const CGUIListItem* item) override
+  {
+    m_updates++;
+    m_value = m_nextValue;
+  }
+
+  int m_updates = 0;
+  bool m_nextValue = false;
+};
+}
+
+TEST(TestInfoBool, ChangeTracker)
+{
+  InfoChangeTracker tracker;
+  const unsigned int epoch = tracker.GetEpoch();
+  EXPECT_FALSE(tracker.HasChanged(DEPENDS_ALL, epoch));
+
+  tracker.Changed(DEPENDS_PLAYER);
+  EXPECT_GT(tracker.GetEpoch(), epoch);
+  EXPECT_TRUE(tracker.HasChanged(DEPENDS_PLAYER, epoch));
+  EXPECT_TRUE(tracker.HasChanged(DEPENDS_PLAYER | DEPENDS_LIBRARY, epoch));
+  EXPECT_FALSE(tracker.HasChanged(DEPENDS_LIBRARY | DEPENDS_LISTITEM | DEPENDS_SYSTEM, epoch));
+  EXPECT_FALSE(tracker.HasChanged(DEPENDS_NONE, epoch));
+
+  // changes are relative to the epoch asked for
+  EXPECT_FALSE(tracker.HasChanged(DEPENDS_PLAYER, tracker.GetEpoch()));
+
+  tracker.Changed(DEPENDS_LIBRARY | DEPENDS_SYSTEM);
+  EXPECT_TRUE(tracker.HasChanged(DEPENDS_LIBRARY, epoch));
+  EXPECT_TRUE(tracker.HasChanged(DEPENDS_SYSTEM, epoch));
+  EXPECT_FALSE(tracker.HasChanged(DEPENDS_LISTITEM, epoch));
+}
+
+TEST(TestInfoBool, EvaluatedOnlyAfterChange)
+{
+  InfoChangeTracker tracker;
+  CountingBool info(DEPENDS_PLAYER, tracker);
+
+  // always evaluated on first use
+  EXPECT_FALSE(info.Get());
+  EXPECT_EQ(1, info.m_updates);
+
+  info.m_nextValue = true;
+  EXPECT_FALSE(info.Get());
+  tracker.Changed(DEPENDS_LIBRARY | DEPENDS_LISTITEM | DEPENDS_SYSTEM);
+  EXPECT_FALSE(info.Get());
+  EXPECT_EQ(1, info.m_updates);
+
+  tracker.Changed(DEPENDS_PLAYER);
+  EXPECT_TRUE(info.Get());
+  EXPECT_TRUE(info.Get());
+  EXPECT_EQ(2, info.m_updates);
+
+  EXPECT_EQ(2u, tracker.GetEvaluations());
+  EXPECT_EQ(3u, tracker.GetCacheHits());
+}
+
+TEST(TestInfoBool, ChangedDuringUpdate)
+{
+  // a change made while evaluating isn't covered by the value just computed
+  class ChangingBool : public CountingBool
+  {
+  public:
+    ChangingBool(InfoChangeTracker& tracker) : CountingBool(DEPENDS_PLAYER, tracker), m_changes(tracker) {}
+    void Update(const CGUIListItem* item) override
+    {
+      CountingBool::Update(item);
+      if (m_updates == 1)
+        m_changes.Changed(DEPENDS_PLAYER);
+    }
+
+  private:
+    InfoChangeTracker& m_changes;
+  };
+
+  InfoChangeTracker tracker;
+  ChangingBool info(tracker);
+  info.Get();
+  info.Get();
+  EXPECT_EQ(2, info.m_updates);
+  info.Get();
+  EXPECT_EQ(2, info.m_updates);
+}
+
+TEST(TestInfoBool, NoDependencies)
+{
+  InfoChangeTracker tracker;
+  CountingBool info(DEPENDS_NONE, tracker);
+  info.Get();
+  tracker.Changed(DEPENDS_ALL);
+  info.Get();
+  EXPECT_EQ(1, info.m_updates);
+}
+
+TEST(TestInfoBool, ListItemDependent)
+{
+  InfoChangeTracker tracker;
+  CountingBool info(DEPENDS_LISTITEM, tracker, true);
+
+  // evaluated for every item, cached without one
+  CGUIListItem item;
+  info.Get(&item);
+  info.Get(&item);
+  EXPECT_EQ(2, info.m_updates);
+  info.Get();
+  info.Get();
+  EXPECT_EQ(3, info.m_updates);
+}
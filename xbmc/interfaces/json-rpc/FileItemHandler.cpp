@@ -39,7 +39,7 @@ using namespace MUSIC_INFO;
 using namespace JSONRPC;
 using namespace XFILE;
 
-bool CFileItemHandler::GetField(const std::string &field, const CVariant &info, const CFileItemPtr &item, CVariant &result, bool &fetchedArt, CThumbLoader *thumbLoader /* = NULL */)
+bool CFileItemHandler::GetField(const std::string &field, CVariant &info, const CFileItemPtr &item, CVariant &result, bool &fetchedArt, CThumbLoader *thumbLoader /* = NULL */)
 {
   if (result.isMember(field) && !result[field].empty())
     return true;
@@ -55,10 +55,11 @@ bool CFileItemHandler::GetField(const std::string &field, const CVariant &info,
     }
   }
 
-  // check for serialized values
+  // check for serialized values, each field is only looked up once so the
+  // value can be moved out of the serialization
   if (info.isMember(field) && !info[field].isNull())
   {
-    result[field] = info[field];
+    result[field] = std::move(info[field]);
     return true;
   }
 
@@ -112,7 +113,7 @@ bool CFileItemHandler::GetField(const std::string &field, const CVariant &info,
           artObj[artIt->first] = CTextureUtils::GetWrappedImageURL(artIt->second);
       }
 
-      result["art"] = artObj;
+      result["art"] = std::move(artObj);
       return true;
     }
 
@@ -232,10 +233,25 @@ void CFileItemHandler::HandleFileItemList(const char *ID, bool allowFile, const
       fields.insert(field->asString());
   }
 
+  // write the items straight to the response if it is streamed
+  CJSONRPCResultStream *stream = CJSONRPCResultStream::Get(result);
+  if (stream != nullptr && (resultname == nullptr || end <= start || !stream->StartList(resultname)))
+    stream = nullptr;
+
   for (int i = start; i < end; i++)
   {
     CFileItemPtr item = items.Get(i);
-    HandleFileItem(ID, allowFile, resultname, item, parameterObject, fields, result, true, thumbLoader);
+    if (stream != nullptr)
+    {
+      CVariant object;
+      HandleFileItem(ID, allowFile, resultname, item, parameterObject, fields, object, false, thumbLoader);
+
+      // stop once the client has gone away
+      if (!stream->AddItem(object[resultname]))
+        break;
+    }
+    else
+      HandleFileItem(ID, allowFile, resultname, item, parameterObject, fields, result, true, thumbLoader);
   }
 
   delete thumbLoader;
@@ -370,9 +386,9 @@ void CFileItemHandler::HandleFileItem(const char *ID, bool allowFile, const char
   if (resultname)
   {
     if (append)
-      result[resultname].append(object);
+      result[resultname].append(std::move(object));
     else
-      result[resultname] = object;
+      result[resultname] = std::move(object);
   }
 }
 
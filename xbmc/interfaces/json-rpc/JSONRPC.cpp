@@ -19,14 +19,98 @@
 #include "playlists/SmartPlayList.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/SettingsComponent.h"
+#include "utils/JSONVariantWriter.h"
 #include "utils/log.h"
 #include "utils/StringUtils.h"
 #include "utils/Variant.h"
 #include "ServiceBroker.h"
 #include "TextureDatabase.h"
 
+#include <set>
+
 using namespace JSONRPC;
 
+namespace
+{
+// methods whose responses are streamed, they return right after handing their
+// list to CFileItemHandler
+const std::set<std::string> StreamableMethods = {
+  "videolibrary.getmovies",
+  "videolibrary.gettvshows",
+  "videolibrary.getepisodes",
+  "videolibrary.getmusicvideos",
+  "videolibrary.getrecentlyaddedmovies",
+  "videolibrary.getrecentlyaddedepisodes",
+  "videolibrary.getrecentlyaddedmusicvideos",
+  "videolibrary.getinprogresstvshows"
+};
+
+thread_local CJSONRPCResultStream *currentStream = nullptr;
+}
+
+CJSONRPCResultStream::CJSONRPCResultStream(CJSONStreamWriter &writer, const CVariant &id)
+  : m_writer(writer),
+    m_id(id)
+{ }
+
+CJSONRPCResultStream* CJSONRPCResultStream::Get(const CVariant &result)
+{
+  if (currentStream != nullptr && currentStream->m_result == &result)
+    return currentStream;
+
+  return nullptr;
+}
+
+bool CJSONRPCResultStream::StartList(const std::string &name)
+{
+  if (m_started)
+    return false;
+
+  m_started = true;
+  m_list = name;
+
+  // the writer ignores everything after an error, which is then reported by AddItem()
+  m_writer.StartObject();
+  m_writer.Key("id");
+  m_writer.Write(m_id);
+  m_writer.Key("jsonrpc");
+  m_writer.Write("2.0");
+  m_writer.Key("result");
+  m_writer.StartObject();
+  m_writer.Key(m_list);
+  m_writer.StartArray();
+
+  return true;
+}
+
+bool CJSONRPCResultStream::AddItem(const CVariant &item)
+{
+  return m_started && m_writer.Write(item);
+}
+
+bool CJSONRPCResultStream::Finish(const CVariant &response)
+{
+  // a successful response has already been started, so abort it instead of
+  // completing it and let the client see the truncated list as an error
+  if (response.isMember("error"))
+  {
+    CLog::Log(LOGERROR, "JSONRPC: Method failed after its result has been partially sent, aborting the response");
+    return false;
+  }
+
+  if (!m_writer.EndArray())
+    return false;
+
+  const CVariant &result = response["result"];
+  for (CVariant::const_iterator_map it = result.begin_map(); it != result.end_map(); ++it)
+  {
+    if (it->first != m_list && (!m_writer.Key(it->first) || !m_writer.Write(it->second)))
+      return false;
+  }
+
+  return m_writer.EndObject() && m_writer.EndObject() && m_writer.Flush();
+}
+
 bool CJSONRPC::m_initialized = false;
 
 void CJSONRPC::Initialize()
@@ -247,7 +331,7 @@ std::string CJSONRPC::MethodCall(const std::string &inputString, ITransportLayer
           CVariant response;
           if (HandleMethodCall(*itr, response, transport, client))
           {
-            outputroot.append(response);
+            outputroot.append(std::move(response));
             hasResponse = true;
           }
         }
@@ -270,7 +354,33 @@ std::string CJSONRPC::MethodCall(const std::string &inputString, ITransportLayer
   return str;
 }
 
-bool CJSONRPC::HandleMethodCall(const CVariant& request, CVariant& response, ITransportLayer *transport, IClient *client)
+bool CJSONRPC::CanStreamMethodCall(const CVariant &request)
+{
+  if (!IsProperJSONRPC(request) || !request.isMember("id"))
+    return false;
+
+  std::string methodName = request["method"].asString();
+  StringUtils::ToLower(methodName);
+
+  return StreamableMethods.find(methodName) != StreamableMethods.end();
+}
+
+bool CJSONRPC::StreamMethodCall(const CVariant &request, ITransportLayer *transport, IClient *client, CJSONStreamWriter &writer)
+{
+  CJSONRPCResultStream stream(writer, request["id"]);
+  CVariant response;
+
+  bool hasResponse = HandleMethodCall(request, response, transport, client, &stream);
+  if (stream.m_started)
+    return stream.Finish(response);
+
+  if (hasResponse && !writer.Write(response))
+    return false;
+
+  return writer.Flush();
+}
+
+bool CJSONRPC::HandleMethodCall(const CVariant& request, CVariant& response, ITransportLayer *transport, IClient *client, CJSONRPCResultStream *stream /* = nullptr */)
 {
   JSONRPC_STATUS errorCode = OK;
   CVariant result;
@@ -287,7 +397,17 @@ bool CJSONRPC::HandleMethodCall(const CVariant& request, CVariant& response, ITr
     CVariant params;
 
     if ((errorCode = CJSONServiceDescription::CheckCall(methodName.c_str(), request["params"], transport, client, isNotification, method, params)) == OK)
+    {
+      // notifications don't have a response to stream
+      if (stream != nullptr && !isNotification)
+      {
+        stream->m_result = &result;
+        currentStream = stream;
+      }
+
       errorCode = method(methodName, transport, client, params, result);
+      currentStream = nullptr;
+    }
     else
       result = params;
   }
@@ -300,7 +420,7 @@ bool CJSONRPC::HandleMethodCall(const CVariant& request, CVariant& response, ITr
     errorCode = InvalidRequest;
   }
 
-  BuildResponse(request, errorCode, result, response);
+  BuildResponse(request, errorCode, std::move(result), response);
 
   return !isNotification;
 }
@@ -310,7 +430,7 @@ inline bool CJSONRPC::IsProperJSONRPC(const CVariant& inputroot)
   return inputroot.isMember("jsonrpc") && inputroot["jsonrpc"].isString() && inputroot["jsonrpc"] == CVariant("2.0") && inputroot.isMember("method") && inputroot["method"].isString() && (!inputroot.isMember("params") || inputroot["params"].isArray() || inputroot["params"].isObject());
 }
 
-inline void CJSONRPC::BuildResponse(const CVariant& request, JSONRPC_STATUS code, const CVariant& result, CVariant& response)
+inline void CJSONRPC::BuildResponse(const CVariant& request, JSONRPC_STATUS code, CVariant&& result, CVariant& response)
 {
   response["jsonrpc"] = "2.0";
   response["id"] = request.isMember("id") ? request["id"] : CVariant();
@@ -318,7 +438,7 @@ inline void CJSONRPC::BuildResponse(const CVariant& request, JSONRPC_STATUS code
   switch (code)
   {
     case OK:
-      response["result"] = result;
+      response["result"] = std::move(result);
       break;
     case ACK:
       response["result"] = "OK";
@@ -331,7 +451,7 @@ inline void CJSONRPC::BuildResponse(const CVariant& request, JSONRPC_STATUS code
       response["error"]["code"] = InvalidParams;
       response["error"]["message"] = "Invalid params.";
       if (!result.isNull())
-        response["error"]["data"] = result;
+        response["error"]["data"] = std::move(result);
       break;
     case MethodNotFound:
       response["error"]["code"] = MethodNotFound;
@@ -16,10 +16,59 @@
 #include "JSONRPCUtils.h"
 #include "JSONServiceDescription.h"
 
+class CJSONStreamWriter;
 class CVariant;
 
 namespace JSONRPC
 {
+  /*!
+   \ingroup jsonrpc
+   \brief Writes the items of a list result directly to a streamed response
+
+   Only available while a method called through CJSONRPC::StreamMethodCall()
+   is being executed. Once a list has been started the response envelope has
+   already been sent, so the method must not touch the list in its result
+   afterwards. Any other members of the result are written after the list.
+   If the method fails after the list has been started, the response is
+   aborted instead of being completed.
+   */
+  class CJSONRPCResultStream
+  {
+  public:
+    /*!
+     \brief Get the stream of the method executed on the calling thread
+     \param result Result object the caller is about to fill
+     \return The stream or nullptr if result isn't the top-level result of a
+     streamed method call
+     */
+    static CJSONRPCResultStream* Get(const CVariant &result);
+
+    /*!
+     \brief Starts writing the response with the given list
+     \return False if a list has already been started
+     */
+    bool StartList(const std::string &name);
+
+    /*!
+     \brief Writes an item of the started list
+     \return False if the response can't be written anymore
+     */
+    bool AddItem(const CVariant &item);
+
+  private:
+    friend class CJSONRPC;
+
+    CJSONRPCResultStream(CJSONStreamWriter &writer, const CVariant &id);
+
+    bool Finish(const CVariant &response);
+
+    CJSONStreamWriter &m_writer;
+    const CVariant &m_id;
+    const CVariant *m_result = nullptr;
+    std::string m_list;
+    bool m_started = false;
+  };
+
   /*!
    \ingroup jsonrpc
    \brief JSON RPC handler
@@ -53,6 +102,27 @@ namespace JSONRPC
      */
     static std::string MethodCall(const std::string &inputString, ITransportLayer *transport, IClient *client);
 
+    /*!
+     \brief Checks whether the response to a request is worth streaming
+     \param request parsed JSON-RPC request
+     \return True for single requests of methods returning large lists
+     */
+    static bool CanStreamMethodCall(const CVariant &request);
+
+    /*!
+     \brief Handles a single JSON-RPC request and writes the response as it is produced
+     \param request parsed JSON-RPC request
+     \param transport Transport protocol on which the request arrived
+     \param client Client which sent the request
+     \param writer Writer receiving the JSON-RPC response
+     \return False if the response couldn't be written completely
+
+     Methods returning lists write their items to the response as soon as
+     they are ready (see CJSONRPCResultStream), other responses are written
+     once the method has finished.
+     */
+    static bool StreamMethodCall(const CVariant &request, ITransportLayer *transport, IClient *client, CJSONStreamWriter &writer);
+
     static JSONRPC_STATUS Introspect(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result);
     static JSONRPC_STATUS Version(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result);
     static JSONRPC_STATUS Permission(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result);
@@ -62,10 +132,10 @@ namespace JSONRPC
     static JSONRPC_STATUS NotifyAll(const std::string &method, ITransportLayer *transport, IClient *client, const CVariant& parameterObject, CVariant &result);
 
   private:
-    static bool HandleMethodCall(const CVariant& request, CVariant& response, ITransportLayer *transport, IClient *client);
+    static bool HandleMethodCall(const CVariant& request, CVariant& response, ITransportLayer *transport, IClient *client, CJSONRPCResultStream *stream = nullptr);
     static inline bool IsProperJSONRPC(const CVariant& inputroot);
 
-    inline static void BuildResponse(const CVariant& request, JSONRPC_STATUS code, const CVariant& result, CVariant& response);
+    inline static void BuildResponse(const CVariant& request, JSONRPC_STATUS code, CVariant&& result, CVariant& response);
 
     static bool m_initialized;
   };
@@ -331,6 +331,10 @@ int CWebServer::HandleRequest(const std::shared_ptr<IHTTPRequestHandler>& handle
       ret = CreateFileDownloadResponse(handler, response);
       break;
 
+    case HTTPStreamDownload:
+      ret = CreateStreamDownloadResponse(handler, response);
+      break;
+
     case HTTPMemoryDownloadNoFreeNoCopy:
     case HTTPMemoryDownloadNoFreeCopy:
     case HTTPMemoryDownloadFreeNoCopy:
@@ -858,6 +862,44 @@ int CWebServer::CreateFileDownloadResponse(const std::shared_ptr<IHTTPRequestHan
   return MHD_YES;
 }
 
+int CWebServer::CreateStreamDownloadResponse(const std::shared_ptr<IHTTPRequestHandler>& handler, struct MHD_Response *&response) const
+{
+  if (handler == nullptr)
+    return MHD_NO;
+
+  const HTTPRequest &request = handler->GetRequest();
+
+  if (request.method == HEAD)
+  {
+    response = create_response(0, nullptr, MHD_NO, MHD_NO);
+    if (response == nullptr)
+    {
+      CLog::Log(LOGERROR, "CWebServer[%hu]: failed to create a HTTP HEAD response for %s", m_port, request.pathUrl.c_str());
+      return MHD_NO;
+    }
+
+    return MHD_YES;
+  }
+
+  // the handler has to stay alive until mhd has read the whole response
+  std::unique_ptr<std::shared_ptr<IHTTPRequestHandler>> context(new std::shared_ptr<IHTTPRequestHandler>(handler));
+
+  // without a known length mhd uses chunked transfer encoding
+  response = MHD_create_response_from_callback(MHD_SIZE_UNKNOWN, 32 * 1024,
+                                                &CWebServer::StreamReaderCallback,
+                                                context.get(),
+                                                &CWebServer::StreamReaderFreeCallback);
+  if (response == nullptr)
+  {
+    CLog::Log(LOGERROR, "CWebServer[%hu]: failed to create a HTTP stream response for %s", m_port, request.pathUrl.c_str());
+    return MHD_NO;
+  }
+
+  context.release(); // ownership was passed to mhd
+
+  return MHD_YES;
+}
+
 int CWebServer::CreateErrorResponse(struct MHD_Connection *connection, int responseType, HTTPMethod method, struct MHD_Response *&response) const
 {
   size_t payloadSize = 0;
@@ -1042,6 +1084,30 @@ void CWebServer::ContentReaderFreeCallback(void *cls)
   CLog::Log(LOGDEBUG, LOGWEBSERVER, "CWebServer [OUT] done");
 }
 
+ssize_t CWebServer::StreamReaderCallback(void *cls, uint64_t pos, char *buf, size_t max)
+{
+  std::shared_ptr<IHTTPRequestHandler> *handler = static_cast<std::shared_ptr<IHTTPRequestHandler>*>(cls);
+  if (handler == nullptr || *handler == nullptr)
+    return MHD_CONTENT_READER_END_WITH_ERROR;
+
+  ssize_t read = (*handler)->ReadResponseStream(buf, max);
+  if (read < 0)
+    return MHD_CONTENT_READER_END_WITH_ERROR;
+  if (read == 0)
+    return MHD_CONTENT_READER_END_OF_STREAM;
+
+  CLog::Log(LOGDEBUG, LOGWEBSERVER, "CWebServer [OUT] streamed %zd bytes from %" PRIu64, read, pos);
+
+  return read;
+}
+
+void CWebServer::StreamReaderFreeCallback(void *cls)
+{
+  delete static_cast<std::shared_ptr<IHTTPRequestHandler>*>(cls);
+
+  CLog::Log(LOGDEBUG, LOGWEBSERVER, "CWebServer [OUT] stream done");
+}
+
 // local helper
 static void panicHandlerForMHD(void* unused, const char* file, unsigned int line, const char *reason)
 {
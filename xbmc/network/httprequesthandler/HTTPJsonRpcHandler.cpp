@@ -7,6 +7,7 @@
  */
 
 #include "HTTPJsonRpcHandler.h"
+#include "ServiceBroker.h"
 #include "URL.h"
 #include "filesystem/File.h"
 #include "interfaces/json-rpc/JSONRPC.h"
@@ -14,12 +15,38 @@
 #include "interfaces/json-rpc/JSONUtils.h"
 #include "network/WebServer.h"
 #include "network/httprequesthandler/HTTPRequestHandlerUtils.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/SettingsComponent.h"
+#include "threads/SingleLock.h"
+#include "threads/Thread.h"
+#include "utils/JSONVariantParser.h"
 #include "utils/JSONVariantWriter.h"
 #include "utils/log.h"
 #include "utils/Variant.h"
 
+#include <algorithm>
+#include <string.h>
+
 #define MAX_HTTP_POST_SIZE 65536
 
+// amount of a streamed response produced ahead of the client
+#define STREAM_PAGE_SIZE (64 * 1024)
+
+CHTTPJsonRpcHandler::~CHTTPJsonRpcHandler()
+{
+  if (m_streamThread == nullptr)
+    return;
+
+  // unblock the producer if the client went away early
+  {
+    CSingleLock lock(m_streamSection);
+    m_streamAborted = true;
+  }
+  m_streamCondition.notifyAll();
+
+  m_streamThread->StopThread(true);
+}
+
 bool CHTTPJsonRpcHandler::CanHandleRequest(const HTTPRequest &request) const
 {
   return (request.pathUrl.compare("/jsonrpc") == 0);
@@ -72,6 +99,22 @@ int CHTTPJsonRpcHandler::HandleRequest()
 
   if (isRequest)
   {
+    // large lists are sent while they are being produced
+    CVariant request;
+    if (CJSONVariantParser::Parse(m_requestData, request) &&
+        JSONRPC::CJSONRPC::CanStreamMethodCall(request) &&
+        StartStream(request, jsonpCallback))
+    {
+      m_requestData.clear();
+
+      m_response.type = HTTPStreamDownload;
+      m_response.status = MHD_HTTP_OK;
+      m_response.contentType = "application/json";
+      m_response.totalLength = 0;
+
+      return MHD_YES;
+    }
+
     m_responseData = JSONRPC::CJSONRPC::MethodCall(m_requestData, &m_transportLayer, &client);
 
     if (!jsonpCallback.empty())
@@ -118,6 +161,82 @@ HttpResponseRanges CHTTPJsonRpcHandler::GetResponseData() const
   return ranges;
 }
 
+ssize_t CHTTPJsonRpcHandler::ReadResponseStream(char *buffer, size_t size)
+{
+  CSingleLock lock(m_streamSection);
+  while (m_streamPosition >= m_streamBuffer.size() && !m_streamDone)
+    m_streamCondition.wait(lock);
+
+  if (m_streamPosition >= m_streamBuffer.size())
+    return m_streamFailed ? -1 : 0;
+
+  size = std::min(size, m_streamBuffer.size() - m_streamPosition);
+  memcpy(buffer, m_streamBuffer.c_str() + m_streamPosition, size);
+  m_streamPosition += size;
+
+  if (m_streamPosition >= m_streamBuffer.size())
+  {
+    m_streamBuffer.clear();
+    m_streamPosition = 0;
+    m_streamCondition.notifyAll();
+  }
+
+  return static_cast<ssize_t>(size);
+}
+
+bool CHTTPJsonRpcHandler::StartStream(const CVariant &request, const std::string &jsonpCallback)
+{
+  m_streamRequest = request;
+  m_streamJsonpCallback = jsonpCallback;
+  m_streamClient.reset(new CHTTPClient(m_request.method));
+
+  m_streamThread.reset(new CThread(this, "JSONRPCStream"));
+  m_streamThread->Create();
+
+  return true;
+}
+
+void CHTTPJsonRpcHandler::Run()
+{
+  CJSONStreamWriter writer([this](const char *data, size_t size) { return WriteResponseStream(data, size); },
+                           CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_jsonOutputCompact,
+                           STREAM_PAGE_SIZE);
+
+  bool success = true;
+  if (!m_streamJsonpCallback.empty())
+    success = writer.WriteRaw(m_streamJsonpCallback + "(");
+
+  success = success && JSONRPC::CJSONRPC::StreamMethodCall(m_streamRequest, &m_transportLayer, m_streamClient.get(), writer);
+
+  if (!m_streamJsonpCallback.empty())
+    success = success && writer.WriteRaw(");") && writer.Flush();
+
+  if (!success)
+    CLog::Log(LOGDEBUG, LOGJSONRPC, "JSONRPC: Streamed response for %s was not completed", m_streamRequest["method"].asString().c_str());
+
+  CSingleLock lock(m_streamSection);
+  m_streamDone = true;
+  m_streamFailed = !success;
+  m_streamCondition.notifyAll();
+}
+
+bool CHTTPJsonRpcHandler::WriteResponseStream(const char *data, size_t size)
+{
+  CSingleLock lock(m_streamSection);
+
+  // keep at most one page ahead of the client
+  while (!m_streamAborted && m_streamBuffer.size() - m_streamPosition >= STREAM_PAGE_SIZE)
+    m_streamCondition.wait(lock);
+
+  if (m_streamAborted)
+    return false;
+
+  m_streamBuffer.append(data, size);
+  m_streamCondition.notifyAll();
+
+  return true;
+}
+
 bool CHTTPJsonRpcHandler::appendPostData(const char *data, size_t size)
 {
   if (m_requestData.size() + size > MAX_HTTP_POST_SIZE)
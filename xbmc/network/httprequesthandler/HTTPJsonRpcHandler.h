@@ -8,17 +8,24 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 
 #include "interfaces/json-rpc/IClient.h"
 #include "interfaces/json-rpc/ITransportLayer.h"
 #include "network/httprequesthandler/IHTTPRequestHandler.h"
+#include "threads/Condition.h"
+#include "threads/CriticalSection.h"
+#include "threads/IRunnable.h"
+#include "utils/Variant.h"
 
-class CHTTPJsonRpcHandler : public IHTTPRequestHandler
+class CThread;
+
+class CHTTPJsonRpcHandler : public IHTTPRequestHandler, private IRunnable
 {
 public:
   CHTTPJsonRpcHandler() = default;
-  ~CHTTPJsonRpcHandler() override = default;
+  ~CHTTPJsonRpcHandler() override;
 
   // implementations of IHTTPRequestHandler
   IHTTPRequestHandler* Create(const HTTPRequest &request) const override { return new CHTTPJsonRpcHandler(request); }
@@ -27,6 +34,7 @@ public:
   int HandleRequest() override;
 
   HttpResponseRanges GetResponseData() const override;
+  ssize_t ReadResponseStream(char *buffer, size_t size) override;
 
   int GetPriority() const override { return 5; }
 
@@ -38,10 +46,30 @@ protected:
   bool appendPostData(const char *data, size_t size) override;
 
 private:
+  // implementation of IRunnable, produces a streamed response
+  void Run() override;
+
+  bool StartStream(const CVariant &request, const std::string &jsonpCallback);
+  bool WriteResponseStream(const char *data, size_t size);
+
   std::string m_requestData;
   std::string m_responseData;
   CHttpResponseRange m_responseRange;
 
+  // streamed responses are produced on a separate thread while the
+  // connection's thread sends them, see ReadResponseStream()
+  CVariant m_streamRequest;
+  std::string m_streamJsonpCallback;
+  std::unique_ptr<JSONRPC::IClient> m_streamClient;
+  std::unique_ptr<CThread> m_streamThread;
+  CCriticalSection m_streamSection;
+  XbmcThreads::ConditionVariable m_streamCondition;
+  std::string m_streamBuffer;
+  size_t m_streamPosition = 0;
+  bool m_streamDone = false;
+  bool m_streamFailed = false;
+  bool m_streamAborted = false;
+
   class CHTTPTransportLayer : public JSONRPC::ITransportLayer
   {
   public:
@@ -54,7 +54,10 @@ typedef enum HTTPResponseType
   HTTPMemoryDownloadFreeNoCopy,
   // creates a HTTP response from a buffer by copying followed by freeing the buffer
   // the buffer must have been malloc'ed and not new'ed
-  HTTPMemoryDownloadFreeCopy
+  HTTPMemoryDownloadFreeCopy,
+  // creates a HTTP response of unknown length which is read piece by piece
+  // from the request handler and sent using chunked transfer encoding
+  HTTPStreamDownload
 } HTTPResponseType;
 
 typedef struct HTTPRequest
@@ -161,6 +164,19 @@ public:
   */
   virtual std::string GetResponseFile() const { return ""; }
 
+  /*!
+  * \brief Reads the next part of the response.
+  *
+  * \details This is only used if the response type is HTTPStreamDownload. It is
+  * called from the connection's thread and may block until data is available.
+  *
+  * \param buffer Buffer to fill
+  * \param size Size of the buffer
+  * \return Number of bytes written to the buffer, 0 at the end of the response
+  * or -1 on error.
+  */
+  virtual ssize_t ReadResponseStream(char *buffer, size_t size) { return -1; }
+
   /*!
   * \brief Returns the HTTP request handled by the HTTP request handler.
   */
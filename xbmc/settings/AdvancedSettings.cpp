@@ -393,6 +393,8 @@ void CAdvancedSettings::Initialize()
   // the following setting determines the readRate of a player data
   // as multiply of the default data read rate
   m_cacheReadFactor = 4.0f;
+  m_cacheLockFree = false;
+  m_cachePersistentSize = 0;
 
   m_addonPackageFolderSize = 200;
 
@@ -405,6 +407,9 @@ void CAdvancedSettings::Initialize()
   m_guiVisualizeDirtyRegions = false;
   m_guiAlgorithmDirtyRegions = 3;
   m_guiSmartRedraw = false;
+  m_guiTextureCacheSize = 0;
+  m_guiSkinCache = true;
+  m_guiFontCache = false;
   m_airTunesPort = 36666;
   m_airPlayPort = 36667;
 
@@ -843,6 +848,8 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetUInt(pElement, "memorysize", m_cacheMemSize);
     XMLUtils::GetUInt(pElement, "buffermode", m_cacheBufferMode, 0, 4);
     XMLUtils::GetFloat(pElement, "readfactor", m_cacheReadFactor);
+    XMLUtils::GetBoolean(pElement, "lockfree", m_cacheLockFree);
+    XMLUtils::GetUInt(pElement, "persistentsize", m_cachePersistentSize);
   }
 
   pElement = pRootElement->FirstChildElement("jsonrpc");
@@ -1221,6 +1228,9 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetBoolean(pElement, "visualizedirtyregions", m_guiVisualizeDirtyRegions);
     XMLUtils::GetInt(pElement, "algorithmdirtyregions",     m_guiAlgorithmDirtyRegions);
     XMLUtils::GetBoolean(pElement, "smartredraw", m_guiSmartRedraw);
+    XMLUtils::GetUInt(pElement, "texturecachesize", m_guiTextureCacheSize);
+    XMLUtils::GetBoolean(pElement, "skincache", m_guiSkinCache);
+    XMLUtils::GetBoolean(pElement, "fontcache", m_guiFontCache);
   }
 
   std::string seekSteps;
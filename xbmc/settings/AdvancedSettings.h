@@ -342,11 +342,16 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     bool m_guiVisualizeDirtyRegions;
     int  m_guiAlgorithmDirtyRegions;
     bool m_guiSmartRedraw;
+    uint32_t m_guiTextureCacheSize; ///< MB of texture memory in which released skin textures are kept for reuse
+    bool m_guiSkinCache; ///< cache the prepared window XML of the skin on disk, see CGUISkinCache
+    bool m_guiFontCache; ///< keep the rasterized glyphs of each font on disk between runs
     unsigned int m_addonPackageFolderSize;
 
     unsigned int m_cacheMemSize;
     unsigned int m_cacheBufferMode;
     float m_cacheReadFactor;
+    bool m_cacheLockFree; ///< \brief use the lock-free ring buffer for the memory cache
+    unsigned int m_cachePersistentSize; ///< \brief budget in MB for keeping read data on disk between opens, 0 to disable
 
     bool m_jsonOutputCompact;
     unsigned int m_jsonTcpPort;
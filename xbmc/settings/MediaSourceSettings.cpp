@@ -411,6 +411,7 @@ bool CMediaSourceSettings::GetSource(const std::string &category, const TiXmlNod
     share.m_strThumbnailImage = pThumbnailNode->FirstChild()->Value();
 
   XMLUtils::GetBoolean(source, "allowsharing", share.m_allowSharing);
+  XMLUtils::GetInt(source, "scanconcurrency", share.m_scanConcurrency, 1, 16);
 
   return true;
 }
@@ -487,6 +488,9 @@ bool CMediaSourceSettings::SetSources(TiXmlNode *root, const char *section, cons
 
     XMLUtils::SetBoolean(&source, "allowsharing", share.m_allowSharing);
 
+    if (share.m_scanConcurrency > 0)
+      XMLUtils::SetInt(&source, "scanconcurrency", share.m_scanConcurrency);
+
     sectionNode->InsertEndChild(source);
   }
 
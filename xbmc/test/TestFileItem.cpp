@@ -131,3 +131,96 @@ const TestFileData BaseMovies[] = {{ "c:\\dir\\filename.avi", false, "c:\\dir\\f
                                    { "/home/user/movies/movie_name/BDMV/index.bdmv", true, "/home/user/movies/movie_name/" }};
 
 INSTANTIATE_TEST_CASE_P(BaseNameMovies, TestFileItemBasePath, ValuesIn(BaseMovies));
+
+TEST(TestFileItem, Properties)
+{
+  CFileItem item;
+  EXPECT_FALSE(item.HasProperties());
+  EXPECT_TRUE(item.GetProperty("foo").isNull());
+
+  item.SetProperty("Foo", "bar");
+  item.SetProperty("count", 1);
+  EXPECT_TRUE(item.HasProperties());
+  EXPECT_TRUE(item.HasProperty("foo"));
+  EXPECT_TRUE(item.HasProperty("FOO"));
+  EXPECT_EQ("bar", item.GetProperty("fOo").asString());
+
+  item.IncrementProperty("count", 2);
+  EXPECT_EQ(3, item.GetProperty("count").asInteger());
+
+  item.ClearProperty("FOO");
+  EXPECT_FALSE(item.HasProperty("foo"));
+  EXPECT_TRUE(item.HasProperty("count"));
+
+  item.ClearProperties();
+  EXPECT_FALSE(item.HasProperties());
+}
+
+TEST(TestFileItem, CopiesAreIndependent)
+{
+  CFileItem item("label");
+  item.SetProperty("foo", "bar");
+  item.SetArt("thumb", "thumb.jpg");
+  item.SetArtFallback("poster", "thumb");
+
+  CFileItem copy(item);
+  EXPECT_EQ("bar", copy.GetProperty("foo").asString());
+  EXPECT_EQ("thumb.jpg", copy.GetArt("poster"));
+
+  copy.SetProperty("foo", "baz");
+  copy.SetArt("thumb", "other.jpg");
+  copy.AppendArt({{"fanart", "fanart.jpg"}});
+  EXPECT_EQ("bar", item.GetProperty("foo").asString());
+  EXPECT_EQ("thumb.jpg", item.GetArt("thumb"));
+  EXPECT_FALSE(item.HasArt("fanart"));
+  EXPECT_EQ("baz", copy.GetProperty("foo").asString());
+  EXPECT_EQ("other.jpg", copy.GetArt("poster"));
+
+  item.ClearArt();
+  item.ClearProperties();
+  EXPECT_TRUE(item.GetArt().empty());
+  EXPECT_EQ("other.jpg", copy.GetArt("thumb"));
+  EXPECT_TRUE(copy.HasProperty("foo"));
+}
+
+TEST(TestFileItem, PropertyNameCase)
+{
+  CGUIListItem item1, item2;
+  item1.SetProperty("MyKey", "one");
+  item2.SetProperty("mykey", "two");
+  EXPECT_EQ("two", item2.GetProperty("MYKEY").asString());
+
+  // setting the property again keeps the spelling it was first set with
+  item1.SetProperty("MYKEY", "three");
+
+  CVariant value1, value2;
+  item1.Serialize(value1);
+  item2.Serialize(value2);
+  EXPECT_TRUE(value1["properties"].isMember("MyKey"));
+  EXPECT_FALSE(value1["properties"].isMember("MYKEY"));
+  EXPECT_EQ("three", value1["properties"]["MyKey"].asString());
+  EXPECT_TRUE(value2["properties"].isMember("mykey"));
+  EXPECT_FALSE(value2["properties"].isMember("MyKey"));
+}
+
+TEST(TestFileItem, PropertyNamesAreReleased)
+{
+  {
+    CFileItem item;
+    item.SetProperty("TestFileItemReleasedName", true);
+    EXPECT_TRUE(CGUIListItemProperties::Find("TestFileItemReleasedName") != nullptr);
+  }
+  EXPECT_TRUE(CGUIListItemProperties::Find("TestFileItemReleasedName") == nullptr);
+}
+
+TEST(TestFileItem, PropertyValueOutlivesChanges)
+{
+  CGUIListItem item;
+  item.SetProperty("first", "value");
+  const CVariant value = item.GetProperty("first");
+  for (int i = 0; i < 32; ++i)
+    item.SetProperty("key" + std::to_string(i), i);
+  item.ClearProperty("first");
+  EXPECT_EQ("value", value.asString());
+  EXPECT_TRUE(item.GetProperty("first").isNull());
+}
@@ -0,0 +1,63 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "GUIInfoManager.h"
+#include "guilib/guiinfo/GUIInfoLabels.h"
+#include "interfaces/info/InfoBool.h"
+
+#include "gtest/gtest.h"
+
+using namespace INFO;
+
+class TestGUIInfoManager : public testing::Test
+{
+protected:
+  unsigned int GetDependencies(const std::string& condition)
+  {
+    return m_infoManager.GetDependencies(m_infoManager.TranslateString(condition));
+  }
+
+  CGUIInfoManager m_infoManager;
+};
+
+TEST_F(TestGUIInfoManager, GetDependencies)
+{
+  EXPECT_EQ(DEPENDS_NONE, GetDependencies("true"));
+  EXPECT_EQ(DEPENDS_NONE, GetDependencies("false"));
+
+  EXPECT_EQ(DEPENDS_PLAYER, GetDependencies("player.hasvideo"));
+  EXPECT_EQ(DEPENDS_PLAYER, GetDependencies("videoplayer.title"));
+  EXPECT_EQ(DEPENDS_PLAYER, GetDependencies("musicplayer.title"));
+
+  EXPECT_EQ(DEPENDS_LIBRARY, GetDependencies("library.hascontent(music)"));
+
+  EXPECT_EQ(DEPENDS_LISTITEM, GetDependencies("listitem.label"));
+  EXPECT_EQ(DEPENDS_LISTITEM, GetDependencies("container.numitems"));
+
+  // player state that also changes while nothing is playing
+  EXPECT_EQ(DEPENDS_SYSTEM, GetDependencies("player.volume"));
+  EXPECT_EQ(DEPENDS_SYSTEM, GetDependencies("player.muted"));
+
+  EXPECT_EQ(DEPENDS_SYSTEM, GetDependencies("system.hasnetwork"));
+}
+
+TEST_F(TestGUIInfoManager, GetDependenciesOfMultiInfo)
+{
+  // resolved through the info the parameterized condition is based on
+  EXPECT_EQ(DEPENDS_LISTITEM, GetDependencies("listitem.property(foo)"));
+  EXPECT_EQ(DEPENDS_LISTITEM, GetDependencies("container(50).numitems"));
+
+  // unknown multi infos may depend on anything
+  EXPECT_EQ(DEPENDS_ALL, m_infoManager.GetDependencies(MULTI_INFO_END));
+}
+
+TEST_F(TestGUIInfoManager, GetDependenciesOfInverted)
+{
+  EXPECT_EQ(DEPENDS_PLAYER, m_infoManager.GetDependencies(-PLAYER_HAS_VIDEO));
+  EXPECT_EQ(DEPENDS_LISTITEM, m_infoManager.GetDependencies(-m_infoManager.TranslateString("listitem.property(foo)")));
+}
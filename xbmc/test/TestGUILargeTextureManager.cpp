@@ -0,0 +1,246 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "GUILargeTextureManager.h"
+#include "ServiceBroker.h"
+#include "guilib/Texture.h"
+#include "threads/Event.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "windowing/WinSystem.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#ifdef TARGET_POSIX
+#include "platform/linux/XTimeUtils.h"
+#endif
+
+namespace
+{
+
+//! 16 MiB of pixels, a quarter of the prefetch memory limit
+const unsigned int TEXTURE_SIZE = 2048;
+
+class CTestTexture : public CBaseTexture
+{
+public:
+  CTestTexture() : CBaseTexture(TEXTURE_SIZE, TEXTURE_SIZE) {}
+
+  void CreateTextureObject() override {}
+  void DestroyTextureObject() override {}
+  void LoadToGPU() override {}
+  void BindToUnit(unsigned int unit) override {}
+};
+
+//! provides the graphics context textures are freed under
+class CTestWinSystem : public CWinSystemBase
+{
+public:
+  bool CreateNewWindow(const std::string& name, bool fullScreen, RESOLUTION_INFO& res) override { return false; }
+  bool ResizeWindow(int newWidth, int newHeight, int newLeft, int newTop) override { return false; }
+  bool SetFullScreen(bool fullScreen, RESOLUTION_INFO& res, bool blankOtherDisplays) override { return false; }
+  void Register(IDispResource* resource) override {}
+  void Unregister(IDispResource* resource) override {}
+};
+
+//! loads a blank texture once released
+class CTestImageLoader : public CImageLoader
+{
+public:
+  CTestImageLoader(const std::string& path, std::shared_ptr<CEvent> release)
+    : CImageLoader(path, false), m_release(std::move(release))
+  {
+  }
+
+  bool DoWork() override
+  {
+    m_release->WaitMSec(10000);
+    m_texture = new CTestTexture;
+    return true;
+  }
+
+private:
+  std::shared_ptr<CEvent> m_release;
+};
+
+class CTestLargeTextureManager : public CGUILargeTextureManager
+{
+public:
+  ~CTestLargeTextureManager() override
+  {
+    // no job may call back into the manager once it's gone
+    m_release->Set();
+    WaitForLoads();
+    CleanupUnusedImages(true);
+  }
+
+  bool IsQueued(const std::string& path)
+  {
+    CSingleLock lock(m_listSection);
+    return std::find_if(m_queued.begin(), m_queued.end(), [&path](const std::pair<unsigned int, CLargeTexture*>& queued) {
+      return queued.second->GetPath() == path;
+    }) != m_queued.end();
+  }
+
+  bool IsLoaded(const std::string& path)
+  {
+    CSingleLock lock(m_listSection);
+    return std::find_if(m_allocated.begin(), m_allocated.end(), [&path](const CLargeTexture* image) {
+      return image->GetPath() == path;
+    }) != m_allocated.end();
+  }
+
+  size_t GetLoadedCount()
+  {
+    CSingleLock lock(m_listSection);
+    return m_allocated.size();
+  }
+
+  bool WaitForLoads()
+  {
+    unsigned int start = XbmcThreads::SystemClockMillis();
+    while (XbmcThreads::SystemClockMillis() - start < 10000)
+    {
+      {
+        CSingleLock lock(m_listSection);
+        if (m_queued.empty())
+          return true;
+      }
+      Sleep(10);
+    }
+    return false;
+  }
+
+  std::shared_ptr<CEvent> m_release = std::make_shared<CEvent>(true);
+  std::vector<std::string> m_loads; ///< paths loaders were created for
+
+protected:
+  CImageLoader* CreateLoader(const std::string& path, bool useCache) override
+  {
+    m_loads.push_back(path);
+    return new CTestImageLoader(path, m_release);
+  }
+};
+
+} // unnamed namespace
+
+class TestGUILargeTextureManager : public testing::Test
+{
+protected:
+  TestGUILargeTextureManager()
+  {
+    CServiceBroker::RegisterWinSystem(&m_winSystem);
+  }
+
+  ~TestGUILargeTextureManager() override
+  {
+    CServiceBroker::UnregisterWinSystem();
+  }
+
+  CTestWinSystem m_winSystem;
+  const int m_owner = 0;
+  const int m_otherOwner = 0;
+};
+
+TEST_F(TestGUILargeTextureManager, PrefetchedImagesAreReturnedAtOnce)
+{
+  CTestLargeTextureManager manager;
+  manager.m_release->Set();
+  manager.PrefetchImages(&m_owner, { "a.png", "b.png" });
+  ASSERT_TRUE(manager.WaitForLoads());
+
+  CTextureArray texture;
+  EXPECT_TRUE(manager.GetImage("a.png", texture, true));
+  EXPECT_EQ(1u, texture.size());
+  // served by the prefetch, not loaded again
+  EXPECT_EQ(2u, manager.m_loads.size());
+
+  manager.ReleaseImage("a.png", true);
+  EXPECT_FALSE(manager.IsLoaded("a.png"));
+  EXPECT_TRUE(manager.IsLoaded("b.png"));
+}
+
+TEST_F(TestGUILargeTextureManager, PrefetchReplacesPreviousRequest)
+{
+  CTestLargeTextureManager manager;
+  manager.PrefetchImages(&m_owner, { "a.png", "b.png" });
+  manager.PrefetchImages(&m_otherOwner, { "x.png" });
+
+  // e.g. the scroll direction changed
+  manager.PrefetchImages(&m_owner, { "b.png", "c.png" });
+  EXPECT_FALSE(manager.IsQueued("a.png"));
+  EXPECT_TRUE(manager.IsQueued("b.png"));
+  EXPECT_TRUE(manager.IsQueued("c.png"));
+  EXPECT_TRUE(manager.IsQueued("x.png"));
+  EXPECT_EQ(4u, manager.m_loads.size());
+
+  manager.m_release->Set();
+  ASSERT_TRUE(manager.WaitForLoads());
+  EXPECT_FALSE(manager.IsLoaded("a.png"));
+  EXPECT_EQ(3u, manager.GetLoadedCount());
+}
+
+TEST_F(TestGUILargeTextureManager, CancelPrefetch)
+{
+  CTestLargeTextureManager manager;
+  manager.PrefetchImages(&m_owner, { "a.png", "b.png" });
+  manager.PrefetchImages(&m_otherOwner, { "x.png" });
+
+  CTextureArray texture;
+  manager.GetImage("b.png", texture, true);
+
+  // images requested meanwhile are loaded regardless
+  manager.CancelPrefetch(&m_owner);
+  EXPECT_FALSE(manager.IsQueued("a.png"));
+  EXPECT_TRUE(manager.IsQueued("b.png"));
+  EXPECT_TRUE(manager.IsQueued("x.png"));
+
+  manager.m_release->Set();
+  ASSERT_TRUE(manager.WaitForLoads());
+  EXPECT_FALSE(manager.IsLoaded("a.png"));
+  EXPECT_TRUE(manager.IsLoaded("b.png"));
+  EXPECT_TRUE(manager.IsLoaded("x.png"));
+  manager.ReleaseImage("b.png", true);
+}
+
+TEST_F(TestGUILargeTextureManager, MemoryLimit)
+{
+  CTestLargeTextureManager manager;
+  manager.m_release->Set();
+  manager.PrefetchImages(&m_owner, { "a.png", "b.png", "c.png", "d.png", "e.png", "f.png" });
+  ASSERT_TRUE(manager.WaitForLoads());
+  EXPECT_EQ(6u, manager.GetLoadedCount());
+
+  // unused textures beyond the limit are dropped
+  manager.CleanupUnusedImages();
+  EXPECT_EQ(4u, manager.GetLoadedCount());
+
+  // and no more are prefetched while at the limit
+  manager.PrefetchImages(&m_owner, { "g.png" });
+  EXPECT_FALSE(manager.IsQueued("g.png"));
+  EXPECT_EQ(6u, manager.m_loads.size());
+
+  // textures in use don't count towards the limit
+  CTextureArray texture;
+  std::vector<std::string> used;
+  for (const char* path : { "a.png", "b.png", "c.png", "d.png", "e.png", "f.png" })
+  {
+    if (manager.IsLoaded(path) && manager.GetImage(path, texture, true))
+      used.push_back(path);
+  }
+  EXPECT_EQ(4u, used.size());
+  manager.PrefetchImages(&m_owner, { "g.png" });
+  EXPECT_TRUE(manager.IsQueued("g.png"));
+  for (const auto& path : used)
+    manager.ReleaseImage(path, true);
+}
@@ -0,0 +1,90 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "TextureCacheIndex.h"
+
+#include "gtest/gtest.h"
+
+namespace
+{
+CTextureDetails MakeDetails(int id, const std::string &file)
+{
+  CTextureDetails details;
+  details.id = id;
+  details.file = file;
+  details.hash = "d1234-1234";
+  details.width = 320;
+  details.height = 240;
+  return details;
+}
+}
+
+TEST(TestTextureCacheIndex, SetGet)
+{
+  CTextureCacheIndex index;
+  index.Set("/path/to/image.jpg", MakeDetails(1, "a/a1234.jpg"), CDateTime());
+  EXPECT_EQ(1u, index.Size());
+
+  CTextureDetails details;
+  ASSERT_TRUE(index.Get("/path/to/image.jpg", details));
+  EXPECT_EQ(1, details.id);
+  EXPECT_EQ("a/a1234.jpg", details.file);
+  EXPECT_EQ(320u, details.width);
+  EXPECT_EQ(240u, details.height);
+
+  EXPECT_FALSE(index.Get("/path/to/other.jpg", details));
+}
+
+TEST(TestTextureCacheIndex, HashCheck)
+{
+  CTextureCacheIndex index;
+  CTextureDetails details;
+
+  // never checked for updates
+  index.Set("/path/to/image.jpg", MakeDetails(1, "a/a1234.jpg"), CDateTime());
+  ASSERT_TRUE(index.Get("/path/to/image.jpg", details));
+  EXPECT_TRUE(details.hash.empty());
+
+  // checked recently
+  index.SetLastHashCheck("/path/to/image.jpg", CDateTime::GetCurrentDateTime());
+  details = CTextureDetails();
+  ASSERT_TRUE(index.Get("/path/to/image.jpg", details));
+  EXPECT_TRUE(details.hash.empty());
+
+  // due to be checked
+  EXPECT_TRUE(index.SetLastHashCheck("/path/to/image.jpg", CDateTime::GetCurrentDateTime() - CDateTimeSpan(2, 0, 0, 0)));
+  details = CTextureDetails();
+  ASSERT_TRUE(index.Get("/path/to/image.jpg", details));
+  EXPECT_EQ("d1234-1234", details.hash);
+
+  EXPECT_FALSE(index.SetLastHashCheck("/path/to/other.jpg", CDateTime::GetCurrentDateTime()));
+}
+
+TEST(TestTextureCacheIndex, Erase)
+{
+  CTextureCacheIndex index;
+  index.Set("/path/to/image1.jpg", MakeDetails(1, "a/a1234.jpg"), CDateTime());
+  index.Set("/path/to/image2.jpg", MakeDetails(2, "b/b1234.jpg"), CDateTime());
+  index.Set("/path/to/image3.jpg", MakeDetails(3, "c/c1234.jpg"), CDateTime());
+  EXPECT_EQ(3u, index.Size());
+
+  CTextureDetails details;
+  EXPECT_TRUE(index.Erase("/path/to/image1.jpg"));
+  EXPECT_FALSE(index.Erase("/path/to/image1.jpg"));
+  EXPECT_FALSE(index.Get("/path/to/image1.jpg", details));
+
+  EXPECT_TRUE(index.Erase(2));
+  EXPECT_FALSE(index.Erase(2));
+  EXPECT_FALSE(index.Get("/path/to/image2.jpg", details));
+  EXPECT_TRUE(index.Get("/path/to/image3.jpg", details));
+  EXPECT_EQ(1u, index.Size());
+
+  index.Clear();
+  EXPECT_EQ(0u, index.Size());
+  EXPECT_FALSE(index.Get("/path/to/image3.jpg", details));
+}
@@ -0,0 +1,399 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+/*!
+ \file xbmc-demuxbench.cpp
+ \brief Headless demuxer throughput benchmark
+
+ Opens a file the same way CVideoPlayer does, through CDVDFactoryInputStream
+ and CDVDFactoryDemuxer, then reads every packet as fast as possible and passes
+ it through a CDVDMessageQueue, without decoding. Time is split into the layers
+ a packet goes through:
+
+   input    - CDVDInputStream::Read/Seek from the AVIO callbacks (CFile and file cache)
+   ffmpeg   - av_read_frame minus the time spent in the AVIO callbacks
+   demux    - CDVDDemuxFFmpeg::Read minus av_read_frame (packet conversion)
+   queue    - CDVDMessageQueue Put and Get
+
+ Heap allocations are counted through operator new, buffers allocated by FFmpeg
+ itself (av_malloc) are not included.
+
+ Without a file, --generate writes a Matroska file with a video and an audio
+ track of filler packets to special://temp/ first. Only the container is
+ exercised, the payload isn't decodable.
+
+ Usage: kodi-demuxbench [--iterations <n>] [--cache-mode <0-4>] [--generate <seconds>] [<file>]
+ */
+
+#include "TestBasicEnvironment.h"
+
+#include "FileItem.h"
+#include "ServiceBroker.h"
+#include "cores/VideoPlayer/DVDDemuxers/DVDDemuxFFmpeg.h"
+#include "cores/VideoPlayer/DVDDemuxers/DVDDemuxUtils.h"
+#include "cores/VideoPlayer/DVDDemuxers/DVDFactoryDemuxer.h"
+#include "cores/VideoPlayer/DVDDemuxers/DemuxPacketPool.h"
+#include "cores/VideoPlayer/DVDInputStreams/DVDFactoryInputStream.h"
+#include "cores/VideoPlayer/DVDInputStreams/DVDInputStream.h"
+#include "cores/VideoPlayer/DVDMessageQueue.h"
+#include "filesystem/SpecialProtocol.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/SettingsComponent.h"
+#include "utils/TimeUtils.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include "libavformat/avformat.h"
+}
+
+namespace
+{
+
+std::atomic<uint64_t> allocCount{0};
+
+struct Options
+{
+  std::string file;
+  unsigned int iterations = 1;
+  int cacheMode = -1;
+  unsigned int generateSeconds = 0;
+};
+
+struct RunStats
+{
+  uint64_t packets = 0;
+  uint64_t bytes = 0;
+  uint64_t allocs = 0;
+  int64_t openTicks = 0;
+  int64_t totalTicks = 0;
+  int64_t readTicks = 0; ///< in CDVDDemux::Read
+  int64_t queueTicks = 0;
+  DemuxIOStats io;
+  XFILE::SCacheStatus cache = {};
+  bool cached = false;
+};
+
+void Usage(const char* name)
+{
+  fprintf(stderr, "Usage: %s [--iterations <n>] [--cache-mode <0-4>] [--generate <seconds>] [<file>]\n", name);
+}
+
+bool ParseArgs(int argc, char** argv, Options& options)
+{
+  for (int i = 1; i < argc; i++)
+  {
+    std::string arg = argv[i];
+    if (arg == "--iterations" && i + 1 < argc)
+      options.iterations = std::max(1, atoi(argv[++i]));
+    else if (arg == "--cache-mode" && i + 1 < argc)
+      options.cacheMode = atoi(argv[++i]);
+    else if (arg == "--generate" && i + 1 < argc)
+      options.generateSeconds = std::max(1, atoi(argv[++i]));
+    else if (!arg.empty() && arg[0] != '-' && options.file.empty())
+      options.file = arg;
+    else
+      return false;
+  }
+  return !options.file.empty() || options.generateSeconds > 0;
+}
+
+double ToMs(int64_t ticks)
+{
+  return 1000.0 * ticks / CurrentHostFrequency();
+}
+
+//! fills a packet with bytes that never form an MPEG start code
+void Fill(std::vector<uint8_t>& buffer, unsigned int& seed)
+{
+  for (auto& byte : buffer)
+  {
+    seed = seed * 1103515245 + 12345;
+    byte = static_cast<uint8_t>((seed >> 16) | 1);
+  }
+}
+
+bool WritePacket(AVFormatContext* context, AVStream* stream, std::vector<uint8_t>& buffer,
+                 int64_t ms, int64_t durationMs, bool keyframe)
+{
+  AVPacket pkt;
+  av_init_packet(&pkt);
+  pkt.data = buffer.data();
+  pkt.size = static_cast<int>(buffer.size());
+  pkt.stream_index = stream->index;
+  pkt.pts = pkt.dts = av_rescale_q(ms, AVRational{1, 1000}, stream->time_base);
+  pkt.duration = av_rescale_q(durationMs, AVRational{1, 1000}, stream->time_base);
+  pkt.flags = keyframe ? AV_PKT_FLAG_KEY : 0;
+  return av_interleaved_write_frame(context, &pkt) >= 0;
+}
+
+//! writes 25 fps 1080p video at about 8 Mbit/s and 5.1 AC3 audio
+bool GenerateStream(const std::string& path, unsigned int seconds)
+{
+  AVFormatContext* context = nullptr;
+  if (avformat_alloc_output_context2(&context, nullptr, "matroska", path.c_str()) < 0)
+    return false;
+
+  AVStream* video = avformat_new_stream(context, nullptr);
+  video->time_base = AVRational{1, 1000};
+  video->codecpar->codec_type = AVMEDIA_TYPE_VIDEO;
+  video->codecpar->codec_id = AV_CODEC_ID_MPEG2VIDEO;
+  video->codecpar->width = 1920;
+  video->codecpar->height = 1080;
+
+  AVStream* audio = avformat_new_stream(context, nullptr);
+  audio->time_base = AVRational{1, 1000};
+  audio->codecpar->codec_type = AVMEDIA_TYPE_AUDIO;
+  audio->codecpar->codec_id = AV_CODEC_ID_AC3;
+  audio->codecpar->sample_rate = 48000;
+  audio->codecpar->channels = 6;
+
+  bool ok = avio_open(&context->pb, path.c_str(), AVIO_FLAG_WRITE) >= 0 &&
+            avformat_write_header(context, nullptr) >= 0;
+
+  unsigned int seed = 1;
+  std::vector<uint8_t> buffer;
+  int64_t audioMs = 0;
+  for (unsigned int frame = 0; ok && frame < seconds * 25; frame++)
+  {
+    int64_t videoMs = frame * 40;
+    bool keyframe = frame % 50 == 0;
+    buffer.resize(keyframe ? 200000 : 36000 + (seed >> 20) % 8000);
+    Fill(buffer, seed);
+    ok = WritePacket(context, video, buffer, videoMs, 40, keyframe);
+
+    // one AC3 frame every 32 ms at 384 kbit/s
+    for (; ok && audioMs < videoMs + 40; audioMs += 32)
+    {
+      buffer.resize(1536);
+      Fill(buffer, seed);
+      ok = WritePacket(context, audio, buffer, audioMs, 32, true);
+    }
+  }
+
+  if (ok)
+    ok = av_write_trailer(context) >= 0;
+  avio_closep(&context->pb);
+  avformat_free_context(context);
+  return ok;
+}
+
+bool RunIteration(const std::string& file, RunStats& stats)
+{
+  CFileItem item(file, false);
+  item.SetMimeTypeForInternetFile();
+
+  int64_t start = CurrentHostCounter();
+
+  std::shared_ptr<CDVDInputStream> input = CDVDFactoryInputStream::CreateInputStream(nullptr, item);
+  if (!input || !input->Open())
+  {
+    fprintf(stderr, "Unable to open input stream for %s\n", file.c_str());
+    return false;
+  }
+
+  std::unique_ptr<CDVDDemux> demuxer(CDVDFactoryDemuxer::CreateDemuxer(input));
+  if (!demuxer)
+  {
+    fprintf(stderr, "Unable to create demuxer for %s\n", file.c_str());
+    return false;
+  }
+
+  // the timings below only cover reading the packets, not probing the streams
+  CDVDDemuxFFmpeg* ffmpeg = dynamic_cast<CDVDDemuxFFmpeg*>(demuxer.get());
+  DemuxIOStats openIO;
+  if (ffmpeg)
+    openIO = ffmpeg->GetIOStats();
+
+  int64_t readStart = CurrentHostCounter();
+  stats.openTicks += readStart - start;
+  uint64_t allocs = allocCount.load();
+
+  CDVDMessageQueue queue("demuxbench");
+  queue.Init();
+
+  while (true)
+  {
+    int64_t packetStart = CurrentHostCounter();
+    DemuxPacket* packet = demuxer->Read();
+    int64_t packetEnd = CurrentHostCounter();
+    stats.readTicks += packetEnd - packetStart;
+    if (!packet)
+      break;
+
+    stats.packets++;
+    stats.bytes += packet->iSize;
+
+    // hand the packet over the way CVideoPlayer does, and take it out again
+    queue.Put(new CDVDMsgDemuxerPacket(packet));
+    CDVDMsg* msg;
+    if (queue.Get(&msg, 0) == MSGQ_OK)
+      msg->Release();
+    stats.queueTicks += CurrentHostCounter() - packetEnd;
+  }
+
+  stats.totalTicks += CurrentHostCounter() - readStart;
+  stats.allocs += allocCount.load() - allocs;
+
+  if (ffmpeg)
+  {
+    const DemuxIOStats& io = ffmpeg->GetIOStats();
+    stats.io.reads += io.reads - openIO.reads;
+    stats.io.readBytes += io.readBytes - openIO.readBytes;
+    stats.io.readTicks += io.readTicks - openIO.readTicks;
+    stats.io.seeks += io.seeks - openIO.seeks;
+    stats.io.seekTicks += io.seekTicks - openIO.seekTicks;
+    stats.io.frameTicks += io.frameTicks - openIO.frameTicks;
+  }
+
+  stats.cached = input->GetCacheStatus(&stats.cache);
+
+  queue.End();
+  demuxer.reset();
+  input->Close();
+
+  return true;
+}
+
+void PrintLayer(const char* name, int64_t ticks, const RunStats& stats)
+{
+  printf("  %-8s %10.3f ms %6.1f %% %8.3f us/packet\n", name, ToMs(ticks),
+         stats.totalTicks ? 100.0 * ticks / stats.totalTicks : 0.0,
+         stats.packets ? 1000.0 * ToMs(ticks) / stats.packets : 0.0);
+}
+
+int RunBenchmark(const Options& options)
+{
+  std::string file = options.file;
+  if (file.empty())
+  {
+    file = CSpecialProtocol::TranslatePath("special://temp/demuxbench.mkv");
+    printf("Generating %u second(s) of test stream in %s\n", options.generateSeconds, file.c_str());
+    if (!GenerateStream(file, options.generateSeconds))
+    {
+      fprintf(stderr, "Unable to write %s\n", file.c_str());
+      return EXIT_FAILURE;
+    }
+  }
+
+  if (options.cacheMode >= 0)
+    CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_cacheBufferMode = options.cacheMode;
+
+  RunStats stats;
+  for (unsigned int iteration = 0; iteration < options.iterations; iteration++)
+  {
+    if (!RunIteration(file, stats))
+      return EXIT_FAILURE;
+  }
+
+  if (!stats.packets || !stats.totalTicks)
+  {
+    fprintf(stderr, "No packets read from %s\n", file.c_str());
+    return EXIT_FAILURE;
+  }
+
+  double seconds = ToMs(stats.totalTicks) / 1000.0;
+  printf("File %s, %u iteration(s)\n", file.c_str(), options.iterations);
+  printf("  open     %10.3f ms per iteration\n", ToMs(stats.openTicks) / options.iterations);
+  printf("  packets  %10llu, %.0f packets/s\n", static_cast<unsigned long long>(stats.packets),
+         stats.packets / seconds);
+  printf("  data     %10.1f MiB, %.1f MiB/s\n", stats.bytes / 1048576.0,
+         stats.bytes / 1048576.0 / seconds);
+  printf("  allocs   %10.2f per packet\n", static_cast<double>(stats.allocs) / stats.packets);
+
+  printf("\nTime per layer:\n");
+  if (stats.io.reads)
+  {
+    int64_t inputTicks = stats.io.readTicks + stats.io.seekTicks;
+    PrintLayer("input", inputTicks, stats);
+    PrintLayer("ffmpeg", stats.io.frameTicks - inputTicks, stats);
+    PrintLayer("demux", stats.readTicks - stats.io.frameTicks, stats);
+  }
+  else
+    PrintLayer("demux", stats.readTicks, stats);
+  PrintLayer("queue", stats.queueTicks, stats);
+
+  if (stats.io.reads)
+    printf("\nAVIO: %llu reads of %.1f KiB on average, %llu seeks\n",
+           static_cast<unsigned long long>(stats.io.reads),
+           stats.io.readBytes / 1024.0 / stats.io.reads,
+           static_cast<unsigned long long>(stats.io.seeks));
+  if (stats.cached)
+    printf("File cache: %.1f MiB forward, read rate %.1f MiB/s, max rate %.1f MiB/s%s\n",
+           stats.cache.forward / 1048576.0, stats.cache.currate / 1048576.0,
+           stats.cache.maxrate / 1048576.0, stats.cache.lowspeed ? ", low speed" : "");
+
+  CDemuxPacketPool::Stats pool = CDemuxPacketPool::GetInstance().GetStats();
+  printf("Packet pool: %llu buffers, %.1f %% reused, peak %.1f MiB in use\n",
+         static_cast<unsigned long long>(pool.allocations),
+         pool.allocations ? 100.0 * pool.hits / pool.allocations : 0.0,
+         pool.peakBytesInUse / 1048576.0);
+  CDVDDemuxUtils::TrimPacketPool();
+
+  return EXIT_SUCCESS;
+}
+
+} // unnamed namespace
+
+// count every heap allocation made by the process
+void* operator new(size_t size)
+{
+  allocCount.fetch_add(1, std::memory_order_relaxed);
+  if (void* ptr = malloc(size ? size : 1))
+    return ptr;
+  throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+  return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+  free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+  free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+  free(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept
+{
+  free(ptr);
+}
+
+int main(int argc, char** argv)
+{
+  Options options;
+  if (!ParseArgs(argc, argv, options))
+  {
+    Usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  TestBasicEnvironment environment;
+  environment.SetUp();
+  int ret = RunBenchmark(options);
+  environment.TearDown();
+
+  return ret;
+}
@@ -0,0 +1,353 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+/*!
+ \file xbmc-skinbench.cpp
+ \brief Headless skin load benchmark
+
+ Loads a skin the same way CApplication::LoadSkin does, minus everything that
+ needs a windowing system (fonts, textures, window manager), then runs every
+ window XML of the skin through the three stages of CGUIWindow::Load:
+
+   parse    - read the window XML file
+   resolve  - resolve includes, constants, variables and expressions (CGUIIncludes)
+   create   - instantiate the control tree (CGUIControlFactory)
+
+ For each window and stage the average time and the number of heap allocations
+ are reported, so changes to the skinning engine can be compared before and
+ after.
+
+ Usage: kodi-skinbench [--skin <addon id>] [--iterations <n>] [--window <name>]
+ */
+
+#include "TestBasicEnvironment.h"
+
+#include "FileItem.h"
+#include "ServiceBroker.h"
+#include "addons/AddonManager.h"
+#include "addons/Skin.h"
+#include "filesystem/Directory.h"
+#include "guilib/GUIColorManager.h"
+#include "guilib/GUIComponent.h"
+#include "guilib/GUIControlFactory.h"
+#include "guilib/GUIControlGroup.h"
+#include "guilib/LocalizeStrings.h"
+#include "settings/Settings.h"
+#include "settings/SettingsComponent.h"
+#include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
+#include "utils/URIUtils.h"
+#include "utils/XBMCTinyXML.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+std::atomic<uint64_t> allocCount{0};
+std::atomic<uint64_t> allocBytes{0};
+
+struct PhaseStats
+{
+  double ms = 0;
+  uint64_t allocs = 0;
+  uint64_t bytes = 0;
+
+  PhaseStats& operator+=(const PhaseStats& other)
+  {
+    ms += other.ms;
+    allocs += other.allocs;
+    bytes += other.bytes;
+    return *this;
+  }
+};
+
+//! measures the time and allocations between construction and Stop()
+class CPhaseTimer
+{
+public:
+  CPhaseTimer()
+    : m_start(CurrentHostCounter()), m_allocs(allocCount.load()), m_bytes(allocBytes.load())
+  {
+  }
+
+  PhaseStats Stop() const
+  {
+    PhaseStats stats;
+    stats.ms = 1000.0 * (CurrentHostCounter() - m_start) / CurrentHostFrequency();
+    stats.allocs = allocCount.load() - m_allocs;
+    stats.bytes = allocBytes.load() - m_bytes;
+    return stats;
+  }
+
+private:
+  int64_t m_start;
+  uint64_t m_allocs;
+  uint64_t m_bytes;
+};
+
+struct WindowStats
+{
+  std::string name;
+  PhaseStats parse;
+  PhaseStats resolve;
+  PhaseStats create;
+  unsigned int controls = 0;
+};
+
+struct Options
+{
+  std::string skin = "skin.estuary";
+  std::string window;
+  unsigned int iterations = 5;
+};
+
+void Usage(const char* name)
+{
+  fprintf(stderr, "Usage: %s [--skin <addon id>] [--iterations <n>] [--window <name>]\n", name);
+}
+
+bool ParseArgs(int argc, char** argv, Options& options)
+{
+  for (int i = 1; i < argc; i++)
+  {
+    std::string arg = argv[i];
+    if (arg == "--skin" && i + 1 < argc)
+      options.skin = argv[++i];
+    else if (arg == "--window" && i + 1 < argc)
+      options.window = argv[++i];
+    else if (arg == "--iterations" && i + 1 < argc)
+      options.iterations = std::max(1, atoi(argv[++i]));
+    else
+      return false;
+  }
+  return true;
+}
+
+// mirrors CGUIWindow::LoadControl
+unsigned int CreateControls(TiXmlElement* node, CGUIControlGroup& group, const CRect& rect)
+{
+  CGUIControlFactory factory;
+  unsigned int count = 0;
+
+  for (TiXmlElement* child = node->FirstChildElement("control"); child;
+       child = child->NextSiblingElement("control"))
+  {
+    CGUIControl* control = factory.Create(group.GetID(), rect, child);
+    if (!control)
+      continue;
+
+    group.AddControl(control);
+    count++;
+
+    if (control->IsGroup())
+    {
+      CRect groupRect(control->GetXPosition(), control->GetYPosition(),
+                      control->GetXPosition() + control->GetWidth(),
+                      control->GetYPosition() + control->GetHeight());
+      count += CreateControls(child, *static_cast<CGUIControlGroup*>(control), groupRect);
+    }
+  }
+
+  return count;
+}
+
+//! runs one iteration over the given window file, returns false if it isn't a window
+bool BenchWindow(const std::string& path, const RESOLUTION_INFO& res, WindowStats& stats)
+{
+  CPhaseTimer parseTimer;
+  CXBMCTinyXML doc;
+  if (!doc.LoadFile(path) || !doc.RootElement() ||
+      !StringUtils::EqualsNoCase(doc.RootElement()->Value(), "window"))
+    return false;
+  stats.parse += parseTimer.Stop();
+
+  CPhaseTimer resolveTimer;
+  std::unique_ptr<TiXmlElement> root(static_cast<TiXmlElement*>(doc.RootElement()->Clone()));
+  std::map<INFO::InfoPtr, bool> includeConditions;
+  g_SkinInfo->ResolveIncludes(root.get(), &includeConditions);
+  stats.resolve += resolveTimer.Stop();
+
+  CPhaseTimer createTimer;
+  {
+    CRect rect(0, 0, static_cast<float>(res.iWidth), static_cast<float>(res.iHeight));
+    CGUIControlGroup window(0, 0, rect.x1, rect.y1, rect.Width(), rect.Height());
+    TiXmlElement* controls = root->FirstChildElement("controls");
+    stats.controls = controls ? CreateControls(controls, window, rect) : 0;
+  }
+  stats.create += createTimer.Stop();
+
+  return true;
+}
+
+bool LoadSkin(const std::string& skinId, PhaseStats& stats)
+{
+  ADDON::AddonPtr addon;
+  if (!CServiceBroker::GetAddonMgr().GetAddon(skinId, addon, ADDON::ADDON_SKIN, false))
+  {
+    fprintf(stderr, "Skin '%s' not found\n", skinId.c_str());
+    return false;
+  }
+
+  CPhaseTimer timer;
+  std::shared_ptr<ADDON::CSkinInfo> skin = std::static_pointer_cast<ADDON::CSkinInfo>(addon);
+  skin->Start();
+  if (!skin->HasSkinFile("Home.xml"))
+  {
+    fprintf(stderr, "Skin '%s' has no Home.xml\n", skinId.c_str());
+    return false;
+  }
+  g_SkinInfo = skin;
+
+  const std::shared_ptr<CSettings> settings = CServiceBroker::GetSettingsComponent()->GetSettings();
+  CServiceBroker::GetGUI()->GetColorManager().Load(settings->GetString(CSettings::SETTING_LOOKANDFEEL_SKINCOLORS));
+
+  g_SkinInfo->LoadIncludes();
+
+  std::string langPath = URIUtils::AddFileToFolder(skin->Path(), "language");
+  URIUtils::AddSlashAtEnd(langPath);
+  g_localizeStrings.LoadSkinStrings(langPath, settings->GetString(CSettings::SETTING_LOCALE_LANGUAGE));
+  stats = timer.Stop();
+
+  return true;
+}
+
+void PrintPhase(const char* name, const PhaseStats& stats, unsigned int iterations)
+{
+  printf("  %-8s %10.3f ms %10llu allocs %10llu KiB\n", name, stats.ms / iterations,
+         static_cast<unsigned long long>(stats.allocs / iterations),
+         static_cast<unsigned long long>(stats.bytes / iterations / 1024));
+}
+
+int RunBenchmark(const Options& options)
+{
+  PhaseStats skinStats;
+  if (!LoadSkin(options.skin, skinStats))
+    return EXIT_FAILURE;
+
+  RESOLUTION_INFO res;
+  std::string xmlDir = URIUtils::GetDirectory(g_SkinInfo->GetSkinPath("Home.xml", &res));
+  CFileItemList items;
+  XFILE::CDirectory::GetDirectory(xmlDir, items, ".xml", XFILE::DIR_FLAG_NO_FILE_DIRS);
+  items.Sort(SortByFile, SortOrderAscending);
+
+  std::vector<WindowStats> windows;
+  for (int i = 0; i < items.Size(); i++)
+  {
+    const std::string& path = items[i]->GetPath();
+    WindowStats stats;
+    stats.name = URIUtils::GetFileName(path);
+    if (!options.window.empty() && !StringUtils::StartsWithNoCase(stats.name, options.window))
+      continue;
+
+    bool isWindow = true;
+    for (unsigned int iteration = 0; iteration < options.iterations && isWindow; iteration++)
+      isWindow = BenchWindow(path, res, stats);
+
+    if (isWindow)
+      windows.push_back(stats);
+  }
+
+  printf("Skin %s (%s), %u iteration(s)\n", g_SkinInfo->ID().c_str(), xmlDir.c_str(), options.iterations);
+  printf("Skin load (includes, colors, strings):\n");
+  PrintPhase("load", skinStats, 1);
+  printf("\n%-40s %10s %10s %10s %8s %10s %10s\n", "window", "parse ms", "resolve ms", "create ms",
+         "controls", "allocs", "KiB");
+
+  WindowStats total;
+  for (const auto& stats : windows)
+  {
+    printf("%-40s %10.3f %10.3f %10.3f %8u %10llu %10llu\n", stats.name.c_str(),
+           stats.parse.ms / options.iterations, stats.resolve.ms / options.iterations,
+           stats.create.ms / options.iterations, stats.controls,
+           static_cast<unsigned long long>((stats.parse.allocs + stats.resolve.allocs + stats.create.allocs) / options.iterations),
+           static_cast<unsigned long long>((stats.parse.bytes + stats.resolve.bytes + stats.create.bytes) / options.iterations / 1024));
+    total.parse += stats.parse;
+    total.resolve += stats.resolve;
+    total.create += stats.create;
+    total.controls += stats.controls;
+  }
+
+  printf("\nTotal over %u window(s), %u control(s):\n", static_cast<unsigned int>(windows.size()), total.controls);
+  PrintPhase("parse", total.parse, options.iterations);
+  PrintPhase("resolve", total.resolve, options.iterations);
+  PrintPhase("create", total.create, options.iterations);
+
+  g_SkinInfo.reset();
+  return windows.empty() ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+} // unnamed namespace
+
+// count every heap allocation made by the process
+void* operator new(size_t size)
+{
+  allocCount.fetch_add(1, std::memory_order_relaxed);
+  allocBytes.fetch_add(size, std::memory_order_relaxed);
+  if (void* ptr = malloc(size ? size : 1))
+    return ptr;
+  throw std::bad_alloc();
+}
+
+void* operator new[](size_t size)
+{
+  return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+  free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+  free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+  free(ptr);
+}
+
+void operator delete[](void* ptr, size_t) noexcept
+{
+  free(ptr);
+}
+
+int main(int argc, char** argv)
+{
+  Options options;
+  if (!ParseArgs(argc, argv, options))
+  {
+    Usage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  TestBasicEnvironment environment;
+  environment.SetUp();
+
+  int ret;
+  {
+    // the info and color managers are needed to resolve conditions and colors,
+    // the component is intentionally never Init()'ed as that requires a GPU
+    CGUIComponent gui;
+    CServiceBroker::RegisterGUI(&gui);
+    ret = RunBenchmark(options);
+  }
+
+  environment.TearDown();
+  return ret;
+}
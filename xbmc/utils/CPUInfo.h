@@ -36,6 +36,8 @@ class CLinuxResourceCounter;
 #define CPU_FEATURE_3DNOWEXT 1 << 9
 #define CPU_FEATURE_ALTIVEC  1 << 10
 #define CPU_FEATURE_NEON     1 << 11
+#define CPU_FEATURE_AVX      1 << 12
+#define CPU_FEATURE_AVX2     1 << 13
 
 struct CoreInfo
 {
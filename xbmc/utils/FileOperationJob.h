@@ -39,6 +39,7 @@ public:
   // implementations of CJob
   bool DoWork() override;
   const char* GetType() const override { return m_displayProgress ? "filemanager" : ""; }
+  AFFINITY GetAffinity() const override { return AFFINITY_IO; }
   bool operator==(const CJob *job) const override;
 
   void SetFileOperation(FileAction action, CFileItemList &items, const std::string &strDestFile);
@@ -9,11 +9,29 @@
 #include "JSONVariantWriter.h"
 
 #include <rapidjson/prettywriter.h>
-#include <rapidjson/stringbuffer.h>
 #include <rapidjson/writer.h>
 
 #include "utils/Variant.h"
 
+namespace
+{
+// rapidjson output stream appending straight to a std::string so large
+// responses aren't buffered twice
+class CStringOutputStream
+{
+public:
+  typedef char Ch;
+
+  explicit CStringOutputStream(std::string& output) : m_output(output) { }
+
+  void Put(Ch c) { m_output.push_back(c); }
+  void Flush() { }
+
+private:
+  std::string& m_output;
+};
+}
+
 template<class TWriter>
 bool InternalWrite(TWriter& writer, const CVariant &value)
 {
@@ -70,23 +88,142 @@ bool InternalWrite(TWriter& writer, const CVariant &value)
 
 bool CJSONVariantWriter::Write(const CVariant &value, std::string& output, bool compact)
 {
-  rapidjson::StringBuffer stringBuffer;
+  std::string buffer;
+  CStringOutputStream stream(buffer);
   if (compact)
   {
-    rapidjson::Writer<rapidjson::StringBuffer> writer(stringBuffer);
+    rapidjson::Writer<CStringOutputStream> writer(stream);
 
     if (!InternalWrite(writer, value) || !writer.IsComplete())
       return false;
   }
   else
   {
-    rapidjson::PrettyWriter<rapidjson::StringBuffer> writer(stringBuffer);
+    rapidjson::PrettyWriter<CStringOutputStream> writer(stream);
     writer.SetIndent('\t', 1);
 
     if (!InternalWrite(writer, value) || !writer.IsComplete())
       return false;
   }
 
-  output = stringBuffer.GetString();
+  output.swap(buffer);
   return true;
 }
+
+class CJSONStreamWriter::IWriter
+{
+public:
+  virtual ~IWriter() = default;
+
+  virtual bool StartObject() = 0;
+  virtual bool EndObject() = 0;
+  virtual bool StartArray() = 0;
+  virtual bool EndArray() = 0;
+  virtual bool Key(const std::string &key) = 0;
+  virtual bool Write(const CVariant &value) = 0;
+};
+
+template<class TWriter>
+class CJSONStreamWriter::CWriter : public CJSONStreamWriter::IWriter
+{
+public:
+  explicit CWriter(std::string &buffer)
+    : m_stream(buffer),
+      m_writer(m_stream)
+  { }
+
+  TWriter& GetWriter() { return m_writer; }
+
+  bool StartObject() override { return m_writer.StartObject(); }
+  bool EndObject() override { return m_writer.EndObject(); }
+  bool StartArray() override { return m_writer.StartArray(); }
+  bool EndArray() override { return m_writer.EndArray(); }
+  bool Key(const std::string &key) override { return m_writer.Key(key.c_str(), key.size()); }
+  bool Write(const CVariant &value) override { return InternalWrite(m_writer, value); }
+
+private:
+  CStringOutputStream m_stream;
+  TWriter m_writer;
+};
+
+CJSONStreamWriter::CJSONStreamWriter(OutputFunc output, bool compact, size_t bufferSize /* = 64 * 1024 */)
+  : m_output(std::move(output)),
+    m_bufferSize(bufferSize)
+{
+  m_buffer.reserve(m_bufferSize);
+
+  if (compact)
+    m_writer.reset(new CWriter<rapidjson::Writer<CStringOutputStream>>(m_buffer));
+  else
+  {
+    auto writer = new CWriter<rapidjson::PrettyWriter<CStringOutputStream>>(m_buffer);
+    writer->GetWriter().SetIndent('\t', 1);
+    m_writer.reset(writer);
+  }
+}
+
+CJSONStreamWriter::~CJSONStreamWriter() = default;
+
+bool CJSONStreamWriter::StartObject()
+{
+  return !m_failed && Check(m_writer->StartObject());
+}
+
+bool CJSONStreamWriter::EndObject()
+{
+  return !m_failed && Check(m_writer->EndObject());
+}
+
+bool CJSONStreamWriter::StartArray()
+{
+  return !m_failed && Check(m_writer->StartArray());
+}
+
+bool CJSONStreamWriter::EndArray()
+{
+  return !m_failed && Check(m_writer->EndArray());
+}
+
+bool CJSONStreamWriter::Key(const std::string &key)
+{
+  return !m_failed && Check(m_writer->Key(key));
+}
+
+bool CJSONStreamWriter::Write(const CVariant &value)
+{
+  return !m_failed && Check(m_writer->Write(value));
+}
+
+bool CJSONStreamWriter::WriteRaw(const std::string &text)
+{
+  if (m_failed)
+    return false;
+
+  m_buffer.append(text);
+  return Check(true);
+}
+
+bool CJSONStreamWriter::Flush()
+{
+  if (m_failed)
+    return false;
+
+  if (!m_buffer.empty())
+  {
+    if (!m_output(m_buffer.c_str(), m_buffer.size()))
+      m_failed = true;
+    m_buffer.clear();
+  }
+
+  return !m_failed;
+}
+
+bool CJSONStreamWriter::Check(bool result)
+{
+  if (!result)
+    m_failed = true;
+  else if (m_buffer.size() >= m_bufferSize)
+    return Flush();
+
+  return !m_failed;
+}
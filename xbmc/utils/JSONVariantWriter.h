@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include <functional>
+#include <memory>
 #include <string>
 
 class CVariant;
@@ -19,3 +21,54 @@ public:
 
   static bool Write(const CVariant &value, std::string& output, bool compact);
 };
+
+/*!
+ \brief Writes a JSON document piece by piece
+
+ The output is collected in a buffer which is handed to the output function
+ whenever it grows beyond the given size, so only a bounded part of the
+ document is held in memory at any time.
+ */
+class CJSONStreamWriter
+{
+public:
+  /*!
+   \brief Consumes a part of the written document
+   \return false to abort writing
+   */
+  typedef std::function<bool(const char *data, size_t size)> OutputFunc;
+
+  CJSONStreamWriter(OutputFunc output, bool compact, size_t bufferSize = 64 * 1024);
+  ~CJSONStreamWriter();
+
+  bool StartObject();
+  bool EndObject();
+  bool StartArray();
+  bool EndArray();
+  bool Key(const std::string &key);
+  bool Write(const CVariant &value);
+
+  /*!
+   \brief Passes text to the output as is, bypassing the JSON writer
+   */
+  bool WriteRaw(const std::string &text);
+
+  /*!
+   \brief Passes everything buffered so far to the output
+   */
+  bool Flush();
+
+  bool HasFailed() const { return m_failed; }
+
+private:
+  class IWriter;
+  template<class TWriter> class CWriter;
+
+  bool Check(bool result);
+
+  OutputFunc m_output;
+  size_t m_bufferSize;
+  std::string m_buffer;
+  std::unique_ptr<IWriter> m_writer;
+  bool m_failed = false;
+};
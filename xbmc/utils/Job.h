@@ -101,6 +101,15 @@ public:
     PRIORITY_HIGH,
     PRIORITY_DEDICATED, // will create a new worker if no worker is available at queue time
   };
+
+  /*!
+   \brief Affinity hints for jobs, selecting the group of workers a job is run on.
+   \sa CJobManager, GetAffinity()
+   */
+  enum AFFINITY {
+    AFFINITY_COMPUTE = 0, // CPU bound work, run on the pool sized to the number of cores
+    AFFINITY_IO,          // mostly waits on disk or network, run on the I/O pool
+  };
   CJob() { m_callback = NULL; };
 
   /*!
@@ -136,6 +145,17 @@ public:
    */
   virtual const char *GetType() const { return ""; };
 
+  /*!
+   \brief Function that returns which workers should run the job.
+
+   Jobs that spend most of their time blocked on disk or network access should return AFFINITY_IO,
+   so they don't occupy the workers sized to the number of cores.
+
+   \return the affinity of the job, AFFINITY_COMPUTE by default.
+   \sa CJobManager
+   */
+  virtual AFFINITY GetAffinity() const { return AFFINITY_COMPUTE; };
+
   virtual bool operator==(const CJob* job) const
   {
     return false;
@@ -10,12 +10,25 @@
 #include <algorithm>
 #include <functional>
 #include <stdexcept>
+#include <thread>
 #include "threads/SingleLock.h"
 #include "utils/log.h"
 #ifdef TARGET_POSIX
 #include "platform/linux/XTimeUtils.h"
 #endif
 
+namespace
+{
+// the worker running on the current thread, if any
+thread_local const CJobWorker* currentWorker = nullptr;
+
+// time an idle worker waits for new jobs before it exits
+const unsigned int WORKER_IDLE_TIMEOUT = 30000;
+
+// I/O bound jobs mostly wait, so their pool doesn't depend on the number of cores
+const unsigned int IO_POOL_SIZE = 8;
+}
+
 bool CJob::ShouldCancel(unsigned int progress, unsigned int total) const
 {
   if (m_callback)
@@ -23,9 +36,10 @@ bool CJob::ShouldCancel(unsigned int progress, unsigned int total) const
   return false;
 }
 
-CJobWorker::CJobWorker(CJobManager *manager) : CThread("JobWorker")
+CJobWorker::CJobWorker(CJobManager *manager, int queue) : CThread("JobWorker")
 {
   m_jobManager = manager;
+  m_queue = queue;
   Create(true); // start work immediately, and kill ourselves when we're done
 }
 
@@ -42,6 +56,7 @@ CJobWorker::~CJobWorker()
 void CJobWorker::Process()
 {
   SetPriority( GetMinPriority() );
+  currentWorker = this;
   while (true)
   {
     // request an item from our manager (this call is blocking)
@@ -58,7 +73,7 @@ void CJobWorker::Process()
     {
       CLog::Log(LOGERROR, "%s error processing job %s", __FUNCTION__, job->GetType());
     }
-    m_jobManager->OnJobComplete(success, job);
+    m_jobManager->OnJobComplete(success, job, this);
   }
 }
 
@@ -170,6 +185,22 @@ CJobManager::CJobManager()
   m_jobCounter = 0;
   m_running = true;
   m_pauseJobs = false;
+  m_dedicatedIdle = 0;
+
+  // The single set of at most 5 workers used to be shared by all jobs, so a few
+  // slow network jobs kept everything else waiting. Compute jobs don't block,
+  // one worker per core keeps the cores busy without oversubscribing them.
+  // I/O jobs mostly wait and get a separate, small fixed pool so they can't
+  // hold up compute jobs. Workers still only start when there is work for them
+  // and exit after WORKER_IDLE_TIMEOUT, so an idle system keeps no threads.
+  // The pools need a worker per priority, so lower priorities can't take all of them.
+  const unsigned int minPoolSize = CJob::PRIORITY_HIGH + 1;
+  m_computePool.m_size = std::max(std::thread::hardware_concurrency(), minPoolSize);
+  m_ioPool.m_first = m_computePool.m_size;
+  m_ioPool.m_size = std::max(IO_POOL_SIZE, minPoolSize);
+
+  for (unsigned int i = 0; i < m_computePool.m_size + m_ioPool.m_size; ++i)
+    m_queues.emplace_back(new CWorkQueue);
 }
 
 void CJobManager::Restart()
@@ -187,20 +218,31 @@ void CJobManager::CancelJobs()
   m_running = false;
 
   // clear any pending jobs
-  for (unsigned int priority = CJob::PRIORITY_LOW_PAUSABLE; priority <= CJob::PRIORITY_DEDICATED; ++priority)
+  for_each(m_dedicatedQueue.begin(), m_dedicatedQueue.end(), [](CWorkItem& wi) { wi.FreeJob(); });
+  m_dedicatedQueue.clear();
+  for (unsigned int i = 0; i < m_queues.size(); ++i)
   {
-    for_each(m_jobQueue[priority].begin(), m_jobQueue[priority].end(), [](CWorkItem& wi) { wi.FreeJob(); });
-    m_jobQueue[priority].clear();
-  }
+    CWorkQueue &queue = *m_queues[i];
+    CSingleLock queueLock(queue.m_section);
+    for (unsigned int priority = CJob::PRIORITY_LOW_PAUSABLE; priority <= CJob::PRIORITY_HIGH; ++priority)
+    {
+      for_each(queue.m_jobs[priority].begin(), queue.m_jobs[priority].end(), [](CWorkItem& wi) { wi.FreeJob(); });
+      GetPool(i).m_queued -= queue.m_jobs[priority].size();
+      queue.m_queued[priority] = 0;
+      queue.m_jobs[priority].clear();
+    }
 
-  // cancel any callbacks on jobs still processing
-  for_each(m_processing.begin(), m_processing.end(), [](CWorkItem& wi) { wi.Cancel(); });
+    // cancel any callbacks on jobs still processing
+    CSingleLock processingLock(queue.m_processingSection);
+    queue.m_processing.Cancel();
+  }
+  for_each(m_dedicatedProcessing.begin(), m_dedicatedProcessing.end(), [](CWorkItem& wi) { wi.Cancel(); });
 
   // tell our workers to finish
   while (m_workers.size())
   {
     lock.Leave();
-    m_jobEvent.Set();
+    WakeWorkers();
     Sleep(0); // yield after setting the event to give the workers some time to die
     lock.Enter();
   }
@@ -208,81 +250,196 @@ void CJobManager::CancelJobs()
 
 unsigned int CJobManager::AddJob(CJob *job, IJobCallback *callback, CJob::PRIORITY priority)
 {
-  CSingleLock lock(m_section);
-
   if (!m_running)
     return 0;
 
   // increment the job counter, ensuring 0 (invalid job) is never hit
-  m_jobCounter++;
-  if (m_jobCounter == 0)
-    m_jobCounter++;
+  unsigned int id = ++m_jobCounter;
+  if (id == 0)
+    id = ++m_jobCounter;
 
   // create a work item for this job
-  CWorkItem work(job, m_jobCounter, priority, callback);
-  m_jobQueue[priority].push_back(work);
+  CWorkItem work(job, id, priority, callback);
+
+  if (priority == CJob::PRIORITY_DEDICATED)
+  {
+    CSingleLock lock(m_section);
+    if (!m_running)
+      return 0;
+
+    m_dedicatedQueue.push_back(work);
+    if (m_dedicatedIdle >= m_dedicatedQueue.size())
+      m_jobEvent.Set();
+    else
+      m_workers.push_back(new CJobWorker(this, -1));
+    return id;
+  }
+
+  CPool &pool = job->GetAffinity() == CJob::AFFINITY_IO ? m_ioPool : m_computePool;
+
+  // jobs added by a worker go to its own queue, others are spread over the pool
+  unsigned int index;
+  const CJobWorker *worker = currentWorker;
+  if (worker && worker->m_jobManager == this && worker->m_queue >= 0 && &GetPool(worker->m_queue) == &pool)
+    index = worker->m_queue;
+  else
+    index = pool.m_first + pool.m_next++ % pool.m_size;
+
+  CWorkQueue &queue = *m_queues[index];
+  {
+    CSingleLock lock(queue.m_section);
+    if (!m_running)
+      return 0;
+
+    queue.m_jobs[priority].push_back(work);
+    ++queue.m_queued[priority];
+    ++pool.m_queued;
+  }
 
-  StartWorkers(priority);
-  return work.m_id;
+  // start another worker if all of them are busy
+  if (pool.m_processing >= pool.m_workers && pool.m_workers < pool.m_size)
+    StartWorker(pool, index);
+  if (pool.m_idle)
+    pool.m_jobEvent.Set();
+
+  return id;
 }
 
 void CJobManager::CancelJob(unsigned int jobID)
 {
   CSingleLock lock(m_section);
 
-  // check whether we have this job in the queue
-  for (unsigned int priority = CJob::PRIORITY_LOW_PAUSABLE; priority <= CJob::PRIORITY_DEDICATED; ++priority)
+  // check whether we have this job in the dedicated queue
+  JobQueue::iterator i = find(m_dedicatedQueue.begin(), m_dedicatedQueue.end(), jobID);
+  if (i != m_dedicatedQueue.end())
+  {
+    delete i->m_job;
+    m_dedicatedQueue.erase(i);
+    return;
+  }
+  Processing::iterator it = find(m_dedicatedProcessing.begin(), m_dedicatedProcessing.end(), jobID);
+  if (it != m_dedicatedProcessing.end())
   {
-    JobQueue::iterator i = find(m_jobQueue[priority].begin(), m_jobQueue[priority].end(), jobID);
-    if (i != m_jobQueue[priority].end())
+    it->m_callback = NULL; // job is in progress, so only thing to do is to remove callback
+    return;
+  }
+
+  // hold all queues, so no job moves from a queue to a worker while we look for it
+  for (auto& queue : m_queues)
+    queue->m_section.lock();
+
+  for (unsigned int index = 0; index < m_queues.size(); ++index)
+  {
+    CWorkQueue &queue = *m_queues[index];
+    bool found = false;
+    for (unsigned int priority = CJob::PRIORITY_LOW_PAUSABLE; priority <= CJob::PRIORITY_HIGH && !found; ++priority)
     {
-      delete i->m_job;
-      m_jobQueue[priority].erase(i);
-      return;
+      JobQueue::iterator j = find(queue.m_jobs[priority].begin(), queue.m_jobs[priority].end(), jobID);
+      if (j != queue.m_jobs[priority].end())
+      {
+        delete j->m_job;
+        queue.m_jobs[priority].erase(j);
+        --queue.m_queued[priority];
+        --GetPool(index).m_queued;
+        found = true;
+      }
     }
+    if (!found)
+    {
+      CSingleLock processingLock(queue.m_processingSection);
+      if (queue.m_processing.m_job && queue.m_processing == jobID)
+      {
+        queue.m_processing.m_callback = NULL;
+        found = true;
+      }
+    }
+    if (found)
+      break;
   }
-  // or if we're processing it
-  Processing::iterator it = find(m_processing.begin(), m_processing.end(), jobID);
-  if (it != m_processing.end())
-    it->m_callback = NULL; // job is in progress, so only thing to do is to remove callback
+
+  for (auto& queue : m_queues)
+    queue->m_section.unlock();
 }
 
-void CJobManager::StartWorkers(CJob::PRIORITY priority)
+CJobManager::CPool &CJobManager::GetPool(int queue)
+{
+  return static_cast<unsigned int>(queue) < m_ioPool.m_first ? m_computePool : m_ioPool;
+}
+
+void CJobManager::StartWorker(CPool &pool, unsigned int queue)
 {
   CSingleLock lock(m_section);
 
-  // check how many free threads we have
-  if (m_processing.size() >= GetMaxWorkers(priority))
+  if (!m_running)
     return;
 
-  // do we have any sleeping threads?
-  if (m_processing.size() < m_workers.size())
+  // prefer the given queue, otherwise any queue of the pool that has no worker
+  for (unsigned int i = 0; i < pool.m_size; ++i)
   {
-    m_jobEvent.Set();
-    return;
+    unsigned int index = pool.m_first + (queue - pool.m_first + i) % pool.m_size;
+    if (!m_queues[index]->m_worker)
+    {
+      ++pool.m_workers;
+      m_workers.push_back(new CJobWorker(this, index));
+      m_queues[index]->m_worker = m_workers.back();
+      return;
+    }
   }
+}
 
-  // everyone is busy - we need more workers
-  m_workers.push_back(new CJobWorker(this));
+void CJobManager::WakeWorkers()
+{
+  m_computePool.m_jobEvent.Set();
+  m_ioPool.m_jobEvent.Set();
+  m_jobEvent.Set();
 }
 
-CJob *CJobManager::PopJob()
+CJob *CJobManager::PopJob(int queue)
 {
-  CSingleLock lock(m_section);
-  for (int priority = CJob::PRIORITY_DEDICATED; priority >= CJob::PRIORITY_LOW_PAUSABLE; --priority)
+  CPool &pool = GetPool(queue);
+  if (!pool.m_queued)
+    return NULL;
+
+  // the number of busy workers decides which priorities may run
+  unsigned int processing = pool.m_processing;
+  for (int priority = CJob::PRIORITY_HIGH; priority >= CJob::PRIORITY_LOW_PAUSABLE; --priority)
   {
+    if (processing >= GetMaxWorkers(CJob::PRIORITY(priority), pool.m_size))
+      break;
+
     // Check whether we're pausing pausable jobs
     if (priority == CJob::PRIORITY_LOW_PAUSABLE && m_pauseJobs)
       continue;
 
-    if (m_jobQueue[priority].size() && m_processing.size() < GetMaxWorkers(CJob::PRIORITY(priority)))
+    // try our own queue first, then steal from the other workers of the pool
+    for (unsigned int i = 0; i < pool.m_size; ++i)
     {
-      // pop the job off the queue
-      CWorkItem job = m_jobQueue[priority].front();
-      m_jobQueue[priority].pop_front();
+      CWorkQueue &victim = *m_queues[pool.m_first + (queue - pool.m_first + i) % pool.m_size];
+      if (!victim.m_queued[priority])
+        continue;
+
+      CSingleLock lock(victim.m_section);
+      JobQueue &jobs = victim.m_jobs[priority];
+      if (jobs.empty())
+        continue;
+
+      // claim a worker of the pool, unless others took the spare ones meanwhile
+      bool claimed = false;
+      while (!claimed && processing < GetMaxWorkers(CJob::PRIORITY(priority), pool.m_size))
+        claimed = pool.m_processing.compare_exchange_weak(processing, processing + 1);
+      if (!claimed)
+        break;
 
-      // add to the processing vector
-      m_processing.push_back(job);
+      // pop the job off the queue
+      CWorkItem job = jobs.front();
+      jobs.pop_front();
+      --victim.m_queued[priority];
+      --pool.m_queued;
+
+      // mark as processing before the queue is released, so CancelJob() always finds it
+      CWorkQueue &own = *m_queues[queue];
+      CSingleLock processingLock(own.m_processingSection);
+      own.m_processing = job;
       job.m_job->m_callback = this;
       return job.m_job;
     }
@@ -290,26 +447,61 @@ CJob *CJobManager::PopJob()
   return NULL;
 }
 
-void CJobManager::PauseJobs()
+CJob *CJobManager::PopDedicatedJob()
 {
   CSingleLock lock(m_section);
+  if (m_dedicatedQueue.empty())
+    return NULL;
+
+  // pop the job off the queue
+  CWorkItem job = m_dedicatedQueue.front();
+  m_dedicatedQueue.pop_front();
+
+  // add to the processing vector
+  m_dedicatedProcessing.push_back(job);
+  job.m_job->m_callback = this;
+  return job.m_job;
+}
+
+void CJobManager::PauseJobs()
+{
   m_pauseJobs = true;
 }
 
 void CJobManager::UnPauseJobs()
 {
-  CSingleLock lock(m_section);
   m_pauseJobs = false;
+  ResumeWorkers(m_computePool);
+  ResumeWorkers(m_ioPool);
 }
 
-bool CJobManager::IsProcessing(const CJob::PRIORITY &priority) const
+void CJobManager::ResumeWorkers(CPool &pool)
 {
-  CSingleLock lock(m_section);
+  // the jobs held back while paused may be waiting in any queue of the pool.
+  // m_jobEvent is an auto-reset event, so set it for every idle worker rather
+  // than once, and start workers for the jobs the idle ones can't take.
+  for (unsigned int idle = pool.m_idle; idle > 0; --idle)
+    pool.m_jobEvent.Set();
+
+  const unsigned int wanted = std::min<unsigned int>(pool.m_queued, pool.m_size);
+  for (unsigned int i = pool.m_workers; i < wanted; ++i)
+    StartWorker(pool, pool.m_first + i);
+}
 
+bool CJobManager::IsProcessing(const CJob::PRIORITY &priority) const
+{
   if (m_pauseJobs)
     return false;
 
-  for(Processing::const_iterator it = m_processing.begin(); it < m_processing.end(); ++it)
+  for (const auto& queue : m_queues)
+  {
+    CSingleLock lock(queue->m_processingSection);
+    if (queue->m_processing.m_job && priority == queue->m_processing.m_priority)
+      return true;
+  }
+
+  CSingleLock lock(m_section);
+  for(Processing::const_iterator it = m_dedicatedProcessing.begin(); it < m_dedicatedProcessing.end(); ++it)
   {
     if (priority == it->m_priority)
       return true;
@@ -320,12 +512,19 @@ bool CJobManager::IsProcessing(const CJob::PRIORITY &priority) const
 int CJobManager::IsProcessing(const std::string &type) const
 {
   int jobsMatched = 0;
-  CSingleLock lock(m_section);
 
   if (m_pauseJobs)
     return 0;
 
-  for(Processing::const_iterator it = m_processing.begin(); it < m_processing.end(); ++it)
+  for (const auto& queue : m_queues)
+  {
+    CSingleLock lock(queue->m_processingSection);
+    if (queue->m_processing.m_job && type == std::string(queue->m_processing.m_job->GetType()))
+      jobsMatched++;
+  }
+
+  CSingleLock lock(m_section);
+  for(Processing::const_iterator it = m_dedicatedProcessing.begin(); it < m_dedicatedProcessing.end(); ++it)
   {
     if (type == std::string(it->m_job->GetType()))
       jobsMatched++;
@@ -333,25 +532,78 @@ int CJobManager::IsProcessing(const std::string &type) const
   return jobsMatched;
 }
 
-CJob *CJobManager::GetNextJob(const CJobWorker *worker)
+CJob *CJobManager::GetNextJob(CJobWorker *worker)
+{
+  if (worker->m_queue < 0)
+    return GetNextDedicatedJob(worker);
+
+  CPool &pool = GetPool(worker->m_queue);
+  CWorkQueue &queue = *m_queues[worker->m_queue];
+  while (m_running)
+  {
+    // grab a job off the queues if we have one
+    CJob *job = PopJob(worker->m_queue);
+    if (job)
+      return job;
+
+    // announce we're idle before checking again, so either AddJob() sees us or we see its job
+    ++pool.m_idle;
+    job = PopJob(worker->m_queue);
+    if (job)
+    {
+      --pool.m_idle;
+      return job;
+    }
+
+    // no jobs are left - sleep for 30 seconds to allow new jobs to come in
+    bool newJob = pool.m_jobEvent.WaitMSec(WORKER_IDLE_TIMEOUT);
+    --pool.m_idle;
+    if (!newJob)
+    {
+      // leave, unless jobs were queued in the meantime. AddJob() only starts
+      // a worker if it sees all workers busy, so it either sees us gone or
+      // we see its job.
+      CSingleLock lock(m_section);
+      --pool.m_workers;
+      if (!pool.m_queued)
+      {
+        queue.m_worker = nullptr;
+        RemoveWorker(worker);
+        return NULL;
+      }
+      ++pool.m_workers;
+    }
+  }
+
+  // have no jobs
+  CSingleLock lock(m_section);
+  queue.m_worker = nullptr;
+  --pool.m_workers;
+  RemoveWorker(worker);
+  return NULL;
+}
+
+CJob *CJobManager::GetNextDedicatedJob(const CJobWorker *worker)
 {
   CSingleLock lock(m_section);
   while (m_running)
   {
     // grab a job off the queue if we have one
-    CJob *job = PopJob();
+    CJob *job = PopDedicatedJob();
     if (job)
       return job;
     // no jobs are left - sleep for 30 seconds to allow new jobs to come in
+    m_dedicatedIdle++;
     lock.Leave();
-    bool newJob = m_jobEvent.WaitMSec(30000);
+    bool newJob = m_jobEvent.WaitMSec(WORKER_IDLE_TIMEOUT);
     lock.Enter();
+    m_dedicatedIdle--;
     if (!newJob)
       break;
   }
   // ensure no jobs have come in during the period after
   // timeout and before we held the lock
-  CJob *job = PopJob();
+  CJob *job = PopDedicatedJob();
   if (job)
     return job;
   // have no jobs
@@ -359,50 +611,94 @@ CJob *CJobManager::GetNextJob(const CJobWorker *worker)
   return NULL;
 }
 
-bool CJobManager::OnJobProgress(unsigned int progress, unsigned int total, const CJob *job) const
+bool CJobManager::FindProcessing(const CJob *job, CWorkItem &item) const
 {
-  CSingleLock lock(m_section);
-  // find the job in the processing queue, and check whether it's cancelled (no callback)
-  Processing::const_iterator i = find(m_processing.begin(), m_processing.end(), job);
-  if (i != m_processing.end())
+  // the job usually asks from its worker thread, so look there first
+  const CJobWorker *worker = currentWorker;
+  if (worker && worker->m_jobManager == this && worker->m_queue >= 0)
   {
-    CWorkItem item(*i);
-    lock.Leave(); // leave section prior to call
-    if (item.m_callback)
+    const CWorkQueue &queue = *m_queues[worker->m_queue];
+    CSingleLock lock(queue.m_processingSection);
+    if (queue.m_processing.m_job && queue.m_processing == job)
     {
-      item.m_callback->OnJobProgress(item.m_id, progress, total, job);
-      return false;
+      item = queue.m_processing;
+      return true;
+    }
+  }
+
+  for (const auto& queue : m_queues)
+  {
+    CSingleLock lock(queue->m_processingSection);
+    if (queue->m_processing.m_job && queue->m_processing == job)
+    {
+      item = queue->m_processing;
+      return true;
     }
   }
+
+  CSingleLock lock(m_section);
+  Processing::const_iterator i = find(m_dedicatedProcessing.begin(), m_dedicatedProcessing.end(), job);
+  if (i != m_dedicatedProcessing.end())
+  {
+    item = *i;
+    return true;
+  }
+  return false;
+}
+
+bool CJobManager::OnJobProgress(unsigned int progress, unsigned int total, const CJob *job) const
+{
+  // find the job in the processing queue, and check whether it's cancelled (no callback)
+  CWorkItem item;
+  if (FindProcessing(job, item) && item.m_callback)
+  {
+    item.m_callback->OnJobProgress(item.m_id, progress, total, job);
+    return false;
+  }
   return true; // couldn't find the job, or it's been cancelled
 }
 
-void CJobManager::OnJobComplete(bool success, CJob *job)
+void CJobManager::OnJobComplete(bool success, CJob *job, const CJobWorker *worker)
 {
-  CSingleLock lock(m_section);
+  CWorkItem item;
+  if (worker->m_queue >= 0)
+  {
+    CWorkQueue &queue = *m_queues[worker->m_queue];
+    CSingleLock lock(queue.m_processingSection);
+    item = queue.m_processing;
+  }
+  else if (!FindProcessing(job, item))
+    return;
+
+  // tell any listeners we're done with the job, then delete it
+  try
+  {
+    if (item.m_callback)
+      item.m_callback->OnJobComplete(item.m_id, success, item.m_job);
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s error processing job %s", __FUNCTION__, item.m_job->GetType());
+  }
+
   // remove the job from the processing queue
-  Processing::iterator i = find(m_processing.begin(), m_processing.end(), job);
-  if (i != m_processing.end())
+  if (worker->m_queue >= 0)
   {
-    // tell any listeners we're done with the job, then delete it
-    CWorkItem item(*i);
-    lock.Leave();
-    try
+    CWorkQueue &queue = *m_queues[worker->m_queue];
     {
-      if (item.m_callback)
-        item.m_callback->OnJobComplete(item.m_id, success, item.m_job);
+      CSingleLock lock(queue.m_processingSection);
+      queue.m_processing = CWorkItem();
     }
-    catch (...)
-    {
-      CLog::Log(LOGERROR, "%s error processing job %s", __FUNCTION__, item.m_job->GetType());
-    }
-    lock.Enter();
-    Processing::iterator j = find(m_processing.begin(), m_processing.end(), job);
-    if (j != m_processing.end())
-      m_processing.erase(j);
-    lock.Leave();
-    item.FreeJob();
+    --GetPool(worker->m_queue).m_processing;
   }
+  else
+  {
+    CSingleLock lock(m_section);
+    Processing::iterator j = find(m_dedicatedProcessing.begin(), m_dedicatedProcessing.end(), job);
+    if (j != m_dedicatedProcessing.end())
+      m_dedicatedProcessing.erase(j);
+  }
+  item.FreeJob();
 }
 
 void CJobManager::RemoveWorker(const CJobWorker *worker)
@@ -414,10 +710,9 @@ void CJobManager::RemoveWorker(const CJobWorker *worker)
     m_workers.erase(i); // workers auto-delete
 }
 
-unsigned int CJobManager::GetMaxWorkers(CJob::PRIORITY priority)
+unsigned int CJobManager::GetMaxWorkers(CJob::PRIORITY priority, unsigned int poolSize)
 {
-  static const unsigned int max_workers = 5;
-  if (priority == CJob::PRIORITY_DEDICATED)
-    return 10000; // A large number..
-  return max_workers - (CJob::PRIORITY_HIGH - priority);
+  // keep a worker free for each higher priority
+  unsigned int reserved = CJob::PRIORITY_HIGH - priority;
+  return poolSize > reserved ? poolSize - reserved : 1;
 }
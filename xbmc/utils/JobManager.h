@@ -8,10 +8,13 @@
 
 #pragma once
 
+#include <atomic>
+#include <memory>
 #include <queue>
 #include <vector>
 #include <string>
 #include "threads/CriticalSection.h"
+#include "threads/Event.h"
 #include "threads/Thread.h"
 #include "Job.h"
 
@@ -20,12 +23,17 @@ class CJobManager;
 class CJobWorker : public CThread
 {
 public:
-  explicit CJobWorker(CJobManager *manager);
+  /*!
+   \param queue index of the work queue owned by this worker, -1 for a dedicated worker
+   */
+  CJobWorker(CJobManager *manager, int queue);
   ~CJobWorker() override;
 
   void Process() override;
 private:
+  friend class CJobManager;
   CJobManager  *m_jobManager;
+  int           m_queue;
 };
 
 template<typename F>
@@ -186,6 +194,15 @@ private:
  priority levels.  Lower priority jobs are executed only if there are sufficient
  spare worker threads free to allow for higher priority jobs that may arise.
 
+ Jobs run on one of two fixed size pools, selected by CJob::GetAffinity(): a pool
+ sized to the number of cores and a pool for jobs that mostly wait on I/O. Every
+ worker of a pool owns a work queue. Jobs added by a worker go to its own queue,
+ other jobs are spread over the queues of the pool, and idle workers steal jobs
+ from the queues of the other workers. Workers are started when needed and exit
+ when idle for a while, so at most max(cores, 4) + 8 pool workers run at the
+ same time, with none left once the system is idle. PRIORITY_DEDICATED jobs are run by separate workers that
+ are started whenever no dedicated worker is free.
+
  \sa CJob and IJobCallback
  */
 class CJobManager final
@@ -193,6 +210,7 @@ class CJobManager final
   class CWorkItem
   {
   public:
+    CWorkItem() : CWorkItem(nullptr, 0, CJob::PRIORITY_LOW, nullptr) {}
     CWorkItem(CJob *job, unsigned int id, CJob::PRIORITY priority, IJobCallback *callback)
     {
       m_job = job;
@@ -223,6 +241,49 @@ class CJobManager final
     CJob::PRIORITY m_priority;
   };
 
+  typedef std::deque<CWorkItem>    JobQueue;
+  typedef std::vector<CWorkItem>   Processing;
+  typedef std::vector<CJobWorker*> Workers;
+
+  /*!
+   \brief Jobs queued on, and the job processed by, a single pool worker
+   Lock order is CJobManager::m_section, m_section, m_processingSection.
+   */
+  class CWorkQueue
+  {
+  public:
+    CWorkQueue()
+    {
+      for (auto& queued : m_queued)
+        queued = 0;
+    }
+
+    CCriticalSection m_section;
+    JobQueue m_jobs[CJob::PRIORITY_HIGH + 1];
+    std::atomic<unsigned int> m_queued[CJob::PRIORITY_HIGH + 1];
+
+    mutable CCriticalSection m_processingSection;
+    CWorkItem m_processing; ///< m_job is NULL while idle
+
+    const CJobWorker *m_worker = nullptr; ///< worker owning the queue, guarded by CJobManager::m_section
+  };
+
+  /*!
+   \brief A group of workers sharing jobs by stealing from each other
+   */
+  class CPool
+  {
+  public:
+    unsigned int m_first = 0; ///< index of the first queue of the pool
+    unsigned int m_size = 0;
+    std::atomic<unsigned int> m_queued{0};
+    std::atomic<unsigned int> m_processing{0};
+    std::atomic<unsigned int> m_idle{0};
+    std::atomic<unsigned int> m_workers{0};
+    std::atomic<unsigned int> m_next{0};
+    CEvent m_jobEvent;
+  };
+
 public:
   /*!
    \brief The only way through which the global instance of the CJobManager should be accessed.
@@ -297,6 +358,7 @@ public:
 
   /*!
    \brief Resumes queueing of (previously paused) jobs with priority PRIORITY_LOW_PAUSABLE
+   Wakes all idle workers, so jobs held back in any queue are picked up at once.
    \sa PauseJobs()
    */
   void UnPauseJobs();
@@ -318,16 +380,17 @@ protected:
    \param worker a pointer to the current CJobWorker instance requesting a job.
    \sa CJob
    */
-  CJob *GetNextJob(const CJobWorker *worker);
+  CJob *GetNextJob(CJobWorker *worker);
 
   /*!
    \brief Callback from CJobWorker after a job has completed.
    Calls IJobCallback::OnJobComplete(), and then destroys job.
    \param job a pointer to the calling subclassed CJob instance.
    \param success the result from the DoWork call
+   \param worker the worker that processed the job
    \sa IJobCallback, CJob
    */
-  void  OnJobComplete(bool success, CJob *job);
+  void  OnJobComplete(bool success, CJob *job, const CJobWorker *worker);
 
   /*!
    \brief Callback from CJob to report progress and check for cancellation.
@@ -346,27 +409,41 @@ private:
   CJobManager(const CJobManager&) = delete;
   CJobManager const& operator=(CJobManager const&) = delete;
 
-  /*! \brief Pop a job off the job queue and add to the processing queue ready to process
+  /*! \brief Pop a job off the queues of the worker's pool, stealing from other workers if needed,
+   and mark it as processed by the worker.
+   \return the job to process, NULL if no jobs are available
+   */
+  CJob *PopJob(int queue);
+
+  /*! \brief Pop a job off the dedicated job queue and add to the processing queue ready to process
    \return the job to process, NULL if no jobs are available
    */
-  CJob *PopJob();
+  CJob *PopDedicatedJob();
 
-  void StartWorkers(CJob::PRIORITY priority);
+  CJob *GetNextDedicatedJob(const CJobWorker *worker);
+  bool FindProcessing(const CJob *job, CWorkItem &item) const;
+
+  CPool &GetPool(int queue);
+  void StartWorker(CPool &pool, unsigned int queue);
+  void WakeWorkers();
+  void ResumeWorkers(CPool &pool);
   void RemoveWorker(const CJobWorker *worker);
-  static unsigned int GetMaxWorkers(CJob::PRIORITY priority);
+  static unsigned int GetMaxWorkers(CJob::PRIORITY priority, unsigned int poolSize);
 
-  unsigned int m_jobCounter;
+  std::atomic<unsigned int> m_jobCounter;
 
-  typedef std::deque<CWorkItem>    JobQueue;
-  typedef std::vector<CWorkItem>   Processing;
-  typedef std::vector<CJobWorker*> Workers;
+  CPool      m_computePool;
+  CPool      m_ioPool;
+  std::vector<std::unique_ptr<CWorkQueue>> m_queues;
 
-  JobQueue   m_jobQueue[CJob::PRIORITY_DEDICATED + 1];
-  bool       m_pauseJobs;
-  Processing m_processing;
+  JobQueue   m_dedicatedQueue;
+  Processing m_dedicatedProcessing;
+  unsigned int m_dedicatedIdle;
   Workers    m_workers;
 
+  std::atomic<bool> m_pauseJobs;
+
   mutable CCriticalSection m_section;
-  CEvent           m_jobEvent;
-  bool             m_running;
+  CEvent           m_jobEvent; ///< wakes dedicated workers
+  std::atomic<bool> m_running;
 };
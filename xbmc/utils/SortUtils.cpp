@@ -10,12 +10,20 @@
 #include "LangInfo.h"
 #include "URL.h"
 #include "Util.h"
+#include "threads/Event.h"
 #include "utils/CharsetConverter.h"
+#include "utils/JobManager.h"
 #include "utils/StringUtils.h"
 #include "utils/Variant.h"
 #include "utils/log.h"
 
 #include <algorithm>
+#include <atomic>
+#include <functional>
+#include <locale>
+#include <memory>
+#include <thread>
+#include <unordered_map>
 
 std::string ArrayToString(SortAttribute attributes, const CVariant &variant, const std::string &separator = " / ")
 {
@@ -423,132 +431,368 @@ std::string ByLastUsed(SortAttribute attributes, const SortItem &values)
   return values.at(FieldLastUsed).asString();
 }
 
-bool preliminarySort(const SortItem &left, const SortItem &right, bool handleFolder, bool &result, std::wstring &labelLeft, std::wstring &labelRight)
+namespace
 {
-  // make sure both items have the necessary data to do the sorting
-  SortItem::const_iterator itLeftSort, itRightSort;
-  if ((itLeftSort = left.find(FieldSort)) == left.end())
-  {
-    result = false;
-    return true;
-  }
-  if ((itRightSort = right.find(FieldSort)) == right.end())
+
+//! inputs of at least this size are sorted in chunks on the compute workers
+const size_t PARALLEL_SORT_THRESHOLD = 20000;
+const unsigned int MAX_SORT_CHUNKS = 8;
+
+/*!
+ \brief A piece of a sort label, either a single character or a run of up to 15 digits
+
+ Splitting the labels up front and replacing every character by its collation
+ weight lets the comparisons during the sort run without any locale lookups,
+ while giving the same order as StringUtils::AlphaNumericCompare.
+
+ Characters are stored as their weight. Digit runs have TOKEN_NUMBER set, their
+ value in the lowest 50 bits and their first digit above it.
+ */
+typedef uint64_t SortToken;
+
+const SortToken TOKEN_NUMBER = 1ULL << 63;
+const unsigned int TOKEN_DIGIT_SHIFT = 50;
+const SortToken TOKEN_VALUE_MASK = (1ULL << TOKEN_DIGIT_SHIFT) - 1;
+
+//! everything needed to compare an item, extracted once from its SortItem
+struct SortKey
+{
+  const CVariant *label = nullptr; ///< FieldSort of the item, nullptr if not set
+  int special = 1; ///< 0: sorted on top, 1: no special sorting, 2: sorted on bottom
+  int folder = -1; ///< -1: unknown, 0: file, 1: folder
+  std::vector<SortToken> tokens;
+};
+
+inline wchar_t FoldCase(wchar_t c)
+{
+  // same case folding as StringUtils::AlphaNumericCompare
+  return (c >= L'A' && c <= L'Z') ? c + (L'a' - L'A') : c;
+}
+
+inline bool IsDigit(wchar_t c)
+{
+  return c >= L'0' && c <= L'9';
+}
+
+/*!
+ \brief Collation weights of all characters used in a set of labels
+
+ Two characters get the same weight if the locale collates them equal, a lower
+ weight if it collates them before.
+ */
+class CCollationWeights
+{
+public:
+  void Add(const std::wstring &label)
   {
-    result = true;
-    return true;
+    for (wchar_t c : label)
+      m_weights.insert(std::make_pair(FoldCase(c), 0));
   }
 
-  // look at special sorting behaviour
-  SortItem::const_iterator itLeft, itRight;
-  SortSpecial leftSortSpecial = SortSpecialNone;
-  SortSpecial rightSortSpecial = SortSpecialNone;
-  if ((itLeft = left.find(FieldSortSpecial)) != left.end() && itLeft->second.asInteger() <= (int64_t)SortSpecialOnBottom)
-    leftSortSpecial = (SortSpecial)itLeft->second.asInteger();
-  if ((itRight = right.find(FieldSortSpecial)) != right.end() && itRight->second.asInteger() <= (int64_t)SortSpecialOnBottom)
-    rightSortSpecial = (SortSpecial)itRight->second.asInteger();
-
-  // one has a special sort
-  if (leftSortSpecial != rightSortSpecial)
+  void Build()
   {
-    // left should be sorted on top
-    // or right should be sorted on bottom
-    // => left is sorted above right
-    if (leftSortSpecial == SortSpecialOnTop ||
-        rightSortSpecial == SortSpecialOnBottom)
+    std::vector<wchar_t> chars;
+    chars.reserve(m_weights.size());
+    for (const auto &weight : m_weights)
+      chars.push_back(weight.first);
+
+    const std::collate<wchar_t>& coll = std::use_facet<std::collate<wchar_t> >(g_langInfo.GetSystemLocale());
+    auto compare = [&coll](wchar_t left, wchar_t right)
+    {
+      return coll.compare(&left, &left + 1, &right, &right + 1);
+    };
+    std::sort(chars.begin(), chars.end(), [&compare](wchar_t left, wchar_t right)
+    {
+      return compare(left, right) < 0;
+    });
+
+    uint32_t weight = 0;
+    for (size_t i = 0; i < chars.size(); i++)
     {
-      result = true;
-      return true;
+      if (i > 0 && compare(chars[i - 1], chars[i]) != 0)
+        weight++;
+      m_weights[chars[i]] = weight;
     }
 
-    // otherwise right is sorted above left
-    result = false;
-    return true;
+    for (wchar_t digit = L'0'; digit <= L'9'; digit++)
+    {
+      auto it = m_weights.find(digit);
+      m_digitWeights[digit - L'0'] = it != m_weights.end() ? it->second : 0;
+    }
   }
-  // both have either sort on top or sort on bottom -> leave as-is
-  else if (leftSortSpecial != SortSpecialNone && leftSortSpecial == rightSortSpecial)
+
+  //! collation weight of a token, for digit runs the one of their first digit
+  uint32_t GetWeight(SortToken token) const
   {
-    result = false;
-    return true;
+    if (token & TOKEN_NUMBER)
+      return m_digitWeights[(token & ~TOKEN_NUMBER) >> TOKEN_DIGIT_SHIFT];
+    return static_cast<uint32_t>(token);
   }
 
-  if (handleFolder)
+  void Tokenize(const std::wstring &label, std::vector<SortToken> &tokens) const
   {
-    itLeft = left.find(FieldFolder);
-    itRight = right.find(FieldFolder);
-    if (itLeft != left.end() && itRight != right.end() &&
-        itLeft->second.asBoolean() != itRight->second.asBoolean())
+    tokens.clear();
+    const wchar_t *c = label.c_str();
+    while (*c != 0)
     {
-      result = itLeft->second.asBoolean();
-      return true;
+      if (IsDigit(*c))
+      {
+        // compare only up to 15 digits
+        SortToken token = TOKEN_NUMBER | (static_cast<SortToken>(*c - L'0') << TOKEN_DIGIT_SHIFT);
+        SortToken number = 0;
+        const wchar_t *start = c;
+        while (IsDigit(*c) && c < start + 15)
+          number = number * 10 + (*c++ - L'0');
+        tokens.push_back(token | number);
+      }
+      else
+        tokens.push_back(m_weights.at(FoldCase(*c++)));
     }
+    tokens.shrink_to_fit();
   }
 
-  labelLeft = itLeftSort->second.asWideString();
-  labelRight = itRightSort->second.asWideString();
-
-  return false;
-}
+private:
+  std::unordered_map<wchar_t, uint32_t> m_weights;
+  uint32_t m_digitWeights[10];
+};
 
-bool SorterAscending(const SortItem &left, const SortItem &right)
+//! same result as the sign of StringUtils::AlphaNumericCompare() on the labels
+int CompareLabels(const SortKey &left, const SortKey &right, const CCollationWeights &weights)
 {
-  bool result;
-  std::wstring labelLeft, labelRight;
-  if (preliminarySort(left, right, true, result, labelLeft, labelRight))
-    return result;
+  size_t count = std::min(left.tokens.size(), right.tokens.size());
+  for (size_t i = 0; i < count; i++)
+  {
+    SortToken l = left.tokens[i];
+    SortToken r = right.tokens[i];
+    if (l == r)
+      continue;
 
-  return StringUtils::AlphaNumericCompare(labelLeft.c_str(), labelRight.c_str()) < 0;
-}
+    if ((l & TOKEN_NUMBER) && (r & TOKEN_NUMBER))
+    {
+      if ((l & TOKEN_VALUE_MASK) != (r & TOKEN_VALUE_MASK))
+        return (l & TOKEN_VALUE_MASK) < (r & TOKEN_VALUE_MASK) ? -1 : 1;
+      continue;
+    }
 
-bool SorterDescending(const SortItem &left, const SortItem &right)
-{
-  bool result;
-  std::wstring labelLeft, labelRight;
-  if (preliminarySort(left, right, true, result, labelLeft, labelRight))
-    return result;
+    uint32_t leftWeight = weights.GetWeight(l);
+    uint32_t rightWeight = weights.GetWeight(r);
+    if (leftWeight != rightWeight)
+      return leftWeight < rightWeight ? -1 : 1;
+    if ((l & TOKEN_NUMBER) != (r & TOKEN_NUMBER))
+    {
+      // a digit collating equal to another character, the digit runs no longer line up
+      int64_t result = StringUtils::AlphaNumericCompare(left.label->asWideString().c_str(),
+                                                         right.label->asWideString().c_str());
+      return result < 0 ? -1 : (result > 0 ? 1 : 0);
+    }
+  }
 
-  return StringUtils::AlphaNumericCompare(labelLeft.c_str(), labelRight.c_str()) > 0;
+  if (right.tokens.size() > count)
+    return -1;
+  if (left.tokens.size() > count)
+    return 1;
+  return 0;
 }
 
-bool SorterIgnoreFoldersAscending(const SortItem &left, const SortItem &right)
+/*!
+ \brief Orders item indices by their sort keys
+
+ Items that compare equal are kept in their original order, so this is a
+ strict total order and any sort algorithm gives the result of a stable sort.
+ */
+class CSortKeyComparator
 {
-  bool result;
-  std::wstring labelLeft, labelRight;
-  if (preliminarySort(left, right, false, result, labelLeft, labelRight))
-    return result;
+public:
+  CSortKeyComparator(const std::vector<SortKey> &keys, const CCollationWeights &weights, bool descending, bool handleFolder)
+    : m_keys(keys), m_weights(weights), m_descending(descending), m_handleFolder(handleFolder)
+  {
+  }
 
-  return StringUtils::AlphaNumericCompare(labelLeft.c_str(), labelRight.c_str()) < 0;
-}
+  bool operator()(size_t leftIndex, size_t rightIndex) const
+  {
+    const SortKey &left = m_keys[leftIndex];
+    const SortKey &right = m_keys[rightIndex];
+
+    // items without the necessary data to do the sorting go last
+    if ((left.label != nullptr) != (right.label != nullptr))
+      return left.label != nullptr;
+    if (!left.label)
+      return leftIndex < rightIndex;
+
+    // look at special sorting behaviour, both sorted on top or bottom -> leave as-is
+    if (left.special != right.special)
+      return left.special < right.special;
+    if (left.special != 1)
+      return leftIndex < rightIndex;
+
+    if (m_handleFolder && left.folder >= 0 && right.folder >= 0 && left.folder != right.folder)
+      return left.folder > right.folder;
+
+    int result = CompareLabels(left, right, m_weights);
+    if (result != 0)
+      return m_descending ? result > 0 : result < 0;
+    return leftIndex < rightIndex;
+  }
 
-bool SorterIgnoreFoldersDescending(const SortItem &left, const SortItem &right)
+private:
+  const std::vector<SortKey> &m_keys;
+  const CCollationWeights &m_weights;
+  bool m_descending;
+  bool m_handleFolder;
+};
+
+/*!
+ \brief Run tasks on the compute workers and wait for all of them
+ Tasks no worker has picked up yet are run by the caller instead of waiting for a
+ free worker, so this can't deadlock when called from a busy or single worker.
+ */
+void RunOnComputeWorkers(const std::vector<std::function<void()>> &tasks)
 {
-  bool result;
-  std::wstring labelLeft, labelRight;
-  if (preliminarySort(left, right, false, result, labelLeft, labelRight))
-    return result;
+  // jobs that start after the caller ran their task only touch the shared state
+  struct CTasks
+  {
+    explicit CTasks(const std::vector<std::function<void()>> &tasks)
+      : tasks(tasks), claimed(tasks.size()), remaining(static_cast<unsigned int>(tasks.size()))
+    {
+    }
 
-  return StringUtils::AlphaNumericCompare(labelLeft.c_str(), labelRight.c_str()) > 0;
+    void Run(size_t task)
+    {
+      if (claimed[task].exchange(true))
+        return;
+      tasks[task]();
+      if (--remaining == 0)
+        done.Set();
+    }
+
+    std::vector<std::function<void()>> tasks;
+    std::vector<std::atomic<bool>> claimed;
+    std::atomic<unsigned int> remaining;
+    CEvent done;
+  };
+
+  std::shared_ptr<CTasks> state = std::make_shared<CTasks>(tasks);
+  for (size_t i = 1; i < tasks.size(); i++)
+    CJobManager::GetInstance().Submit([state, i]() { state->Run(i); }, CJob::PRIORITY_HIGH);
+  for (size_t i = 0; i < tasks.size(); i++)
+    state->Run(i);
+  state->done.Wait();
 }
 
-bool SorterIndirectAscending(const SortItemPtr &left, const SortItemPtr &right)
+void ParallelSort(std::vector<size_t> &order, const CSortKeyComparator &comparator)
 {
-  return SorterAscending(*left, *right);
+  unsigned int chunks = std::min(std::max(std::thread::hardware_concurrency(), 1u), MAX_SORT_CHUNKS);
+  if (chunks < 2)
+  {
+    std::sort(order.begin(), order.end(), comparator);
+    return;
+  }
+
+  // sort equal sized chunks, then merge neighbouring chunks until one is left
+  std::vector<size_t> bounds;
+  for (unsigned int i = 0; i <= chunks; i++)
+    bounds.push_back(order.size() * i / chunks);
+
+  std::vector<std::function<void()>> tasks;
+  for (unsigned int i = 0; i < chunks; i++)
+  {
+    size_t first = bounds[i], last = bounds[i + 1];
+    tasks.push_back([&order, &comparator, first, last]()
+    {
+      std::sort(order.begin() + first, order.begin() + last, comparator);
+    });
+  }
+  RunOnComputeWorkers(tasks);
+
+  while (bounds.size() > 2)
+  {
+    std::vector<size_t> merged;
+    tasks.clear();
+    for (size_t i = 0; i + 2 < bounds.size(); i += 2)
+    {
+      size_t first = bounds[i], middle = bounds[i + 1], last = bounds[i + 2];
+      tasks.push_back([&order, &comparator, first, middle, last]()
+      {
+        std::inplace_merge(order.begin() + first, order.begin() + middle, order.begin() + last, comparator);
+      });
+      merged.push_back(first);
+    }
+    if (bounds.size() % 2 == 0)
+      merged.push_back(bounds[bounds.size() - 2]);
+    merged.push_back(bounds.back());
+
+    RunOnComputeWorkers(tasks);
+    bounds.swap(merged);
+  }
 }
 
-bool SorterIndirectDescending(const SortItemPtr &left, const SortItemPtr &right)
+inline const SortItem& GetSortItem(const SortItem &item)
 {
-  return SorterDescending(*left, *right);
+  return item;
 }
 
-bool SorterIndirectIgnoreFoldersAscending(const SortItemPtr &left, const SortItemPtr &right)
+inline const SortItem& GetSortItem(const SortItemPtr &item)
 {
-  return SorterIgnoreFoldersAscending(*left, *right);
+  return *item;
 }
 
-bool SorterIndirectIgnoreFoldersDescending(const SortItemPtr &left, const SortItemPtr &right)
+/*!
+ \brief Sort items on the label prepared under FieldSort
+ \param limitEnd if set, only the first limitEnd items need to be in order
+ */
+template<typename T>
+void SortByKeys(std::vector<T> &items, SortOrder sortOrder, SortAttribute attributes, int limitEnd)
 {
-  return SorterIgnoreFoldersDescending(*left, *right);
+  std::vector<SortKey> keys(items.size());
+  CCollationWeights weights;
+  for (size_t i = 0; i < items.size(); i++)
+  {
+    const SortItem &item = GetSortItem(items[i]);
+    SortKey &key = keys[i];
+
+    SortItem::const_iterator it;
+    if ((it = item.find(FieldSort)) == item.end())
+      continue;
+    key.label = &it->second;
+    weights.Add(key.label->asWideString());
+
+    if ((it = item.find(FieldSortSpecial)) != item.end() && it->second.asInteger() <= (int64_t)SortSpecialOnBottom)
+    {
+      SortSpecial special = (SortSpecial)it->second.asInteger();
+      key.special = special == SortSpecialOnTop ? 0 : (special == SortSpecialOnBottom ? 2 : 1);
+    }
+    if ((it = item.find(FieldFolder)) != item.end())
+      key.folder = it->second.asBoolean() ? 1 : 0;
+  }
+
+  weights.Build();
+  for (auto &key : keys)
+  {
+    if (key.label)
+      weights.Tokenize(key.label->asWideString(), key.tokens);
+  }
+
+  std::vector<size_t> order(items.size());
+  for (size_t i = 0; i < order.size(); i++)
+    order[i] = i;
+
+  CSortKeyComparator comparator(keys, weights, sortOrder == SortOrderDescending, !(attributes & SortAttributeIgnoreFolders));
+  if (limitEnd > 0 && (size_t)limitEnd < order.size())
+    std::partial_sort(order.begin(), order.begin() + limitEnd, order.end(), comparator);
+  else if (order.size() >= PARALLEL_SORT_THRESHOLD)
+    ParallelSort(order, comparator);
+  else
+    std::sort(order.begin(), order.end(), comparator);
+
+  std::vector<T> sorted;
+  sorted.reserve(items.size());
+  for (size_t index : order)
+    sorted.push_back(std::move(items[index]));
+  items.swap(sorted);
 }
 
+} // unnamed namespace
+
 std::map<SortBy, SortUtils::SortPreparator> fillPreparators()
 {
   std::map<SortBy, SortUtils::SortPreparator> preparators;
@@ -736,7 +980,7 @@ void SortUtils::Sort(SortBy sortBy, SortOrder sortOrder, SortAttribute attribute
       }
 
       // Do the sorting
-      std::stable_sort(items.begin(), items.end(), getSorter(sortOrder, attributes));
+      SortByKeys(items, sortOrder, attributes, limitEnd);
     }
   }
 
@@ -786,7 +1030,7 @@ void SortUtils::Sort(SortBy sortBy, SortOrder sortOrder, SortAttribute attribute
       }
 
       // Do the sorting
-      std::stable_sort(items.begin(), items.end(), getSorterIndirect(sortOrder, attributes));
+      SortByKeys(items, sortOrder, attributes, limitEnd);
     }
   }
 
@@ -839,22 +1083,6 @@ const SortUtils::SortPreparator& SortUtils::getPreparator(SortBy sortBy)
   return m_preparators[SortByNone];
 }
 
-SortUtils::Sorter SortUtils::getSorter(SortOrder sortOrder, SortAttribute attributes)
-{
-  if (attributes & SortAttributeIgnoreFolders)
-    return sortOrder == SortOrderDescending ? SorterIgnoreFoldersDescending : SorterIgnoreFoldersAscending;
-
-  return sortOrder == SortOrderDescending ? SorterDescending : SorterAscending;
-}
-
-SortUtils::SorterIndirect SortUtils::getSorterIndirect(SortOrder sortOrder, SortAttribute attributes)
-{
-  if (attributes & SortAttributeIgnoreFolders)
-    return sortOrder == SortOrderDescending ? SorterIndirectIgnoreFoldersDescending : SorterIndirectIgnoreFoldersAscending;
-
-  return sortOrder == SortOrderDescending ? SorterIndirectDescending : SorterIndirectAscending;
-}
-
 const Fields& SortUtils::GetFieldsForSorting(SortBy sortBy)
 {
   std::map<SortBy, Fields>::const_iterator it = m_sortingFields.find(sortBy);
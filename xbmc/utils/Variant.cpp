@@ -144,7 +144,7 @@ CVariant::CVariant(VariantType type)
       m_data.dvalue = 0.0;
       break;
     case VariantTypeString:
-      m_data.string = new std::string();
+      setString("", 0);
       break;
     case VariantTypeWideString:
       m_data.wstring = new std::wstring();
@@ -208,25 +208,25 @@ CVariant::CVariant(bool boolean)
 CVariant::CVariant(const char *str)
 {
   m_type = VariantTypeString;
-  m_data.string = new std::string(str);
+  setString(str, strlen(str));
 }
 
 CVariant::CVariant(const char *str, unsigned int length)
 {
   m_type = VariantTypeString;
-  m_data.string = new std::string(str, length);
+  setString(str, length);
 }
 
 CVariant::CVariant(const std::string &str)
 {
   m_type = VariantTypeString;
-  m_data.string = new std::string(str);
+  setString(str.c_str(), str.size());
 }
 
 CVariant::CVariant(std::string &&str)
 {
   m_type = VariantTypeString;
-  m_data.string = new std::string(std::move(str));
+  setString(std::move(str));
 }
 
 CVariant::CVariant(const wchar_t *str)
@@ -301,8 +301,11 @@ void CVariant::cleanup()
   switch (m_type)
   {
   case VariantTypeString:
-    delete m_data.string;
-    m_data.string = nullptr;
+    if (m_stringSize == HEAP_STRING)
+    {
+      delete m_data.string;
+      m_data.string = nullptr;
+    }
     break;
 
   case VariantTypeWideString:
@@ -325,6 +328,46 @@ void CVariant::cleanup()
   m_type = VariantTypeNull;
 }
 
+void CVariant::setString(const char *str, size_t length)
+{
+  if (length < SMALL_STRING_SIZE)
+  {
+    memcpy(m_data.smallString, str, length);
+    m_data.smallString[length] = '\0';
+    m_stringSize = length;
+  }
+  else
+  {
+    m_data.string = new std::string(str, length);
+    m_stringSize = HEAP_STRING;
+  }
+}
+
+void CVariant::setString(std::string &&str)
+{
+  if (str.size() < SMALL_STRING_SIZE)
+    setString(str.c_str(), str.size());
+  else
+  {
+    m_data.string = new std::string(std::move(str));
+    m_stringSize = HEAP_STRING;
+  }
+}
+
+const char *CVariant::stringData() const
+{
+  if (m_stringSize == HEAP_STRING)
+    return m_data.string->c_str();
+  return m_data.smallString;
+}
+
+size_t CVariant::stringSize() const
+{
+  if (m_stringSize == HEAP_STRING)
+    return m_data.string->size();
+  return m_stringSize;
+}
+
 bool CVariant::isInteger() const
 {
   return isSignedInteger() || isUnsignedInteger();
@@ -391,7 +434,7 @@ int64_t CVariant::asInteger(int64_t fallback) const
     case VariantTypeDouble:
       return (int64_t)m_data.dvalue;
     case VariantTypeString:
-      return str2int64(*m_data.string, fallback);
+      return str2int64(std::string(stringData(), stringSize()), fallback);
     case VariantTypeWideString:
       return str2int64(*m_data.wstring, fallback);
     default:
@@ -417,7 +460,7 @@ uint64_t CVariant::asUnsignedInteger(uint64_t fallback) const
     case VariantTypeDouble:
       return (uint64_t)m_data.dvalue;
     case VariantTypeString:
-      return str2uint64(*m_data.string, fallback);
+      return str2uint64(std::string(stringData(), stringSize()), fallback);
     case VariantTypeWideString:
       return str2uint64(*m_data.wstring, fallback);
     default:
@@ -443,7 +486,7 @@ double CVariant::asDouble(double fallback) const
     case VariantTypeUnsignedInteger:
       return (double)m_data.unsignedinteger;
     case VariantTypeString:
-      return str2double(*m_data.string, fallback);
+      return str2double(std::string(stringData(), stringSize()), fallback);
     case VariantTypeWideString:
       return str2double(*m_data.wstring, fallback);
     default:
@@ -464,7 +507,7 @@ float CVariant::asFloat(float fallback) const
     case VariantTypeUnsignedInteger:
       return (float)m_data.unsignedinteger;
     case VariantTypeString:
-      return (float)str2double(*m_data.string, fallback);
+      return (float)str2double(std::string(stringData(), stringSize()), fallback);
     case VariantTypeWideString:
       return (float)str2double(*m_data.wstring, fallback);
     default:
@@ -487,9 +530,12 @@ bool CVariant::asBoolean(bool fallback) const
     case VariantTypeDouble:
       return (m_data.dvalue != 0);
     case VariantTypeString:
-      if (m_data.string->empty() || m_data.string->compare("0") == 0 || m_data.string->compare("false") == 0)
+    {
+      const size_t size = stringSize();
+      if (size == 0 || (size == 1 && stringData()[0] == '0') || (size == 5 && memcmp(stringData(), "false", 5) == 0))
         return false;
       return true;
+    }
     case VariantTypeWideString:
       if (m_data.wstring->empty() || m_data.wstring->compare(L"0") == 0 || m_data.wstring->compare(L"false") == 0)
         return false;
@@ -506,7 +552,7 @@ std::string CVariant::asString(const std::string &fallback /* = "" */) const
   switch (m_type)
   {
     case VariantTypeString:
-      return *m_data.string;
+      return std::string(stringData(), stringSize());
     case VariantTypeBoolean:
       return m_data.boolean ? "true" : "false";
     case VariantTypeInteger:
@@ -606,7 +652,7 @@ CVariant &CVariant::operator=(const CVariant &rhs)
     m_data.dvalue = rhs.m_data.dvalue;
     break;
   case VariantTypeString:
-    m_data.string = new std::string(*rhs.m_data.string);
+    setString(rhs.stringData(), rhs.stringSize());
     break;
   case VariantTypeWideString:
     m_data.wstring = new std::wstring(*rhs.m_data.wstring);
@@ -629,27 +675,22 @@ CVariant& CVariant::operator=(CVariant&& rhs)
   if (m_type == VariantTypeConstNull || this == &rhs)
     return *this;
 
-  //Make sure that if we're moved into we don't leak any pointers
-  if (m_type != VariantTypeNull)
-    cleanup();
+  take(rhs);
 
+  return *this;
+}
+
+void CVariant::take(CVariant &rhs)
+{
+  cleanup();
+
+  // the storage is owned through plain pointers or held in place, so it can
+  // be taken over as is
   m_type = rhs.m_type;
-  m_data = std::move(rhs.m_data);
-
-  //Should be enough to just set m_type here
-  //but better safe than sorry, could probably lead to coverity warnings
-  if (rhs.m_type == VariantTypeString)
-    rhs.m_data.string = nullptr;
-  else if (rhs.m_type == VariantTypeWideString)
-    rhs.m_data.wstring = nullptr;
-  else if (rhs.m_type == VariantTypeArray)
-    rhs.m_data.array = nullptr;
-  else if (rhs.m_type == VariantTypeObject)
-    rhs.m_data.map = nullptr;
+  m_stringSize = rhs.m_stringSize;
+  m_data = rhs.m_data;
 
   rhs.m_type = VariantTypeNull;
-
-  return *this;
 }
 
 bool CVariant::operator==(const CVariant &rhs) const
@@ -667,7 +708,7 @@ bool CVariant::operator==(const CVariant &rhs) const
     case VariantTypeDouble:
       return m_data.dvalue == rhs.m_data.dvalue;
     case VariantTypeString:
-      return *m_data.string == *rhs.m_data.string;
+      return stringSize() == rhs.stringSize() && memcmp(stringData(), rhs.stringData(), stringSize()) == 0;
     case VariantTypeWideString:
       return *m_data.wstring == *rhs.m_data.wstring;
     case VariantTypeArray:
@@ -719,21 +760,17 @@ void CVariant::append(CVariant&& variant)
 const char *CVariant::c_str() const
 {
   if (m_type == VariantTypeString)
-    return m_data.string->c_str();
+    return stringData();
   else
     return NULL;
 }
 
 void CVariant::swap(CVariant &rhs)
 {
-  VariantType  temp_type = m_type;
-  VariantUnion temp_data = m_data;
-
-  m_type = rhs.m_type;
-  m_data = rhs.m_data;
-
-  rhs.m_type = temp_type;
-  rhs.m_data = temp_data;
+  CVariant temp;
+  temp.take(rhs);
+  rhs.take(*this);
+  take(temp);
 }
 
 CVariant::iterator_array CVariant::begin_array()
@@ -807,7 +844,7 @@ unsigned int CVariant::size() const
   else if (m_type == VariantTypeArray)
     return m_data.array->size();
   else if (m_type == VariantTypeString)
-    return m_data.string->size();
+    return stringSize();
   else if (m_type == VariantTypeWideString)
     return m_data.wstring->size();
   else
@@ -821,7 +858,7 @@ bool CVariant::empty() const
   else if (m_type == VariantTypeArray)
     return m_data.array->empty();
   else if (m_type == VariantTypeString)
-    return m_data.string->empty();
+    return stringSize() == 0;
   else if (m_type == VariantTypeWideString)
     return m_data.wstring->empty();
   else if (m_type == VariantTypeNull)
@@ -837,7 +874,12 @@ void CVariant::clear()
   else if (m_type == VariantTypeArray)
     m_data.array->clear();
   else if (m_type == VariantTypeString)
-    m_data.string->clear();
+  {
+    if (m_stringSize == HEAP_STRING)
+      m_data.string->clear();
+    else
+      setString("", 0);
+  }
   else if (m_type == VariantTypeWideString)
     m_data.wstring->clear();
 }
@@ -144,6 +144,19 @@ public:
 
 private:
   void cleanup();
+  void take(CVariant &rhs);
+
+  void setString(const char *str, size_t length);
+  void setString(std::string &&str);
+  const char *stringData() const;
+  size_t stringSize() const;
+
+  // strings shorter than SMALL_STRING_SIZE are stored in place to save an
+  // allocation per value, longer ones on the heap. m_stringSize holds the
+  // length of an in place string or HEAP_STRING.
+  static const size_t SMALL_STRING_SIZE = 23;
+  static const uint8_t HEAP_STRING = 0xFF;
+
   union VariantUnion
   {
     int64_t integer;
@@ -151,18 +164,22 @@ private:
     bool boolean;
     double dvalue;
     std::string *string;
+    char smallString[SMALL_STRING_SIZE];
     std::wstring *wstring;
     VariantArray *array;
     VariantMap *map;
   };
 
   VariantType m_type;
+  uint8_t m_stringSize;
   VariantUnion m_data;
 
   static VariantArray EMPTY_ARRAY;
   static VariantMap EMPTY_MAP;
 };
 
+static_assert(sizeof(CVariant) <= 32, "CVariant is copied around a lot, keep it small");
+
 #ifdef TARGET_WINDOWS_STORE
 #pragma pack(pop)
 #endif
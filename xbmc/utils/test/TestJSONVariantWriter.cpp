@@ -9,6 +9,9 @@
 #include "utils/JSONVariantWriter.h"
 #include "utils/Variant.h"
 
+#include <string>
+#include <vector>
+
 #include "gtest/gtest.h"
 
 TEST(TestJSONVariantWriter, CanWriteNull)
@@ -149,3 +152,49 @@ TEST(TestJSONVariantWriter, CanWriteArray)
   ASSERT_TRUE(CJSONVariantWriter::Write(variant, str, false));
   ASSERT_STREQ("[\n\t{\n\t\t\"foo\": \"bar\"\n\t}\n]", str.c_str());
 }
+
+TEST(TestJSONStreamWriter, WritesInParts)
+{
+  std::vector<std::string> parts;
+  CJSONStreamWriter writer([&parts](const char *data, size_t size)
+  {
+    parts.emplace_back(data, size);
+    return true;
+  }, true, 16);
+
+  CVariant item;
+  item["label"] = "some item label";
+
+  ASSERT_TRUE(writer.StartObject());
+  ASSERT_TRUE(writer.Key("items"));
+  ASSERT_TRUE(writer.StartArray());
+  for (int i = 0; i < 3; i++)
+    ASSERT_TRUE(writer.Write(item));
+  ASSERT_TRUE(writer.EndArray());
+  ASSERT_TRUE(writer.EndObject());
+  ASSERT_TRUE(writer.Flush());
+
+  std::string str;
+  for (const auto& part : parts)
+    str += part;
+
+  EXPECT_LT(1U, parts.size());
+  EXPECT_STREQ("{\"items\":[{\"label\":\"some item label\"},{\"label\":\"some item label\"},{\"label\":\"some item label\"}]}", str.c_str());
+}
+
+TEST(TestJSONStreamWriter, StopsOnOutputFailure)
+{
+  int calls = 0;
+  CJSONStreamWriter writer([&calls](const char *data, size_t size)
+  {
+    calls++;
+    return false;
+  }, true, 4);
+
+  ASSERT_TRUE(writer.StartArray());
+  EXPECT_FALSE(writer.Write(CVariant("long enough to flush")));
+  EXPECT_TRUE(writer.HasFailed());
+  EXPECT_FALSE(writer.Write(CVariant("ignored")));
+  EXPECT_FALSE(writer.Flush());
+  EXPECT_EQ(1, calls);
+}
@@ -10,7 +10,12 @@
 #include "utils/Job.h"
 
 #include "gtest/gtest.h"
+#include <algorithm>
 #include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <vector>
 
 #ifdef TARGET_POSIX
 #include "platform/linux/XTimeUtils.h"
@@ -170,3 +175,139 @@ TEST_F(TestJobManager, IsProcessing)
 
   job->FinishAndStopBlocking();
 }
+
+namespace
+{
+// shared with the jobs, which may still be signalling when the test is done waiting
+struct JobCounter
+{
+  explicit JobCounter(int total) : total(total) {}
+
+  void Done()
+  {
+    if (++done == total)
+      finished.Set();
+  }
+
+  const int total;
+  std::atomic<int> done{0};
+  CEvent finished;
+};
+
+class CountingJob : public CJob
+{
+public:
+  CountingJob(std::shared_ptr<JobCounter> counter, AFFINITY affinity) :
+    m_counter(std::move(counter)), m_affinity(affinity)
+  {
+  }
+
+  bool DoWork() override
+  {
+    m_counter->Done();
+    return true;
+  }
+
+  AFFINITY GetAffinity() const override { return m_affinity; }
+
+private:
+  std::shared_ptr<JobCounter> m_counter;
+  AFFINITY m_affinity;
+};
+
+// counts itself as started and blocks until released
+class BlockingJob : public CJob
+{
+public:
+  BlockingJob(std::shared_ptr<JobCounter> counter, std::shared_ptr<CEvent> release) :
+    m_counter(std::move(counter)), m_release(std::move(release))
+  {
+  }
+
+  bool DoWork() override
+  {
+    m_counter->Done();
+    m_release->WaitMSec(10000);
+    return true;
+  }
+
+  AFFINITY GetAffinity() const override { return AFFINITY_IO; }
+
+private:
+  std::shared_ptr<JobCounter> m_counter;
+  std::shared_ptr<CEvent> m_release;
+};
+}
+
+TEST_F(TestJobManager, Affinity)
+{
+  auto counter = std::make_shared<JobCounter>(100);
+  for (int i = 0; i < counter->total; i++)
+  {
+    CJob::AFFINITY affinity = i % 2 ? CJob::AFFINITY_IO : CJob::AFFINITY_COMPUTE;
+    CJobManager::GetInstance().AddJob(new CountingJob(counter, affinity), nullptr);
+  }
+  EXPECT_TRUE(counter->finished.WaitMSec(10000));
+  EXPECT_EQ(counter->total, counter->done);
+}
+
+TEST_F(TestJobManager, JobsAddedByJobs)
+{
+  // jobs queued by a worker go to its own queue and are stolen by the others
+  auto counter = std::make_shared<JobCounter>(1000);
+  CJobManager::GetInstance().Submit([counter]() {
+    for (int i = 0; i < counter->total; i++)
+      CJobManager::GetInstance().AddJob(new CountingJob(counter, CJob::AFFINITY_COMPUTE), nullptr);
+  }, CJob::PRIORITY_HIGH);
+  EXPECT_TRUE(counter->finished.WaitMSec(10000));
+  EXPECT_EQ(counter->total, counter->done);
+}
+
+TEST_F(TestJobManager, UnPauseStartsAllJobs)
+{
+  // the jobs only all start if they run side by side
+  auto counter = std::make_shared<JobCounter>(3);
+  auto release = std::make_shared<CEvent>(true);
+  CJobManager::GetInstance().PauseJobs();
+  for (int i = 0; i < counter->total; i++)
+    CJobManager::GetInstance().AddJob(new BlockingJob(counter, release), nullptr, CJob::PRIORITY_LOW_PAUSABLE);
+  Sleep(50);
+  EXPECT_EQ(0, counter->done);
+
+  CJobManager::GetInstance().UnPauseJobs();
+  EXPECT_TRUE(counter->finished.WaitMSec(5000));
+  EXPECT_EQ(counter->total, counter->done);
+  release->Set();
+}
+
+// Stress test reporting throughput and queueing latency, run with --gtest_also_run_disabled_tests
+TEST_F(TestJobManager, DISABLED_ManyTinyJobs)
+{
+  typedef std::chrono::steady_clock Clock;
+
+  const int total = 20000;
+  auto counter = std::make_shared<JobCounter>(total);
+  auto latencies = std::make_shared<std::vector<Clock::duration>>(total);
+
+  Clock::time_point start = Clock::now();
+  for (int i = 0; i < total; i++)
+  {
+    Clock::time_point queued = Clock::now();
+    CJobManager::GetInstance().Submit([counter, latencies, i, queued]() {
+      (*latencies)[i] = Clock::now() - queued;
+      counter->Done();
+    }, CJob::PRIORITY_NORMAL);
+  }
+  ASSERT_TRUE(counter->finished.WaitMSec(60000));
+  EXPECT_EQ(total, counter->done);
+  double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+  std::sort(latencies->begin(), latencies->end());
+  auto percentile = [&latencies](double p) {
+    size_t index = static_cast<size_t>(p * (latencies->size() - 1));
+    return std::chrono::duration<double, std::micro>((*latencies)[index]).count();
+  };
+  std::cout << "jobs/sec: " << total / seconds << std::endl;
+  std::cout << "latency p50: " << percentile(0.5) << " us, p99: " << percentile(0.99)
+            << " us, p99.9: " << percentile(0.999) << " us, max: " << percentile(1.0) << " us" << std::endl;
+}
@@ -103,6 +103,79 @@ TEST(TestSortUtils, Sort_SortDescription)
   EXPECT_STREQ("R Artist", (*items.at(6))[FieldArtist].asString().c_str());
 }
 
+TEST(TestSortUtils, Sort_Numbers)
+{
+  DatabaseResults items;
+  const char *labels[] = { "Track 10", "track 2", "Track 1", "Track 02", "Track 100", "Track" };
+  for (const char *label : labels)
+  {
+    DatabaseResult item;
+    item[FieldLabel] = label;
+    items.push_back(item);
+  }
+
+  SortUtils::Sort(SortByLabel, SortOrderAscending, SortAttributeNone, items);
+
+  ASSERT_EQ(6u, items.size());
+  EXPECT_STREQ("Track", items.at(0)[FieldLabel].asString().c_str());
+  EXPECT_STREQ("Track 1", items.at(1)[FieldLabel].asString().c_str());
+  EXPECT_STREQ("track 2", items.at(2)[FieldLabel].asString().c_str());
+  EXPECT_STREQ("Track 02", items.at(3)[FieldLabel].asString().c_str());
+  EXPECT_STREQ("Track 10", items.at(4)[FieldLabel].asString().c_str());
+  EXPECT_STREQ("Track 100", items.at(5)[FieldLabel].asString().c_str());
+}
+
+TEST(TestSortUtils, Sort_SpecialAndFolders)
+{
+  SortItems items;
+  const char *labels[] = { "b", "a", "c", "d", "e" };
+  for (const char *label : labels)
+  {
+    SortItemPtr item(new SortItem());
+    (*item)[FieldLabel] = label;
+    (*item)[FieldFolder] = false;
+    items.push_back(item);
+  }
+  (*items.at(2))[FieldSortSpecial] = SortSpecialOnTop;
+  (*items.at(1))[FieldSortSpecial] = SortSpecialOnBottom;
+  (*items.at(4))[FieldFolder] = true;
+
+  SortUtils::Sort(SortByLabel, SortOrderDescending, SortAttributeNone, items);
+
+  ASSERT_EQ(5u, items.size());
+  EXPECT_STREQ("c", (*items.at(0))[FieldLabel].asString().c_str());
+  EXPECT_STREQ("e", (*items.at(1))[FieldLabel].asString().c_str());
+  EXPECT_STREQ("d", (*items.at(2))[FieldLabel].asString().c_str());
+  EXPECT_STREQ("b", (*items.at(3))[FieldLabel].asString().c_str());
+  EXPECT_STREQ("a", (*items.at(4))[FieldLabel].asString().c_str());
+}
+
+TEST(TestSortUtils, Sort_Limit)
+{
+  SortItems items;
+  for (int i = 0; i < 1000; i++)
+  {
+    SortItemPtr item(new SortItem());
+    (*item)[FieldTrackNumber] = (i * 7919) % 1000;
+    (*item)[FieldId] = i;
+    items.push_back(item);
+  }
+  // equal labels keep their order
+  (*items.at(10))[FieldTrackNumber] = 5;
+  (*items.at(20))[FieldTrackNumber] = 5;
+
+  SortUtils::Sort(SortByTrackNumber, SortOrderAscending, SortAttributeNone, items, 8, 3);
+
+  ASSERT_EQ(5u, items.size());
+  EXPECT_EQ(3, (*items.at(0))[FieldTrackNumber].asInteger());
+  EXPECT_EQ(4, (*items.at(1))[FieldTrackNumber].asInteger());
+  EXPECT_EQ(5, (*items.at(2))[FieldTrackNumber].asInteger());
+  EXPECT_EQ(10, (*items.at(2))[FieldId].asInteger());
+  EXPECT_EQ(5, (*items.at(3))[FieldTrackNumber].asInteger());
+  EXPECT_EQ(20, (*items.at(3))[FieldId].asInteger());
+  EXPECT_EQ(5, (*items.at(4))[FieldTrackNumber].asInteger());
+}
+
 TEST(TestSortUtils, GetFieldsForSorting)
 {
   Fields fields;
@@ -222,6 +222,63 @@ TEST(TestVariant, swap)
   a.swap(b);
   EXPECT_TRUE(b.isInteger());
   EXPECT_TRUE(a.isString());
+  EXPECT_STREQ("variant", a.c_str());
+
+  a.swap(a);
+  EXPECT_STREQ("variant", a.c_str());
+}
+
+TEST(TestVariant, move)
+{
+  std::string longString(100, 'x');
+  CVariant a(longString), b(L"wide");
+
+  CVariant c(std::move(a));
+  EXPECT_TRUE(a.isNull());
+  EXPECT_EQ(longString, c.asString());
+
+  c = std::move(b);
+  EXPECT_TRUE(b.isNull());
+  EXPECT_EQ(L"wide", c.asWideString());
+
+  CVariant d;
+  d["object"]["key"] = std::move(c);
+  EXPECT_TRUE(c.isNull());
+  EXPECT_EQ(L"wide", d["object"]["key"].asWideString());
+}
+
+TEST(TestVariant, smallString)
+{
+  // values on both sides of the in place storage limit
+  std::string shortString(22, 's');
+  std::string longString(23, 'l');
+  CVariant a(shortString), b(longString);
+  EXPECT_EQ(shortString, a.asString());
+  EXPECT_EQ(longString, b.asString());
+  EXPECT_EQ(22U, a.size());
+  EXPECT_EQ(23U, b.size());
+
+  CVariant c(a), d(b);
+  EXPECT_TRUE(a == c);
+  EXPECT_TRUE(b == d);
+  EXPECT_FALSE(a == b);
+
+  a.swap(b);
+  EXPECT_EQ(longString, a.asString());
+  EXPECT_EQ(shortString, b.asString());
+
+  CVariant e(std::string("embedded\0nul", 12));
+  EXPECT_EQ(12U, e.size());
+  EXPECT_EQ(std::string("embedded\0nul", 12), e.asString());
+
+  c.clear();
+  d.clear();
+  EXPECT_TRUE(c.empty());
+  EXPECT_TRUE(d.empty());
+  EXPECT_STREQ("", c.c_str());
+  EXPECT_STREQ("", d.c_str());
+  EXPECT_FALSE(CVariant("false").asBoolean());
+  EXPECT_TRUE(CVariant("true").asBoolean());
 }
 
 TEST(TestVariant, iterator_array)
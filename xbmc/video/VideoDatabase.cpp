@@ -11,6 +11,7 @@
 #include <algorithm>
 #include <map>
 #include <memory>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -69,6 +70,48 @@ using namespace ADDON;
 using namespace KODI::MESSAGING;
 using namespace KODI::GUILIB;
 
+namespace
+{
+// a bulk ingest transaction is committed once any of these is reached
+const unsigned int BULK_INGEST_MAX_ITEMS = 100;
+const unsigned int BULK_INGEST_MAX_LINKS = 5000;
+const unsigned int BULK_INGEST_MAX_DURATION = 5000; // ms
+
+const size_t BULK_INGEST_ROWS_PER_INSERT = 500;
+// SQLite's default limit of parameters in a single statement
+const size_t BULK_INGEST_PARAMS_PER_INSERT = 999;
+
+bool ExecutePrepared(dbiplus::Dataset& ds, const std::string& sql, const dbiplus::StmtParams& params)
+{
+  try
+  {
+    ds.exec_prepared(sql, params);
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s - failed to execute query '%s'", __FUNCTION__, sql.c_str());
+  }
+  return false;
+}
+}
+
+struct CVideoDatabase::CBulkIngest
+{
+  typedef std::map<std::string, std::vector<dbiplus::StmtParams>> LinkRows; ///< values per link table
+
+  std::map<std::string, int> ids; ///< lookup table ids, keyed by table and lower case name
+  std::set<std::pair<std::string, int>> newMedia; ///< added items that don't have links yet
+  LinkRows links; ///< links of completed items
+  size_t pendingLinks = 0;
+  LinkRows itemLinks; ///< links of the item currently written
+  std::set<std::string> itemLinkKeys;
+  unsigned int depth = 0; ///< nesting level of BeginTransaction()
+  bool inTransaction = false;
+  unsigned int items = 0; ///< items written in the current transaction
+  unsigned int transactionStart = 0;
+};
+
 //********************************************************************************************************************************
 CVideoDatabase::CVideoDatabase(void) = default;
 
@@ -1286,6 +1329,7 @@ int CVideoDatabase::AddMovie(const std::string& strFilenameAndPath)
       std::string strSQL=PrepareSQL("insert into movie (idMovie, idFile) values (NULL, %i)", idFile);
       m_pDS->exec(strSQL);
       idMovie = (int)m_pDS->lastinsertid();
+      MarkNewMedia(MediaTypeMovie, idMovie);
     }
 
     return idMovie;
@@ -1339,7 +1383,11 @@ bool CVideoDatabase::AddPathToTvShow(int idShow, const std::string &path, const
 int CVideoDatabase::AddTvShow()
 {
   if (ExecuteQuery("INSERT INTO tvshow(idShow) VALUES(NULL)"))
-    return (int)m_pDS->lastinsertid();
+  {
+    int idTvShow = (int)m_pDS->lastinsertid();
+    MarkNewMedia(MediaTypeTvShow, idTvShow);
+    return idTvShow;
+  }
   return -1;
 }
 
@@ -1358,7 +1406,9 @@ int CVideoDatabase::AddEpisode(int idShow, const std::string& strFilenameAndPath
 
     std::string strSQL=PrepareSQL("insert into episode (idEpisode, idFile, idShow) values (NULL, %i, %i)", idFile, idShow);
     m_pDS->exec(strSQL);
-    return (int)m_pDS->lastinsertid();
+    int idEpisode = (int)m_pDS->lastinsertid();
+    MarkNewMedia(MediaTypeEpisode, idEpisode);
+    return idEpisode;
   }
   catch (...)
   {
@@ -1384,6 +1434,7 @@ int CVideoDatabase::AddMusicVideo(const std::string& strFilenameAndPath)
       std::string strSQL=PrepareSQL("insert into musicvideo (idMVideo, idFile) values (NULL, %i)", idFile);
       m_pDS->exec(strSQL);
       idMVideo = (int)m_pDS->lastinsertid();
+      MarkNewMedia(MediaTypeMusicVideo, idMVideo);
     }
 
     return idMVideo;
@@ -1403,23 +1454,37 @@ int CVideoDatabase::AddToTable(const std::string& table, const std::string& firs
     if (NULL == m_pDB.get()) return -1;
     if (NULL == m_pDS.get()) return -1;
 
-    std::string strSQL = PrepareSQL("select %s from %s where %s like '%s'", firstField.c_str(), table.c_str(), secondField.c_str(), value.substr(0, 255).c_str());
-    m_pDS->query(strSQL);
+    // tags are removed by a trigger once their last link is gone, so their ids can't be cached.
+    // Names containing wildcards can't be cached either as the lookup uses like.
+    std::string key;
+    if (m_bulkIngest && table != "tag" && value.find_first_of("%_\\") == std::string::npos)
+    {
+      key = table + ":" + value.substr(0, 255);
+      StringUtils::ToLower(key);
+      const auto it = m_bulkIngest->ids.find(key);
+      if (it != m_bulkIngest->ids.end())
+        return it->second;
+    }
+
+    int id;
+    const field_value name(value.substr(0, 255).c_str());
+    m_pDS->query_prepared("SELECT " + firstField + " FROM " + table + " WHERE " + secondField + " LIKE ?", { name });
     if (m_pDS->num_rows() == 0)
     {
       m_pDS->close();
       // doesnt exists, add it
-      strSQL = PrepareSQL("insert into %s (%s, %s) values(NULL, '%s')", table.c_str(), firstField.c_str(), secondField.c_str(), value.substr(0, 255).c_str());
-      m_pDS->exec(strSQL);
-      int id = (int)m_pDS->lastinsertid();
-      return id;
+      m_pDS->exec_prepared("INSERT INTO " + table + " (" + firstField + ", " + secondField + ") VALUES (NULL, ?)", { name });
+      id = (int)m_pDS->lastinsertid();
     }
     else
     {
-      int id = m_pDS->fv(firstField.c_str()).get_asInt();
+      id = m_pDS->fv(firstField.c_str()).get_asInt();
       m_pDS->close();
-      return id;
     }
+
+    if (!key.empty())
+      m_bulkIngest->ids[key] = id;
+    return id;
   }
   catch (...)
   {
@@ -1606,27 +1671,39 @@ int CVideoDatabase::AddActor(const std::string& name, const std::string& thumbUR
     std::string trimmedName = name.c_str();
     StringUtils::Trim(trimmedName);
 
-    std::string strSQL=PrepareSQL("select actor_id from actor where name like '%s'", trimmedName.substr(0, 255).c_str());
-    m_pDS->query(strSQL);
-    if (m_pDS->num_rows() == 0)
+    std::string key;
+    if (m_bulkIngest && trimmedName.find_first_of("%_\\") == std::string::npos)
+    {
+      key = "actor:" + trimmedName.substr(0, 255);
+      StringUtils::ToLower(key);
+      const auto it = m_bulkIngest->ids.find(key);
+      if (it != m_bulkIngest->ids.end())
+        idActor = it->second;
+    }
+
+    const field_value actorName(trimmedName.substr(0, 255).c_str());
+    if (idActor < 0)
     {
+      m_pDS->query_prepared("SELECT actor_id FROM actor WHERE name LIKE ?", { actorName });
+      if (m_pDS->num_rows() > 0)
+        idActor = m_pDS->fv(0).get_asInt();
       m_pDS->close();
+    }
+    if (idActor < 0)
+    {
       // doesnt exists, add it
-      strSQL=PrepareSQL("insert into actor (actor_id, name, art_urls) values(NULL, '%s', '%s')", trimmedName.substr(0,255).c_str(), thumbURLs.c_str());
-      m_pDS->exec(strSQL);
+      m_pDS->exec_prepared("INSERT INTO actor (actor_id, name, art_urls) VALUES (NULL, ?, ?)",
+                           { actorName, field_value(thumbURLs.c_str()) });
       idActor = (int)m_pDS->lastinsertid();
     }
-    else
+    else if (!thumbURLs.empty())
     {
-      idActor = m_pDS->fv(0).get_asInt();
-      m_pDS->close();
       // update the thumb url's
-      if (!thumbURLs.empty())
-      {
-        strSQL=PrepareSQL("update actor set art_urls = '%s' where actor_id = %i", thumbURLs.c_str(), idActor);
-        m_pDS->exec(strSQL);
-      }
+      m_pDS->exec_prepared("UPDATE actor SET art_urls = ? WHERE actor_id = ?",
+                           { field_value(thumbURLs.c_str()), field_value(idActor) });
     }
+    if (!key.empty())
+      m_bulkIngest->ids[key] = idActor;
     // add artwork
     if (!thumb.empty())
       SetArtForItem(idActor, "actor", "thumb", thumb);
@@ -1643,29 +1720,63 @@ int CVideoDatabase::AddActor(const std::string& name, const std::string& thumbUR
 
 void CVideoDatabase::AddLinkToActor(int mediaId, const char *mediaType, int actorId, const std::string &role, int order)
 {
-  std::string sql=PrepareSQL("SELECT 1 FROM actor_link WHERE actor_id=%i AND media_id=%i AND media_type='%s'", actorId, mediaId, mediaType);
+  const StmtParams link = { field_value(actorId), field_value(mediaId), field_value(mediaType),
+                           field_value(role.c_str()), field_value(order) };
+  if (IsNewMedia(mediaId, mediaType))
+  {
+    QueueLink("actor_link (actor_id, media_id, media_type, role, cast_order)", link);
+    return;
+  }
 
-  if (GetSingleValue(sql).empty())
-  { // doesnt exists, add it
-    sql = PrepareSQL("INSERT INTO actor_link (actor_id, media_id, media_type, role, cast_order) VALUES(%i,%i,'%s','%s',%i)", actorId, mediaId, mediaType, role.c_str(), order);
-    ExecuteQuery(sql);
+  FlushPendingLinks();
+  try
+  {
+    m_pDS->query_prepared("SELECT 1 FROM actor_link WHERE actor_id=? AND media_id=? AND media_type=?",
+                          StmtParams(link.begin(), link.begin() + 3));
+    bool exists = !m_pDS->eof();
+    m_pDS->close();
+    if (!exists)
+    { // doesnt exists, add it
+      m_pDS->exec_prepared("INSERT INTO actor_link (actor_id, media_id, media_type, role, cast_order) VALUES (?,?,?,?,?)", link);
+    }
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s (%i, %i, %s) failed", __FUNCTION__, actorId, mediaId, mediaType);
   }
 }
 
 void CVideoDatabase::AddToLinkTable(int mediaId, const std::string& mediaType, const std::string& table, int valueId, const char *foreignKey)
 {
   const char *key = foreignKey ? foreignKey : table.c_str();
-  std::string sql = PrepareSQL("SELECT 1 FROM %s_link WHERE %s_id=%i AND media_id=%i AND media_type='%s'", table.c_str(), key, valueId, mediaId, mediaType.c_str());
+  // tag links aren't collected, the delete_tag trigger relies on them being in the table
+  const StmtParams link = { field_value(valueId), field_value(mediaId), field_value(mediaType.c_str()) };
+  if (table != "tag" && IsNewMedia(mediaId, mediaType))
+  {
+    QueueLink(table + "_link (" + key + "_id, media_id, media_type)", link);
+    return;
+  }
 
-  if (GetSingleValue(sql).empty())
-  { // doesnt exists, add it
-    sql = PrepareSQL("INSERT INTO %s_link (%s_id,media_id,media_type) VALUES(%i,%i,'%s')", table.c_str(), key, valueId, mediaId, mediaType.c_str());
-    ExecuteQuery(sql);
+  FlushPendingLinks();
+  try
+  {
+    m_pDS->query_prepared("SELECT 1 FROM " + table + "_link WHERE " + key + "_id=? AND media_id=? AND media_type=?", link);
+    bool exists = !m_pDS->eof();
+    m_pDS->close();
+    if (!exists)
+    { // doesnt exists, add it
+      m_pDS->exec_prepared("INSERT INTO " + table + "_link (" + key + "_id,media_id,media_type) VALUES (?,?,?)", link);
+    }
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s (%s, %i, %i, %s) failed", __FUNCTION__, table.c_str(), valueId, mediaId, mediaType.c_str());
   }
 }
 
 void CVideoDatabase::RemoveFromLinkTable(int mediaId, const std::string& mediaType, const std::string& table, int valueId, const char *foreignKey)
 {
+  FlushPendingLinks();
   const char *key = foreignKey ? foreignKey : table.c_str();
   std::string sql = PrepareSQL("DELETE FROM %s_link WHERE %s_id=%i AND media_id=%i AND media_type='%s'", table.c_str(), key, valueId, mediaId, mediaType.c_str());
 
@@ -1687,6 +1798,7 @@ void CVideoDatabase::AddLinksToItem(int mediaId, const std::string& mediaType, c
 
 void CVideoDatabase::UpdateLinksToItem(int mediaId, const std::string& mediaType, const std::string& field, const std::vector<std::string>& values)
 {
+  FlushPendingLinks();
   std::string sql = PrepareSQL("DELETE FROM %s_link WHERE media_id=%i AND media_type='%s'", field.c_str(), mediaId, mediaType.c_str());
   m_pDS->exec(sql);
 
@@ -1708,6 +1820,7 @@ void CVideoDatabase::AddActorLinksToItem(int mediaId, const std::string& mediaTy
 
 void CVideoDatabase::UpdateActorLinksToItem(int mediaId, const std::string& mediaType, const std::string& field, const std::vector<std::string>& values)
 {
+  FlushPendingLinks();
   std::string sql = PrepareSQL("DELETE FROM %s_link WHERE media_id=%i AND media_type='%s'", field.c_str(), mediaId, mediaType.c_str());
   m_pDS->exec(sql);
 
@@ -1846,6 +1959,8 @@ void CVideoDatabase::DeleteDetailsForTvShow(int idTvShow)
     if (NULL == m_pDB.get()) return ;
     if (NULL == m_pDS.get()) return ;
 
+    FlushPendingLinks();
+
     std::string strSQL;
     strSQL=PrepareSQL("DELETE from genre_link WHERE media_id=%i AND media_type='tvshow'", idTvShow);
     m_pDS->exec(strSQL);
@@ -3361,6 +3476,10 @@ void CVideoDatabase::DeleteMovie(int idMovie, bool bKeepId /* = false */)
     if (NULL == m_pDB.get()) return ;
     if (NULL == m_pDS.get()) return ;
 
+    // the delete triggers remove all links of the item
+    if (!bKeepId)
+      FlushPendingLinks();
+
     BeginTransaction();
 
     // keep the movie table entry, linking to tv shows, and bookmarks
@@ -3408,6 +3527,10 @@ void CVideoDatabase::DeleteTvShow(int idTvShow, bool bKeepId /* = false */)
     if (NULL == m_pDB.get()) return ;
     if (NULL == m_pDS.get()) return ;
 
+    // the delete triggers remove all links of the item
+    if (!bKeepId)
+      FlushPendingLinks();
+
     BeginTransaction();
 
     std::set<int> paths;
@@ -3506,6 +3629,10 @@ void CVideoDatabase::DeleteEpisode(int idEpisode, bool bKeepId /* = false */)
     if (NULL == m_pDB.get()) return ;
     if (NULL == m_pDS.get()) return ;
 
+    // the delete triggers remove all links of the item
+    if (!bKeepId)
+      FlushPendingLinks();
+
     //! @todo move this below CommitTransaction() once UPnP doesn't rely on this anymore
     if (!bKeepId)
       AnnounceRemove(MediaTypeEpisode, idEpisode);
@@ -3547,6 +3674,10 @@ void CVideoDatabase::DeleteMusicVideo(int idMVideo, bool bKeepId /* = false */)
     if (NULL == m_pDB.get()) return ;
     if (NULL == m_pDS.get()) return ;
 
+    // the delete triggers remove all links of the item
+    if (!bKeepId)
+      FlushPendingLinks();
+
     BeginTransaction();
 
     // keep the music video table entry and bookmarks so we can update data in place
@@ -4176,19 +4307,20 @@ void CVideoDatabase::GetCast(int media_id, const std::string &media_type, std::v
     if (!m_pDB.get()) return;
     if (!m_pDS2.get()) return;
 
-    std::string sql = PrepareSQL("SELECT actor.name,"
-                                 "  actor_link.role,"
-                                 "  actor_link.cast_order,"
-                                 "  actor.art_urls,"
-                                 "  art.url "
-                                 "FROM actor_link"
-                                 "  JOIN actor ON"
-                                 "    actor_link.actor_id=actor.actor_id"
-                                 "  LEFT JOIN art ON"
-                                 "    art.media_id=actor.actor_id AND art.media_type='actor' AND art.type='thumb' "
-                                 "WHERE actor_link.media_id=%i AND actor_link.media_type='%s'"
-                                 "ORDER BY actor_link.cast_order", media_id, media_type.c_str());
-    m_pDS2->query(sql);
+    FlushPendingLinks();
+
+    m_pDS2->query_prepared("SELECT actor.name,"
+                           "  actor_link.role,"
+                           "  actor_link.cast_order,"
+                           "  actor.art_urls,"
+                           "  art.url "
+                           "FROM actor_link"
+                           "  JOIN actor ON"
+                           "    actor_link.actor_id=actor.actor_id"
+                           "  LEFT JOIN art ON"
+                           "    art.media_id=actor.actor_id AND art.media_type='actor' AND art.type='thumb' "
+                           "WHERE actor_link.media_id=? AND actor_link.media_type=? "
+                           "ORDER BY actor_link.cast_order", { field_value(media_id), field_value(media_type.c_str()) });
     while (!m_pDS2->eof())
     {
       SActorInfo info;
@@ -4227,8 +4359,8 @@ void CVideoDatabase::GetTags(int media_id, const std::string &media_type, std::v
     if (!m_pDB.get()) return;
     if (!m_pDS2.get()) return;
 
-    std::string sql = PrepareSQL("SELECT tag.name FROM tag INNER JOIN tag_link ON tag_link.tag_id = tag.tag_id WHERE tag_link.media_id = %i AND tag_link.media_type = '%s' ORDER BY tag.tag_id", media_id, media_type.c_str());
-    m_pDS2->query(sql);
+    m_pDS2->query_prepared("SELECT tag.name FROM tag INNER JOIN tag_link ON tag_link.tag_id = tag.tag_id WHERE tag_link.media_id = ? AND tag_link.media_type = ? ORDER BY tag.tag_id",
+                           { field_value(media_id), field_value(media_type.c_str()) });
     while (!m_pDS2->eof())
     {
       tags.emplace_back(m_pDS2->fv(0).get_asString());
@@ -4249,8 +4381,8 @@ void CVideoDatabase::GetRatings(int media_id, const std::string &media_type, Rat
     if (!m_pDB.get()) return;
     if (!m_pDS2.get()) return;
 
-    std::string sql = PrepareSQL("SELECT rating.rating_type, rating.rating, rating.votes FROM rating WHERE rating.media_id = %i AND rating.media_type = '%s'", media_id, media_type.c_str());
-    m_pDS2->query(sql);
+    m_pDS2->query_prepared("SELECT rating.rating_type, rating.rating, rating.votes FROM rating WHERE rating.media_id = ? AND rating.media_type = ?",
+                           { field_value(media_id), field_value(media_type.c_str()) });
     while (!m_pDS2->eof())
     {
       ratings[m_pDS2->fv(0).get_asString()] = CRating(m_pDS2->fv(1).get_asFloat(), m_pDS2->fv(2).get_asInt());
@@ -4271,8 +4403,8 @@ void CVideoDatabase::GetUniqueIDs(int media_id, const std::string &media_type, C
     if (!m_pDB.get()) return;
     if (!m_pDS2.get()) return;
 
-    std::string sql = PrepareSQL("SELECT type, value FROM uniqueid WHERE media_id = %i AND media_type = '%s'", media_id, media_type.c_str());
-    m_pDS2->query(sql);
+    m_pDS2->query_prepared("SELECT type, value FROM uniqueid WHERE media_id = ? AND media_type = ?",
+                           { field_value(media_id), field_value(media_type.c_str()) });
     while (!m_pDS2->eof())
     {
       details.SetUniqueID(m_pDS2->fv(1).get_asString(), m_pDS2->fv(0).get_asString());
@@ -9841,19 +9973,210 @@ void CVideoDatabase::InvalidatePathHash(const std::string& strPath)
   }
 }
 
+void CVideoDatabase::BeginTransaction()
+{
+  if (!m_bulkIngest)
+  {
+    CDatabase::BeginTransaction();
+    return;
+  }
+
+  if (!m_bulkIngest->inTransaction)
+  {
+    CDatabase::BeginTransaction();
+    m_bulkIngest->inTransaction = true;
+    m_bulkIngest->transactionStart = XbmcThreads::SystemClockMillis();
+  }
+  if (m_bulkIngest->depth++ == 0)
+    ExecuteQuery("SAVEPOINT bulk_item");
+}
+
 bool CVideoDatabase::CommitTransaction()
 {
+  if (m_bulkIngest)
+  {
+    // nested, or the item was rolled back already
+    if (m_bulkIngest->depth == 0 || --m_bulkIngest->depth > 0)
+      return true;
+
+    if (!ExecuteQuery("RELEASE SAVEPOINT bulk_item"))
+    {
+      ExecuteQuery("ROLLBACK TO SAVEPOINT bulk_item");
+      ExecuteQuery("RELEASE SAVEPOINT bulk_item");
+      ResetBulkIngest(false);
+      return false;
+    }
+
+    for (auto& table : m_bulkIngest->itemLinks)
+    {
+      std::vector<StmtParams>& rows = m_bulkIngest->links[table.first];
+      rows.insert(rows.end(), table.second.begin(), table.second.end());
+      m_bulkIngest->pendingLinks += table.second.size();
+    }
+    m_bulkIngest->itemLinks.clear();
+    m_bulkIngest->itemLinkKeys.clear();
+    // links added to these items from now on may already be in the db
+    m_bulkIngest->newMedia.clear();
+
+    if (++m_bulkIngest->items >= BULK_INGEST_MAX_ITEMS ||
+        m_bulkIngest->pendingLinks >= BULK_INGEST_MAX_LINKS ||
+        XbmcThreads::SystemClockMillis() - m_bulkIngest->transactionStart >= BULK_INGEST_MAX_DURATION)
+      return CommitBulkIngest();
+    return true;
+  }
+
   if (CDatabase::CommitTransaction())
   { // number of items in the db has likely changed, so recalculate
-    GUIINFO::CLibraryGUIInfo& guiInfo = CServiceBroker::GetGUI()->GetInfoManager().GetInfoProviders().GetLibraryInfoProvider();
-    guiInfo.SetLibraryBool(LIBRARY_HAS_MOVIES, HasContent(VIDEODB_CONTENT_MOVIES));
-    guiInfo.SetLibraryBool(LIBRARY_HAS_TVSHOWS, HasContent(VIDEODB_CONTENT_TVSHOWS));
-    guiInfo.SetLibraryBool(LIBRARY_HAS_MUSICVIDEOS, HasContent(VIDEODB_CONTENT_MUSICVIDEOS));
+    UpdateLibraryBools();
     return true;
   }
   return false;
 }
 
+void CVideoDatabase::RollbackTransaction()
+{
+  if (!m_bulkIngest)
+  {
+    CDatabase::RollbackTransaction();
+    return;
+  }
+
+  if (m_bulkIngest->depth == 0)
+    return;
+
+  // roll back the whole item, like a rollback of a nested transaction would
+  m_bulkIngest->depth = 0;
+  ExecuteQuery("ROLLBACK TO SAVEPOINT bulk_item");
+  ExecuteQuery("RELEASE SAVEPOINT bulk_item");
+  ResetBulkIngest(false);
+}
+
+void CVideoDatabase::BeginBulkIngest()
+{
+  if (m_bulkIngest)
+    EndBulkIngest();
+
+  m_bulkIngest.reset(new CBulkIngest);
+}
+
+bool CVideoDatabase::EndBulkIngest()
+{
+  if (!m_bulkIngest)
+    return true;
+
+  bool success = CommitBulkIngest();
+  m_bulkIngest.reset();
+  UpdateLibraryBools();
+  return success;
+}
+
+bool CVideoDatabase::CommitBulkIngest()
+{
+  if (!m_bulkIngest->inTransaction)
+    return true;
+
+  FlushPendingLinks();
+  m_bulkIngest->inTransaction = false;
+  m_bulkIngest->items = 0;
+  if (CDatabase::CommitTransaction())
+    return true;
+
+  // everything written since the last commit is lost, including rows the cached ids refer to
+  CDatabase::RollbackTransaction();
+  ResetBulkIngest(true);
+  return false;
+}
+
+void CVideoDatabase::ResetBulkIngest(bool all)
+{
+  m_bulkIngest->itemLinks.clear();
+  m_bulkIngest->itemLinkKeys.clear();
+  m_bulkIngest->newMedia.clear();
+  // ids of rows added by the rolled back items are gone
+  m_bulkIngest->ids.clear();
+
+  if (all)
+  {
+    m_bulkIngest->links.clear();
+    m_bulkIngest->pendingLinks = 0;
+    m_bulkIngest->depth = 0;
+    m_bulkIngest->inTransaction = false;
+    m_bulkIngest->items = 0;
+  }
+}
+
+void CVideoDatabase::MarkNewMedia(const std::string& mediaType, int mediaId)
+{
+  if (m_bulkIngest && mediaId > 0)
+    m_bulkIngest->newMedia.insert(std::make_pair(mediaType, mediaId));
+}
+
+bool CVideoDatabase::IsNewMedia(int mediaId, const std::string& mediaType) const
+{
+  // links are collected per item, so only while an item is written
+  return m_bulkIngest && m_bulkIngest->depth > 0 &&
+         m_bulkIngest->newMedia.find(std::make_pair(mediaType, mediaId)) != m_bulkIngest->newMedia.end();
+}
+
+void CVideoDatabase::QueueLink(const std::string& table, const StmtParams& row)
+{
+  // new items have no links in the db, we only need to skip duplicates of the item itself
+  std::string key = StringUtils::Format("%s:%i:%i:%s", table.c_str(), row[0].get_asInt(), row[1].get_asInt(),
+                                        row[2].get_asString().c_str());
+  if (m_bulkIngest->itemLinkKeys.insert(key).second)
+    m_bulkIngest->itemLinks[table].push_back(row);
+}
+
+void CVideoDatabase::FlushPendingLinks()
+{
+  if (!m_bulkIngest || m_bulkIngest->links.empty())
+    return;
+
+  for (const auto& table : m_bulkIngest->links)
+  {
+    const std::vector<StmtParams>& rows = table.second;
+    const size_t columns = rows.front().size();
+    const std::string placeholders = "(" + StringUtils::Join(std::vector<std::string>(columns, "?"), ",") + ")";
+    const std::string insert = "INSERT INTO " + table.first + " VALUES ";
+    const size_t rowsPerInsert = std::max<size_t>(1, std::min(BULK_INGEST_ROWS_PER_INSERT, BULK_INGEST_PARAMS_PER_INSERT / columns));
+
+    // full batches share the same statement text, so their compiled statement is reused
+    for (size_t first = 0; first < rows.size(); first += rowsPerInsert)
+    {
+      size_t last = std::min(rows.size(), first + rowsPerInsert);
+      std::string sql = insert + placeholders;
+      StmtParams params(rows[first]);
+      for (size_t i = first + 1; i < last; i++)
+      {
+        sql += "," + placeholders;
+        params.insert(params.end(), rows[i].begin(), rows[i].end());
+      }
+
+      if (!ExecutePrepared(*m_pDS, sql, params))
+      {
+        // don't lose the other rows because of a single bad one
+        for (size_t i = first; i < last; i++)
+          ExecutePrepared(*m_pDS, insert + placeholders, rows[i]);
+      }
+    }
+  }
+  m_bulkIngest->links.clear();
+  m_bulkIngest->pendingLinks = 0;
+}
+
+void CVideoDatabase::UpdateLibraryBools()
+{
+  // the database is also used without a GUI, e.g. by the unit tests
+  CGUIComponent* gui = CServiceBroker::GetGUI();
+  if (!gui)
+    return;
+
+  GUIINFO::CLibraryGUIInfo& guiInfo = gui->GetInfoManager().GetInfoProviders().GetLibraryInfoProvider();
+  guiInfo.SetLibraryBool(LIBRARY_HAS_MOVIES, HasContent(VIDEODB_CONTENT_MOVIES));
+  guiInfo.SetLibraryBool(LIBRARY_HAS_TVSHOWS, HasContent(VIDEODB_CONTENT_TVSHOWS));
+  guiInfo.SetLibraryBool(LIBRARY_HAS_MUSICVIDEOS, HasContent(VIDEODB_CONTENT_MUSICVIDEOS));
+}
+
 bool CVideoDatabase::SetSingleValue(VIDEODB_CONTENT_TYPE type, int dbId, int dbField, const std::string &strValue)
 {
   std::string strSQL;
@@ -30,6 +30,7 @@ namespace dbiplus
 {
   class field_value;
   typedef std::vector<field_value> sql_record;
+  typedef std::vector<field_value> StmtParams;
 }
 
 #ifndef my_offsetof
@@ -420,7 +421,25 @@ public:
   ~CVideoDatabase(void) override;
 
   bool Open() override;
+  void BeginTransaction() override;
   bool CommitTransaction() override;
+  void RollbackTransaction() override;
+
+  /*! \brief Start writing items in bulk
+   Until EndBulkIngest() is called, items are written in large transactions that are
+   committed in batches. Ids of genres, studios, countries and actors are cached, and
+   the links of newly added items are collected and written with multi-row inserts.
+   Transactions started while writing a single item become savepoints so a failing
+   item is still rolled back on its own.
+   \sa EndBulkIngest
+   */
+  void BeginBulkIngest();
+
+  /*! \brief Write all pending rows, commit and stop writing in bulk
+   \return true if the pending rows were committed, false otherwise.
+   \sa BeginBulkIngest
+   */
+  bool EndBulkIngest();
 
   int AddMovie(const std::string& strFilenameAndPath);
   int AddEpisode(int idShow, const std::string& strFilenameAndPath);
@@ -1002,4 +1021,31 @@ private:
 
   static void AnnounceRemove(std::string content, int id, bool scanning = false);
   static void AnnounceUpdate(std::string content, int id);
+
+  void UpdateLibraryBools();
+
+  /*! \brief Remember an item added while writing in bulk, it doesn't have any links yet
+   */
+  void MarkNewMedia(const std::string& mediaType, int mediaId);
+  bool IsNewMedia(int mediaId, const std::string& mediaType) const;
+
+  /*! \brief Collect a link of a new item to be written with the next multi-row insert
+   \param table the link table and its columns
+   \param row the values of the link, starting with the value id, media id and media type
+   */
+  void QueueLink(const std::string& table, const dbiplus::StmtParams& row);
+
+  /*! \brief Write the collected links of completed items
+   Has to be called before link tables are read or rows are deleted from them.
+   */
+  void FlushPendingLinks();
+  bool CommitBulkIngest();
+
+  /*! \brief Forget the ids and links of a bulk ingest that were rolled back
+   \param all true if the whole transaction is gone, false if only the current item
+   */
+  void ResetBulkIngest(bool all);
+
+  struct CBulkIngest;
+  std::unique_ptr<CBulkIngest> m_bulkIngest;
 };
@@ -32,6 +32,7 @@
 #include "messaging/helpers/DialogOKHelper.h"
 #include "NfoFile.h"
 #include "settings/AdvancedSettings.h"
+#include "settings/MediaSourceSettings.h"
 #include "settings/Settings.h"
 #include "settings/SettingsComponent.h"
 #include "TextureCache.h"
@@ -48,6 +49,7 @@
 #include "video/VideoLibraryQueue.h"
 #include "video/VideoThumbLoader.h"
 #include "VideoInfoDownloader.h"
+#include "VideoScanPrefetcher.h"
 #include "tags/VideoInfoTagLoaderFactory.h"
 
 using namespace XFILE;
@@ -101,6 +103,7 @@ namespace VIDEO
       unsigned int tick = XbmcThreads::SystemClockMillis();
 
       m_database.Open();
+      m_database.BeginBulkIngest();
 
       m_bCanInterrupt = true;
 
@@ -136,10 +139,21 @@ namespace VIDEO
           CLog::Log(LOGWARNING, "%s directory '%s' does not exist - skipping scan%s.", __FUNCTION__, CURL::GetRedacted(directory).c_str(), m_bClean ? " and clean" : "");
           m_pathsToScan.erase(m_pathsToScan.begin());
         }
-        else if (!DoScan(directory))
-          bCancelled = true;
+        else
+        {
+          // the listings are limited per source, so scan each path with the limit of its source
+          VECSOURCES sources(*CMediaSourceSettings::GetInstance().GetSources("video"));
+          unsigned int concurrency = CVideoScanPrefetcher::GetConcurrency(directory, sources);
+          m_prefetcher.reset(concurrency > 1 ? new CVideoScanPrefetcher(concurrency) : nullptr);
+
+          if (!DoScan(directory))
+            bCancelled = true;
+          m_prefetcher.reset();
+        }
       }
 
+      m_database.EndBulkIngest();
+
       if (!bCancelled)
       {
         if (m_bClean)
@@ -161,8 +175,10 @@ namespace VIDEO
     catch (...)
     {
       CLog::Log(LOGERROR, "VideoInfoScanner: Exception while scanning.");
+      m_database.EndBulkIngest();
     }
 
+    m_prefetcher.reset();
     m_bRunning = false;
     CServiceBroker::GetAnnouncementManager()->Announce(ANNOUNCEMENT::VideoLibrary, "xbmc", "OnScanFinished");
 
@@ -252,23 +268,25 @@ namespace VIDEO
     const std::vector<std::string> &regexps = content == CONTENT_TVSHOWS ? CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_tvshowExcludeFromScanRegExps
                                                          : CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_moviesExcludeFromScanRegExps;
 
-    if (CUtil::ExcludeFileOrFolder(strDirectory, regexps))
-      return true;
-
-    if (HasNoMedia(strDirectory))
-      return true;
-
     bool ignoreFolder = !m_scanAll && settings.noupdate;
-    if (content == CONTENT_NONE || ignoreFolder)
+    if (CUtil::ExcludeFileOrFolder(strDirectory, regexps) || HasNoMedia(strDirectory) ||
+        content == CONTENT_NONE || ignoreFolder)
+    {
+      if (m_prefetcher)
+        m_prefetcher->Discard(strDirectory);
       return true;
+    }
 
     if (URIUtils::IsPlugin(strDirectory) && !CPluginDirectory::IsMediaLibraryScanningAllowed(TranslateContent(content), strDirectory))
     {
       CLog::Log(LOGNOTICE, "VideoInfoScanner: Plugin '%s' does not support media library scanning for '%s' content", CURL::GetRedacted(strDirectory).c_str(), TranslateContent(content));
+      if (m_prefetcher)
+        m_prefetcher->Discard(strDirectory);
       return true;
     }
 
     std::string hash, dbHash;
+    std::vector<std::string> prefetched;
     if (content == CONTENT_MOVIES ||content == CONTENT_MUSICVIDEOS)
     {
       if (m_handle)
@@ -278,24 +296,26 @@ namespace VIDEO
       }
 
       std::string fastHash;
-      if (CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_bVideoLibraryUseFastHash && !URIUtils::IsPlugin(strDirectory))
-        fastHash = GetFastHash(strDirectory, regexps);
+      m_database.GetPathHash(strDirectory, dbHash);
+      if (!m_prefetcher || !m_prefetcher->Get(strDirectory, content, dbHash, items, hash, fastHash, m_bStop))
+        ListDirectory(strDirectory, regexps, dbHash, items, hash, fastHash);
 
-      if (m_database.GetPathHash(strDirectory, dbHash) && !fastHash.empty() && StringUtils::EqualsNoCase(fastHash, dbHash))
-      { // fast hashes match - no need to process anything
-        hash = fastHash;
-      }
-      else
-      { // need to fetch the folder
-        CDirectory::GetDirectory(strDirectory, items, CServiceBroker::GetFileExtensionProvider().GetVideoExtensions(),
-                                 DIR_FLAG_DEFAULTS);
-        items.Stack();
-
-        // check whether to re-use previously computed fast hash
-        if (!CanFastHash(items, regexps) || fastHash.empty())
-          GetPathHash(items, hash);
-        else
-          hash = fastHash;
+      if (m_prefetcher && settings.recurse > 0)
+      {
+        // list the subfolders we are going to recurse into while this folder is
+        // processed. The most recently queued run first, so queue in reverse.
+        for (int i = items.Size() - 1; i >= 0; --i)
+        {
+          const CFileItemPtr &pItem = items[i];
+          if (pItem->m_bIsFolder && !pItem->IsParentFolder() && !pItem->IsPlayList() &&
+              !CUtil::ExcludeFileOrFolder(pItem->GetPath(), regexps))
+          {
+            std::string subHash;
+            m_database.GetPathHash(pItem->GetPath(), subHash);
+            m_prefetcher->Prefetch(pItem->GetPath(), subHash, content);
+            prefetched.push_back(pItem->GetPath());
+          }
+        }
       }
 
       if (StringUtils::EqualsNoCase(hash, dbHash))
@@ -321,6 +341,10 @@ namespace VIDEO
     }
     else if (content == CONTENT_TVSHOWS)
     {
+      // tv show folders are listed here and not recursed into
+      if (m_prefetcher)
+        m_prefetcher->Discard(strDirectory);
+
       if (m_handle)
         m_handle->SetTitle(StringUtils::Format(g_localizeStrings.Get(20319).c_str(), info->Name().c_str()));
 
@@ -390,6 +414,11 @@ namespace VIDEO
         }
       }
     }
+
+    // drop the listings of subfolders that were removed from the items or not reached
+    for (const auto &path : prefetched)
+      m_prefetcher->Discard(path);
+
     return !m_bStop;
   }
 
@@ -1832,7 +1861,31 @@ namespace VIDEO
     return count;
   }
 
-  bool CVideoInfoScanner::CanFastHash(const CFileItemList &items, const std::vector<std::string> &excludes) const
+  void CVideoInfoScanner::ListDirectory(const std::string &directory, const std::vector<std::string> &excludes, const std::string &dbHash,
+                                        CFileItemList &items, std::string &hash, std::string &fastHash)
+  {
+    if (CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_bVideoLibraryUseFastHash && !URIUtils::IsPlugin(directory))
+      fastHash = GetFastHash(directory, excludes);
+
+    if (!fastHash.empty() && StringUtils::EqualsNoCase(fastHash, dbHash))
+    { // fast hashes match - no need to process anything
+      hash = fastHash;
+      return;
+    }
+
+    // need to fetch the folder
+    CDirectory::GetDirectory(directory, items, CServiceBroker::GetFileExtensionProvider().GetVideoExtensions(),
+                             DIR_FLAG_DEFAULTS);
+    items.Stack();
+
+    // check whether to re-use previously computed fast hash
+    if (!CanFastHash(items, excludes) || fastHash.empty())
+      GetPathHash(items, hash);
+    else
+      hash = fastHash;
+  }
+
+  bool CVideoInfoScanner::CanFastHash(const CFileItemList &items, const std::vector<std::string> &excludes)
   {
     if (!CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_bVideoLibraryUseFastHash || items.IsPlugin())
       return false;
@@ -1846,7 +1899,7 @@ namespace VIDEO
   }
 
   std::string CVideoInfoScanner::GetFastHash(const std::string &directory,
-      const std::vector<std::string> &excludes) const
+      const std::vector<std::string> &excludes)
   {
     CDigest digest{CDigest::Type::MD5};
 
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <memory>
 #include <set>
 #include <string>
 #include <vector>
@@ -23,6 +24,7 @@ class CFileItemList;
 namespace VIDEO
 {
   class IVideoInfoTagLoader;
+  class CVideoScanPrefetcher;
 
   typedef struct SScanSettings
   {
@@ -101,6 +103,18 @@ namespace VIDEO
 
     bool EnumerateEpisodeItem(const CFileItem *item, EPISODELIST& episodeList);
 
+    /*! \brief List a movie or music video directory and compute its hash
+     Safe to call from any thread.
+     \param directory folder to list
+     \param excludes string array of exclude expressions
+     \param dbHash hash of the folder stored in the database. The folder isn't listed if its fast hash matches.
+     \param items [out] the stacked directory listing, empty if the fast hash matched
+     \param hash [out] the hash of the folder, empty if it is empty or doesn't exist
+     \param fastHash [out] the fast hash of the folder, empty if not available
+     */
+    static void ListDirectory(const std::string &directory, const std::vector<std::string> &excludes, const std::string &dbHash,
+                              CFileItemList &items, std::string &hash, std::string &fastHash);
+
   protected:
     virtual void Process();
     bool DoScan(const std::string& strDirectory) override;
@@ -185,7 +199,7 @@ namespace VIDEO
      \param excludes string array of exclude expressions
      \return the md5 hash of the folder"
      */
-    std::string GetFastHash(const std::string &directory, const std::vector<std::string> &excludes) const;
+    static std::string GetFastHash(const std::string &directory, const std::vector<std::string> &excludes);
 
     /*! \brief Retrieve a "fast" hash of the given directory recursively (if available)
      Performs a stat() on the directory, and uses modified time to create a "fast"
@@ -207,7 +221,7 @@ namespace VIDEO
      \param excludes string array of exclude expressions
      \return true if this directory listing can be fast hashed, false otherwise
      */
-    bool CanFastHash(const CFileItemList &items, const std::vector<std::string> &excludes) const;
+    static bool CanFastHash(const CFileItemList &items, const std::vector<std::string> &excludes);
 
     /*! \brief Process a series folder, filling in episode details and adding them to the database.
      @todo Ideally we would return INFO_HAVE_ALREADY if we don't have to update any episodes
@@ -231,6 +245,7 @@ namespace VIDEO
     CVideoDatabase m_database;
     std::set<std::string> m_pathsToCount;
     std::set<int> m_pathsToClean;
+    std::unique_ptr<CVideoScanPrefetcher> m_prefetcher; ///< lists directories ahead of the scan, if enabled
   };
 }
 
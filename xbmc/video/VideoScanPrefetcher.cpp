@@ -0,0 +1,169 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "VideoScanPrefetcher.h"
+
+#include "ServiceBroker.h"
+#include "Util.h"
+#include "VideoInfoScanner.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/SettingsComponent.h"
+#include "threads/SingleLock.h"
+
+using namespace VIDEO;
+
+namespace
+{
+class CListDirectoryJob : public CJob
+{
+public:
+  CListDirectoryJob(const std::string &directory, const std::string &dbHash, CONTENT_TYPE content,
+                    const std::shared_ptr<void> &listing)
+    : m_directory(directory), m_dbHash(dbHash), m_content(content), m_listing(listing)
+  {
+  }
+
+  bool DoWork() override
+  {
+    // the scanner skipped or passed the directory while the listing was queued
+    if (m_listing.expired())
+      return false;
+
+    const std::shared_ptr<CAdvancedSettings> advancedSettings = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings();
+    const std::vector<std::string> &regexps = m_content == CONTENT_TVSHOWS ? advancedSettings->m_tvshowExcludeFromScanRegExps
+                                                                           : advancedSettings->m_moviesExcludeFromScanRegExps;
+    CVideoInfoScanner::ListDirectory(m_directory, regexps, m_dbHash, m_items, m_hash, m_fastHash);
+    return true;
+  }
+
+  const char *GetType() const override { return "videoscanlisting"; }
+  AFFINITY GetAffinity() const override { return AFFINITY_IO; }
+
+  bool operator==(const CJob *job) const override
+  {
+    if (strcmp(job->GetType(), GetType()) == 0)
+    {
+      // a directory queued again after it was discarded gets a new listing
+      const CListDirectoryJob *listJob = dynamic_cast<const CListDirectoryJob*>(job);
+      if (listJob && listJob->m_directory == m_directory &&
+          !listJob->m_listing.owner_before(m_listing) && !m_listing.owner_before(listJob->m_listing))
+        return true;
+    }
+    return false;
+  }
+
+  std::string m_directory;
+  std::string m_dbHash;
+  CONTENT_TYPE m_content;
+  std::weak_ptr<void> m_listing;
+  CFileItemList m_items;
+  std::string m_hash;
+  std::string m_fastHash;
+};
+}
+
+const unsigned int CVideoScanPrefetcher::DEFAULT_CONCURRENCY;
+
+CVideoScanPrefetcher::CVideoScanPrefetcher(unsigned int concurrency)
+  : CJobQueue(true, concurrency, CJob::PRIORITY_NORMAL)
+{
+}
+
+CVideoScanPrefetcher::~CVideoScanPrefetcher()
+{
+  // stop the listings before the results go away
+  CancelJobs();
+}
+
+unsigned int CVideoScanPrefetcher::GetConcurrency(const std::string &directory, VECSOURCES &sources)
+{
+  bool isSourceName;
+  int source = CUtil::GetMatchingSource(directory, sources, isSourceName);
+  // plugin and skin paths are reported as a fixed index, which may not exist
+  if (source < 0 || source >= static_cast<int>(sources.size()) || sources[source].m_scanConcurrency <= 0)
+    return DEFAULT_CONCURRENCY;
+
+  return sources[source].m_scanConcurrency;
+}
+
+void CVideoScanPrefetcher::Prefetch(const std::string &directory, const std::string &dbHash, CONTENT_TYPE content)
+{
+  std::shared_ptr<CListing> listing;
+  {
+    CSingleLock lock(m_listingSection);
+    if (m_listings.find(directory) != m_listings.end())
+      return;
+
+    listing = std::make_shared<CListing>();
+    listing->content = content;
+    listing->dbHash = dbHash;
+    m_listings[directory] = listing;
+  }
+  AddJob(new CListDirectoryJob(directory, dbHash, content, listing));
+}
+
+bool CVideoScanPrefetcher::Get(const std::string &directory, CONTENT_TYPE content, const std::string &dbHash,
+                               CFileItemList &items, std::string &hash, std::string &fastHash, const bool &stop)
+{
+  CSingleLock lock(m_listingSection);
+  auto it = m_listings.find(directory);
+  while (it != m_listings.end() && !it->second->done)
+  {
+    if (stop)
+      return false;
+
+    lock.Leave();
+    m_listed.WaitMSec(100);
+    lock.Enter();
+    it = m_listings.find(directory);
+  }
+
+  if (it == m_listings.end())
+    return false;
+
+  bool valid = it->second->content == content && it->second->dbHash == dbHash;
+  if (valid)
+  {
+    items.Assign(it->second->items);
+    hash = it->second->hash;
+    fastHash = it->second->fastHash;
+  }
+  m_listings.erase(it);
+  return valid;
+}
+
+void CVideoScanPrefetcher::Discard(const std::string &directory)
+{
+  CSingleLock lock(m_listingSection);
+  m_listings.erase(directory);
+}
+
+void CVideoScanPrefetcher::OnJobComplete(unsigned int jobID, bool success, CJob *job)
+{
+  CListDirectoryJob *listJob = static_cast<CListDirectoryJob*>(job);
+  {
+    CSingleLock lock(m_listingSection);
+    auto it = m_listings.find(listJob->m_directory);
+    // the listing may have been discarded, or replaced by a new one
+    if (it != m_listings.end() && listJob->m_listing.lock() == it->second)
+    {
+      if (!success)
+        m_listings.erase(it); // let the scanner list it itself
+      else if (!it->second->done)
+      {
+        it->second->items.Assign(listJob->m_items);
+        it->second->hash = listJob->m_hash;
+        it->second->fastHash = listJob->m_fastHash;
+        it->second->done = true;
+      }
+    }
+  }
+  m_listed.Set();
+
+  CJobQueue::OnJobComplete(jobID, success, job);
+}
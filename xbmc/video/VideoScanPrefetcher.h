@@ -0,0 +1,92 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "FileItem.h"
+#include "MediaSource.h"
+#include "addons/Scraper.h"
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "utils/JobManager.h"
+
+#include <map>
+#include <memory>
+#include <string>
+
+namespace VIDEO
+{
+  /*!
+   \brief Lists and hashes directories ahead of the video scanner
+
+   Listing a directory on a network share is mostly spent waiting for round
+   trips. The scanner queues the directories it is going to scan next, and up
+   to the given number of them are listed and hashed concurrently on the I/O
+   workers while the scanner itself processes the current directory and writes
+   to the database. Listings are run most recently queued first, which matches
+   the depth first order of the scan.
+
+   The number of concurrent listings is set per source with <scanconcurrency>
+   in sources.xml, as a NAS and a local disk cope with very different loads.
+   */
+  class CVideoScanPrefetcher : public CJobQueue
+  {
+  public:
+    explicit CVideoScanPrefetcher(unsigned int concurrency);
+    ~CVideoScanPrefetcher() override;
+
+    static const unsigned int DEFAULT_CONCURRENCY = 4;
+
+    /*! \brief Get the number of concurrent listings for a directory
+     \param directory the directory to scan
+     \param sources the video sources
+     \return the concurrency of the source containing the directory, 1 to scan sequentially
+     */
+    static unsigned int GetConcurrency(const std::string &directory, VECSOURCES &sources);
+
+    /*! \brief Queue a directory to be listed
+     \param directory the directory to list
+     \param dbHash hash of the directory stored in the database, the listing is
+            skipped if the fast hash of the directory matches
+     \param content content type of the directory, selects the exclude expressions
+     */
+    void Prefetch(const std::string &directory, const std::string &dbHash, CONTENT_TYPE content);
+
+    /*! \brief Retrieve the result of a queued listing, waiting for it if needed
+     \param dbHash current hash of the directory stored in the database
+     \param stop set when the scan is cancelled, stops waiting
+     \return false if the directory wasn't queued with the same content and hash,
+             or the scan was cancelled
+     \sa CVideoInfoScanner::ListDirectory
+     */
+    bool Get(const std::string &directory, CONTENT_TYPE content, const std::string &dbHash,
+             CFileItemList &items, std::string &hash, std::string &fastHash, const bool &stop);
+
+    /*! \brief Drop the listing of a directory the scanner skipped or has passed
+     A listing that didn't start yet isn't run anymore.
+     */
+    void Discard(const std::string &directory);
+
+    void OnJobComplete(unsigned int jobID, bool success, CJob *job) override;
+
+  private:
+    struct CListing
+    {
+      CONTENT_TYPE content;
+      std::string dbHash;
+      bool done = false;
+      CFileItemList items;
+      std::string hash;
+      std::string fastHash;
+    };
+
+    std::map<std::string, std::shared_ptr<CListing>> m_listings;
+    CCriticalSection m_listingSection;
+    CEvent m_listed;
+  };
+}
@@ -8,7 +8,7 @@
 
 #include "VideoLibraryRefreshingJob.h"
 #include "ServiceBroker.h"
-#include "TextureDatabase.h"
+#include "TextureCache.h"
 #include "addons/Scraper.h"
 #include "dialogs/GUIDialogSelect.h"
 #include "dialogs/GUIDialogYesNo.h"
@@ -239,14 +239,8 @@ bool CVideoLibraryRefreshingJob::Work(CVideoDatabase &db)
     }
 
     // before we start downloading all the necessary information cleanup any existing artwork and hashes
-    CTextureDatabase textureDb;
-    if (textureDb.Open())
-    {
-      for (const auto& artwork : m_item->GetArt())
-        textureDb.InvalidateCachedTexture(artwork.second);
-
-      textureDb.Close();
-    }
+    for (const auto& artwork : m_item->GetArt())
+      CTextureCache::GetInstance().InvalidateCachedImage(artwork.second);
     m_item->ClearArt();
 
     // put together the list of items to refresh
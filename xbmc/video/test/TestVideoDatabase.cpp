@@ -0,0 +1,136 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "settings/AdvancedSettings.h"
+#include "video/VideoDatabase.h"
+#include "video/VideoInfoTag.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace
+{
+const char* TEST_DATABASE = "videodatabase-test";
+
+// links of a table whose value row doesn't exist
+const char* DANGLING_GENRE_LINKS = "SELECT COUNT(*) FROM genre_link LEFT JOIN genre ON genre.genre_id=genre_link.genre_id WHERE genre.genre_id IS NULL";
+const char* DANGLING_ACTOR_LINKS = "SELECT COUNT(*) FROM actor_link LEFT JOIN actor ON actor.actor_id=actor_link.actor_id WHERE actor.actor_id IS NULL";
+}
+
+class TestVideoDatabase : public testing::Test
+{
+protected:
+  TestVideoDatabase()
+  {
+    DatabaseSettings settings;
+    settings.type = "sqlite3";
+    settings.host = CSpecialProtocol::TranslatePath("special://temp/");
+    m_database.Connect(TEST_DATABASE, settings, true);
+  }
+
+  ~TestVideoDatabase() override
+  {
+    m_database.Close();
+    XFILE::CFile::Delete(std::string("special://temp/") + TEST_DATABASE + ".db");
+  }
+
+  int AddMovie(const std::string& path, const std::vector<std::string>& genres, const std::string& actor)
+  {
+    CVideoInfoTag details;
+    details.m_strTitle = path;
+    details.m_genre = genres;
+    if (!actor.empty())
+    {
+      SActorInfo info;
+      info.strName = actor;
+      info.strRole = "Role";
+      details.m_cast.push_back(info);
+    }
+    return m_database.SetDetailsForMovie(path, details, std::map<std::string, std::string>());
+  }
+
+  CVideoDatabase m_database;
+};
+
+TEST_F(TestVideoDatabase, BulkIngest)
+{
+  m_database.BeginBulkIngest();
+  for (int i = 0; i < 3; i++)
+    EXPECT_GT(AddMovie("/movies/movie" + std::to_string(i) + ".mkv", { "Drama", "Comedy" }, "Actor A"), 0);
+  EXPECT_TRUE(m_database.EndBulkIngest());
+
+  // ids of names seen before are reused
+  EXPECT_EQ("2", m_database.GetSingleValue("SELECT COUNT(*) FROM genre"));
+  EXPECT_EQ("1", m_database.GetSingleValue("SELECT COUNT(*) FROM actor"));
+  EXPECT_EQ("6", m_database.GetSingleValue("SELECT COUNT(*) FROM genre_link"));
+  EXPECT_EQ("3", m_database.GetSingleValue("SELECT COUNT(*) FROM actor_link WHERE role='Role'"));
+  EXPECT_EQ("0", m_database.GetSingleValue(DANGLING_GENRE_LINKS));
+
+  // outside of a session links are checked against the db and not added twice
+  EXPECT_GT(AddMovie("/movies/movie0.mkv", { "Drama" }, "Actor A"), 0);
+  EXPECT_EQ("6", m_database.GetSingleValue("SELECT COUNT(*) FROM genre_link"));
+}
+
+TEST_F(TestVideoDatabase, BulkIngestManyLinks)
+{
+  // more rows than fit into a single multi-row insert
+  std::vector<std::string> genres;
+  for (int i = 0; i < 600; i++)
+    genres.push_back("Genre " + std::to_string(i));
+
+  m_database.BeginBulkIngest();
+  EXPECT_GT(AddMovie("/movies/movie.mkv", genres, ""), 0);
+  EXPECT_TRUE(m_database.EndBulkIngest());
+
+  EXPECT_EQ("600", m_database.GetSingleValue("SELECT COUNT(*) FROM genre_link"));
+  EXPECT_EQ("0", m_database.GetSingleValue(DANGLING_GENRE_LINKS));
+}
+
+TEST_F(TestVideoDatabase, BulkIngestRollback)
+{
+  m_database.BeginBulkIngest();
+  m_database.BeginTransaction();
+  EXPECT_GT(AddMovie("/movies/gone.mkv", { "Western" }, "Actor B"), 0);
+  m_database.RollbackTransaction();
+
+  // the rows of the ids cached for the rolled back item are gone
+  EXPECT_GT(AddMovie("/movies/kept.mkv", { "Western" }, "Actor B"), 0);
+  EXPECT_TRUE(m_database.EndBulkIngest());
+
+  EXPECT_EQ("1", m_database.GetSingleValue("SELECT COUNT(*) FROM movie"));
+  EXPECT_EQ("1", m_database.GetSingleValue("SELECT COUNT(*) FROM genre_link JOIN genre ON genre.genre_id=genre_link.genre_id WHERE genre.name='Western'"));
+  EXPECT_EQ("0", m_database.GetSingleValue(DANGLING_GENRE_LINKS));
+  EXPECT_EQ("0", m_database.GetSingleValue(DANGLING_ACTOR_LINKS));
+}
+
+TEST_F(TestVideoDatabase, BulkIngestFailedCommit)
+{
+  // a deferred foreign key violation makes the commit of the session's transaction fail
+  m_database.ExecuteQuery("PRAGMA foreign_keys=ON");
+  m_database.ExecuteQuery("CREATE TABLE commit_check (idMovie INTEGER REFERENCES movie(idMovie) DEFERRABLE INITIALLY DEFERRED)");
+
+  m_database.BeginBulkIngest();
+  EXPECT_GT(AddMovie("/movies/lost0.mkv", { "Western" }, "Actor B"), 0);
+  m_database.ExecuteQuery("INSERT INTO commit_check VALUES (-1)");
+  // enough items for the session to commit
+  for (int i = 1; i < 100; i++)
+    AddMovie("/movies/lost" + std::to_string(i) + ".mkv", {}, "");
+
+  EXPECT_GT(AddMovie("/movies/kept.mkv", { "Western" }, "Actor B"), 0);
+  EXPECT_TRUE(m_database.EndBulkIngest());
+
+  EXPECT_EQ("0", m_database.GetSingleValue("SELECT COUNT(*) FROM commit_check"));
+  EXPECT_EQ("1", m_database.GetSingleValue("SELECT COUNT(*) FROM genre_link JOIN genre ON genre.genre_id=genre_link.genre_id WHERE genre.name='Western'"));
+  EXPECT_EQ("0", m_database.GetSingleValue(DANGLING_GENRE_LINKS));
+  EXPECT_EQ("0", m_database.GetSingleValue(DANGLING_ACTOR_LINKS));
+}
@@ -0,0 +1,127 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "FileItem.h"
+#include "MediaSource.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "utils/URIUtils.h"
+#include "video/VideoInfoScanner.h"
+#include "video/VideoScanPrefetcher.h"
+
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using namespace VIDEO;
+
+class TestVideoScanPrefetcher : public testing::Test
+{
+protected:
+  TestVideoScanPrefetcher()
+  {
+    m_path = URIUtils::AddFileToFolder(CSpecialProtocol::TranslatePath("special://temp/"), "TestVideoScanPrefetcher/");
+    XFILE::CDirectory::Create(m_path);
+    XFILE::CDirectory::Create(m_path + "sub/");
+    for (const char* name : { "movie1.mkv", "movie2.avi", "sub/movie3.mkv" })
+    {
+      XFILE::CFile file;
+      if (file.OpenForWrite(m_path + name, true))
+        file.Write(name, 1);
+    }
+  }
+
+  ~TestVideoScanPrefetcher() override
+  {
+    XFILE::CDirectory::RemoveRecursive(m_path);
+  }
+
+  std::string m_path;
+  bool m_stop = false;
+};
+
+TEST_F(TestVideoScanPrefetcher, Get)
+{
+  CFileItemList expected;
+  std::string expectedHash, expectedFastHash;
+  CVideoInfoScanner::ListDirectory(m_path, std::vector<std::string>(), "", expected, expectedHash, expectedFastHash);
+
+  CVideoScanPrefetcher prefetcher(2);
+  prefetcher.Prefetch(m_path, "", CONTENT_MOVIES);
+
+  CFileItemList items;
+  std::string hash, fastHash;
+  ASSERT_TRUE(prefetcher.Get(m_path, CONTENT_MOVIES, "", items, hash, fastHash, m_stop));
+  EXPECT_EQ(expected.Size(), items.Size());
+  EXPECT_EQ(expectedHash, hash);
+  EXPECT_EQ(expectedFastHash, fastHash);
+
+  // a listing is handed out once
+  EXPECT_FALSE(prefetcher.Get(m_path, CONTENT_MOVIES, "", items, hash, fastHash, m_stop));
+}
+
+TEST_F(TestVideoScanPrefetcher, GetChanged)
+{
+  CVideoScanPrefetcher prefetcher(2);
+  CFileItemList items;
+  std::string hash, fastHash;
+
+  // not queued
+  EXPECT_FALSE(prefetcher.Get(m_path, CONTENT_MOVIES, "", items, hash, fastHash, m_stop));
+
+  // the hash in the database changed since the listing was queued
+  prefetcher.Prefetch(m_path, "", CONTENT_MOVIES);
+  EXPECT_FALSE(prefetcher.Get(m_path, CONTENT_MOVIES, "other", items, hash, fastHash, m_stop));
+
+  // the content of the path changed
+  prefetcher.Prefetch(m_path, "", CONTENT_MOVIES);
+  EXPECT_FALSE(prefetcher.Get(m_path, CONTENT_MUSICVIDEOS, "", items, hash, fastHash, m_stop));
+  EXPECT_TRUE(items.IsEmpty());
+}
+
+TEST_F(TestVideoScanPrefetcher, Discard)
+{
+  CVideoScanPrefetcher prefetcher(1);
+  prefetcher.Prefetch(m_path, "", CONTENT_MOVIES);
+  prefetcher.Prefetch(m_path + "sub/", "", CONTENT_MOVIES);
+  prefetcher.Discard(m_path);
+  prefetcher.Discard(m_path + "sub/");
+
+  CFileItemList items;
+  std::string hash, fastHash;
+  EXPECT_FALSE(prefetcher.Get(m_path, CONTENT_MOVIES, "", items, hash, fastHash, m_stop));
+  EXPECT_FALSE(prefetcher.Get(m_path + "sub/", CONTENT_MOVIES, "", items, hash, fastHash, m_stop));
+
+  // queueing a discarded directory again lists it again
+  prefetcher.Prefetch(m_path + "sub/", "", CONTENT_MOVIES);
+  EXPECT_TRUE(prefetcher.Get(m_path + "sub/", CONTENT_MOVIES, "", items, hash, fastHash, m_stop));
+  EXPECT_EQ(1, items.Size());
+}
+
+TEST_F(TestVideoScanPrefetcher, GetConcurrency)
+{
+  VECSOURCES sources;
+  CMediaSource nas;
+  nas.FromNameAndPaths("video", "NAS", { "smb://nas/movies/" });
+  nas.m_scanConcurrency = 8;
+  sources.push_back(nas);
+  CMediaSource local;
+  local.FromNameAndPaths("video", "Local", { "/media/movies/" });
+  sources.push_back(local);
+  CMediaSource sequential;
+  sequential.FromNameAndPaths("video", "USB", { "/media/usb/" });
+  sequential.m_scanConcurrency = 1;
+  sources.push_back(sequential);
+
+  EXPECT_EQ(8u, CVideoScanPrefetcher::GetConcurrency("smb://nas/movies/Alien (1979)/", sources));
+  EXPECT_EQ(CVideoScanPrefetcher::DEFAULT_CONCURRENCY, CVideoScanPrefetcher::GetConcurrency("/media/movies/", sources));
+  EXPECT_EQ(1u, CVideoScanPrefetcher::GetConcurrency("/media/usb/Films/", sources));
+  EXPECT_EQ(CVideoScanPrefetcher::DEFAULT_CONCURRENCY, CVideoScanPrefetcher::GetConcurrency("/elsewhere/", sources));
+}
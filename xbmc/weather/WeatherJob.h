@@ -19,6 +19,7 @@ public:
   explicit CWeatherJob(int location);
 
   bool DoWork() override;
+  AFFINITY GetAffinity() const override { return AFFINITY_IO; }
 
   const CWeatherInfo &GetInfo() const;
 private: